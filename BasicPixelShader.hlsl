@@ -3,6 +3,11 @@
 Texture2D g_texture0 : register(t0);
 TextureCube g_diffuseCube : register(t1);
 TextureCube g_specularCube : register(t2);
+Texture2D g_packedTexture : register(t3); // R = AO, G = ĥ, B = ݼӼ, A = 
+Texture2DArray g_textureArray : register(t4); // TextureArrayPacker  ؽ
+Texture2DArray g_packedTextureArray : register(t5);
+Texture2D g_brdfLut : register(t6); // split-sum (scale, bias), x = NdotV, y = ĥ
+Texture2D g_specularOctahedral : register(t7); // g_specularCube ȸü 2D ű 
 SamplerState g_sampler : register(s0);
 
 cbuffer BasicPixelConstantBuffer : register(b0)
@@ -11,12 +16,31 @@ cbuffer BasicPixelConstantBuffer : register(b0)
     bool useTexture;
     Material material;
    // Light light[MAX_LIGHTS];
-    float3 rimColor;
-    float rimPower;
-    float rimStrength;
     bool useSmoothstep;
+    int diffuseMode; // 0: g_diffuseCube, 1: irradianceSh
+    int specularMode; // 0: pow(, shininess), 1: split-sum, 2: split-sum (ȸü )
+    float roughness; // packed.g 
+    float4 irradianceSh[9]; // SphericalHarmonics::ToIrradiance()
 };
 
+// ޽ ٸ   (slice -1̸ t0/t3 ؽ ϳ )
+cbuffer MaterialConstantBuffer : register(b1)
+{
+    float4 textureRect; // xy = ũ, zw =  (Ʋ  )
+    float4 packedRect;
+    float textureSlice;
+    float packedSlice;
+};
+
+// Ʋ ̸ ݺǴ uv   
+// frac()   ̺   uv ̺ mip 
+float4 SampleSlice(Texture2DArray tex, float2 uv, float4 rect, float slice)
+{
+    float2 atlasUv = frac(uv) * rect.xy + rect.zw;
+    return tex.SampleGrad(g_sampler, float3(atlasUv, slice), ddx(uv) * rect.xy,
+                          ddy(uv) * rect.xy);
+}
+
 // Schlick approximation: Eq. 9.17 in "Real-Time Rendering 4th Ed."
 // fresnelR0   
 // Water : (0.02, 0.02, 0.02)
@@ -73,22 +97,75 @@ float4 main(PixelShaderInput input) : SV_TARGET
     //    ִ  Դϴ.
     // IBL ٸ ̵ (:  ̵)    ֽϴ.
     
-    float4 diffuse = g_diffuseCube.Sample(g_sampler, input.normalWorld);
-    float4 specular = g_specularCube.Sample(g_sampler, reflect(-toEye, input.normalWorld));
-    
+    //  ȭ  diffuse ť     9 
+    float4 diffuse;
+    if (diffuseMode == 1)
+        diffuse = float4(IrradianceSH(irradianceSh, normalize(input.normalWorld)), 1.0);
+    else
+        diffuse = g_diffuseCube.Sample(g_sampler, input.normalWorld);
     diffuse *= float4(material.diffuse, 1.0);
-    specular *= pow((specular.r + specular.g + specular.b) / 3.0, material.shininess);
-    specular *= float4(material.specular, 1.0);
-    
-    
-    float3 f = SchlickFresnel(material.fresnelR0, input.normalWorld, toEye);
-    specular.xyz *= f;
+
+    //   ؽ ϳ    (  AO = 1 ⺻ ؽ)
+    // ?:   ϹǷ if  (  ̶  ȼ  )
+    float4 packed;
+    if (packedSlice >= 0.0)
+        packed = SampleSlice(g_packedTextureArray, input.texcoord, packedRect, packedSlice);
+    else
+        packed = g_packedTexture.Sample(g_sampler, input.texcoord);
+
+    float4 specular;
+    if (specularMode >= 1)
+    {
+        // split-sum: ĥ⿡ ´  mip (CubemapPrefilter) * (F0 * scale + bias)
+        float3 normal = normalize(input.normalWorld);
+        float3 reflected = reflect(-toEye, normal);
+        float r = saturate(roughness * packed.g);
+        float3 prefiltered;
+        uint width, height, levels;
+        if (specularMode == 2)
+        {
+            // ȸü ʵ ù  ĥ 0,   ĥ 1
+            g_specularOctahedral.GetDimensions(0, width, height, levels);
+            prefiltered = SampleOctahedral(g_specularOctahedral, g_sampler, reflected,
+                                           r * (levels - 1));
+        }
+        else
+        {
+            g_specularCube.GetDimensions(0, width, height, levels);
+            prefiltered = g_specularCube.SampleLevel(g_sampler, reflected, r * (levels - 1)).rgb;
+        }
+
+        // ÷ WRAP̶ ڸ ؼ ߽ 
+        uint lutWidth, lutHeight;
+        g_brdfLut.GetDimensions(lutWidth, lutHeight);
+        float2 halfTexel = 0.5 / float2(lutWidth, lutHeight);
+        float2 lutUv = clamp(float2(saturate(dot(normal, toEye)), r), halfTexel, 1.0 - halfTexel);
+        float2 scaleBias = g_brdfLut.SampleLevel(g_sampler, lutUv, 0).rg;
+
+        specular = float4(prefiltered * (material.fresnelR0 * scaleBias.x + scaleBias.y) *
+                          material.specular, 0.0);
+    }
+    else
+    {
+        specular = g_specularCube.Sample(g_sampler, reflect(-toEye, input.normalWorld));
+        specular *= pow((specular.r + specular.g + specular.b) / 3.0, material.shininess);
+        specular *= float4(material.specular, 1.0);
+
+        float3 f = SchlickFresnel(material.fresnelR0, input.normalWorld, toEye);
+        specular.xyz *= f;
+    }
     
     if (useTexture)
     {
-        diffuse *= g_texture0.Sample(g_sampler, input.texcoord);
+        if (textureSlice >= 0.0)
+            diffuse *= SampleSlice(g_textureArray, input.texcoord, textureRect, textureSlice);
+        else
+            diffuse *= g_texture0.Sample(g_sampler, input.texcoord);
      
     }
+
+    diffuse.rgb *= packed.r;
+    specular.rgb *= packed.r;
     
     return diffuse + specular;
 }
@@ -0,0 +1,1317 @@
+﻿#include "BlockCompressor.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "DdsFile.h"
+#include "ThreadPool.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FEFE_BC_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace FEFE
+{
+
+namespace
+{
+
+// 4x4 블록, c[채널][픽셀] (채널 0~3 = RGBA, 0~255)
+struct alignas(16) Block
+{
+    float c[4][16];
+};
+
+struct Palette
+{
+    float c[16][4];
+    int size = 0;
+};
+
+// BC7 보간 가중치 (/64)
+const int bc7Weights3[8] = {0, 9, 18, 27, 37, 46, 55, 64};
+const int bc7Weights4[16] = {0,  4,  9,  13, 17, 21, 26, 30,
+                             34, 38, 43, 47, 51, 55, 60, 64};
+
+// BC7 두 영역 분할 (bit i = 픽셀 i가 영역 1), 영역 1의 anchor 픽셀
+const uint16_t bc7Partitions2[64] = {
+    0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+    0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+    0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+    0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+    0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+    0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+    0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+    0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22};
+const uint8_t bc7Anchors2[64] = {
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+    15, 2,  8,  2,  2,  8,  8,  15, 2,  8,  2,  2,  8,  8,  2,  2,
+    15, 15, 6,  8,  2,  8,  15, 15, 2,  8,  2,  2,  2,  15, 15, 6,
+    6,  2,  6,  8,  15, 15, 2,  2,  15, 15, 15, 15, 15, 2,  2,  15};
+
+// High 품질에서 끝까지 압축해보는 분할 수 (대략적인 오차가 작은 순)
+const int bc7PartitionCandidates = 4;
+
+inline int Clamp(int x, int lo, int hi) { return std::min(std::max(x, lo), hi); }
+inline int Round(float x) { return int(std::floor(x + 0.5f)); }
+
+void LoadBlock(const uint8_t *rgba, int width, int height, int bx, int by,
+               Block &block)
+{
+    for (int y = 0; y < 4; y++)
+    {
+        const int sy = std::min(by * 4 + y, height - 1);
+        for (int x = 0; x < 4; x++)
+        {
+            const int sx = std::min(bx * 4 + x, width - 1);
+            const uint8_t *p = rgba + (size_t(sy) * width + sx) * 4;
+            for (int ch = 0; ch < 4; ch++)
+                block.c[ch][y * 4 + x] = float(p[ch]);
+        }
+    }
+}
+
+void StoreBlock(const uint8_t decoded[16][4], int width, int height, int bx,
+                int by, uint8_t *rgba)
+{
+    for (int y = 0; y < 4 && by * 4 + y < height; y++)
+    {
+        for (int x = 0; x < 4 && bx * 4 + x < width; x++)
+        {
+            std::memcpy(rgba + (size_t(by * 4 + y) * width + bx * 4 + x) * 4,
+                        decoded[y * 4 + x], 4);
+        }
+    }
+}
+
+// 픽셀마다 팔레트에서 가장 가까운 색 ([first, first + count) 채널만 비교)
+// 전체 제곱 오차를 반환하고, errors가 있으면 픽셀별 오차도 저장
+float FitIndices(const Block &block, const Palette &palette, int first,
+                 int count, uint8_t indices[16], float *errors = nullptr)
+{
+    float total = 0.0f;
+
+#ifdef FEFE_BC_SSE2
+    for (int p = 0; p < 16; p += 4)
+    {
+        __m128 best = _mm_set1_ps(FLT_MAX);
+        __m128 bestIndex = _mm_setzero_ps();
+        for (int i = 0; i < palette.size; i++)
+        {
+            __m128 d = _mm_setzero_ps();
+            for (int ch = first; ch < first + count; ch++)
+            {
+                const __m128 diff = _mm_sub_ps(_mm_load_ps(block.c[ch] + p),
+                                               _mm_set1_ps(palette.c[i][ch]));
+                d = _mm_add_ps(d, _mm_mul_ps(diff, diff));
+            }
+            const __m128 less = _mm_cmplt_ps(d, best);
+            best = _mm_min_ps(d, best);
+            bestIndex = _mm_or_ps(_mm_and_ps(less, _mm_set1_ps(float(i))),
+                                  _mm_andnot_ps(less, bestIndex));
+        }
+
+        float index[4], error[4];
+        _mm_storeu_ps(index, bestIndex);
+        _mm_storeu_ps(error, best);
+        for (int k = 0; k < 4; k++)
+        {
+            indices[p + k] = uint8_t(index[k]);
+            total += error[k];
+            if (errors)
+                errors[p + k] = error[k];
+        }
+    }
+#else
+    for (int p = 0; p < 16; p++)
+    {
+        float best = FLT_MAX;
+        for (int i = 0; i < palette.size; i++)
+        {
+            float d = 0.0f;
+            for (int ch = first; ch < first + count; ch++)
+            {
+                const float diff = block.c[ch][p] - palette.c[i][ch];
+                d += diff * diff;
+            }
+            if (d < best)
+            {
+                best = d;
+                indices[p] = uint8_t(i);
+            }
+        }
+        total += best;
+        if (errors)
+            errors[p] = best;
+    }
+#endif
+
+    return total;
+}
+
+// mask에 속한 픽셀들의 평균과 주성분 방향 (채널 [0, count))
+// 반환값: 주성분 방향으로 설명되지 않는 분산의 합 (직선 하나로 맞출 때의 오차 추정)
+float PrincipalAxis(const Block &block, uint16_t mask, int count,
+                    float mean[4], float axis[4])
+{
+    int n = 0;
+    for (int ch = 0; ch < 4; ch++)
+        mean[ch] = 0.0f;
+    for (int p = 0; p < 16; p++)
+    {
+        if (!(mask >> p & 1))
+            continue;
+        n++;
+        for (int ch = 0; ch < count; ch++)
+            mean[ch] += block.c[ch][p];
+    }
+    if (n == 0)
+        return 0.0f;
+    for (int ch = 0; ch < count; ch++)
+        mean[ch] /= float(n);
+
+    float cov[4][4] = {};
+    for (int p = 0; p < 16; p++)
+    {
+        if (!(mask >> p & 1))
+            continue;
+        float d[4];
+        for (int ch = 0; ch < count; ch++)
+            d[ch] = block.c[ch][p] - mean[ch];
+        for (int i = 0; i < count; i++)
+            for (int j = i; j < count; j++)
+                cov[i][j] += d[i] * d[j];
+    }
+    float variance = 0.0f;
+    for (int i = 0; i < count; i++)
+    {
+        variance += cov[i][i];
+        for (int j = 0; j < i; j++)
+            cov[i][j] = cov[j][i];
+    }
+
+    // 거듭제곱법, 시작은 분산이 큰 채널 쪽
+    for (int ch = 0; ch < 4; ch++)
+        axis[ch] = ch < count ? cov[ch][ch] + 1e-3f : 0.0f;
+    float eigenvalue = 0.0f;
+    for (int iteration = 0; iteration < 8; iteration++)
+    {
+        float next[4] = {};
+        for (int i = 0; i < count; i++)
+            for (int j = 0; j < count; j++)
+                next[i] += cov[i][j] * axis[j];
+        float length = 0.0f;
+        for (int i = 0; i < count; i++)
+            length += next[i] * next[i];
+        length = std::sqrt(length);
+        if (length < 1e-8f)
+            break;
+        for (int i = 0; i < count; i++)
+            axis[i] = next[i] / length;
+        eigenvalue = length;
+    }
+
+    float length = 0.0f;
+    for (int i = 0; i < count; i++)
+        length += axis[i] * axis[i];
+    length = std::sqrt(length);
+    for (int i = 0; i < count; i++)
+        axis[i] = length > 0.0f ? axis[i] / length : 0.0f;
+
+    return std::max(variance - eigenvalue, 0.0f);
+}
+
+// 주성분 방향으로 투영한 양 끝을 끝점으로
+void AxisEndpoints(const Block &block, uint16_t mask, int count,
+                   const float mean[4], const float axis[4], float e0[4],
+                   float e1[4], float maxValue = 255.0f)
+{
+    float tmin = FLT_MAX, tmax = -FLT_MAX;
+    for (int p = 0; p < 16; p++)
+    {
+        if (!(mask >> p & 1))
+            continue;
+        float t = 0.0f;
+        for (int ch = 0; ch < count; ch++)
+            t += (block.c[ch][p] - mean[ch]) * axis[ch];
+        tmin = std::min(tmin, t);
+        tmax = std::max(tmax, t);
+    }
+    if (tmin > tmax)
+        tmin = tmax = 0.0f;
+    for (int ch = 0; ch < 4; ch++)
+    {
+        e0[ch] = std::min(std::max(mean[ch] + tmin * axis[ch], 0.0f), maxValue);
+        e1[ch] = std::min(std::max(mean[ch] + tmax * axis[ch], 0.0f), maxValue);
+    }
+}
+
+// 인덱스가 정해졌을 때 오차가 가장 작은 끝점 (최소제곱)
+// weights[i]: 인덱스 i의 색에서 e1의 비율
+bool LeastSquaresEndpoints(const Block &block, uint16_t mask, int first,
+                           int count, const uint8_t indices[16],
+                           const float *weights, float e0[4], float e1[4],
+                           float maxValue = 255.0f)
+{
+    float a = 0.0f, b = 0.0f, c = 0.0f;
+    float d0[4] = {}, d1[4] = {};
+    for (int p = 0; p < 16; p++)
+    {
+        if (!(mask >> p & 1))
+            continue;
+        const float w = weights[indices[p]];
+        a += (1.0f - w) * (1.0f - w);
+        b += (1.0f - w) * w;
+        c += w * w;
+        for (int ch = first; ch < first + count; ch++)
+        {
+            d0[ch] += (1.0f - w) * block.c[ch][p];
+            d1[ch] += w * block.c[ch][p];
+        }
+    }
+
+    const float det = a * c - b * b;
+    if (std::fabs(det) < 1e-6f)
+        return false;
+    for (int ch = first; ch < first + count; ch++)
+    {
+        e0[ch] = std::min(std::max((c * d0[ch] - b * d1[ch]) / det, 0.0f), maxValue);
+        e1[ch] = std::min(std::max((a * d1[ch] - b * d0[ch]) / det, 0.0f), maxValue);
+    }
+    return true;
+}
+
+// 128비트 블록에 낮은 비트부터 차례로 쓰기/읽기 (BC7)
+struct BitWriter
+{
+    uint64_t bits[2] = {0, 0};
+    int position = 0;
+
+    void Write(uint32_t value, int count)
+    {
+        for (int i = 0; i < count; i++, position++)
+        {
+            if (value >> i & 1)
+                bits[position >> 6] |= uint64_t(1) << (position & 63);
+        }
+    }
+};
+
+struct BitReader
+{
+    uint64_t bits[2];
+    int position = 0;
+
+    explicit BitReader(const uint8_t *block) { std::memcpy(bits, block, 16); }
+
+    uint32_t Read(int count)
+    {
+        uint32_t value = 0;
+        for (int i = 0; i < count; i++, position++)
+            value |= uint32_t(bits[position >> 6] >> (position & 63) & 1) << i;
+        return value;
+    }
+};
+
+// ---------------------------------------------------------------- BC1
+
+uint16_t Quantize565(const float e[4])
+{
+    return uint16_t(Clamp(Round(e[0] * 31.0f / 255.0f), 0, 31) << 11 |
+                    Clamp(Round(e[1] * 63.0f / 255.0f), 0, 63) << 5 |
+                    Clamp(Round(e[2] * 31.0f / 255.0f), 0, 31));
+}
+
+void Expand565(uint16_t c, int rgb[3])
+{
+    const int r = c >> 11, g = c >> 5 & 63, b = c & 31;
+    rgb[0] = r << 3 | r >> 2;
+    rgb[1] = g << 2 | g >> 4;
+    rgb[2] = b << 3 | b >> 2;
+}
+
+// 4색 모드 팔레트: c0, c1, 2/3 c0 + 1/3 c1, 1/3 c0 + 2/3 c1
+void BC1Palette(uint16_t c0, uint16_t c1, Palette &palette)
+{
+    int a[3], b[3];
+    Expand565(c0, a);
+    Expand565(c1, b);
+    palette.size = 4;
+    for (int ch = 0; ch < 3; ch++)
+    {
+        palette.c[0][ch] = float(a[ch]);
+        palette.c[1][ch] = float(b[ch]);
+        palette.c[2][ch] = float((2 * a[ch] + b[ch]) / 3);
+        palette.c[3][ch] = float((a[ch] + 2 * b[ch]) / 3);
+    }
+}
+
+void EncodeBC1(const Block &block, bool refine, uint8_t out[8])
+{
+    static const float weights[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+
+    float mean[4], axis[4], e0[4], e1[4];
+    PrincipalAxis(block, 0xFFFF, 3, mean, axis);
+    AxisEndpoints(block, 0xFFFF, 3, mean, axis, e1, e0);
+
+    uint16_t c0 = Quantize565(e0), c1 = Quantize565(e1);
+    uint8_t indices[16];
+    Palette palette;
+    BC1Palette(c0, c1, palette);
+    float error = FitIndices(block, palette, 0, 3, indices);
+
+    for (int iteration = 0; refine && iteration < 2; iteration++)
+    {
+        if (!LeastSquaresEndpoints(block, 0xFFFF, 0, 3, indices, weights, e0, e1))
+            break;
+        const uint16_t n0 = Quantize565(e0), n1 = Quantize565(e1);
+        uint8_t newIndices[16];
+        BC1Palette(n0, n1, palette);
+        const float newError = FitIndices(block, palette, 0, 3, newIndices);
+        if (newError >= error)
+            break;
+        c0 = n0;
+        c1 = n1;
+        error = newError;
+        std::memcpy(indices, newIndices, 16);
+    }
+
+    // c0 > c1이어야 4색 모드, 같으면 3색 모드가 되므로 모두 c0
+    if (c0 < c1)
+    {
+        std::swap(c0, c1);
+        static const uint8_t swapped[4] = {1, 0, 3, 2};
+        for (auto &index : indices)
+            index = swapped[index];
+    }
+    else if (c0 == c1)
+    {
+        std::memset(indices, 0, 16);
+    }
+
+    uint32_t bits = 0;
+    for (int p = 0; p < 16; p++)
+        bits |= uint32_t(indices[p]) << (p * 2);
+    std::memcpy(out, &c0, 2);
+    std::memcpy(out + 2, &c1, 2);
+    std::memcpy(out + 4, &bits, 4);
+}
+
+void DecodeBC1(const uint8_t block[8], uint8_t decoded[16][4])
+{
+    uint16_t c0, c1;
+    uint32_t bits;
+    std::memcpy(&c0, block, 2);
+    std::memcpy(&c1, block + 2, 2);
+    std::memcpy(&bits, block + 4, 4);
+
+    int a[3], b[3];
+    Expand565(c0, a);
+    Expand565(c1, b);
+    uint8_t colors[4][4];
+    for (int ch = 0; ch < 3; ch++)
+    {
+        colors[0][ch] = uint8_t(a[ch]);
+        colors[1][ch] = uint8_t(b[ch]);
+        if (c0 > c1)
+        {
+            colors[2][ch] = uint8_t((2 * a[ch] + b[ch]) / 3);
+            colors[3][ch] = uint8_t((a[ch] + 2 * b[ch]) / 3);
+        }
+        else
+        {
+            colors[2][ch] = uint8_t((a[ch] + b[ch]) / 2);
+            colors[3][ch] = 0;
+        }
+    }
+    colors[0][3] = colors[1][3] = colors[2][3] = 255;
+    colors[3][3] = c0 > c1 ? 255 : 0;
+
+    for (int p = 0; p < 16; p++)
+        std::memcpy(decoded[p], colors[bits >> (p * 2) & 3], 4);
+}
+
+// ---------------------------------------------------------------- BC4
+
+// 한 채널, a0 > a1인 8단계 모드
+void BC4Palette(int a0, int a1, int channel, Palette &palette)
+{
+    palette.size = 8;
+    palette.c[0][channel] = float(a0);
+    palette.c[1][channel] = float(a1);
+    for (int k = 2; k < 8; k++)
+        palette.c[k][channel] = float(((8 - k) * a0 + (k - 1) * a1) / 7);
+}
+
+void EncodeBC4(const Block &block, int channel, uint8_t out[8])
+{
+    static const float weights[8] = {0.0f,        1.0f,        1.0f / 7.0f,
+                                     2.0f / 7.0f, 3.0f / 7.0f, 4.0f / 7.0f,
+                                     5.0f / 7.0f, 6.0f / 7.0f};
+
+    float lo = 255.0f, hi = 0.0f;
+    for (int p = 0; p < 16; p++)
+    {
+        lo = std::min(lo, block.c[channel][p]);
+        hi = std::max(hi, block.c[channel][p]);
+    }
+
+    int a0 = Round(hi), a1 = Round(lo);
+    uint8_t indices[16] = {};
+    if (a0 > a1)
+    {
+        Palette palette;
+        BC4Palette(a0, a1, channel, palette);
+        float error = FitIndices(block, palette, channel, 1, indices);
+
+        // 양 끝이 튀는 값이면 안쪽으로 당기는 것이 나을 수 있음
+        float e0[4], e1[4];
+        if (LeastSquaresEndpoints(block, 0xFFFF, channel, 1, indices, weights,
+                                  e0, e1))
+        {
+            const int n0 = Round(e0[channel]), n1 = Round(e1[channel]);
+            if (n0 > n1)
+            {
+                uint8_t newIndices[16];
+                BC4Palette(n0, n1, channel, palette);
+                if (FitIndices(block, palette, channel, 1, newIndices) < error)
+                {
+                    a0 = n0;
+                    a1 = n1;
+                    std::memcpy(indices, newIndices, 16);
+                }
+            }
+        }
+    }
+    // a0 == a1이면 6단계 모드의 인덱스 0 (= a0)
+
+    uint64_t bits = 0;
+    for (int p = 0; p < 16; p++)
+        bits |= uint64_t(indices[p]) << (p * 3);
+    out[0] = uint8_t(a0);
+    out[1] = uint8_t(a1);
+    for (int i = 0; i < 6; i++)
+        out[2 + i] = uint8_t(bits >> (i * 8));
+}
+
+void DecodeBC4(const uint8_t block[8], int channel, uint8_t decoded[16][4])
+{
+    const int a0 = block[0], a1 = block[1];
+    int values[8] = {a0, a1};
+    if (a0 > a1)
+    {
+        for (int k = 2; k < 8; k++)
+            values[k] = ((8 - k) * a0 + (k - 1) * a1) / 7;
+    }
+    else
+    {
+        for (int k = 2; k < 6; k++)
+            values[k] = ((6 - k) * a0 + (k - 1) * a1) / 5;
+        values[6] = 0;
+        values[7] = 255;
+    }
+
+    uint64_t bits = 0;
+    for (int i = 0; i < 6; i++)
+        bits |= uint64_t(block[2 + i]) << (i * 8);
+    for (int p = 0; p < 16; p++)
+        decoded[p][channel] = uint8_t(values[bits >> (p * 3) & 7]);
+}
+
+// ---------------------------------------------------------------- BC7
+
+inline int Bc7Interpolate(int e0, int e1, int weight)
+{
+    return ((64 - weight) * e0 + weight * e1 + 32) >> 6;
+}
+
+struct Bc7Result
+{
+    float error = FLT_MAX;
+    uint8_t block[16] = {};
+};
+
+// mode 6: 한 영역, RGBA 7비트 + 끝점마다 p비트, 4비트 인덱스
+void EncodeBC7Mode6(const Block &block, BC7Quality quality, Bc7Result &result)
+{
+    float weights[16];
+    for (int i = 0; i < 16; i++)
+        weights[i] = float(bc7Weights4[i]) / 64.0f;
+
+    float e0[4], e1[4];
+    if (quality == BC7Quality::Fast)
+    {
+        // 범위 상자의 양 끝
+        for (int ch = 0; ch < 4; ch++)
+        {
+            e0[ch] = *std::min_element(block.c[ch], block.c[ch] + 16);
+            e1[ch] = *std::max_element(block.c[ch], block.c[ch] + 16);
+        }
+    }
+    else
+    {
+        float mean[4], axis[4];
+        PrincipalAxis(block, 0xFFFF, 4, mean, axis);
+        AxisEndpoints(block, 0xFFFF, 4, mean, axis, e0, e1);
+    }
+
+    // p비트 4가지 중 오차가 가장 작은 것
+    int best[2][4] = {}, bestP[2] = {};
+    uint8_t bestIndices[16] = {};
+    float bestError = FLT_MAX;
+
+    auto TryEndpoints = [&](const float f0[4], const float f1[4]) {
+        bool improved = false;
+        for (int p0 = 0; p0 < 2; p0++)
+        {
+            for (int p1 = 0; p1 < 2; p1++)
+            {
+                int q[2][4];
+                for (int ch = 0; ch < 4; ch++)
+                {
+                    q[0][ch] = Clamp(Round((f0[ch] - p0) * 0.5f), 0, 127);
+                    q[1][ch] = Clamp(Round((f1[ch] - p1) * 0.5f), 0, 127);
+                }
+
+                Palette palette;
+                palette.size = 16;
+                for (int i = 0; i < 16; i++)
+                {
+                    for (int ch = 0; ch < 4; ch++)
+                    {
+                        palette.c[i][ch] = float(Bc7Interpolate(
+                            q[0][ch] * 2 + p0, q[1][ch] * 2 + p1, bc7Weights4[i]));
+                    }
+                }
+
+                uint8_t indices[16];
+                const float error = FitIndices(block, palette, 0, 4, indices);
+                if (error < bestError)
+                {
+                    bestError = error;
+                    std::memcpy(best, q, sizeof(q));
+                    bestP[0] = p0;
+                    bestP[1] = p1;
+                    std::memcpy(bestIndices, indices, 16);
+                    improved = true;
+                }
+            }
+        }
+        return improved;
+    };
+
+    TryEndpoints(e0, e1);
+    for (int iteration = 0; quality != BC7Quality::Fast && iteration < 2;
+         iteration++)
+    {
+        if (!LeastSquaresEndpoints(block, 0xFFFF, 0, 4, bestIndices, weights,
+                                   e0, e1) ||
+            !TryEndpoints(e0, e1))
+            break;
+    }
+
+    if (bestError >= result.error)
+        return;
+
+    // anchor(픽셀 0)의 인덱스 최상위 비트는 0이어야 함 -> 끝점을 바꿔서 뒤집기
+    if (bestIndices[0] >= 8)
+    {
+        std::swap(best[0], best[1]);
+        std::swap(bestP[0], bestP[1]);
+        for (auto &index : bestIndices)
+            index = uint8_t(15 - index);
+    }
+
+    BitWriter writer;
+    writer.Write(1 << 6, 7);
+    for (int ch = 0; ch < 4; ch++)
+    {
+        writer.Write(best[0][ch], 7);
+        writer.Write(best[1][ch], 7);
+    }
+    writer.Write(bestP[0], 1);
+    writer.Write(bestP[1], 1);
+    for (int p = 0; p < 16; p++)
+        writer.Write(bestIndices[p], p == 0 ? 3 : 4);
+
+    result.error = bestError;
+    std::memcpy(result.block, writer.bits, 16);
+}
+
+// mode 1: 두 영역, RGB 6비트 + 영역마다 공유 p비트, 3비트 인덱스 (알파 없음)
+// 7비트 값 (q << 1 | p)을 8비트로 늘릴 때 (v << 1 | v >> 6)
+inline int Bc7Expand7(int v) { return v << 1 | v >> 6; }
+
+void EncodeBC7Mode1(const Block &block, Bc7Result &result)
+{
+    float weights[8];
+    for (int i = 0; i < 8; i++)
+        weights[i] = float(bc7Weights3[i]) / 64.0f;
+
+    // 1. 영역마다 직선으로 맞출 때의 오차를 추정해서 후보 분할 고르기
+    std::pair<float, int> estimates[64];
+    for (int partition = 0; partition < 64; partition++)
+    {
+        const uint16_t mask1 = bc7Partitions2[partition];
+        float mean[4], axis[4];
+        const float error = PrincipalAxis(block, uint16_t(~mask1), 3, mean, axis) +
+                            PrincipalAxis(block, mask1, 3, mean, axis);
+        estimates[partition] = {error, partition};
+    }
+    std::partial_sort(estimates, estimates + bc7PartitionCandidates,
+                      estimates + 64);
+
+    for (int candidate = 0; candidate < bc7PartitionCandidates; candidate++)
+    {
+        const int partition = estimates[candidate].second;
+        const uint16_t masks[2] = {uint16_t(~bc7Partitions2[partition]),
+                                   bc7Partitions2[partition]};
+
+        int q[2][2][3] = {}; // [영역][끝점][채널]
+        int pbits[2] = {};
+        uint8_t indices[16] = {};
+        float totalError = 0.0f;
+
+        for (int subset = 0; subset < 2; subset++)
+        {
+            float mean[4], axis[4], e0[4], e1[4];
+            PrincipalAxis(block, masks[subset], 3, mean, axis);
+            AxisEndpoints(block, masks[subset], 3, mean, axis, e0, e1);
+
+            float bestError = FLT_MAX;
+            for (int iteration = 0; iteration < 2; iteration++)
+            {
+                bool improved = false;
+                for (int p = 0; p < 2; p++)
+                {
+                    int sq[2][3];
+                    Palette palette;
+                    palette.size = 8;
+                    for (int ch = 0; ch < 3; ch++)
+                    {
+                        sq[0][ch] = Clamp(Round((e0[ch] * 127.0f / 255.0f - p) * 0.5f), 0, 63);
+                        sq[1][ch] = Clamp(Round((e1[ch] * 127.0f / 255.0f - p) * 0.5f), 0, 63);
+                        const int a = Bc7Expand7(sq[0][ch] << 1 | p);
+                        const int b = Bc7Expand7(sq[1][ch] << 1 | p);
+                        for (int i = 0; i < 8; i++)
+                            palette.c[i][ch] = float(Bc7Interpolate(a, b, bc7Weights3[i]));
+                    }
+                    for (int i = 0; i < 8; i++)
+                        palette.c[i][3] = 255.0f;
+
+                    uint8_t subsetIndices[16];
+                    float errors[16];
+                    FitIndices(block, palette, 0, 3, subsetIndices, errors);
+                    float error = 0.0f;
+                    for (int i = 0; i < 16; i++)
+                    {
+                        if (masks[subset] >> i & 1)
+                            error += errors[i];
+                    }
+
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        std::memcpy(q[subset], sq, sizeof(sq));
+                        pbits[subset] = p;
+                        for (int i = 0; i < 16; i++)
+                        {
+                            if (masks[subset] >> i & 1)
+                                indices[i] = subsetIndices[i];
+                        }
+                        improved = true;
+                    }
+                }
+
+                if (!improved ||
+                    !LeastSquaresEndpoints(block, masks[subset], 0, 3, indices,
+                                           weights, e0, e1))
+                    break;
+            }
+            totalError += bestError;
+        }
+
+        if (totalError >= result.error)
+            continue;
+
+        // anchor 픽셀의 인덱스 최상위 비트가 0이 되도록
+        const int anchors[2] = {0, bc7Anchors2[partition]};
+        for (int subset = 0; subset < 2; subset++)
+        {
+            if (indices[anchors[subset]] < 4)
+                continue;
+            std::swap(q[subset][0], q[subset][1]);
+            for (int i = 0; i < 16; i++)
+            {
+                if (masks[subset] >> i & 1)
+                    indices[i] = uint8_t(7 - indices[i]);
+            }
+        }
+
+        BitWriter writer;
+        writer.Write(1 << 1, 2);
+        writer.Write(partition, 6);
+        for (int ch = 0; ch < 3; ch++)
+        {
+            for (int subset = 0; subset < 2; subset++)
+            {
+                writer.Write(q[subset][0][ch], 6);
+                writer.Write(q[subset][1][ch], 6);
+            }
+        }
+        writer.Write(pbits[0], 1);
+        writer.Write(pbits[1], 1);
+        for (int i = 0; i < 16; i++)
+            writer.Write(indices[i], i == anchors[0] || i == anchors[1] ? 2 : 3);
+
+        result.error = totalError;
+        std::memcpy(result.block, writer.bits, 16);
+    }
+}
+
+void EncodeBC7(const Block &block, BC7Quality quality, uint8_t out[16])
+{
+    Bc7Result result;
+    EncodeBC7Mode6(block, quality, result);
+
+    if (quality == BC7Quality::High && result.error > 0.0f)
+    {
+        bool opaque = true;
+        for (int p = 0; p < 16; p++)
+            opaque = opaque && block.c[3][p] == 255.0f;
+        if (opaque)
+            EncodeBC7Mode1(block, result);
+    }
+
+    std::memcpy(out, result.block, 16);
+}
+
+void DecodeBC7(const uint8_t block[16], uint8_t decoded[16][4])
+{
+    BitReader reader(block);
+    int mode = 0;
+    while (mode < 8 && reader.Read(1) == 0)
+        mode++;
+
+    if (mode == 6)
+    {
+        int e[2][4];
+        for (int ch = 0; ch < 4; ch++)
+        {
+            e[0][ch] = int(reader.Read(7)) << 1;
+            e[1][ch] = int(reader.Read(7)) << 1;
+        }
+        const int p0 = reader.Read(1), p1 = reader.Read(1);
+        for (int ch = 0; ch < 4; ch++)
+        {
+            e[0][ch] |= p0;
+            e[1][ch] |= p1;
+        }
+        for (int p = 0; p < 16; p++)
+        {
+            const int index = reader.Read(p == 0 ? 3 : 4);
+            for (int ch = 0; ch < 4; ch++)
+            {
+                decoded[p][ch] = uint8_t(
+                    Bc7Interpolate(e[0][ch], e[1][ch], bc7Weights4[index]));
+            }
+        }
+    }
+    else if (mode == 1)
+    {
+        const int partition = reader.Read(6);
+        int e[2][2][3];
+        for (int ch = 0; ch < 3; ch++)
+        {
+            for (int subset = 0; subset < 2; subset++)
+            {
+                e[subset][0][ch] = int(reader.Read(6)) << 1;
+                e[subset][1][ch] = int(reader.Read(6)) << 1;
+            }
+        }
+        for (int subset = 0; subset < 2; subset++)
+        {
+            const int p = reader.Read(1);
+            for (int ch = 0; ch < 3; ch++)
+            {
+                e[subset][0][ch] = Bc7Expand7(e[subset][0][ch] | p);
+                e[subset][1][ch] = Bc7Expand7(e[subset][1][ch] | p);
+            }
+        }
+        const int anchor2 = bc7Anchors2[partition];
+        for (int p = 0; p < 16; p++)
+        {
+            const int subset = bc7Partitions2[partition] >> p & 1;
+            const int index = reader.Read(p == 0 || p == anchor2 ? 2 : 3);
+            for (int ch = 0; ch < 3; ch++)
+            {
+                decoded[p][ch] = uint8_t(Bc7Interpolate(
+                    e[subset][0][ch], e[subset][1][ch], bc7Weights3[index]));
+            }
+            decoded[p][3] = 255;
+        }
+    }
+    else
+    {
+        // 이 인코더가 쓰지 않는 mode
+        for (int p = 0; p < 16; p++)
+        {
+            decoded[p][0] = decoded[p][2] = decoded[p][3] = 255;
+            decoded[p][1] = 0;
+        }
+    }
+}
+
+// ---------------------------------------------------------------- BC6H
+
+// 부호 없는 half의 비트 값 (0 ~ 0x7BFF, 음수는 0, 너무 크면 최댓값)
+// BC6H는 이 비트 값을 정수처럼 보간하므로 (대략 로그 공간) 오차도 이 값으로 계산
+uint16_t FloatToHalfBits(float f)
+{
+    if (!(f > 0.0f))
+        return 0; // 음수, 0, NaN
+    if (f >= 65504.0f)
+        return 0x7BFF;
+
+    uint32_t bits;
+    std::memcpy(&bits, &f, 4);
+    if (bits < 0x38800000) // half의 비정규 수
+    {
+        if (bits < 0x33000000)
+            return 0;
+        const uint32_t e = bits >> 23;
+        const uint32_t m = (bits & 0x7FFFFF) | 0x800000;
+        const uint32_t shift = 126 - e;
+        return uint16_t((m + (1u << (shift - 1))) >> shift);
+    }
+    bits += 0xFFF + (bits >> 13 & 1); // 가장 가까운 짝수로 반올림
+    return uint16_t(std::min<uint32_t>((bits - 0x38000000) >> 13, 0x7BFF));
+}
+
+float HalfBitsToFloat(uint16_t h)
+{
+    const uint32_t e = h >> 10 & 31, m = h & 1023;
+    if (e == 0)
+        return std::ldexp(float(m), -24);
+    const uint32_t bits = uint32_t(h & 0x8000) << 16 |
+                          (e == 31 ? 255u : e + 112) << 23 | m << 13;
+    float f;
+    std::memcpy(&f, &bits, 4);
+    return f;
+}
+
+// 부호 없는 BC6H 끝점 복원 (bits비트 -> 16비트), 보간 후 (x * 31) >> 6이 half 비트
+inline int Bc6Unquantize(int comp, int bits)
+{
+    if (comp == 0)
+        return 0;
+    if (comp == (1 << bits) - 1)
+        return 0xFFFF;
+    return ((comp << 16) + 0x8000) >> bits;
+}
+
+inline int Bc6Finish(int x) { return (x * 31) >> 6; }
+
+// half 비트 값에 가장 가까운 bits비트 끝점
+int Bc6Quantize(float value, int bits)
+{
+    const int maxComp = (1 << bits) - 1;
+    const int comp = Clamp(int(value * 64.0f / 31.0f * float(1 << bits) / 65536.0f),
+                           0, maxComp);
+    if (comp < maxComp &&
+        std::fabs(Bc6Finish(Bc6Unquantize(comp + 1, bits)) - value) <
+            std::fabs(Bc6Finish(Bc6Unquantize(comp, bits)) - value))
+        return comp + 1;
+    return comp;
+}
+
+// 한 영역 mode만 사용
+// mode 11: 끝점 10비트 그대로, mode 12: 11비트 + 두 번째 끝점은 9비트 차이
+struct Bc6Mode
+{
+    uint32_t modeBits; // 5비트
+    int endpointBits;
+    int deltaBits; // 0이면 차이로 저장하지 않음
+};
+const Bc6Mode bc6Modes[2] = {{0x03, 10, 0}, {0x07, 11, 9}};
+
+struct Bc6Result
+{
+    float error = FLT_MAX;
+    int mode = 0;
+    int q[2][3] = {};
+    uint8_t indices[16] = {};
+};
+
+// 양자화한 끝점의 팔레트
+void Bc6Palette(const int q[2][3], int bits, Palette &palette)
+{
+    palette.size = 16;
+    for (int ch = 0; ch < 3; ch++)
+    {
+        const int a = Bc6Unquantize(q[0][ch], bits);
+        const int b = Bc6Unquantize(q[1][ch], bits);
+        for (int i = 0; i < 16; i++)
+            palette.c[i][ch] = float(Bc6Finish(Bc7Interpolate(a, b, bc7Weights4[i])));
+    }
+}
+
+void EncodeBC6HMode(const Block &block, int modeIndex, const float start0[4],
+                    const float start1[4], Bc6Result &result)
+{
+    const Bc6Mode &mode = bc6Modes[modeIndex];
+    float weights[16];
+    for (int i = 0; i < 16; i++)
+        weights[i] = float(bc7Weights4[i]) / 64.0f;
+
+    float e0[4], e1[4];
+    std::memcpy(e0, start0, sizeof(e0));
+    std::memcpy(e1, start1, sizeof(e1));
+
+    for (int iteration = 0; iteration < 3; iteration++)
+    {
+        int q[2][3];
+        for (int ch = 0; ch < 3; ch++)
+        {
+            q[0][ch] = Bc6Quantize(e0[ch], mode.endpointBits);
+            q[1][ch] = Bc6Quantize(e1[ch], mode.endpointBits);
+        }
+
+        Palette palette;
+        Bc6Palette(q, mode.endpointBits, palette);
+        uint8_t indices[16];
+        const float error = FitIndices(block, palette, 0, 3, indices);
+
+        // anchor(픽셀 0)의 인덱스 최상위 비트는 0이어야 함
+        if (indices[0] >= 8)
+        {
+            std::swap(q[0], q[1]);
+            for (auto &index : indices)
+                index = uint8_t(15 - index);
+        }
+
+        // 차이로 저장하는 mode는 범위를 넘으면 쓸 수 없음
+        bool valid = true;
+        for (int ch = 0; mode.deltaBits > 0 && ch < 3; ch++)
+        {
+            const int delta = q[1][ch] - q[0][ch];
+            valid = valid && delta >= -(1 << (mode.deltaBits - 1)) &&
+                    delta < (1 << (mode.deltaBits - 1));
+        }
+
+        if (valid && error < result.error)
+        {
+            result.error = error;
+            result.mode = modeIndex;
+            std::memcpy(result.q, q, sizeof(q));
+            std::memcpy(result.indices, indices, 16);
+        }
+
+        if (!LeastSquaresEndpoints(block, 0xFFFF, 0, 3, indices, weights, e0,
+                                   e1, float(0x7BFF)))
+            break;
+    }
+}
+
+void EncodeBC6H(const Block &block, uint8_t out[16])
+{
+    float mean[4], axis[4], e0[4], e1[4];
+    PrincipalAxis(block, 0xFFFF, 3, mean, axis);
+    AxisEndpoints(block, 0xFFFF, 3, mean, axis, e0, e1, float(0x7BFF));
+
+    Bc6Result result;
+    for (int modeIndex = 0; modeIndex < 2; modeIndex++)
+        EncodeBC6HMode(block, modeIndex, e0, e1, result);
+
+    const Bc6Mode &mode = bc6Modes[result.mode];
+    BitWriter writer;
+    writer.Write(mode.modeBits, 5);
+    if (mode.deltaBits == 0)
+    {
+        for (int e = 0; e < 2; e++)
+            for (int ch = 0; ch < 3; ch++)
+                writer.Write(result.q[e][ch], 10);
+    }
+    else
+    {
+        // rw[9:0] gw[9:0] bw[9:0] rx[8:0] rw[10] gx[8:0] gw[10] bx[8:0] bw[10]
+        for (int ch = 0; ch < 3; ch++)
+            writer.Write(result.q[0][ch], 10);
+        for (int ch = 0; ch < 3; ch++)
+        {
+            writer.Write(uint32_t(result.q[1][ch] - result.q[0][ch]), 9);
+            writer.Write(result.q[0][ch] >> 10, 1);
+        }
+    }
+    for (int p = 0; p < 16; p++)
+        writer.Write(result.indices[p], p == 0 ? 3 : 4);
+
+    std::memcpy(out, writer.bits, 16);
+}
+
+// 이 인코더가 쓰는 mode 11, 12만
+void DecodeBC6H(const uint8_t block[16], float decoded[16][4])
+{
+    BitReader reader(block);
+    const uint32_t modeBits = reader.Read(5);
+
+    int q[2][3];
+    int bits;
+    if (modeBits == bc6Modes[0].modeBits)
+    {
+        bits = 10;
+        for (int e = 0; e < 2; e++)
+            for (int ch = 0; ch < 3; ch++)
+                q[e][ch] = int(reader.Read(10));
+    }
+    else if (modeBits == bc6Modes[1].modeBits)
+    {
+        bits = 11;
+        for (int ch = 0; ch < 3; ch++)
+            q[0][ch] = int(reader.Read(10));
+        for (int ch = 0; ch < 3; ch++)
+        {
+            int delta = int(reader.Read(9));
+            delta = delta >= 256 ? delta - 512 : delta;
+            q[0][ch] |= int(reader.Read(1)) << 10;
+            q[1][ch] = (q[0][ch] + delta) & 0x7FF;
+        }
+    }
+    else
+    {
+        for (int p = 0; p < 16; p++)
+            for (int ch = 0; ch < 4; ch++)
+                decoded[p][ch] = 0.0f;
+        return;
+    }
+
+    Palette palette;
+    Bc6Palette(q, bits, palette);
+    for (int p = 0; p < 16; p++)
+    {
+        const int index = reader.Read(p == 0 ? 3 : 4);
+        for (int ch = 0; ch < 3; ch++)
+            decoded[p][ch] = HalfBitsToFloat(uint16_t(palette.c[index][ch]));
+        decoded[p][3] = 1.0f;
+    }
+}
+
+} // namespace
+
+uint32_t BlockCompressor::GetDxgiFormat(BlockFormat format)
+{
+    switch (format)
+    {
+    case BlockFormat::BC1:
+        return DxgiFormat::BC1_Unorm;
+    case BlockFormat::BC3:
+        return DxgiFormat::BC3_Unorm;
+    case BlockFormat::BC5:
+        return DxgiFormat::BC5_Unorm;
+    default:
+        return DxgiFormat::BC7_Unorm;
+    }
+}
+
+const char *BlockCompressor::GetName(BlockFormat format)
+{
+    switch (format)
+    {
+    case BlockFormat::BC1:
+        return "bc1";
+    case BlockFormat::BC3:
+        return "bc3";
+    case BlockFormat::BC5:
+        return "bc5";
+    default:
+        return "bc7";
+    }
+}
+
+size_t BlockCompressor::GetCompressedSize(BlockFormat format, int width,
+                                          int height)
+{
+    return DdsFile::GetLevelSize(GetDxgiFormat(format), width, height);
+}
+
+void BlockCompressor::Compress(const uint8_t *rgba, int width, int height,
+                               BlockFormat format, BC7Quality quality,
+                               uint8_t *out)
+{
+    const size_t blockSize = DdsFile::GetBlockSize(GetDxgiFormat(format));
+    const int blocksX = std::max((width + 3) / 4, 1);
+    const int blocksY = std::max((height + 3) / 4, 1);
+
+    ThreadPool::Get().ParallelFor(size_t(blocksY), [&](size_t by) {
+        Block block;
+        for (int bx = 0; bx < blocksX; bx++)
+        {
+            LoadBlock(rgba, width, height, bx, int(by), block);
+            uint8_t *dst = out + (by * blocksX + bx) * blockSize;
+            switch (format)
+            {
+            case BlockFormat::BC1:
+                EncodeBC1(block, true, dst);
+                break;
+            case BlockFormat::BC3:
+                EncodeBC4(block, 3, dst);
+                EncodeBC1(block, true, dst + 8);
+                break;
+            case BlockFormat::BC5:
+                EncodeBC4(block, 0, dst);
+                EncodeBC4(block, 1, dst + 8);
+                break;
+            case BlockFormat::BC7:
+                EncodeBC7(block, quality, dst);
+                break;
+            }
+        }
+    });
+}
+
+void BlockCompressor::Decompress(const uint8_t *blocks, int width, int height,
+                                 BlockFormat format, uint8_t *rgba)
+{
+    const size_t blockSize = DdsFile::GetBlockSize(GetDxgiFormat(format));
+    const int blocksX = std::max((width + 3) / 4, 1);
+    const int blocksY = std::max((height + 3) / 4, 1);
+
+    ThreadPool::Get().ParallelFor(size_t(blocksY), [&](size_t by) {
+        uint8_t decoded[16][4];
+        for (int bx = 0; bx < blocksX; bx++)
+        {
+            const uint8_t *src = blocks + (by * blocksX + bx) * blockSize;
+            switch (format)
+            {
+            case BlockFormat::BC1:
+                DecodeBC1(src, decoded);
+                break;
+            case BlockFormat::BC3:
+                DecodeBC1(src + 8, decoded);
+                DecodeBC4(src, 3, decoded);
+                break;
+            case BlockFormat::BC5:
+                DecodeBC4(src, 0, decoded);
+                DecodeBC4(src + 8, 1, decoded);
+                for (int p = 0; p < 16; p++)
+                {
+                    decoded[p][2] = 0;
+                    decoded[p][3] = 255;
+                }
+                break;
+            case BlockFormat::BC7:
+                DecodeBC7(src, decoded);
+                break;
+            }
+            StoreBlock(decoded, width, height, bx, int(by), rgba);
+        }
+    });
+}
+
+double BlockCompressor::ComputePsnr(const uint8_t *rgba, const uint8_t *blocks,
+                                    int width, int height, BlockFormat format)
+{
+    std::vector<uint8_t> decoded(size_t(width) * height * 4);
+    Decompress(blocks, width, height, format, decoded.data());
+
+    const int numChannels = format == BlockFormat::BC1   ? 3
+                            : format == BlockFormat::BC5 ? 2
+                                                         : 4;
+    double sum = 0.0;
+    for (size_t i = 0; i < size_t(width) * height; i++)
+    {
+        for (int ch = 0; ch < numChannels; ch++)
+        {
+            const double d = double(rgba[i * 4 + ch]) - decoded[i * 4 + ch];
+            sum += d * d;
+        }
+    }
+    const double mse = sum / (double(width) * height * numChannels);
+    return mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : 99.0;
+}
+
+void BlockCompressor::CompressBC6H(const float *rgba, int width, int height,
+                                   uint8_t *out)
+{
+    const int blocksX = std::max((width + 3) / 4, 1);
+    const int blocksY = std::max((height + 3) / 4, 1);
+
+    ThreadPool::Get().ParallelFor(size_t(blocksY), [&](size_t by) {
+        Block block;
+        for (int bx = 0; bx < blocksX; bx++)
+        {
+            for (int y = 0; y < 4; y++)
+            {
+                const int sy = std::min(int(by) * 4 + y, height - 1);
+                for (int x = 0; x < 4; x++)
+                {
+                    const int sx = std::min(bx * 4 + x, width - 1);
+                    const float *p = rgba + (size_t(sy) * width + sx) * 4;
+                    for (int ch = 0; ch < 3; ch++)
+                        block.c[ch][y * 4 + x] = float(FloatToHalfBits(p[ch]));
+                    block.c[3][y * 4 + x] = 0.0f;
+                }
+            }
+            EncodeBC6H(block, out + (by * blocksX + bx) * 16);
+        }
+    });
+}
+
+void BlockCompressor::DecompressBC6H(const uint8_t *blocks, int width,
+                                     int height, float *rgba)
+{
+    const int blocksX = std::max((width + 3) / 4, 1);
+    const int blocksY = std::max((height + 3) / 4, 1);
+
+    ThreadPool::Get().ParallelFor(size_t(blocksY), [&](size_t by) {
+        float decoded[16][4];
+        for (int bx = 0; bx < blocksX; bx++)
+        {
+            DecodeBC6H(blocks + (by * blocksX + bx) * 16, decoded);
+            for (int y = 0; y < 4 && int(by) * 4 + y < height; y++)
+            {
+                for (int x = 0; x < 4 && bx * 4 + x < width; x++)
+                {
+                    std::memcpy(rgba + (size_t(by * 4 + y) * width + bx * 4 + x) * 4,
+                                decoded[y * 4 + x], sizeof(float) * 4);
+                }
+            }
+        }
+    });
+}
+
+void BlockCompressor::AccumulateHdrError(const float *rgba,
+                                         const uint8_t *blocks, int width,
+                                         int height, HdrError &error)
+{
+    std::vector<float> decoded(size_t(width) * height * 4);
+    DecompressBC6H(blocks, width, height, decoded.data());
+
+    // 아주 어두운 값의 상대 오차가 커지지 않도록 작은 값을 더해서 비교
+    const double epsilon = 1e-3;
+    for (size_t i = 0; i < size_t(width) * height; i++)
+    {
+        for (int ch = 0; ch < 3; ch++)
+        {
+            const double reference = std::max(double(rgba[i * 4 + ch]), 0.0);
+            const double value = decoded[i * 4 + ch];
+            const double stops =
+                std::fabs(std::log2((value + epsilon) / (reference + epsilon)));
+            error.sumSquared += (value - reference) * (value - reference);
+            error.sumStops += stops;
+            error.maxStops = std::max(error.maxStops, stops);
+            error.count++;
+        }
+    }
+}
+
+float BlockCompressor::HalfToFloat(uint16_t half) { return HalfBitsToFloat(half); }
+
+uint16_t BlockCompressor::FloatToHalf(float f) { return FloatToHalfBits(f); }
+
+} // namespace FEFE
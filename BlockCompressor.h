@@ -0,0 +1,79 @@
+﻿#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace FEFE
+{
+
+enum class BlockFormat
+{
+    BC1, // RGB, 4 bpp (알파 없음)
+    BC3, // RGB + BC4 알파, 8 bpp
+    BC5, // RG 두 채널 (탄젠트 공간 노멀맵의 xy), 8 bpp
+    BC7, // RGBA, 8 bpp, BC1/BC3보다 품질이 좋지만 압축이 느림
+};
+
+enum class BC7Quality
+{
+    Fast,   // mode 6, 범위 상자로 끝점
+    Normal, // mode 6, 주성분 + 최소제곱 보정
+    High,   // Normal + mode 1 (두 영역, 64개 분할 중 좋은 것) 비교
+};
+
+// BC6H 압축 결과와 float 원본의 차이 (여러 이미지를 누적할 수 있음)
+struct HdrError
+{
+    double sumSquared = 0.0; // 선형 값 차이의 제곱합
+    double sumStops = 0.0;   // |log2(압축 / 원본)|의 합 (노출 단계)
+    double maxStops = 0.0;
+    size_t count = 0; // 비교한 채널 수 (RGB)
+
+    double GetRmse() const { return count ? std::sqrt(sumSquared / count) : 0.0; }
+    double GetMeanStops() const { return count ? sumStops / count : 0.0; }
+};
+
+// RGBA 8비트 이미지를 BC 블록으로 압축하는 클래스
+// 블록 줄 단위로 ThreadPool에서 병렬, 블록 안의 16픽셀을 SoA로 두고
+// 팔레트에서 가장 가까운 색 찾기를 4픽셀씩 SSE로 계산
+class BlockCompressor
+{
+  public:
+    // DxgiFormat 값 (DdsFile.h)
+    static uint32_t GetDxgiFormat(BlockFormat format);
+
+    // 캐시 파일 이름에 쓰는 짧은 이름 ("bc1", ...)
+    static const char *GetName(BlockFormat format);
+
+    // width x height를 압축한 크기 (가장자리 블록은 끝 픽셀 반복)
+    static size_t GetCompressedSize(BlockFormat format, int width, int height);
+
+    // out에는 GetCompressedSize() 바이트를 씀
+    static void Compress(const uint8_t *rgba, int width, int height,
+                         BlockFormat format, BC7Quality quality, uint8_t *out);
+
+    // 압축한 블록을 다시 RGBA로 풀기 (오차 확인용, 이 클래스가 쓰는 BC7 mode만)
+    static void Decompress(const uint8_t *blocks, int width, int height,
+                           BlockFormat format, uint8_t *rgba);
+
+    // 원본과 압축 결과의 PSNR (dB), BC5는 RG만 비교
+    static double ComputePsnr(const uint8_t *rgba, const uint8_t *blocks,
+                              int width, int height, BlockFormat format);
+
+    // float RGBA (알파 무시) -> BC6H_UF16, 음수는 0
+    // 한 영역 mode 11 (10비트 끝점)과 mode 12 (11비트 + 차이) 중 오차가 작은 것
+    // 크기는 DdsFile::GetLevelSize(DxgiFormat::BC6H_UF16, ...)
+    static void CompressBC6H(const float *rgba, int width, int height,
+                             uint8_t *out);
+    static void DecompressBC6H(const uint8_t *blocks, int width, int height,
+                               float *rgba);
+    static void AccumulateHdrError(const float *rgba, const uint8_t *blocks,
+                                   int width, int height, HdrError &error);
+
+    static float HalfToFloat(uint16_t half);
+    // 부호 없는 half (음수는 0, 너무 크면 최댓값), float 큐브맵 쓰기에 사용
+    static uint16_t FloatToHalf(float f);
+};
+
+} // namespace FEFE
@@ -0,0 +1,286 @@
+﻿#include "BrdfLut.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+#include "BlockCompressor.h"
+#include "DdsFile.h"
+#include "ThreadPool.h"
+
+// VertexKernels.cpp와 같은 기준 (x64는 항상 SSE2)
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FEFE_BRDF_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace FEFE
+{
+
+namespace
+{
+
+// 파일 형식이나 적분 방법이 바뀌면 올려서 예전 파일을 다시 만듦
+// 옵션은 버전에 함께 넣음 (크기, 샘플 수가 다르면 다시 만듦)
+const uint32_t brdfLutVersion = 1;
+
+const float pi = 3.14159265358979f;
+
+uint32_t MakeWriterVersion(const BrdfLutOptions &options)
+{
+    return brdfLutVersion | uint32_t(std::min(options.sampleCount, 0xFFFF)) << 8;
+}
+
+float RadicalInverse(uint32_t bits)
+{
+    bits = (bits << 16u) | (bits >> 16u);
+    bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+    bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+    bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+    bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+    return float(bits) * 2.3283064365386963e-10f;
+}
+
+// 한 줄 (같은 거칠기)이 같이 쓰는 하프 벡터 H (접평면 좌표계, N = z)
+// SIMD로 4개씩 읽도록 성분별 배열, 4의 배수로 채우고 남는 자리는 z = 0 (NdotL <= 0이라 무시됨)
+struct HalfVectors
+{
+    std::vector<float> x, z; // V가 xz 평면에 있어서 y는 필요 없음
+    float k = 0.0f;          // Smith G의 k = alpha / 2 (IBL)
+};
+
+HalfVectors CreateHalfVectors(float roughness, int sampleCount)
+{
+    const float alpha = roughness * roughness;
+    const float alpha2 = alpha * alpha;
+
+    HalfVectors h;
+    const size_t padded = (size_t(sampleCount) + 3) & ~size_t(3);
+    h.x.assign(padded, 0.0f);
+    h.z.assign(padded, 0.0f);
+    h.k = alpha * 0.5f;
+    for (int i = 0; i < sampleCount; i++)
+    {
+        const float phi = 2.0f * pi * float(i) / float(sampleCount);
+        const float xi = RadicalInverse(uint32_t(i));
+        const float cosTheta =
+            std::sqrt((1.0f - xi) / (1.0f + (alpha2 - 1.0f) * xi));
+        const float sinTheta = std::sqrt(1.0f - cosTheta * cosTheta);
+        h.x[size_t(i)] = sinTheta * std::cos(phi);
+        h.z[size_t(i)] = cosTheta;
+    }
+    return h;
+}
+
+// V = (sin, 0, NdotV)에서 샘플마다
+//   L = 2 (V.H) H - V, G_vis = G * VdotH / (NdotH * NdotV), Fc = (1 - VdotH)^5
+//   scale += (1 - Fc) G_vis, bias += Fc G_vis
+void IntegrateScalar(const HalfVectors &h, float nDotV, int sampleCount,
+                     float &scale, float &bias)
+{
+    const float vx = std::sqrt(1.0f - nDotV * nDotV);
+    const float gv = nDotV / (nDotV * (1.0f - h.k) + h.k);
+
+    float a = 0.0f, b = 0.0f;
+    for (size_t i = 0; i < h.x.size(); i++)
+    {
+        const float vDotH = vx * h.x[i] + nDotV * h.z[i];
+        const float nDotL = 2.0f * vDotH * h.z[i] - nDotV;
+        if (nDotL <= 0.0f || vDotH <= 0.0f)
+            continue;
+
+        const float gl = nDotL / (nDotL * (1.0f - h.k) + h.k);
+        const float gVis = gv * gl * vDotH / (h.z[i] * nDotV);
+        const float f = 1.0f - vDotH;
+        const float fc = (f * f) * (f * f) * f;
+        a += (1.0f - fc) * gVis;
+        b += fc * gVis;
+    }
+    scale = a / float(sampleCount);
+    bias = b / float(sampleCount);
+}
+
+#ifdef FEFE_BRDF_SSE2
+
+inline float HorizontalSum(__m128 v)
+{
+    const __m128 pairs = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+}
+
+void IntegrateSse2(const HalfVectors &h, float nDotV, int sampleCount,
+                   float &scale, float &bias)
+{
+    const float vx = std::sqrt(1.0f - nDotV * nDotV);
+    const float gv = nDotV / (nDotV * (1.0f - h.k) + h.k);
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 vvx = _mm_set1_ps(vx);
+    const __m128 vnDotV = _mm_set1_ps(nDotV);
+    const __m128 k = _mm_set1_ps(h.k);
+    const __m128 oneMinusK = _mm_set1_ps(1.0f - h.k);
+    const __m128 gvOverNdotV = _mm_set1_ps(gv / nDotV);
+
+    __m128 a = zero, b = zero;
+    for (size_t i = 0; i < h.x.size(); i += 4)
+    {
+        const __m128 hx = _mm_loadu_ps(h.x.data() + i);
+        const __m128 hz = _mm_loadu_ps(h.z.data() + i);
+
+        const __m128 vDotH =
+            _mm_add_ps(_mm_mul_ps(vvx, hx), _mm_mul_ps(vnDotV, hz));
+        const __m128 nDotL =
+            _mm_sub_ps(_mm_mul_ps(_mm_mul_ps(two, vDotH), hz), vnDotV);
+        // 뒤쪽 샘플 (채운 자리 포함)은 0으로
+        const __m128 valid = _mm_and_ps(_mm_cmpgt_ps(nDotL, zero),
+                                        _mm_cmpgt_ps(vDotH, zero));
+
+        const __m128 gl = _mm_div_ps(
+            nDotL, _mm_add_ps(_mm_mul_ps(nDotL, oneMinusK), k));
+        // hz는 채운 자리에서 0이라 나누기 전에 1로 바꿈
+        const __m128 safeHz = _mm_or_ps(_mm_and_ps(valid, hz),
+                                        _mm_andnot_ps(valid, one));
+        const __m128 gVis = _mm_and_ps(
+            valid, _mm_div_ps(_mm_mul_ps(_mm_mul_ps(gvOverNdotV, gl), vDotH),
+                              safeHz));
+
+        const __m128 f = _mm_sub_ps(one, vDotH);
+        const __m128 f2 = _mm_mul_ps(f, f);
+        const __m128 fc = _mm_mul_ps(_mm_mul_ps(f2, f2), f);
+        a = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(one, fc), gVis));
+        b = _mm_add_ps(b, _mm_mul_ps(fc, gVis));
+    }
+    scale = HorizontalSum(a) / float(sampleCount);
+    bias = HorizontalSum(b) / float(sampleCount);
+}
+
+#endif
+
+void GenerateImpl(const BrdfLutOptions &options, bool useSimd,
+                  std::vector<float> &scaleBias)
+{
+    const int size = std::max(options.size, 1);
+    const int sampleCount = std::max(options.sampleCount, 1);
+    scaleBias.assign(size_t(size) * size * 2, 0.0f);
+
+    ThreadPool::Get().ParallelFor(size_t(size), [&](size_t y) {
+        const float roughness = (float(y) + 0.5f) / float(size);
+        const HalfVectors h = CreateHalfVectors(roughness, sampleCount);
+
+        float *row = scaleBias.data() + y * size * 2;
+        for (int x = 0; x < size; x++)
+        {
+            const float nDotV = (float(x) + 0.5f) / float(size);
+#ifdef FEFE_BRDF_SSE2
+            if (useSimd)
+            {
+                IntegrateSse2(h, nDotV, sampleCount, row[x * 2], row[x * 2 + 1]);
+                continue;
+            }
+#endif
+            IntegrateScalar(h, nDotV, sampleCount, row[x * 2], row[x * 2 + 1]);
+        }
+    });
+}
+
+} // namespace
+
+void BrdfLut::Generate(const BrdfLutOptions &options,
+                       std::vector<float> &scaleBias)
+{
+    GenerateImpl(options, true, scaleBias);
+}
+
+bool BrdfLut::Write(const std::string &filename, const BrdfLutOptions &options)
+{
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<float> scaleBias;
+    Generate(options, scaleBias);
+    const double ms = std::chrono::duration<double, std::milli>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+
+    std::vector<uint16_t> halfs(scaleBias.size());
+    for (size_t i = 0; i < scaleBias.size(); i++)
+        halfs[i] = BlockCompressor::FloatToHalf(scaleBias[i]);
+
+    DdsDesc desc;
+    desc.format = DxgiFormat::R16G16_Float;
+    desc.width = desc.height = uint32_t(std::max(options.size, 1));
+
+    std::cout << "BrdfLut " << filename << ": " << desc.width << "x"
+              << desc.height << ", " << options.sampleCount << " samples, "
+              << GetInstructionSet() << ", " << ms << " ms" << std::endl;
+
+    return DdsFile::Write(filename, desc,
+                          reinterpret_cast<const uint8_t *>(halfs.data()),
+                          halfs.size() * sizeof(uint16_t),
+                          MakeWriterVersion(options));
+}
+
+bool BrdfLut::Update(const std::string &filename, const BrdfLutOptions &options)
+{
+    DdsDesc desc;
+    if (DdsFile::ReadDesc(filename, desc) &&
+        desc.format == DxgiFormat::R16G16_Float &&
+        desc.width == uint32_t(options.size) &&
+        desc.writerVersion == MakeWriterVersion(options))
+        return true;
+    return Write(filename, options);
+}
+
+bool BrdfLut::CheckConvergence(const BrdfLutOptions &options,
+                               int referenceSampleCount, float tolerance)
+{
+    auto Measure = [](const BrdfLutOptions &o, bool useSimd,
+                      std::vector<float> &result) {
+        const auto start = std::chrono::steady_clock::now();
+        GenerateImpl(o, useSimd, result);
+        return std::chrono::duration<double, std::milli>(
+                   std::chrono::steady_clock::now() - start)
+            .count();
+    };
+
+    std::vector<float> simd, scalar, reference;
+    const double simdMs = Measure(options, true, simd);
+    const double scalarMs = Measure(options, false, scalar);
+    BrdfLutOptions referenceOptions = options;
+    referenceOptions.sampleCount = referenceSampleCount;
+    Measure(referenceOptions, true, reference);
+
+    float maxError = 0.0f, maxSimdError = 0.0f;
+    double sumError = 0.0;
+    for (size_t i = 0; i < simd.size(); i++)
+    {
+        const float error = std::fabs(simd[i] - reference[i]);
+        maxError = std::max(maxError, error);
+        sumError += error;
+        maxSimdError = std::max(maxSimdError, std::fabs(simd[i] - scalar[i]));
+    }
+
+    const bool converged = maxError <= tolerance && maxSimdError <= 1e-4f;
+    std::cout << "BrdfLut " << options.size << "x" << options.size << ", "
+              << options.sampleCount << " samples vs " << referenceSampleCount
+              << ": max error " << maxError << ", mean "
+              << sumError / double(std::max<size_t>(simd.size(), 1))
+              << ", simd vs scalar " << maxSimdError << " ("
+              << GetInstructionSet() << " " << simdMs << " ms, scalar "
+              << scalarMs << " ms) -> " << (converged ? "ok" : "FAILED")
+              << std::endl;
+    return converged;
+}
+
+const char *BrdfLut::GetInstructionSet()
+{
+#ifdef FEFE_BRDF_SSE2
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace FEFE
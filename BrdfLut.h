@@ -0,0 +1,44 @@
+﻿#pragma once
+
+#include <string>
+#include <vector>
+
+namespace FEFE
+{
+
+struct BrdfLutOptions
+{
+    int size = 256;         // 한 변 (x = NdotV, y = 거칠기)
+    int sampleCount = 1024; // 텍셀마다 GGX 중요도 샘플 수
+};
+
+// split-sum 근사의 BRDF 적분 (Karis 2013, "Real Shading in Unreal Engine 4")
+// specular = 프리필터 큐브맵 (CubemapPrefilter) * (F0 * scale + bias)
+// 텍셀 (x, y)는 NdotV = (x + 0.5) / size, 거칠기 = (y + 0.5) / size
+class BrdfLut
+{
+  public:
+    // 줄마다 병렬, 한 텍셀의 샘플은 4개씩 SIMD
+    // scaleBias: size * size * 2 (scale, bias)
+    static void Generate(const BrdfLutOptions &options,
+                         std::vector<float> &scaleBias);
+
+    // R16G16_FLOAT DDS로 저장
+    static bool Write(const std::string &filename,
+                      const BrdfLutOptions &options = BrdfLutOptions());
+
+    // 없거나 옵션 (크기, 샘플 수)이 다르면 새로 만듦
+    static bool Update(const std::string &filename,
+                       const BrdfLutOptions &options = BrdfLutOptions());
+
+    // 샘플을 많이 쓴 기준 결과와 비교해서 최대 오차가 tolerance 이하인지 확인
+    // SIMD와 스칼라 결과가 같은지도 확인 (오차와 시간 출력)
+    // 기본값 1024 샘플의 최대 오차는 거칠기와 NdotV가 작은 구석에서 1e-2 정도
+    static bool CheckConvergence(const BrdfLutOptions &options = BrdfLutOptions(),
+                                 int referenceSampleCount = 65536,
+                                 float tolerance = 1e-2f);
+
+    static const char *GetInstructionSet();
+};
+
+} // namespace FEFE
@@ -0,0 +1,359 @@
+﻿#include "ChannelPacker.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <initializer_list>
+#include <iostream>
+#include <unordered_map>
+
+#include "DdsFile.h"
+#include "Hash.h"
+#include "TextureLoader.h"
+#include "ThreadPool.h"
+
+namespace FEFE
+{
+
+namespace
+{
+
+// 합치는 방법이나 파일 형식이 바뀌면 올려서 예전 파일을 무시
+const uint32_t packerVersion = 1;
+
+// writerVersion의 아래 4비트 = 실제로 읽은 값들 (R, G, B, A 순서)
+// 나머지 비트 = 원본 조합의 해시 (같은 이름의 다른 재질이면 다시 만듦)
+const uint32_t channelMask = 0xF;
+
+std::array<const ScalarTexture *, 4> GetSlots(const MaterialTextures &textures)
+{
+    return {&textures.occlusion, &textures.roughness, &textures.metallic,
+            &textures.height};
+}
+
+std::array<int8_t *, 4> GetChannels(MaterialChannels &channels)
+{
+    return {&channels.occlusion, &channels.roughness, &channels.metallic,
+            &channels.height};
+}
+
+// 원본 파일 경로들과 채널 배치 전체의 해시
+uint64_t HashSources(const MaterialTextures &sources)
+{
+    uint64_t key = HashCombine(0, packerVersion);
+    for (const ScalarTexture *slot : GetSlots(sources))
+    {
+        key = HashBytes(slot->filename.data(), slot->filename.size(), key);
+        key = HashCombine(key, uint64_t(slot->channel));
+    }
+    return key;
+}
+
+uint32_t MakeSourceKey(uint64_t sourceHash)
+{
+    return uint32_t(sourceHash ^ (sourceHash >> 32)) & ~channelMask;
+}
+
+// 16자리 16진수 (결과 파일 이름에 넣음)
+std::string ToHex(uint64_t value)
+{
+    const char digits[] = "0123456789abcdef";
+    std::string text(16, '0');
+    for (int i = 15; i >= 0; i--, value >>= 4)
+        text[size_t(i)] = digits[value & 0xF];
+    return text;
+}
+
+// 결과 파일이 모든 원본보다 새롭고 같은 조합으로 만든 것이면 true
+bool IsUpToDate(const std::string &outputFilename,
+                const std::vector<std::string> &sourceFilenames,
+                uint32_t sourceKey, uint32_t &presentMask)
+{
+    std::error_code error;
+    const auto outputTime =
+        std::filesystem::last_write_time(outputFilename, error);
+    if (error)
+        return false;
+    for (const std::string &filename : sourceFilenames)
+    {
+        const auto sourceTime = std::filesystem::last_write_time(filename, error);
+        if (error || outputTime < sourceTime)
+            return false;
+    }
+
+    DdsDesc desc;
+    if (!DdsFile::ReadDesc(outputFilename, desc) ||
+        (desc.writerVersion & ~channelMask) != sourceKey)
+        return false;
+
+    presentMask = desc.writerVersion & channelMask;
+    return true;
+}
+
+// RGBA 이미지의 한 채널을 (width, height) 크기로 bilinear 샘플링 (텍스춰처럼 wrap)
+void ResampleChannel(const ImageData &image, int channel, int width, int height,
+                     int dstChannel, uint8_t *dst)
+{
+    const uint8_t *src = image.pixels.data();
+    const int w = image.width;
+    const int h = image.height;
+
+    if (w == width && h == height)
+    {
+        ThreadPool::Get().ParallelFor(size_t(height), [&](size_t y) {
+            const size_t row = y * size_t(width) * 4;
+            for (size_t i = row; i < row + size_t(width) * 4; i += 4)
+                dst[i + dstChannel] = src[i + channel];
+        });
+        return;
+    }
+
+    const float scaleX = float(w) / float(width);
+    const float scaleY = float(h) / float(height);
+
+    ThreadPool::Get().ParallelFor(size_t(height), [&](size_t y) {
+        const float v = (float(y) + 0.5f) * scaleY - 0.5f;
+        const float fy = std::floor(v);
+        const float ty = v - fy;
+        const int y0 = (int(fy) % h + h) % h;
+        const int y1 = (y0 + 1) % h;
+
+        for (int x = 0; x < width; x++)
+        {
+            const float u = (float(x) + 0.5f) * scaleX - 0.5f;
+            const float fx = std::floor(u);
+            const float tx = u - fx;
+            const int x0 = (int(fx) % w + w) % w;
+            const int x1 = (x0 + 1) % w;
+
+            auto At = [&](int sx, int sy) {
+                return float(src[(size_t(sy) * w + sx) * 4 + channel]);
+            };
+            const float top = At(x0, y0) + (At(x1, y0) - At(x0, y0)) * tx;
+            const float bottom = At(x0, y1) + (At(x1, y1) - At(x0, y1)) * tx;
+            const float value = top + (bottom - top) * ty;
+
+            dst[(y * size_t(width) + x) * 4 + dstChannel] =
+                uint8_t(std::min(std::max(value + 0.5f, 0.0f), 255.0f));
+        }
+    });
+}
+
+} // namespace
+
+std::string ChannelPacker::Pack(const MaterialTextures &sources,
+                                MaterialChannels &channels)
+{
+    channels = MaterialChannels();
+
+    const auto slots = GetSlots(sources);
+    const auto outChannels = GetChannels(channels);
+
+    // 1. 있는 원본 파일 (glTF는 AO/거칠기/금속성이 한 이미지라서 한 번만)
+    std::vector<std::string> filenames;
+    int slotImage[4] = {-1, -1, -1, -1};
+    for (int i = 0; i < 4; i++)
+    {
+        const std::string &filename = slots[i]->filename;
+        if (filename.empty() || !std::filesystem::exists(filename))
+            continue;
+        auto it = std::find(filenames.begin(), filenames.end(), filename);
+        slotImage[i] = int(it - filenames.begin());
+        if (it == filenames.end())
+            filenames.push_back(filename);
+    }
+    if (filenames.empty())
+        return std::string();
+
+    // 첫 원본을 같이 쓰는 다른 재질과 겹치지 않게 원본 조합의 해시를 이름에 넣음
+    // (PackMeshes가 재질들을 동시에 합치므로 같은 파일을 쓰면 안 됨)
+    const uint64_t sourceHash = HashSources(sources);
+    const std::filesystem::path first(filenames[0]);
+    const std::string outputFilename =
+        (first.parent_path() / first.stem()).string() + "." +
+        ToHex(sourceHash) + ".orm.dds";
+    const uint32_t sourceKey = MakeSourceKey(sourceHash);
+
+    uint32_t presentMask = 0;
+    if (!IsUpToDate(outputFilename, filenames, sourceKey, presentMask))
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        // 2. 디코딩 (실패한 원본은 없는 것으로)
+        std::vector<ImageData> images(filenames.size());
+        std::vector<char> decoded(filenames.size(), 0);
+        ThreadPool::Get().ParallelFor(filenames.size(), [&](size_t i) {
+            decoded[i] = TextureLoader::Decode(filenames[i], images[i]);
+        });
+
+        int width = 0, height = 0;
+        size_t sourceBytes = 0;
+        for (size_t i = 0; i < images.size(); i++)
+        {
+            if (!decoded[i])
+                continue;
+            width = std::max(width, images[i].width);
+            height = std::max(height, images[i].height);
+            sourceBytes += images[i].pixels.size();
+        }
+        if (width == 0)
+            return std::string();
+
+        // 3. 채널마다 가장 큰 크기로 맞춰서 복사, 없는 값은 기본값
+        const uint8_t defaults[4] = {defaultOcclusion, defaultRoughness,
+                                     defaultMetallic, defaultHeight};
+        ImageData packed;
+        packed.filename = outputFilename;
+        packed.width = width;
+        packed.height = height;
+        packed.pixels.resize(size_t(width) * height * 4);
+        for (size_t i = 0; i < packed.pixels.size(); i += 4)
+            std::copy(defaults, defaults + 4, packed.pixels.begin() + i);
+
+        for (int i = 0; i < 4; i++)
+        {
+            if (slotImage[i] < 0 || !decoded[size_t(slotImage[i])])
+                continue;
+            const int channel = std::min(std::max(slots[i]->channel, 0), 3);
+            ResampleChannel(images[size_t(slotImage[i])], channel, width,
+                            height, i, packed.pixels.data());
+            presentMask |= 1u << i;
+        }
+        images.clear();
+
+        // 4. 값 그대로 평균한 mip + BC7 (크기가 4의 배수일 때)
+        MipOptions mipOptions;
+        mipOptions.srgb = false;
+        TextureLoader::GenerateMips(packed, mipOptions);
+        if (width % 4 == 0 && height % 4 == 0)
+            TextureLoader::Compress(packed, BlockFormat::BC7,
+                                    BC7Quality::Normal);
+
+        DdsDesc desc;
+        desc.format = packed.format;
+        desc.width = uint32_t(width);
+        desc.height = uint32_t(height);
+        desc.mipLevels = uint32_t(packed.mipLevels.size());
+        if (!DdsFile::Write(outputFilename, desc, packed.pixels.data(),
+                            packed.pixels.size(), sourceKey | presentMask))
+        {
+            std::cout << "ChannelPacker::Pack() failed: " << outputFilename
+                      << std::endl;
+            return std::string();
+        }
+
+        std::cout << outputFilename << ": " << filenames.size()
+                  << " images -> 1 " << DdsFile::GetFormatName(packed.format)
+                  << " " << width << "x" << height << ", "
+                  << sourceBytes / 1024 << " KB -> "
+                  << packed.pixels.size() / 1024 << " KB (with mips), "
+                  << std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - start)
+                         .count()
+                  << " ms" << std::endl;
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+        if (presentMask & (1u << i))
+            *outChannels[i] = int8_t(i);
+    }
+    return outputFilename;
+}
+
+void ChannelPacker::PackMeshes(std::vector<MeshData> &meshes,
+                               const std::string &name)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    // 원본 조합이 같은 메쉬끼리 묶음
+    std::unordered_map<std::string, size_t> groupOf;
+    std::vector<size_t> meshGroup(meshes.size(), SIZE_MAX);
+    std::vector<const MaterialTextures *> groupSources;
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+        std::string key;
+        for (const ScalarTexture *slot : GetSlots(meshes[i].materialTextures))
+        {
+            if (!slot->filename.empty())
+                key += slot->filename + "#" + std::to_string(slot->channel);
+            key += "|";
+        }
+        if (key == "||||")
+            continue;
+
+        auto it = groupOf.find(key);
+        if (it == groupOf.end())
+        {
+            it = groupOf.emplace(key, groupSources.size()).first;
+            groupSources.push_back(&meshes[i].materialTextures);
+        }
+        meshGroup[i] = it->second;
+    }
+    if (groupSources.empty())
+        return;
+
+    std::vector<std::string> packedFilenames(groupSources.size());
+    std::vector<MaterialChannels> packedChannels(groupSources.size());
+    ThreadPool::Get().ParallelFor(groupSources.size(), [&](size_t g) {
+        packedFilenames[g] = Pack(*groupSources[g], packedChannels[g]);
+    });
+
+    size_t numPacked = 0;
+    for (size_t g = 0; g < groupSources.size(); g++)
+        numPacked += !packedFilenames[g].empty();
+
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+        if (meshGroup[i] == SIZE_MAX)
+            continue;
+        meshes[i].packedTextureFilename = packedFilenames[meshGroup[i]];
+        meshes[i].packedChannels = packedChannels[meshGroup[i]];
+    }
+
+    std::cout << name << ": channel packing " << numPacked << "/"
+              << groupSources.size() << " materials, "
+              << std::chrono::duration<double, std::milli>(
+                     std::chrono::steady_clock::now() - start)
+                     .count()
+              << " ms" << std::endl;
+}
+
+void ChannelPacker::FindBySuffix(const std::string &basePath,
+                                 const std::string &materialName,
+                                 MaterialTextures &textures)
+{
+    if (materialName.empty())
+        return;
+
+    const char *extensions[] = {".png", ".jpg", ".tga"};
+    auto Find = [&](ScalarTexture &slot,
+                    std::initializer_list<const char *> suffixes) {
+        if (!slot.filename.empty())
+            return;
+        for (const char *suffix : suffixes)
+        {
+            for (const char *extension : extensions)
+            {
+                const std::string filename =
+                    basePath + materialName + suffix + extension;
+                if (std::filesystem::exists(filename))
+                {
+                    slot.filename = filename;
+                    slot.channel = 0;
+                    return;
+                }
+            }
+        }
+    };
+
+    Find(textures.occlusion, {"_Mixed_AO", "_AO", "_Occlusion"});
+    Find(textures.roughness, {"_Roughness"});
+    Find(textures.metallic, {"_Metallic", "_Metalness"});
+    Find(textures.height, {"_Height", "_Displacement"});
+}
+
+} // namespace FEFE
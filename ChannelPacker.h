@@ -0,0 +1,44 @@
+﻿#pragma once
+
+#include <string>
+#include <vector>
+
+#include "MeshData.h"
+
+namespace FEFE
+{
+
+// 재질의 스칼라 텍스춰(AO, 거칠기, 금속성, 높이)를 RGBA 텍스춰 하나로 합치는 클래스
+// R = occlusion, G = roughness, B = metallic (glTF ORM과 같은 배치), A = height
+//
+// 크기가 다르면 가장 큰 크기로 bilinear 확대하고, 선형 mip + BC7까지 끝내서
+// 첫 번째 원본 옆 "<이름>.<원본 조합 해시>.orm.dds"에 저장
+// (원본이 바뀌지 않았으면 다시 만들지 않음)
+// 결과 파일은 TextureLoader가 변환 없이 그대로 읽음
+class ChannelPacker
+{
+  public:
+    // 없는 값의 채널에 채우는 기본값 (쉐이더 기본값과 같음)
+    static const uint8_t defaultOcclusion = 255;
+    static const uint8_t defaultRoughness = 255;
+    static const uint8_t defaultMetallic = 0;
+    static const uint8_t defaultHeight = 128;
+
+    // 재질 하나를 합치고 파일 이름을 돌려줌
+    // 원본을 하나도 읽지 못하면 빈 문자열 (channels는 모두 -1)
+    static std::string Pack(const MaterialTextures &sources,
+                            MaterialChannels &channels);
+
+    // 메쉬마다 materialTextures를 합쳐서 packedTextureFilename/packedChannels에 기록
+    // 같은 원본 조합을 쓰는 메쉬들은 한 번만 합침
+    static void PackMeshes(std::vector<MeshData> &meshes,
+                           const std::string &name);
+
+    // 텍스춰 페인팅 툴이 내보내는 이름 규칙으로 비어있는 값 채우기
+    // basePath + materialName + "_Metallic.png" 등 (흑백 이미지, 채널 0)
+    static void FindBySuffix(const std::string &basePath,
+                             const std::string &materialName,
+                             MaterialTextures &textures);
+};
+
+} // namespace FEFE
@@ -135,6 +135,60 @@ struct Material
 //    // warning X4000: use of potentially uninitialized variable
 //}
 
+// SphericalHarmonics::ToIrradiance()  diffuse ťʰ   (E(n) / pi)
+// ڻ ǰ   CPU ̸ 
+float3 IrradianceSH(float4 sh[9], float3 n)
+{
+    float3 result = sh[0].rgb;
+    result += sh[1].rgb * n.y + sh[2].rgb * n.z + sh[3].rgb * n.x;
+    result += sh[4].rgb * (n.x * n.y) + sh[5].rgb * (n.y * n.z);
+    result += sh[6].rgb * (3.0 * n.z * n.z - 1.0) + sh[7].rgb * (n.x * n.z);
+    result += sh[8].rgb * (n.x * n.x - n.y * n.y);
+    return max(result, 0.0); //   ݴ ringing
+}
+
+// 8ü(octahedral) ڵ   ([-1, 1]^2 ->  )
+// C++  ڵ VertexFormat.cpp
+float3 OctahedralDecode(float2 e)
+{
+    float3 n = float3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    float t = saturate(-n.z);
+    n.xy += n.xy >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+//  (ȭ  ص ) -> [-1, 1]^2
+float2 OctahedralEncode(float3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    float2 e = n.xy;
+    if (n.z < 0.0)
+        e = (1.0 - abs(n.yx)) * (n.xy >= 0.0 ? 1.0 : -1.0);
+    return e;
+}
+
+// OctahedralEnvMap  ȸü ȯ,  ѷ OctahedralOptions::border ؼ
+#define OCTAHEDRAL_BORDER 1.0
+
+//  ׵θ    ޶    а  (trilinear  б )
+float3 SampleOctahedral(Texture2D tex, SamplerState s, float3 dir, float lod)
+{
+    uint width, height, levels;
+    tex.GetDimensions(0, width, height, levels);
+    float2 e = OctahedralEncode(dir) * 0.5 + 0.5;
+
+    lod = clamp(lod, 0.0, float(levels - 1));
+    float level0 = floor(lod);
+    float level1 = min(level0 + 1.0, float(levels - 1));
+    float size0 = max(floor(width / exp2(level0)), 1.0);
+    float size1 = max(floor(width / exp2(level1)), 1.0);
+    float2 uv0 = (OCTAHEDRAL_BORDER + e * (size0 - 2.0 * OCTAHEDRAL_BORDER)) / size0;
+    float2 uv1 = (OCTAHEDRAL_BORDER + e * (size1 - 2.0 * OCTAHEDRAL_BORDER)) / size1;
+
+    return lerp(tex.SampleLevel(s, uv0, level0).rgb, tex.SampleLevel(s, uv1, level1).rgb,
+                lod - level0);
+}
+
 struct VertexShaderInput
 {
     float3 posModel : POSITION; // ǥ ġ position
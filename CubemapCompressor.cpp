@@ -0,0 +1,150 @@
+﻿#include "CubemapCompressor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+#include "DdsFile.h"
+
+namespace FEFE
+{
+
+namespace
+{
+
+// 캐시 파일 형식이나 인코더가 바뀌면 올려서 예전 파일을 무시
+const uint32_t cubemapCacheVersion = 1;
+
+bool IsFloatFormat(uint32_t format)
+{
+    return format == DxgiFormat::R16G16B16A16_Float ||
+           format == DxgiFormat::R32G32B32A32_Float;
+}
+
+// 한 레벨을 float RGBA로
+void ToFloatRgba(const uint8_t *src, uint32_t format, size_t numPixels,
+                 std::vector<float> &dst)
+{
+    dst.resize(numPixels * 4);
+    if (format == DxgiFormat::R32G32B32A32_Float)
+    {
+        std::memcpy(dst.data(), src, numPixels * 4 * sizeof(float));
+        return;
+    }
+
+    const uint16_t *halfs = reinterpret_cast<const uint16_t *>(src);
+    for (size_t i = 0; i < numPixels * 4; i++)
+        dst[i] = BlockCompressor::HalfToFloat(halfs[i]);
+}
+
+} // namespace
+
+bool CubemapCompressor::Compress(const std::string &sourceFilename,
+                                 const std::string &outputFilename,
+                                 HdrError &error)
+{
+    DdsDesc desc;
+    std::vector<uint8_t> source;
+    if (!DdsFile::Read(sourceFilename, desc, source))
+    {
+        std::cout << "CubemapCompressor::Compress() failed to read "
+                  << sourceFilename << std::endl;
+        return false;
+    }
+    if (!IsFloatFormat(desc.format) || desc.width % 4 != 0 ||
+        desc.height % 4 != 0)
+    {
+        std::cout << "CubemapCompressor::Compress() unsupported format or size: "
+                  << sourceFilename << std::endl;
+        return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    DdsDesc outputDesc = desc;
+    outputDesc.format = DxgiFormat::BC6H_UF16;
+    std::vector<uint8_t> output(DdsFile::GetDataSize(outputDesc));
+
+    // 면(배열 원소)마다 mip 0, 1, ... 순서
+    // 각 레벨 안에서 블록 줄 단위로 병렬 (작은 mip은 금방 끝남)
+    HdrError total;
+    std::vector<float> pixels;
+    size_t sourceOffset = 0, outputOffset = 0;
+    for (uint32_t face = 0; face < desc.arraySize; face++)
+    {
+        for (uint32_t level = 0; level < desc.mipLevels; level++)
+        {
+            const uint32_t width = std::max(desc.width >> level, 1u);
+            const uint32_t height = std::max(desc.height >> level, 1u);
+
+            ToFloatRgba(source.data() + sourceOffset, desc.format,
+                        size_t(width) * height, pixels);
+            BlockCompressor::CompressBC6H(pixels.data(), int(width),
+                                          int(height),
+                                          output.data() + outputOffset);
+            BlockCompressor::AccumulateHdrError(pixels.data(),
+                                                output.data() + outputOffset,
+                                                int(width), int(height), total);
+
+            sourceOffset += DdsFile::GetLevelSize(desc.format, width, height);
+            outputOffset +=
+                DdsFile::GetLevelSize(outputDesc.format, width, height);
+        }
+    }
+
+    const double ms = std::chrono::duration<double, std::milli>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+
+    std::cout << sourceFilename << " -> bc6h: " << desc.width << "x"
+              << desc.height << " x " << desc.arraySize << " faces, "
+              << desc.mipLevels << " levels, " << source.size() / 1024
+              << " KB -> " << output.size() / 1024 << " KB, rmse "
+              << total.GetRmse() << ", mean " << total.GetMeanStops()
+              << " stops, max " << total.maxStops << " stops, " << ms
+              << " ms" << std::endl;
+
+    error.sumSquared += total.sumSquared;
+    error.sumStops += total.sumStops;
+    error.maxStops = std::max(error.maxStops, total.maxStops);
+    error.count += total.count;
+
+    return DdsFile::Write(outputFilename, outputDesc, output.data(),
+                          output.size(), cubemapCacheVersion);
+}
+
+std::string CubemapCompressor::GetCompressed(const std::string &sourceFilename)
+{
+    const std::filesystem::path sourcePath(sourceFilename);
+    const std::string outputFilename =
+        (sourcePath.parent_path() / sourcePath.stem()).string() + ".bc6h.dds";
+
+    // 원본보다 새롭고 같은 버전으로 만든 파일이면 그대로 사용
+    std::error_code errorCode;
+    const auto sourceTime =
+        std::filesystem::last_write_time(sourceFilename, errorCode);
+    if (errorCode)
+        return sourceFilename;
+    const auto outputTime =
+        std::filesystem::last_write_time(outputFilename, errorCode);
+
+    DdsDesc desc;
+    if (!errorCode && outputTime >= sourceTime &&
+        DdsFile::ReadDesc(outputFilename, desc) &&
+        desc.writerVersion == cubemapCacheVersion &&
+        desc.format == DxgiFormat::BC6H_UF16)
+        return outputFilename;
+
+    // 이미 압축된 원본 (BC6H 등)은 그대로
+    if (!DdsFile::ReadDesc(sourceFilename, desc) || !IsFloatFormat(desc.format))
+        return sourceFilename;
+
+    HdrError error;
+    return Compress(sourceFilename, outputFilename, error) ? outputFilename
+                                                           : sourceFilename;
+}
+
+} // namespace FEFE
@@ -0,0 +1,27 @@
+﻿#pragma once
+
+#include <string>
+
+#include "BlockCompressor.h"
+
+namespace FEFE
+{
+
+// float 큐브맵 DDS (IBL diffuse/specular)를 BC6H_UF16 큐브맵 DDS로 압축
+// 모든 면과 mip 레벨을 압축하고, 결과는 CreateCubemapTexture()로 그대로 읽을 수 있음
+// 2D float DDS (OctahedralEnvMap 결과)도 같은 방법으로 압축
+// (R16G16B16A16 float 대비 1/4, R32G32B32A32 float 대비 1/8 크기)
+class CubemapCompressor
+{
+  public:
+    // 입력: R16G16B16A16_FLOAT 또는 R32G32B32A32_FLOAT, 크기는 4의 배수
+    // 원본과 비교한 오차를 error에 누적하고 출력
+    static bool Compress(const std::string &sourceFilename,
+                         const std::string &outputFilename, HdrError &error);
+
+    // 압축한 파일 (원본 옆 "*.bc6h.dds")의 이름을 돌려줌
+    // 없거나 원본보다 오래됐으면 새로 만들고, 이미 BC 형식이거나 실패하면 원본 그대로
+    static std::string GetCompressed(const std::string &sourceFilename);
+};
+
+} // namespace FEFE
@@ -0,0 +1,305 @@
+﻿#include "CubemapPrefilter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+
+#include "BlockCompressor.h"
+#include "DdsFile.h"
+#include "ThreadPool.h"
+
+namespace FEFE
+{
+
+namespace
+{
+
+// 결과 파일 형식이나 필터가 바뀌면 올려서 예전 파일을 다시 만듦
+const uint32_t prefilterVersion = 1;
+
+const float pi = 3.14159265358979f;
+
+const int tileRows = 8;
+
+// 접평면 좌표계 (z = N = V)의 샘플 하나
+struct PrefilterSample
+{
+    float direction[3];
+    float weight; // NdotL
+    float lod;    // 원본 mip 레벨 (실수)
+};
+
+float RadicalInverse(uint32_t bits)
+{
+    bits = (bits << 16u) | (bits >> 16u);
+    bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+    bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+    bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+    bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+    return float(bits) * 2.3283064365386963e-10f;
+}
+
+// Hammersley 점으로 GGX 하프 벡터를 뽑고 반사 방향으로 바꿈
+// PDF(L) = D(H) * NdotH / (4 * VdotH) = D(H) / 4 (N = V)
+// 샘플 하나가 덮는 입체각이 원본 텍셀 몇 개인지로 mip 레벨 선택
+std::vector<PrefilterSample> CreateSamples(float roughness, int sampleCount,
+                                           int sourceSize)
+{
+    const float alpha = roughness * roughness;
+    const float alpha2 = alpha * alpha;
+    const float texelSolidAngle = 4.0f * pi / (6.0f * sourceSize * sourceSize);
+
+    std::vector<PrefilterSample> samples;
+    samples.reserve(size_t(sampleCount));
+    float totalWeight = 0.0f;
+    for (int i = 0; i < sampleCount; i++)
+    {
+        const float xi1 = float(i) / float(sampleCount);
+        const float xi2 = RadicalInverse(uint32_t(i));
+
+        const float phi = 2.0f * pi * xi1;
+        const float cosTheta =
+            std::sqrt((1.0f - xi2) / (1.0f + (alpha2 - 1.0f) * xi2));
+        const float sinTheta = std::sqrt(1.0f - cosTheta * cosTheta);
+        const float h[3] = {sinTheta * std::cos(phi), sinTheta * std::sin(phi),
+                            cosTheta};
+
+        // L = 2 (V.H) H - V
+        PrefilterSample sample;
+        sample.direction[0] = 2.0f * cosTheta * h[0];
+        sample.direction[1] = 2.0f * cosTheta * h[1];
+        sample.direction[2] = 2.0f * cosTheta * h[2] - 1.0f;
+        sample.weight = sample.direction[2];
+        if (sample.weight <= 0.0f)
+            continue;
+
+        const float d = cosTheta * cosTheta * (alpha2 - 1.0f) + 1.0f;
+        const float pdf = alpha2 / (pi * d * d) * 0.25f;
+        const float sampleSolidAngle = 1.0f / (float(sampleCount) * pdf + 1e-6f);
+        // +1: 조금 더 흐린 레벨을 써서 샘플 사이의 틈을 메움
+        sample.lod = std::max(
+            0.5f * std::log2(sampleSolidAngle / texelSolidAngle) + 1.0f, 0.0f);
+
+        totalWeight += sample.weight;
+        samples.push_back(sample);
+    }
+
+    for (auto &sample : samples)
+        sample.weight /= totalWeight;
+    return samples;
+}
+
+// 원본 mip 두 개 사이를 보간 (trilinear)
+void SampleLod(const std::vector<FloatCubemap> &mips, const float direction[3],
+               float lod, float rgb[3])
+{
+    lod = std::min(lod, float(mips.size() - 1));
+    const int level = int(lod);
+    const float t = lod - float(level);
+
+    mips[size_t(level)].Sample(direction, rgb);
+    if (t > 0.0f && size_t(level) + 1 < mips.size())
+    {
+        float next[3];
+        mips[size_t(level) + 1].Sample(direction, next);
+        for (int ch = 0; ch < 3; ch++)
+            rgb[ch] += (next[ch] - rgb[ch]) * t;
+    }
+}
+
+void PrefilterRows(const std::vector<FloatCubemap> &mips,
+                   const std::vector<PrefilterSample> &samples,
+                   FloatCubemap &output, int face, int firstRow, int lastRow)
+{
+    const int size = output.size;
+    float *texels = output.GetFace(face);
+    for (int y = firstRow; y < lastRow; y++)
+    {
+        for (int x = 0; x < size; x++)
+        {
+            const float u = (float(x) + 0.5f) * 2.0f / float(size) - 1.0f;
+            const float v = (float(y) + 0.5f) * 2.0f / float(size) - 1.0f;
+            float n[3];
+            FloatCubemap::GetDirection(face, u, v, n);
+            const float invLength =
+                1.0f / std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            for (float &c : n)
+                c *= invLength;
+
+            // N을 z축으로 하는 접평면 좌표계
+            const float up[3] = {std::fabs(n[2]) < 0.999f ? 0.0f : 1.0f, 0.0f,
+                                 std::fabs(n[2]) < 0.999f ? 1.0f : 0.0f};
+            float tangent[3] = {up[1] * n[2] - up[2] * n[1],
+                                up[2] * n[0] - up[0] * n[2],
+                                up[0] * n[1] - up[1] * n[0]};
+            const float invTangentLength =
+                1.0f / std::sqrt(tangent[0] * tangent[0] +
+                                 tangent[1] * tangent[1] +
+                                 tangent[2] * tangent[2]);
+            for (float &c : tangent)
+                c *= invTangentLength;
+            const float bitangent[3] = {n[1] * tangent[2] - n[2] * tangent[1],
+                                        n[2] * tangent[0] - n[0] * tangent[2],
+                                        n[0] * tangent[1] - n[1] * tangent[0]};
+
+            float sum[3] = {};
+            for (const PrefilterSample &sample : samples)
+            {
+                float l[3];
+                for (int i = 0; i < 3; i++)
+                {
+                    l[i] = tangent[i] * sample.direction[0] +
+                           bitangent[i] * sample.direction[1] +
+                           n[i] * sample.direction[2];
+                }
+                float rgb[3];
+                SampleLod(mips, l, sample.lod, rgb);
+                for (int ch = 0; ch < 3; ch++)
+                    sum[ch] += rgb[ch] * sample.weight;
+            }
+
+            float *texel = texels + (size_t(y) * size + x) * 4;
+            texel[0] = sum[0];
+            texel[1] = sum[1];
+            texel[2] = sum[2];
+            texel[3] = 1.0f;
+        }
+    }
+}
+
+} // namespace
+
+std::vector<FloatCubemap>
+CubemapPrefilter::Prefilter(const FloatCubemap &environment,
+                            const PrefilterOptions &options)
+{
+    // 원본의 mip 체인 (샘플의 PDF로 레벨 선택)
+    std::vector<FloatCubemap> mips = {environment};
+    while (mips.back().size > 1)
+        mips.push_back(mips.back().Downsample());
+
+    // 결과 레벨 0의 크기와 같은 원본 mip
+    int size = options.size > 0 ? std::min(options.size, environment.size)
+                                : environment.size;
+    size_t firstMip = 0;
+    while (firstMip + 1 < mips.size() && mips[firstMip].size > size)
+        firstMip++;
+    size = mips[firstMip].size;
+
+    int mipLevels = options.mipLevels;
+    if (mipLevels <= 0)
+    {
+        mipLevels = 1;
+        while ((size >> mipLevels) >= std::max(options.minSize, 1))
+            mipLevels++;
+    }
+    mipLevels = std::min(mipLevels, int(mips.size() - firstMip));
+
+    std::vector<FloatCubemap> levels(static_cast<size_t>(mipLevels));
+    levels[0] = mips[firstMip];
+
+    struct Task
+    {
+        int level;
+        int face;
+        int firstRow;
+    };
+    std::vector<Task> tasks;
+    std::vector<std::vector<PrefilterSample>> samples(levels.size());
+    for (int level = 1; level < mipLevels; level++)
+    {
+        const float roughness = float(level) / float(mipLevels - 1);
+        samples[size_t(level)] =
+            CreateSamples(roughness, options.sampleCount, environment.size);
+        levels[size_t(level)].Resize(std::max(size >> level, 1));
+
+        for (int face = 0; face < 6; face++)
+        {
+            for (int row = 0; row < levels[size_t(level)].size; row += tileRows)
+                tasks.push_back({level, face, row});
+        }
+    }
+
+    // 큰 레벨은 샘플이 좁게 모여서 빠르고 작은 레벨은 타일 수가 적음
+    ThreadPool::Get().ParallelFor(tasks.size(), [&](size_t i) {
+        const Task &task = tasks[i];
+        FloatCubemap &output = levels[size_t(task.level)];
+        PrefilterRows(mips, samples[size_t(task.level)], output, task.face,
+                      task.firstRow,
+                      std::min(task.firstRow + tileRows, output.size));
+    });
+
+    return levels;
+}
+
+bool CubemapPrefilter::Generate(const std::string &environmentFilename,
+                                const std::string &outputFilename,
+                                const PrefilterOptions &options)
+{
+    FloatCubemap environment;
+    if (!environment.Read(environmentFilename))
+        return false;
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::vector<FloatCubemap> levels = Prefilter(environment, options);
+    const double ms = std::chrono::duration<double, std::milli>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+
+    DdsDesc desc;
+    desc.format = DxgiFormat::R16G16B16A16_Float;
+    desc.width = desc.height = uint32_t(levels[0].size);
+    desc.mipLevels = uint32_t(levels.size());
+    desc.arraySize = 6;
+    desc.cubemap = true;
+
+    // 면마다 mip 0, 1, ... 순서
+    std::vector<uint16_t> halfs;
+    halfs.reserve(DdsFile::GetDataSize(desc) / sizeof(uint16_t));
+    for (int face = 0; face < 6; face++)
+    {
+        for (const FloatCubemap &level : levels)
+        {
+            const float *texels = level.GetFace(face);
+            const size_t count = size_t(level.size) * level.size * 4;
+            for (size_t i = 0; i < count; i++)
+                halfs.push_back(BlockCompressor::FloatToHalf(texels[i]));
+        }
+    }
+
+    std::cout << environmentFilename << " -> ggx prefilter: "
+              << environment.size << " -> " << desc.width << "x"
+              << desc.height << ", " << desc.mipLevels << " levels, "
+              << options.sampleCount << " samples, " << ms << " ms"
+              << std::endl;
+
+    return DdsFile::Write(outputFilename, desc,
+                          reinterpret_cast<const uint8_t *>(halfs.data()),
+                          halfs.size() * sizeof(uint16_t), prefilterVersion);
+}
+
+bool CubemapPrefilter::Update(const std::string &environmentFilename,
+                              const std::string &outputFilename,
+                              const PrefilterOptions &options)
+{
+    std::error_code errorCode;
+    const auto environmentTime =
+        std::filesystem::last_write_time(environmentFilename, errorCode);
+    if (errorCode)
+        return std::filesystem::exists(outputFilename, errorCode);
+
+    // 다른 도구로 만든 파일도 환경 큐브맵보다 새로우면 그대로 사용
+    const auto outputTime =
+        std::filesystem::last_write_time(outputFilename, errorCode);
+    DdsDesc desc;
+    if (!errorCode && outputTime >= environmentTime &&
+        DdsFile::ReadDesc(outputFilename, desc) &&
+        (desc.writerVersion == 0 || desc.writerVersion == prefilterVersion))
+        return true;
+
+    return Generate(environmentFilename, outputFilename, options);
+}
+
+} // namespace FEFE
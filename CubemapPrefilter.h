@@ -0,0 +1,43 @@
+﻿#pragma once
+
+#include <string>
+#include <vector>
+
+#include "FloatCubemap.h"
+
+namespace FEFE
+{
+
+struct PrefilterOptions
+{
+    int size = 0;          // 결과 레벨 0의 한 변 (0이면 원본 크기, 원본보다 크게는 안 함)
+    int mipLevels = 0;     // 0이면 한 변이 minSize가 될 때까지
+    int minSize = 8;       // 거칠기 1의 레벨 크기 (mipLevels가 0일 때)
+    int sampleCount = 128; // 텍셀마다 GGX 중요도 샘플 수
+};
+
+// 환경 큐브맵을 GGX로 프리필터해서 거칠기별 mip 체인을 만듦 (split-sum의 앞부분)
+// 레벨 m의 거칠기는 m / (mipLevels - 1), 레벨 0은 원본 (거울 반사)
+// N = V = R 근사, 샘플의 PDF로 원본 mip을 골라서 적은 샘플로도 얼룩이 없음
+// (Karis 2013, "Real Shading in Unreal Engine 4", GPU Gems 3 20장)
+class CubemapPrefilter
+{
+  public:
+    // 레벨, 면, 8줄 타일 단위로 모든 코어에서 병렬
+    static std::vector<FloatCubemap> Prefilter(const FloatCubemap &environment,
+                                               const PrefilterOptions &options);
+
+    // 환경 큐브맵 DDS -> R16G16B16A16_FLOAT 큐브맵 DDS (mip 체인)
+    // 런타임에는 CubemapCompressor가 BC6H로 압축
+    static bool Generate(const std::string &environmentFilename,
+                         const std::string &outputFilename,
+                         const PrefilterOptions &options = PrefilterOptions());
+
+    // outputFilename이 없거나 환경 큐브맵보다 오래됐으면 새로 만듦
+    // 환경 큐브맵이 없으면 미리 만든 outputFilename을 그대로 사용 (false면 둘 다 없음)
+    static bool Update(const std::string &environmentFilename,
+                       const std::string &outputFilename,
+                       const PrefilterOptions &options = PrefilterOptions());
+};
+
+} // namespace FEFE
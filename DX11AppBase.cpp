@@ -3,12 +3,11 @@
 
 #include "DX11AppBase.h"
 
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
-
-#include <directxtk/DDSTextureLoader.h> // 큐브맵 읽을 때 필요
+#include <cstddef>
+#include <directxtk/DDSTextureLoader.h> // DdsImage가 읽지 못하는 큐브맵
 #include <dxgi.h>                       // DXGIFactory
 #include <dxgi1_4.h>                    // DXGIFactory4
+#include <filesystem>
 
 // imgui_impl_win32.cpp에 정의된 메시지 처리 함수에 대한 전방 선언
 extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd,
@@ -22,6 +21,16 @@ namespace FEFE
 using namespace std;
 using namespace DirectX;
 
+// DdsImage의 subresource 배열을 복사 없이 초기 데이터로 넘기기 위해
+static_assert(sizeof(DdsSubresource) == sizeof(D3D11_SUBRESOURCE_DATA) &&
+                  offsetof(DdsSubresource, data) ==
+                      offsetof(D3D11_SUBRESOURCE_DATA, pSysMem) &&
+                  offsetof(DdsSubresource, rowPitch) ==
+                      offsetof(D3D11_SUBRESOURCE_DATA, SysMemPitch) &&
+                  offsetof(DdsSubresource, slicePitch) ==
+                      offsetof(D3D11_SUBRESOURCE_DATA, SysMemSlicePitch),
+              "DdsSubresource layout");
+
 // RegisterClassEx()에서 멤버 함수를 직접 등록할 수가 없음
 // 클래스의 멤버 함수에서 간접적으로 메시지를 처리할 수 있도록 도와줍니다.
 AppBase *g_appBase = nullptr;
@@ -603,68 +612,148 @@ void AppBase::CreatePixelShader(const wstring &filename,
                                 &pixelShader);
 }
 
-void AppBase::CreateIndexBuffer(const std::vector<uint32_t> &indices,
-                                ComPtr<ID3D11Buffer> &indexBuffer) 
+DXGI_FORMAT AppBase::CreateIndexBuffer(const std::vector<uint32_t> &indices,
+                                       ComPtr<ID3D11Buffer> &indexBuffer) 
+{
+    return CreateIndexBuffer(indices.data(), indices.size(), indexBuffer);
+}
+
+DXGI_FORMAT AppBase::CreateIndexBuffer(const uint32_t *indices,
+                                       size_t numIndices,
+                                       ComPtr<ID3D11Buffer> &indexBuffer) 
 {
+    // 가장 큰 인덱스가 16비트에 들어가면 절반 크기로 변환
+    // (큰 메쉬는 GeometryGenerator::ReadFromFile()에서 미리 나눠둠)
+    uint32_t maxIndex = 0;
+    for (size_t i = 0; i < numIndices; i++)
+    {
+        if (indices[i] > maxIndex)
+            maxIndex = indices[i];
+    }
+
+    std::vector<uint16_t> shortIndices;
+    const bool useShortIndices = maxIndex <= 0xFFFF;
+    if (useShortIndices)
+        shortIndices.assign(indices, indices + numIndices);
+
+    const UINT indexSize =
+        useShortIndices ? sizeof(uint16_t) : sizeof(uint32_t);
+
     D3D11_BUFFER_DESC bufferDesc = {};
     bufferDesc.Usage = D3D11_USAGE_IMMUTABLE; // 초기화 후 변경X
-    bufferDesc.ByteWidth = UINT(sizeof(uint32_t) * indices.size());
+    bufferDesc.ByteWidth = UINT(indexSize * numIndices);
     bufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
     bufferDesc.CPUAccessFlags = 0; // 0 if no CPU access is necessary.
-    bufferDesc.StructureByteStride = sizeof(uint32_t);
+    bufferDesc.StructureByteStride = indexSize;
 
     D3D11_SUBRESOURCE_DATA indexBufferData = {0};
-    indexBufferData.pSysMem = indices.data();
+    indexBufferData.pSysMem = useShortIndices
+                                  ? static_cast<const void *>(shortIndices.data())
+                                  : static_cast<const void *>(indices);
     indexBufferData.SysMemPitch = 0;
     indexBufferData.SysMemSlicePitch = 0;
 
     m_d3dDevice->CreateBuffer(&bufferDesc, &indexBufferData,
                            indexBuffer.GetAddressOf());
+
+    return useShortIndices ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
 }
 
 void AppBase::CreateTexture(
     const std::string filename, ComPtr<ID3D11Texture2D> &texture,
     ComPtr<ID3D11ShaderResourceView> &textureResourceView)
 {
+    ImageData image;
+    if (TextureLoader::Load(filename, TextureLoadOptions(), image))
+        CreateTexture(image, texture, textureResourceView);
+}
 
-    int width, height, channels;
-
-    unsigned char *img =
-        stbi_load(filename.c_str(), &width, &height, &channels, 0);
+void AppBase::CreateTexture(
+    const ImageData &image, ComPtr<ID3D11Texture2D> &texture,
+    ComPtr<ID3D11ShaderResourceView> &textureResourceView)
+{
+    if (image.pixels.empty())
+        return;
 
-    // assert(channels == 4);
-
-    // 4채널로 만들어서 복사
-    std::vector<uint8_t> image;
-    image.resize(width * height * 4);
-    for (size_t i = 0; i < width * height; i++) {
-        for (size_t c = 0; c < 3; c++) {
-            image[4 * i + c] = img[i * channels + c];
-        }
-        image[4 * i + 3] = 255;
-    }
+    // mip 레벨이 없으면 레벨 0만
+    std::vector<MipLevel> levels = image.mipLevels;
+    if (levels.empty())
+        levels.push_back({image.width, image.height, 0});
 
     // Create texture.
     D3D11_TEXTURE2D_DESC txtDesc = {};
-    txtDesc.Width = width;
-    txtDesc.Height = height;
-    txtDesc.MipLevels = txtDesc.ArraySize = 1;
-    txtDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    txtDesc.Width = image.width;
+    txtDesc.Height = image.height;
+    txtDesc.MipLevels = UINT(levels.size());
+    txtDesc.ArraySize = 1;
+    txtDesc.Format = DXGI_FORMAT(image.format); // RGBA8 또는 BC
     txtDesc.SampleDesc.Count = 1;
     txtDesc.Usage = D3D11_USAGE_IMMUTABLE;
     txtDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
 
     // Fill in the subresource data.
-    D3D11_SUBRESOURCE_DATA initData;
-    initData.pSysMem = image.data();
-    initData.SysMemPitch = txtDesc.Width * sizeof(uint8_t) * 4;
-    // initData.SysMemSlicePitch = 0;
+    // IMMUTABLE이라서 모든 레벨을 만들 때 한 번에 넘겨야 함
+    std::vector<D3D11_SUBRESOURCE_DATA> initData(levels.size());
+    for (size_t level = 0; level < levels.size(); level++)
+    {
+        initData[level].pSysMem = image.pixels.data() + levels[level].offset;
+        // BC 형식은 4x4 블록 한 줄의 바이트 수
+        initData[level].SysMemPitch = UINT(
+            DdsFile::GetRowPitch(image.format, UINT(levels[level].width)));
+        initData[level].SysMemSlicePitch = 0;
+    }
 
-    m_d3dDevice->CreateTexture2D(&txtDesc, &initData, texture.GetAddressOf());
+    m_d3dDevice->CreateTexture2D(&txtDesc, initData.data(),
+                                 texture.GetAddressOf());
     m_d3dDevice->CreateShaderResourceView(texture.Get(), nullptr,
                                        textureResourceView.GetAddressOf());
 }
 
+void AppBase::CreateTextureArray(
+    const TextureArrayData &array, ComPtr<ID3D11Texture2D> &texture,
+    ComPtr<ID3D11ShaderResourceView> &textureResourceView)
+{
+    if (array.slices.empty())
+        return;
+
+    D3D11_TEXTURE2D_DESC txtDesc = {};
+    txtDesc.Width = array.width;
+    txtDesc.Height = array.height;
+    txtDesc.MipLevels = UINT(array.mipLevels.size());
+    txtDesc.ArraySize = UINT(array.slices.size());
+    txtDesc.Format = DXGI_FORMAT(array.format);
+    txtDesc.SampleDesc.Count = 1;
+    txtDesc.Usage = D3D11_USAGE_IMMUTABLE;
+    txtDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+    // subresource 순서: slice 0의 레벨 0, 1, ..., slice 1의 레벨 0, ...
+    std::vector<D3D11_SUBRESOURCE_DATA> initData;
+    initData.reserve(array.mipLevels.size() * array.slices.size());
+    for (const std::vector<uint8_t> &slice : array.slices)
+    {
+        const uint8_t *sliceData = slice.data();
+        for (const MipLevel &level : array.mipLevels)
+        {
+            D3D11_SUBRESOURCE_DATA data = {};
+            data.pSysMem = sliceData + level.offset;
+            data.SysMemPitch = UINT(
+                DdsFile::GetRowPitch(array.format, UINT(level.width)));
+            initData.push_back(data);
+        }
+    }
+
+    m_d3dDevice->CreateTexture2D(&txtDesc, initData.data(),
+                                 texture.GetAddressOf());
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = txtDesc.Format;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+    srvDesc.Texture2DArray.MipLevels = txtDesc.MipLevels;
+    srvDesc.Texture2DArray.ArraySize = txtDesc.ArraySize;
+    m_d3dDevice->CreateShaderResourceView(texture.Get(), &srvDesc,
+                                          textureResourceView.GetAddressOf());
+}
+
 void AppBase::CreateCubemapTexture(
     const wchar_t *filename,
     ComPtr<ID3D11ShaderResourceView> &textureResourceView) 
@@ -672,6 +761,54 @@ void AppBase::CreateCubemapTexture(
 
     ComPtr<ID3D11Texture2D> texture;
 
+    // 파일을 매핑해서 중간 버퍼 없이 바로 올림
+    DdsImage image;
+    if (image.Open(filesystem::path(filename).string()) &&
+        image.GetDesc().cubemap)
+    {
+        const DdsDesc &desc = image.GetDesc();
+
+        D3D11_TEXTURE2D_DESC txtDesc = {};
+        txtDesc.Width = desc.width;
+        txtDesc.Height = desc.height;
+        txtDesc.MipLevels = desc.mipLevels;
+        txtDesc.ArraySize = desc.arraySize;
+        txtDesc.Format = DXGI_FORMAT(desc.format);
+        txtDesc.SampleDesc.Count = 1;
+        txtDesc.Usage = D3D11_USAGE_IMMUTABLE;
+        txtDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+        txtDesc.MiscFlags = D3D11_RESOURCE_MISC_TEXTURECUBE;
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = txtDesc.Format;
+        if (desc.arraySize > 6)
+        {
+            srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBEARRAY;
+            srvDesc.TextureCubeArray.MipLevels = desc.mipLevels;
+            srvDesc.TextureCubeArray.NumCubes = desc.arraySize / 6;
+        }
+        else
+        {
+            srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBE;
+            srvDesc.TextureCube.MipLevels = desc.mipLevels;
+        }
+
+        if (SUCCEEDED(m_d3dDevice->CreateTexture2D(
+                &txtDesc,
+                reinterpret_cast<const D3D11_SUBRESOURCE_DATA *>(
+                    image.GetSubresources()),
+                texture.GetAddressOf())) &&
+            SUCCEEDED(m_d3dDevice->CreateShaderResourceView(
+                texture.Get(), &srvDesc,
+                textureResourceView.GetAddressOf())))
+            return;
+
+        cout << "CreateCubemapTexture() failed: "
+             << DdsFile::GetFormatName(desc.format) << endl;
+        texture.Reset();
+        textureResourceView.Reset();
+    }
+
     // https://github.com/microsoft/DirectXTK/wiki/DDSTextureLoader
     auto hr = CreateDDSTextureFromFileEx(
         m_d3dDevice.Get(), filename, 0, D3D11_USAGE_DEFAULT,
@@ -10,6 +10,9 @@
 #include <windows.h>
 #include <wrl.h> // ComPtr
 
+#include "TextureArrayPacker.h"
+#include "TextureLoader.h"
+
 namespace FEFE 
 {
 
@@ -58,14 +61,26 @@ class AppBase
         ComPtr<ID3D11InputLayout> &inputLayout);
     void CreatePixelShader(const wstring &filename,
                            ComPtr<ID3D11PixelShader> &pixelShader);
-    void CreateIndexBuffer(const vector<uint32_t> &indices,
-                           ComPtr<ID3D11Buffer> &indexBuffer);
+    // 인덱스가 모두 16비트에 들어가면 uint16 버퍼로 만들고 R16_UINT를 반환
+    // 반환값을 Mesh::m_indexFormat에 저장해서 IASetIndexBuffer()에 사용
+    DXGI_FORMAT CreateIndexBuffer(const vector<uint32_t> &indices,
+                                  ComPtr<ID3D11Buffer> &indexBuffer);
+    // 메모리 매핑된 캐시처럼 vector가 아닌 곳에 있는 인덱스용
+    DXGI_FORMAT CreateIndexBuffer(const uint32_t *indices, size_t numIndices,
+                                  ComPtr<ID3D11Buffer> &indexBuffer);
 
 
     // 템플릿 // 
     template <typename T_VERTEX>
     void CreateVertexBuffer(const vector<T_VERTEX> &vertices,
                             ComPtr<ID3D11Buffer> &vertexBuffer) 
+    {
+        CreateVertexBuffer(vertices.data(), vertices.size(), vertexBuffer);
+    }
+
+    template <typename T_VERTEX>
+    void CreateVertexBuffer(const T_VERTEX *vertices, size_t numVertices,
+                            ComPtr<ID3D11Buffer> &vertexBuffer) 
     {
         // vertices를 gpu에 옮겨서 버퍼를 만듦
         // D3D11_USAGE enumeration (d3d11.h)
@@ -74,13 +89,13 @@ class AppBase
         D3D11_BUFFER_DESC bufferDesc;
         ZeroMemory(&bufferDesc, sizeof(bufferDesc));
         bufferDesc.Usage = D3D11_USAGE_IMMUTABLE; // 초기화 후 변경X
-        bufferDesc.ByteWidth = UINT(sizeof(T_VERTEX) * vertices.size());
+        bufferDesc.ByteWidth = UINT(sizeof(T_VERTEX) * numVertices);
         bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
         bufferDesc.CPUAccessFlags = 0; 
         bufferDesc.StructureByteStride = sizeof(T_VERTEX); // 버텍스하나가 가지고있는 사이즈 넣어줌
 
         D3D11_SUBRESOURCE_DATA vertexBufferData = {0};  // MS 예제에서 초기화하는 방식
-        vertexBufferData.pSysMem = vertices.data();     // cpu데이터의 첫포인터, 가리키는 곳부터 보내라
+        vertexBufferData.pSysMem = vertices;            // cpu데이터의 첫포인터, 가리키는 곳부터 보내라
         vertexBufferData.SysMemPitch = 0;           
         vertexBufferData.SysMemSlicePitch = 0;
 
@@ -142,6 +157,14 @@ class AppBase
     void CreateTexture(const std::string filename,
                        ComPtr<ID3D11Texture2D> &texture,
                        ComPtr<ID3D11ShaderResourceView> &textureResourceView);
+    // TextureLoader에서 디코딩이 끝난 이미지를 올림 (렌더 스레드에서 호출)
+    void CreateTexture(const ImageData &image,
+                       ComPtr<ID3D11Texture2D> &texture,
+                       ComPtr<ID3D11ShaderResourceView> &textureResourceView);
+    // TextureArrayPacker로 묶은 slice들을 Texture2DArray 하나로 올림
+    void CreateTextureArray(const TextureArrayData &array,
+                            ComPtr<ID3D11Texture2D> &texture,
+                            ComPtr<ID3D11ShaderResourceView> &textureResourceView);
     void CreateCubemapTexture(const wchar_t *filename,
                               ComPtr<ID3D11ShaderResourceView> &texResView);
 
@@ -1,10 +1,26 @@
 ﻿#include "DX11ExampleApp.h"
 
+#include <cfloat>
+#include <chrono>
 #include <directxtk/DDSTextureLoader.h> // 큐브맵 읽을 때 필요
+#include <filesystem>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
+#include "BrdfLut.h"
+#include "ChannelPacker.h"
+#include "CubemapCompressor.h"
+#include "CubemapPrefilter.h"
+#include "EquirectConverter.h"
 #include "GeometryGenerator.h"
+#include "ImageDecoder.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "MeshletBuilder.h"
+#include "OctahedralEnvMap.h"
+#include "SphericalHarmonics.h"
+#include "VertexKernels.h"
 
 namespace FEFE 
 {
@@ -15,6 +31,281 @@ using namespace DirectX;
 
 ExampleApp::ExampleApp() : AppBase(), m_BasicPixelConstantBufferData() {}
 
+template <typename T_VERTEX>
+void ExampleApp::CreateModelMeshes(const SceneView &scene,
+                                   ComPtr<ID3D11Buffer> &vertexConstantBuffer,
+                                   ComPtr<ID3D11Buffer> &pixelConstantBuffer)
+{
+    const vector<MeshDataView> &meshes = scene.meshes;
+
+    // 모든 메쉬가 같은 범위로 양자화 (PackedVertexConstantBuffer 하나를 공유)
+    const VertexQuantization quantization =
+        VertexQuantization::FromMeshes(meshes);
+    m_packedVertexConstantBufferData =
+        VertexFormat<T_VERTEX>::Dequantization(quantization);
+    AppBase::CreateConstantBuffer(m_packedVertexConstantBufferData,
+                                  m_packedVertexConstantBuffer);
+
+    // 텍스춰는 작업 스레드에서 디코딩하고, 그동안 버텍스/인덱스 버퍼를 만듦
+    // 같은 이미지를 쓰는 메쉬들은 텍스춰 하나를 공유 (경로가 달라도 내용이 같으면)
+    // 캐시에 없는 것만 새로 읽음
+    vector<string> textureFilenames;
+    unordered_map<string, shared_ptr<CachedTexture>> newTextures;
+    auto AcquireTexture = [&](const string &filename) {
+        if (filename.empty())
+            return shared_ptr<CachedTexture>();
+        bool isNew = false;
+        shared_ptr<CachedTexture> texture =
+            m_textureCache.Acquire(filename, isNew);
+        if (isNew)
+        {
+            textureFilenames.push_back(filename);
+            newTextures[filename] = texture;
+        }
+        return texture;
+    };
+
+    // 재질 텍스춰 (ChannelPacker가 만든 .orm.dds)도 같은 캐시로 읽음
+    vector<shared_ptr<CachedTexture>> meshTextures(meshes.size());
+    vector<shared_ptr<CachedTexture>> meshPackedTextures(meshes.size());
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+        meshTextures[i] = AcquireTexture(meshes[i].textureFilename);
+        meshPackedTextures[i] = AcquireTexture(meshes[i].packedTextureFilename);
+    }
+
+    // 예산 관리를 쓰면 여기서 읽지 않고 처음 보일 때 읽음 (UpdateResidency())
+    const size_t numNewTextures = textureFilenames.size();
+    if (m_useResidency)
+    {
+        m_residency.SetLoadOptions(m_textureOptions);
+        for (const string &filename : textureFilenames)
+            m_residency.Register(newTextures[filename], filename);
+        textureFilenames.clear();
+    }
+
+    const auto textureStart = chrono::steady_clock::now();
+    TextureLoader textureLoader(m_maxQueuedTextures, m_textureOptions);
+    textureLoader.Start(textureFilenames);
+
+    VertexPackingError error;
+    size_t numVertices = 0;
+    const size_t firstMesh = m_meshes.size();
+
+    for (size_t meshIndex = 0; meshIndex < meshes.size(); meshIndex++)
+    {
+        const MeshDataView &meshData = meshes[meshIndex];
+        const TMeshData<T_VERTEX> packed =
+            PackMeshData<T_VERTEX>(meshData, quantization, error);
+        numVertices += packed.vertices.size();
+
+        // 인스턴스가 번호로 가리키므로 빈 메쉬도 자리는 만듦
+        auto newMesh = std::make_shared<Mesh>();
+        this->m_meshes.push_back(newMesh);
+        if (meshData.numVertices == 0 || meshData.numIndices == 0)
+            continue;
+
+        // 경계 구 (AABB 중심 기준)
+        Vector3 vmin, vmax;
+        VertexKernels::ComputeBounds(meshData.vertices, meshData.numVertices,
+                                     vmin, vmax);
+        newMesh->m_boundingCenter = (vmin + vmax) * 0.5f;
+        for (size_t i = 0; i < meshData.numVertices; i++)
+        {
+            newMesh->m_boundingRadius = std::max(
+                newMesh->m_boundingRadius,
+                (meshData.vertices[i].position - newMesh->m_boundingCenter)
+                    .Length());
+        }
+
+        AppBase::CreateVertexBuffer(packed.vertices, newMesh->vertexBuffer);
+        newMesh->m_vertexStride = sizeof(T_VERTEX);
+        newMesh->m_lods = packed.lods;
+        newMesh->m_meshlets = packed.meshlets;
+        newMesh->m_indexCount = packed.lods.empty()
+                                    ? UINT(packed.indices.size())
+                                    : packed.lods[0].indexCount;
+        newMesh->m_indexFormat =
+            AppBase::CreateIndexBuffer(packed.indices, newMesh->indexBuffer);
+
+        newMesh->vertexConstantBuffer = vertexConstantBuffer;
+        newMesh->pixelConstantBuffer = pixelConstantBuffer;
+        newMesh->texture = meshTextures[meshIndex];
+        newMesh->packedTexture = meshPackedTextures[meshIndex];
+        newMesh->packedChannels = meshData.packedChannels;
+        newMesh->m_uvDensity = meshData.uvDensity;
+    }
+
+    // 디코딩이 끝난 순서대로 올림
+    // 묶을 때는 받는 대로 packer의 배열로 옮기고 마지막에 한 번에 올림
+    TextureArrayPacker packer(m_textureArrayOptions);
+    vector<pair<string, size_t>> batchTextures; // 파일 이름, 크기 (Add() 순서)
+    ImageData image;
+    while (textureLoader.Pop(image))
+    {
+        cout << image.filename << endl;
+
+        if (m_batchTextures)
+        {
+            if (!image.pixels.empty())
+            {
+                batchTextures.emplace_back(image.filename, image.pixels.size());
+                packer.Add(image, TextureLoader::GuessUsage(image.filename));
+            }
+            continue;
+        }
+
+        ComPtr<ID3D11Texture2D> texture;
+        ComPtr<ID3D11ShaderResourceView> textureResourceView;
+        AppBase::CreateTexture(image, texture, textureResourceView);
+        if (textureResourceView)
+        {
+            m_textureCache.SetTexture(*newTextures[image.filename], texture,
+                                      textureResourceView, image.pixels.size());
+        }
+    }
+    if (!batchTextures.empty())
+    {
+        vector<TextureArrayData> arrays;
+        vector<TextureSlot> slots;
+        vector<ImageData> unplaced;
+        packer.Finish(arrays, slots, unplaced);
+
+        const int firstArray = int(m_textureArrays.size());
+        for (TextureArrayData &array : arrays)
+        {
+            TextureArray textureArray;
+            AppBase::CreateTextureArray(array, textureArray.texture,
+                                        textureArray.resourceView);
+            m_textureArrays.push_back(textureArray);
+            array.slices.clear(); // GPU로 올렸으므로 바로 해제
+        }
+
+        // 배열에 묶지 못하고 돌려받은 이미지는 따로 텍스춰로 만듦
+        for (size_t i = 0; i < batchTextures.size(); i++)
+        {
+            CachedTexture &entry = *newTextures[batchTextures[i].first];
+            entry.slot = slots[i];
+            ComPtr<ID3D11Texture2D> texture;
+            ComPtr<ID3D11ShaderResourceView> textureResourceView;
+            if (entry.slot.arrayIndex >= 0)
+            {
+                entry.slot.arrayIndex += firstArray;
+            }
+            else if (!unplaced[i].pixels.empty())
+            {
+                AppBase::CreateTexture(unplaced[i], texture,
+                                       textureResourceView);
+                unplaced[i].pixels.clear();
+                if (!textureResourceView)
+                    continue;
+            }
+            m_textureCache.SetTexture(entry, texture, textureResourceView,
+                                      batchTextures[i].second);
+        }
+    }
+
+    // 텍스춰 위치가 정해졌으므로 메쉬마다 재질 상수 버퍼
+    for (size_t meshIndex = firstMesh; meshIndex < m_meshes.size(); meshIndex++)
+    {
+        Mesh &mesh = *m_meshes[meshIndex];
+        if (!mesh.indexBuffer)
+            continue;
+
+        auto SetSlot = [](const shared_ptr<CachedTexture> &texture,
+                          Vector4 &rect, float &slice) {
+            if (!texture || texture->slot.arrayIndex < 0)
+                return;
+            const TextureSlot &slot = texture->slot;
+            rect = Vector4(slot.scale[0], slot.scale[1], slot.offset[0],
+                           slot.offset[1]);
+            slice = float(slot.slice);
+        };
+
+        MaterialConstantBuffer material;
+        SetSlot(mesh.texture, material.textureRect, material.textureSlice);
+        SetSlot(mesh.packedTexture, material.packedRect, material.packedSlice);
+        AppBase::CreateConstantBuffer(material, mesh.materialConstantBuffer);
+    }
+
+    cout << numNewTextures << " textures, "
+         << chrono::duration<double, milli>(chrono::steady_clock::now() -
+                                            textureStart)
+                .count()
+         << " ms" << endl;
+    m_textureCache.PrintStats();
+
+    // 같은 메쉬를 가리키는 인스턴스는 버퍼를 공유하고 행렬만 다름
+    const vector<Matrix> world =
+        ComputeWorldTransforms(scene.nodes, scene.numNodes);
+    for (size_t i = 0; i < scene.numInstances; i++)
+    {
+        const MeshInstance &instance = scene.instances[i];
+        if (!m_meshes[instance.meshIndex]->indexBuffer)
+            continue;
+
+        MeshRenderInstance renderInstance;
+        renderInstance.mesh = m_meshes[instance.meshIndex];
+        renderInstance.m_transform = world[instance.nodeIndex];
+        m_instances.push_back(renderInstance);
+    }
+
+    cout << meshes.size() << " meshes, " << m_instances.size()
+         << " instances" << endl;
+    cout << "vertex format: " << sizeof(T_VERTEX) << " bytes, "
+         << numVertices * sizeof(T_VERTEX) / 1024 << " KB (float: "
+         << numVertices * sizeof(Vertex) / 1024
+         << " KB), max error position " << error.position << ", normal "
+         << error.normalDegrees << " deg, texcoord " << error.texcoord << endl;
+
+    // 입력 레이아웃은 버텍스 타입에서 컴파일 타임에 만들어짐
+    AppBase::CreateVertexShaderAndInputLayout(
+        VertexFormat<T_VERTEX>::vertexShaderFilename,
+        GetInputElements<T_VERTEX>(), m_basicVertexShader, m_basicInputLayout);
+}
+
+
+void ExampleApp::LoadCubemap(const wchar_t *filename,
+                             ComPtr<ID3D11ShaderResourceView> &resView)
+{
+    std::wstring path = filename;
+    if (m_compressCubemaps)
+    {
+        path = filesystem::path(CubemapCompressor::GetCompressed(
+                                    filesystem::path(filename).string()))
+                   .wstring();
+    }
+    CreateCubemapTexture(path.c_str(), resView);
+}
+
+void ExampleApp::LoadSpecularOctahedral()
+{
+    const filesystem::path cubemapPath(m_specularCubemapFilename);
+    std::string filename =
+        (cubemapPath.parent_path() / cubemapPath.stem()).string() + ".oct.dds";
+    if (!OctahedralEnvMap::Update(cubemapPath.string(), filename))
+        return;
+    if (m_compressCubemaps)
+        filename = CubemapCompressor::GetCompressed(filename);
+    AppBase::CreateTexture(filename, m_specularOctahedralTexture,
+                           m_specularOctahedralResView);
+}
+
+bool ExampleApp::CanUseSpecularMode(int specularMode) const
+{
+    // split-sum은 프리필터한 큐브맵과 BRDF LUT, 팔면체는 팔면체 맵까지 필요
+    switch (specularMode)
+    {
+    case 0:
+        return true;
+    case 1:
+        return m_cubeMapping.specularResView && m_brdfLutResView;
+    case 2:
+        return m_specularOctahedralResView && m_brdfLutResView;
+    default:
+        return false;
+    }
+}
 
 void ExampleApp::InitializeCubeMapping() 
 {
@@ -36,9 +327,83 @@ void ExampleApp::InitializeCubeMapping()
     auto MSPathDiffuseFilename = L"./CubemapTextures/MSPath_diffuseIBL.dds";
     auto MSPathSpecularFilename = L"./CubemapTextures/MSPath_specularIBL.dds";
 
+    // 파노라마 universe.jpg를 환경 큐브맵으로 변환해서 GGX로 프리필터 (specular)하고
+    // 구면 조화로 투영 (diffuse, 이 환경에 맞는 diffuse 큐브맵은 없음)
+    // 변환에 실패하면 함께 들어있는 saint_specular.dds (레벨 0이 거울 반사)를 환경으로,
+    // 프리필터도 실패하면 saint_diffuse.dds/saint_specular.dds를 그대로 사용
+    const std::wstring panoramaFilename = L"./universe.jpg";
+    std::wstring environmentFilename = L"./CubemapTextures/universe_env.dds";
+    std::wstring prefilteredFilename =
+        L"./CubemapTextures/universe_specularIBL.dds";
+    m_diffuseCubemapFilename.clear();
+    if (!EquirectConverter::Update(
+            filesystem::path(panoramaFilename).string(),
+            filesystem::path(environmentFilename).string()))
+    {
+        cout << "EquirectConverter failed, using "
+             << filesystem::path(saintSpecularFilename).string() << endl;
+        environmentFilename = saintSpecularFilename;
+        prefilteredFilename = L"./CubemapTextures/saint_specularIBL.dds";
+        m_diffuseCubemapFilename = saintDiffuseFilename;
+    }
+
+    m_specularCubemapFilename = prefilteredFilename;
+    if (!CubemapPrefilter::Update(
+            filesystem::path(environmentFilename).string(),
+            filesystem::path(prefilteredFilename).string()))
+    {
+        cout << "CubemapPrefilter failed, using "
+             << filesystem::path(saintSpecularFilename).string() << endl;
+        environmentFilename = saintSpecularFilename;
+        m_diffuseCubemapFilename = saintDiffuseFilename;
+        m_specularCubemapFilename = saintSpecularFilename;
+    }
+
+    // diffuse 조명의 다른 방법: 환경 큐브맵을 투영한 구면 조화 9개
+    // (압축하지 않은 원본에서 계산)
+    SHCoefficients radiance;
+    m_hasIrradianceSh = SphericalHarmonics::ProjectCubemap(
+        filesystem::path(environmentFilename).string(), radiance);
+    if (m_hasIrradianceSh)
+    {
+        const SHCoefficients irradiance =
+            SphericalHarmonics::ToIrradiance(radiance);
+        for (int i = 0; i < 9; i++)
+        {
+            m_BasicPixelConstantBufferData.irradianceSh[i] =
+                Vector4(irradiance.c[i][0], irradiance.c[i][1],
+                        irradiance.c[i][2], 0.0f);
+        }
+    }
+    else if (m_diffuseCubemapFilename.empty())
+    {
+        // diffuse가 둘 다 없으면 saint 큐브맵으로
+        m_diffuseCubemapFilename = saintDiffuseFilename;
+    }
+
     // .dds 파일 읽어들여서 초기화 
-    CreateCubemapTexture(stonewallDiffuseFilename, m_cubeMapping.diffuseResView);
-    CreateCubemapTexture(stonewallSpecularFilename, m_cubeMapping.specularResView);
+    // diffuse 큐브맵이 없거나 읽지 못하면 구면 조화, 구면 조화가 없으면 큐브맵
+    int &diffuseMode = m_BasicPixelConstantBufferData.diffuseMode;
+    if (!m_hasIrradianceSh)
+        diffuseMode = 0;
+    if (diffuseMode == 0 && !m_diffuseCubemapFilename.empty())
+        LoadCubemap(m_diffuseCubemapFilename.c_str(),
+                    m_cubeMapping.diffuseResView);
+    if (diffuseMode == 0 && !m_cubeMapping.diffuseResView && m_hasIrradianceSh)
+        diffuseMode = 1;
+
+    if (m_BasicPixelConstantBufferData.specularMode == 2)
+        LoadSpecularOctahedral();
+    LoadCubemap(m_specularCubemapFilename.c_str(),
+                m_cubeMapping.specularResView);
+
+    // 환경과 관계없는 split-sum BRDF 적분 (t6)
+    const std::string brdfLutFilename = "./BrdfLut.dds";
+    if (BrdfLut::Update(brdfLutFilename))
+        AppBase::CreateTexture(brdfLutFilename, m_brdfLutTexture,
+                               m_brdfLutResView);
+    if (!CanUseSpecularMode(m_BasicPixelConstantBufferData.specularMode))
+        m_BasicPixelConstantBufferData.specularMode = 0;
 
     m_cubeMapping.cubeMesh = std::make_shared<Mesh>();
 
@@ -62,25 +427,16 @@ void ExampleApp::InitializeCubeMapping()
     AppBase::CreateVertexBuffer(cubeMeshData.vertices,
                                 m_cubeMapping.cubeMesh->vertexBuffer);
     m_cubeMapping.cubeMesh->m_indexCount = UINT(cubeMeshData.indices.size());
-    AppBase::CreateIndexBuffer(cubeMeshData.indices,
-                               m_cubeMapping.cubeMesh->indexBuffer);
+    m_cubeMapping.cubeMesh->m_indexFormat = AppBase::CreateIndexBuffer(
+        cubeMeshData.indices, m_cubeMapping.cubeMesh->indexBuffer);
 
 
     // 쉐이더 초기화
-    vector<D3D11_INPUT_ELEMENT_DESC> basicInputElements = 
-    {
-        {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0,
-         D3D11_INPUT_PER_VERTEX_DATA, 0},
-        {"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 4 * 3,     
-         D3D11_INPUT_PER_VERTEX_DATA, 0},
-        {"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 4 * 3 + 4 * 3,
-         D3D11_INPUT_PER_VERTEX_DATA, 0},
-    };
-    
+    m_cubeMapping.cubeMesh->m_vertexStride = sizeof(Vertex);
 
     // 정의한 InputElements배열로 부터 Inputlayout 만듦
     AppBase::CreateVertexShaderAndInputLayout(
-        L"CubeMappingVertexShader.hlsl", basicInputElements,
+        L"CubeMappingVertexShader.hlsl", GetInputElements<Vertex>(),
         m_cubeMapping.vertexShader, m_cubeMapping.inputLayout);
 
     AppBase::CreatePixelShader(L"CubeMappingPixelShader.hlsl",
@@ -111,21 +467,69 @@ bool ExampleApp::Initialize()
     // Create the Sample State
     m_d3dDevice->CreateSamplerState(&sampDesc, m_samplerState.GetAddressOf());
 
+    // 합친 재질 텍스춰가 없는 메쉬용 1x1 (ChannelPacker가 빈 채널에 채우는 값)
+    ImageData defaultPacked;
+    defaultPacked.width = 1;
+    defaultPacked.height = 1;
+    defaultPacked.pixels = {ChannelPacker::defaultOcclusion,
+                            ChannelPacker::defaultRoughness,
+                            ChannelPacker::defaultMetallic,
+                            ChannelPacker::defaultHeight};
+    AppBase::CreateTexture(defaultPacked, m_defaultPackedTexture,
+                           m_defaultPackedResView);
+
+    CreateModel();
+
+    AppBase::CreatePixelShader(L"BasicPixelShader.hlsl", m_basicPixelShader);
+
+    AppBase::CreateVertexShaderAndInputLayout(
+        L"NormalVertexShader.hlsl", GetInputElements<Vertex>(),
+        m_normalVertexShader, m_normalInputLayout);
+    AppBase::CreatePixelShader(L"NormalPixelShader.hlsl", m_normalPixelShader);
+
+    return true;
+}
+
+void ExampleApp::CreateModel()
+{
+    // 다시 만들 때는 이전 모델을 먼저 해제 (텍스춰는 아무도 쓰지 않게 되면 캐시에서도 정리)
+    m_meshes.clear();
+    m_instances.clear();
+    m_textureArrays.clear();
+    m_textureCache.Purge();
+
     // Geometry 정의
        
     // Sphere
     vector<MeshData> meshes = {GeometryGenerator::MakeSphere(0.3f, 100, 100)};
     meshes[0].textureFilename = "ojwD8.jpg";
+    MeshOptimizer::Optimize(meshes[0], "sphere");
+    meshes[0].uvDensity = GeometryGenerator::ComputeUvDensity(meshes[0]);
+    MeshSimplifier::BuildLods(meshes[0], "sphere");
+    MeshletBuilder::Build(meshes[0], "sphere");
+
+    const SceneData sphereScene = SceneData::FromMeshes(std::move(meshes));
+
+    // 버퍼를 만들 때는 view만 사용 (SceneData 또는 캐시 파일을 가리킴)
+    // meshCache는 매핑된 파일을 들고 있으므로 버퍼 생성이 끝날 때까지 유지
+    MeshCache meshCache;
+    SceneView sceneView;
 
     // 3D model 사용 시 파일 위치 지정
-    /* auto meshes =
-         GeometryGenerator::ReadFromFile("C:/Users/.../.../IBL_MediaProject_FEFE/MODEL/", "gear.gltf");*/
+    // 두 번째 실행부터는 .meshcache 파일을 매핑해서 바로 사용
+    /* if (GeometryGenerator::ReadFromFileCached("C:/Users/.../.../IBL_MediaProject_FEFE/MODEL/", "gear.gltf", meshCache))
+         sceneView = meshCache.GetSceneView();*/
+
+    /* if (GeometryGenerator::ReadFromFileCached("C:/Users/.../.../IBL_MediaProject_FEFE/MODEL/dota/", "scene.gltf", meshCache))
+         sceneView = meshCache.GetSceneView();*/
 
-     /*auto meshes =
-         GeometryGenerator::ReadFromFile("C:/Users/.../.../IBL_MediaProject_FEFE/MODEL/dota/", "scene.gltf");*/
+    /* if (GeometryGenerator::ReadFromFileCached("C:/Users/.../.../IBL_MediaProject_FEFE/MODEL/shd/", "High.fbx", meshCache))
+         sceneView = meshCache.GetSceneView();*/
 
-    /*auto meshes =
-        GeometryGenerator::ReadFromFile("C:/Users/.../.../IBL_MediaProject_FEFE/MODEL/shd/", "High.fbx");*/
+    if (sceneView.meshes.empty()) 
+    {
+        sceneView = SceneView::From(sphereScene);
+    }
 
     // ConstantBuffer 만들기 (하나 만들어서 공유)
     m_BasicVertexConstantBufferData.model = Matrix();
@@ -138,60 +542,49 @@ bool ExampleApp::Initialize()
     AppBase::CreateConstantBuffer(m_BasicPixelConstantBufferData,
                                   pixelConstantBuffer);
 
-    for (const auto &meshData : meshes) 
-    {
-        auto newMesh = std::make_shared<Mesh>();
-        AppBase::CreateVertexBuffer(meshData.vertices, newMesh->vertexBuffer);
-        newMesh->m_indexCount = UINT(meshData.indices.size());
-        AppBase::CreateIndexBuffer(meshData.indices, newMesh->indexBuffer);
-
-        if (!meshData.textureFilename.empty()) 
-        {
-
-            cout << meshData.textureFilename << endl;
-            AppBase::CreateTexture(meshData.textureFilename, newMesh->texture,
-                                   newMesh->textureResourceView);
-        }
-
-        newMesh->vertexConstantBuffer = vertexConstantBuffer;
-        newMesh->pixelConstantBuffer = pixelConstantBuffer;
-
-        this->m_meshes.push_back(newMesh);
-    }
-
     // POSITION에 float3를 보낼 경우 내부적으로 마지막에 1을 덧붙여서 float4를 만듦
     // https://learn.microsoft.com/en-us/windows-hardware/drivers/display/supplying-default-values-for-texture-coordinates-in-vertex-declaration
-    vector<D3D11_INPUT_ELEMENT_DESC> basicInputElements = 
-    {
-        {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0,
-         D3D11_INPUT_PER_VERTEX_DATA, 0},
-        {"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 4 * 3,
-         D3D11_INPUT_PER_VERTEX_DATA, 0},
-        {"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 4 * 3 + 4 * 3,
-         D3D11_INPUT_PER_VERTEX_DATA, 0},
-    };
-
-    AppBase::CreateVertexShaderAndInputLayout(
-        L"BasicVertexShader.hlsl", basicInputElements, m_basicVertexShader,
-        m_basicInputLayout);
-
-    AppBase::CreatePixelShader(L"BasicPixelShader.hlsl", m_basicPixelShader);
+    // 압축 형식은 PackedVertexShader에서 원래 값으로 되돌림
+    switch (m_vertexFormat)
+    {
+    case 1:
+        CreateModelMeshes<VertexPacked>(sceneView, vertexConstantBuffer,
+                                        pixelConstantBuffer);
+        break;
+    case 2:
+        CreateModelMeshes<VertexCompact>(sceneView, vertexConstantBuffer,
+                                         pixelConstantBuffer);
+        break;
+    default:
+        CreateModelMeshes<Vertex>(sceneView, vertexConstantBuffer,
+                                  pixelConstantBuffer);
+        break;
+    }
 
     // 노멀 벡터 그리기
-    // InputLayout은 BasicVertexShader와 같이 사용
+    // 모델 버텍스 형식과 관계없이 float Vertex 사용
     m_normalLines = std::make_shared<Mesh>();
 
     std::vector<Vertex> normalVertices;
     std::vector<uint32_t> normalIndices;
 
-    // 여러 메쉬의 normal 들을 하나로 합치기
-    size_t offset = 0;
-    for (const auto &meshData : meshes) 
+    // 여러 인스턴스의 normal 들을 노드 행렬을 적용해서 하나로 합치기
+    const vector<Matrix> world =
+        ComputeWorldTransforms(sceneView.nodes, sceneView.numNodes);
+    std::vector<Vertex> instanceVertices;
+    for (size_t instance = 0; instance < sceneView.numInstances; instance++)
     {
-        for (size_t i = 0; i < meshData.vertices.size(); i++) 
+        const MeshDataView &meshData =
+            sceneView.meshes[sceneView.instances[instance].meshIndex];
+        instanceVertices.assign(meshData.vertices,
+                                meshData.vertices + meshData.numVertices);
+        VertexKernels::TransformVertices(
+            instanceVertices.data(), instanceVertices.size(),
+            world[sceneView.instances[instance].nodeIndex]);
+
+        for (auto v : instanceVertices)
         {
-
-            auto v = meshData.vertices[i];
+            const uint32_t start = uint32_t(normalVertices.size());
 
             v.texcoord.x = 0.0f; // 시작점 표시
             normalVertices.push_back(v);
@@ -199,24 +592,19 @@ bool ExampleApp::Initialize()
             v.texcoord.x = 1.0f; // 끝점 표시
             normalVertices.push_back(v);
 
-            normalIndices.push_back(uint32_t(2 * (i + offset)));
-            normalIndices.push_back(uint32_t(2 * (i + offset) + 1));
+            normalIndices.push_back(start);
+            normalIndices.push_back(start + 1);
         }
-        offset += meshData.vertices.size();
     }
 
     AppBase::CreateVertexBuffer(normalVertices, m_normalLines->vertexBuffer);
+    m_normalLines->m_vertexStride = sizeof(Vertex);
     m_normalLines->m_indexCount = UINT(normalIndices.size());
-    AppBase::CreateIndexBuffer(normalIndices, m_normalLines->indexBuffer);
+    m_normalLines->m_indexFormat =
+        AppBase::CreateIndexBuffer(normalIndices, m_normalLines->indexBuffer);
     AppBase::CreateConstantBuffer(m_normalVertexConstantBufferData,
                                   m_normalLines->vertexConstantBuffer);
-
-    AppBase::CreateVertexShaderAndInputLayout(
-        L"NormalVertexShader.hlsl", basicInputElements, m_normalVertexShader,
-        m_basicInputLayout);
-    AppBase::CreatePixelShader(L"NormalPixelShader.hlsl", m_normalPixelShader);
-
-    return true;
+    m_drawNormalsDirtyFlag = true;
 }
 
 void ExampleApp::Update(float dt) 
@@ -224,24 +612,20 @@ void ExampleApp::Update(float dt)
     
     using namespace DirectX;
 
-    // 모델의 변환
-    m_BasicVertexConstantBufferData.model =
-        Matrix::CreateScale(m_modelScaling) *
-        Matrix::CreateRotationY(m_modelRotation.y) *
-        Matrix::CreateRotationX(m_modelRotation.x) *
-        Matrix::CreateRotationZ(m_modelRotation.z) *
-        Matrix::CreateTranslation(m_modelTranslation);
-
-    m_BasicVertexConstantBufferData.model =
-        m_BasicVertexConstantBufferData.model.Transpose();
-
-    m_BasicVertexConstantBufferData.invTranspose =
-        m_BasicVertexConstantBufferData.model;
-
-    m_BasicVertexConstantBufferData.invTranspose.Translation(Vector3(0.0f));
+    // GUI에서 읽기 설정을 바꿨으면 모델을 다시 만듦
+    if (m_modelDirtyFlag)
+    {
+        CreateModel();
+        m_modelDirtyFlag = false;
+    }
 
-    m_BasicVertexConstantBufferData.invTranspose =
-        m_BasicVertexConstantBufferData.invTranspose.Transpose().Invert();
+    // 모델의 변환
+    // 인스턴스마다 노드 행렬을 앞에 곱해서 Render()에서 올림
+    m_modelMatrix = Matrix::CreateScale(m_modelScaling) *
+                    Matrix::CreateRotationY(m_modelRotation.y) *
+                    Matrix::CreateRotationX(m_modelRotation.x) *
+                    Matrix::CreateRotationZ(m_modelRotation.z) *
+                    Matrix::CreateTranslation(m_modelTranslation);
 
     // 시점 변환
     m_BasicVertexConstantBufferData.view =
@@ -252,6 +636,8 @@ void ExampleApp::Update(float dt)
     m_BasicPixelConstantBufferData.eyeWorld = Vector3::Transform(
         Vector3(0.0f), m_BasicVertexConstantBufferData.view.Invert());
 
+    SelectLods(m_modelMatrix, m_BasicPixelConstantBufferData.eyeWorld);
+
     m_BasicVertexConstantBufferData.view =
         m_BasicVertexConstantBufferData.view.Transpose();
 
@@ -271,15 +657,17 @@ void ExampleApp::Update(float dt)
     m_BasicVertexConstantBufferData.projection =
         m_BasicVertexConstantBufferData.projection.Transpose();
 
-    // Constant를 CPU에서 GPU로 복사
-    // buffer를 공유하기 때문에 하나만 복사
-    if (m_meshes[0]) 
-    {
-        AppBase::UpdateBuffer(m_BasicVertexConstantBufferData,
-                              m_meshes[0]->vertexConstantBuffer);
-    }
+    CullMeshlets(m_modelMatrix,
+                 m_BasicVertexConstantBufferData.view.Transpose() *
+                     m_BasicVertexConstantBufferData.projection.Transpose(),
+                 m_BasicPixelConstantBufferData.eyeWorld);
 
-    // buffer를 공유하기 때문에 하나만 복사
+    if (m_useResidency)
+        UpdateResidency();
+
+    // Constant를 CPU에서 GPU로 복사
+    // 버텍스 상수는 인스턴스마다 행렬이 달라서 Render()에서 복사
+    // 픽셀 상수는 buffer를 공유하기 때문에 하나만 복사
     if (m_meshes[0]) 
     {
         AppBase::UpdateBuffer(m_BasicPixelConstantBufferData,
@@ -309,6 +697,185 @@ void ExampleApp::Update(float dt)
         Vector3(m_materialSpecular);
 }
 
+void ExampleApp::SelectLods(const Matrix &model, const Vector3 &eyeWorld)
+{
+    const float aspect = AppBase::GetAspectRatio();
+    const float tanHalfFovY = std::tan(XMConvertToRadians(m_projFovAngleY) * 0.5f);
+    const float viewportWidth = float(m_screenWidth - m_guiWidth);
+    const float viewportHeight = float(m_screenHeight);
+
+    for (auto &instance : m_instances)
+    {
+        const Mesh &mesh = *instance.mesh;
+        instance.m_lodLevel = 0;
+
+        // 모델 좌표 1만큼이 월드에서 얼마인지 (노드 행렬 포함, 가장 큰 축)
+        const Matrix world = instance.m_transform * model;
+        const float scale = std::max(
+            {Vector3(world._11, world._12, world._13).Length(),
+             Vector3(world._21, world._22, world._23).Length(),
+             Vector3(world._31, world._32, world._33).Length()});
+
+        // 월드 좌표 1만큼이 화면에서 몇 픽셀인지
+        // NDC 세로 [-1, 1]은 tan(fovY/2), 가로는 tan(fovY/2) * aspect
+        float ndcPerUnitY = 1.0f;
+        if (m_usePerspectiveProjection)
+        {
+            const Vector3 center =
+                Vector3::Transform(mesh.m_boundingCenter, world);
+            const float distance =
+                std::max((center - eyeWorld).Length() -
+                             mesh.m_boundingRadius * scale,
+                         m_nearZ);
+            ndcPerUnitY = 1.0f / (distance * tanHalfFovY);
+        }
+        const float ndcPerUnitX = ndcPerUnitY / aspect;
+        const float pixelsPerUnit =
+            std::max(ndcPerUnitX * viewportWidth, ndcPerUnitY * viewportHeight) *
+            0.5f;
+
+        // 텍스춰 mip 선택에도 사용 (UpdateResidency())
+        instance.m_pixelsPerUnit = scale * pixelsPerUnit;
+
+        if (m_useLod && mesh.m_lods.size() > 1)
+        {
+            for (size_t level = 1; level < mesh.m_lods.size(); level++)
+            {
+                if (mesh.m_lods[level].error * instance.m_pixelsPerUnit >
+                    m_lodPixelError)
+                    break;
+                instance.m_lodLevel = level;
+            }
+        }
+    }
+}
+
+void ExampleApp::UpdateResidency()
+{
+    // uv 1만큼이 화면에서 몇 픽셀인지 = (모델 좌표 1당 픽셀) / (모델 좌표 1당 uv)
+    // uv 밀도를 모르면 가장 큰 mip을 요청
+    m_residency.BeginFrame();
+    for (const auto &instance : m_instances)
+    {
+        if (instance.m_drawRanges.empty())
+            continue;
+
+        const Mesh &mesh = *instance.mesh;
+        const float pixelsPerUv =
+            mesh.m_uvDensity > 0.0f
+                ? instance.m_pixelsPerUnit / mesh.m_uvDensity
+                : FLT_MAX;
+        m_residency.Request(mesh.texture.get(), pixelsPerUv);
+        m_residency.Request(mesh.packedTexture.get(), pixelsPerUv);
+    }
+
+    m_residency.EndFrame(
+        m_d3dDevice.Get(), m_d3dContext.Get(),
+        [&](const ImageData &image, ComPtr<ID3D11Texture2D> &texture,
+            ComPtr<ID3D11ShaderResourceView> &resourceView) {
+            AppBase::CreateTexture(image, texture, resourceView);
+        });
+}
+
+void ExampleApp::CullMeshlets(const Matrix &model, const Matrix &viewProj,
+                              const Vector3 &eyeWorld)
+{
+    m_numDrawnTriangles = 0;
+    m_numMeshlets = 0;
+    m_numDrawnMeshlets = 0;
+    m_numDrawCalls = 0;
+
+    for (auto &instance : m_instances)
+    {
+        const Mesh &mesh = *instance.mesh;
+        auto &ranges = instance.m_drawRanges;
+        ranges.clear();
+
+        if (mesh.m_lods.empty())
+        {
+            ranges.push_back({0, mesh.m_indexCount});
+        }
+        else
+        {
+            const MeshLod &lod = mesh.m_lods[instance.m_lodLevel];
+            m_numMeshlets += lod.meshletCount;
+
+            if (!m_useMeshletCulling || lod.meshletCount == 0)
+            {
+                ranges.push_back({lod.indexOffset, lod.indexCount});
+            }
+            else
+            {
+                // 모든 판정은 인스턴스의 모델 좌표에서
+                // (스케일이 균등하지 않으면 근사)
+                const Matrix world = instance.m_transform * model;
+                const Matrix m = world * viewProj;
+
+                // 절두체 평면 (Gribb & Hartmann)
+                // 행 벡터 규약이므로 열을 조합, D3D의 클립 공간은 0 <= z <= w
+                const Vector4 c0(m._11, m._21, m._31, m._41);
+                const Vector4 c1(m._12, m._22, m._32, m._42);
+                const Vector4 c2(m._13, m._23, m._33, m._43);
+                const Vector4 c3(m._14, m._24, m._34, m._44);
+                Vector4 planes[6] = {c3 + c0, c3 - c0, c3 + c1,
+                                     c3 - c1, c2,      c3 - c2};
+                for (auto &plane : planes)
+                    plane /= Vector3(plane.x, plane.y, plane.z).Length();
+
+                auto IsInFrustum = [&](const Vector3 &center, float radius) {
+                    for (const auto &plane : planes)
+                    {
+                        if (plane.x * center.x + plane.y * center.y +
+                                plane.z * center.z + plane.w <
+                            -radius)
+                            return false;
+                    }
+                    return true;
+                };
+
+                // 원근 투영은 눈의 위치, 직교 투영은 보는 방향으로 뒷면 판정
+                const Vector3 eye = Vector3::Transform(eyeWorld, world.Invert());
+                const Matrix invM = m.Invert();
+                Vector3 viewDir =
+                    Vector3::Transform(Vector3(0.0f, 0.0f, 1.0f), invM) -
+                    Vector3::Transform(Vector3(0.0f), invM);
+                viewDir.Normalize();
+
+                if (IsInFrustum(mesh.m_boundingCenter, mesh.m_boundingRadius))
+                {
+                    for (uint32_t i = 0; i < lod.meshletCount; i++)
+                    {
+                        const Meshlet &meshlet =
+                            mesh.m_meshlets[lod.meshletOffset + i];
+
+                        if (!IsInFrustum(meshlet.center, meshlet.radius))
+                            continue;
+                        if (m_usePerspectiveProjection
+                                ? MeshletBuilder::IsBackFacing(meshlet, eye)
+                                : MeshletBuilder::IsBackFacingDirection(meshlet,
+                                                                        viewDir))
+                            continue;
+
+                        m_numDrawnMeshlets++;
+
+                        if (!ranges.empty() &&
+                            ranges.back().first + ranges.back().second ==
+                                meshlet.indexOffset)
+                            ranges.back().second += meshlet.indexCount;
+                        else
+                            ranges.push_back(
+                                {meshlet.indexOffset, meshlet.indexCount});
+                    }
+                }
+            }
+        }
+
+        for (const auto &range : ranges)
+            m_numDrawnTriangles += range.second / 3;
+        m_numDrawCalls += ranges.size();
+    }
+}
+
 void ExampleApp::Render() 
 {
 
@@ -329,16 +896,15 @@ void ExampleApp::Render()
                                   m_d3dDepthStencilView.Get());
     m_d3dContext->OMSetDepthStencilState(m_d3dDepthStencilState.Get(), 0);
 
-    UINT stride = sizeof(Vertex);
     UINT offset = 0;
 
     // 큐브매핑
     m_d3dContext->IASetInputLayout(m_cubeMapping.inputLayout.Get());
     m_d3dContext->IASetVertexBuffers(
-        0, 1, m_cubeMapping.cubeMesh->vertexBuffer.GetAddressOf(), &stride,
-        &offset);
+        0, 1, m_cubeMapping.cubeMesh->vertexBuffer.GetAddressOf(),
+        &m_cubeMapping.cubeMesh->m_vertexStride, &offset);
     m_d3dContext->IASetIndexBuffer(m_cubeMapping.cubeMesh->indexBuffer.Get(),
-                                DXGI_FORMAT_R32_UINT, 0);
+                                m_cubeMapping.cubeMesh->m_indexFormat, 0);
     m_d3dContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
     m_d3dContext->VSSetShader(m_cubeMapping.vertexShader.Get(), 0, 0);
@@ -366,59 +932,151 @@ void ExampleApp::Render()
         m_d3dContext->RSSetState(m_d3dSolidRasterizerSate.Get());
     }
 
-    // 버텍스/인덱스 버퍼 설정
-    for (const auto &mesh : m_meshes)
-    {
-        m_d3dContext->VSSetConstantBuffers(
-            0, 1, mesh->vertexConstantBuffer.GetAddressOf());
+    // 인스턴스마다 모델 행렬을 올리고 그림
+    // 같은 메쉬의 인스턴스라도 LOD와 컬링 결과가 달라서 하나씩 DrawIndexed()
+    auto UpdateModelMatrix = [&](const Matrix &model,
+                                 ComPtr<ID3D11Buffer> &vertexConstantBuffer) {
+        m_BasicVertexConstantBufferData.model = model.Transpose();
+
+        Matrix invTranspose = model;
+        invTranspose.Translation(Vector3(0.0f));
+        m_BasicVertexConstantBufferData.invTranspose = invTranspose.Invert();
 
-        // 물체 렌더링할 때 큐브맵도 같이 사용
-        ID3D11ShaderResourceView *resViews[3] = 
+        AppBase::UpdateBuffer(m_BasicVertexConstantBufferData,
+                              vertexConstantBuffer);
+    };
+
+    ID3D11ShaderResourceView *boundViews[8] = {};
+    m_numTextureBinds = 0;
+    for (auto &instance : m_instances)
+    {
+        auto &mesh = instance.mesh;
+
+        UpdateModelMatrix(instance.m_transform * m_modelMatrix,
+                          mesh->vertexConstantBuffer);
+
+        ID3D11Buffer *vsBuffers[2] = {mesh->vertexConstantBuffer.Get(),
+                                      m_packedVertexConstantBuffer.Get()};
+        m_d3dContext->VSSetConstantBuffers(0, 2, vsBuffers);
+
+        // 물체 렌더링할 때 큐브맵도 같이 사용 (구면 조화 모드는 specular만)
+        // 합친 재질 텍스춰가 없으면 기본값 텍스춰 (AO 1, 거칠기 1, 금속성 0)
+        // 배열로 묶은 텍스춰는 t4/t5, BRDF LUT는 t6, 팔면체 specular는 t7
+        // 같은 배열이면 다시 바인딩하지 않음
+        auto GetArrayView = [&](const shared_ptr<CachedTexture> &texture) {
+            return texture && texture->slot.arrayIndex >= 0
+                       ? m_textureArrays[size_t(texture->slot.arrayIndex)]
+                             .resourceView.Get()
+                       : nullptr;
+        };
+        ID3D11ShaderResourceView *resViews[8] = 
         {
-            mesh->textureResourceView.Get(), m_cubeMapping.diffuseResView.Get(),
-            m_cubeMapping.specularResView.Get()
+            mesh->texture ? mesh->texture->resourceView.Get() : nullptr,
+            m_BasicPixelConstantBufferData.diffuseMode == 0
+                ? m_cubeMapping.diffuseResView.Get()
+                : nullptr,
+            m_cubeMapping.specularResView.Get(),
+            mesh->packedTexture && mesh->packedTexture->resourceView
+                ? mesh->packedTexture->resourceView.Get()
+                : m_defaultPackedResView.Get(),
+            GetArrayView(mesh->texture),
+            GetArrayView(mesh->packedTexture),
+            m_brdfLutResView.Get(),
+            m_specularOctahedralResView.Get()
         };
-        m_d3dContext->PSSetShaderResources(0, 3, resViews);
+        if (!std::equal(resViews, resViews + 8, boundViews))
+        {
+            m_d3dContext->PSSetShaderResources(0, 8, resViews);
+            std::copy(resViews, resViews + 8, boundViews);
+            m_numTextureBinds++;
+        }
 
-        m_d3dContext->PSSetConstantBuffers(
-            0, 1, mesh->pixelConstantBuffer.GetAddressOf());
+        ID3D11Buffer *psBuffers[2] = {mesh->pixelConstantBuffer.Get(),
+                                      mesh->materialConstantBuffer.Get()};
+        m_d3dContext->PSSetConstantBuffers(0, 2, psBuffers);
 
         m_d3dContext->IASetInputLayout(m_basicInputLayout.Get());
         m_d3dContext->IASetVertexBuffers(0, 1, mesh->vertexBuffer.GetAddressOf(),
-                                      &stride, &offset);
+                                      &mesh->m_vertexStride, &offset);
         m_d3dContext->IASetIndexBuffer(mesh->indexBuffer.Get(),
-                                    DXGI_FORMAT_R32_UINT, 0);
+                                    mesh->m_indexFormat, 0);
         m_d3dContext->IASetPrimitiveTopology(
             D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-        m_d3dContext->DrawIndexed(mesh->m_indexCount, 0, 0);
+        for (const auto &range : instance.m_drawRanges)
+            m_d3dContext->DrawIndexed(range.second, range.first, 0);
     }
 
     // 노멀 벡터 그리기
+    // 선분은 노드 행렬을 이미 적용해서 만들었으므로 모델 전체의 변환만 사용
     if (m_drawNormals) 
     {
         m_d3dContext->VSSetShader(m_normalVertexShader.Get(), 0, 0);
 
+        UpdateModelMatrix(m_modelMatrix, m_meshes[0]->vertexConstantBuffer);
+
         ID3D11Buffer *pptr[2] = {m_meshes[0]->vertexConstantBuffer.Get(),
                                  m_normalLines->vertexConstantBuffer.Get()};
         m_d3dContext->VSSetConstantBuffers(0, 2, pptr);
 
         m_d3dContext->PSSetShader(m_normalPixelShader.Get(), 0, 0);
        
+        m_d3dContext->IASetInputLayout(m_normalInputLayout.Get());
         m_d3dContext->IASetVertexBuffers(
-            0, 1, m_normalLines->vertexBuffer.GetAddressOf(), &stride, &offset);
+            0, 1, m_normalLines->vertexBuffer.GetAddressOf(),
+            &m_normalLines->m_vertexStride, &offset);
         m_d3dContext->IASetIndexBuffer(m_normalLines->indexBuffer.Get(),
-                                    DXGI_FORMAT_R32_UINT, 0);
+                                    m_normalLines->m_indexFormat, 0);
         m_d3dContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
         m_d3dContext->DrawIndexed(m_normalLines->m_indexCount, 0, 0);
     }
 }
 
+void ExampleApp::RunChecks()
+{
+    // InitializeCubeMapping()에서 만드는 LUT와 같은 옵션
+    BrdfLut::CheckConvergence();
+
+    VertexKernels::Benchmark(1 << 20);
+    ImageDecoder::Benchmark("./"); // 실행 폴더의 텍스춰 (ojwD8.jpg 등)
+}
+
 void ExampleApp::UpdateGUI() 
 {
 
     ImGui::Checkbox("Use Texture", &m_BasicPixelConstantBufferData.useTexture);
     ImGui::Checkbox("Wireframe", &m_drawAsWire);
     ImGui::Checkbox("Draw Normals", &m_drawNormals);
+
+    // 읽지 못한 큐브맵이나 투영하지 못한 구면 조화로는 바꾸지 않음
+    int &diffuseMode = m_BasicPixelConstantBufferData.diffuseMode;
+    if (ImGui::RadioButton("Diffuse cubemap", diffuseMode == 0))
+    {
+        if (!m_cubeMapping.diffuseResView && !m_diffuseCubemapFilename.empty())
+            LoadCubemap(m_diffuseCubemapFilename.c_str(),
+                        m_cubeMapping.diffuseResView);
+        if (m_cubeMapping.diffuseResView)
+            diffuseMode = 0;
+    }
+    ImGui::SameLine();
+    if (ImGui::RadioButton("Diffuse SH", diffuseMode == 1) && m_hasIrradianceSh)
+        diffuseMode = 1;
+
+    int &specularMode = m_BasicPixelConstantBufferData.specularMode;
+    ImGui::RadioButton("Specular pow", &specularMode, 0);
+    ImGui::SameLine();
+    if (ImGui::RadioButton("Specular split-sum", specularMode == 1) &&
+        CanUseSpecularMode(1))
+        specularMode = 1;
+    ImGui::SameLine();
+    if (ImGui::RadioButton("Octahedral", specularMode == 2))
+    {
+        if (!m_specularOctahedralResView)
+            LoadSpecularOctahedral();
+        if (CanUseSpecularMode(2))
+            specularMode = 2;
+    }
+    ImGui::SliderFloat("Roughness", &m_BasicPixelConstantBufferData.roughness,
+                       0.0f, 1.0f);
     if (ImGui::SliderFloat("Normal scale",
                            &m_normalVertexConstantBufferData.scale, 0.0f,
                            1.0f))
@@ -426,6 +1084,40 @@ void ExampleApp::UpdateGUI()
         m_drawNormalsDirtyFlag = true;
     }
 
+    // 읽을 때 정해지는 설정은 바꾸면 모델을 다시 만듦
+    m_modelDirtyFlag |= ImGui::RadioButton("Vertex 32B", &m_vertexFormat, 0);
+    ImGui::SameLine();
+    m_modelDirtyFlag |= ImGui::RadioButton("Packed 16B", &m_vertexFormat, 1);
+    ImGui::SameLine();
+    m_modelDirtyFlag |= ImGui::RadioButton("Compact 12B", &m_vertexFormat, 2);
+
+    ImGui::Checkbox("Use LOD", &m_useLod);
+    ImGui::SliderFloat("LOD pixel error", &m_lodPixelError, 0.1f, 10.0f);
+    ImGui::Checkbox("Meshlet culling", &m_useMeshletCulling);
+    ImGui::Text("Triangles: %d", int(m_numDrawnTriangles));
+    ImGui::Text("Meshlets: %d / %d, draws: %d", int(m_numDrawnMeshlets),
+                int(m_numMeshlets), int(m_numDrawCalls));
+    ImGui::Text("Texture arrays: %d, binds: %d", int(m_textureArrays.size()),
+                int(m_numTextureBinds));
+    if (m_useResidency)
+    {
+        const ResidencyStats &stats = m_residency.GetStats();
+        int budgetMB = int(stats.budget >> 20);
+        if (ImGui::SliderInt("Texture budget (MB)", &budgetMB, 1, 1024))
+            m_residency.SetBudget(size_t(budgetMB) << 20);
+        ImGui::Text("Resident: %.1f / %.1f MB (requested %.1f MB)",
+                    stats.residentBytes / 1048576.0, stats.budget / 1048576.0,
+                    stats.requestedBytes / 1048576.0);
+        ImGui::Text("Textures: %d / %d resident, %d visible, %d loading",
+                    int(stats.numResident), int(stats.numTextures),
+                    int(stats.numRequested), int(stats.numPendingLoads));
+        ImGui::Text("Dropped levels: %d, pressure %.2f",
+                    int(stats.numDroppedLevels), stats.GetPressure());
+        ImGui::Text("Loads: %d, drops: %d, evictions: %d, over budget: %d",
+                    int(stats.numLoads), int(stats.numDrops),
+                    int(stats.numEvictions), int(stats.numOverBudgetFrames));
+    }
+
     ImGui::SliderFloat3("m_modelRotation", &m_modelRotation.x, -3.14f, 3.14f);
     ImGui::SliderFloat3("m_viewRot", &m_viewRot.x, -3.14f, 3.14f);
     ImGui::SliderFloat3("Material FresnelR0",
@@ -437,6 +1129,22 @@ void ExampleApp::UpdateGUI()
     ImGui::SliderFloat("Material Shininess",
                        &m_BasicPixelConstantBufferData.material.shininess,
                        0.01f, 20.0f);
+
+    // 바꾸면 읽어둔 큐브맵을 다시 읽음
+    if (ImGui::Checkbox("Compress cubemaps (BC6H)", &m_compressCubemaps))
+    {
+        if (m_cubeMapping.diffuseResView)
+            LoadCubemap(m_diffuseCubemapFilename.c_str(),
+                        m_cubeMapping.diffuseResView);
+        LoadCubemap(m_specularCubemapFilename.c_str(),
+                    m_cubeMapping.specularResView);
+        if (m_specularOctahedralResView)
+            LoadSpecularOctahedral();
+    }
+    m_modelDirtyFlag |= ImGui::Checkbox("Batch textures", &m_batchTextures);
+
+    if (ImGui::Button("Run checks"))
+        RunChecks();
 }
 
 } // namespace FEFE
@@ -3,11 +3,14 @@
 #include <algorithm>
 #include <iostream>
 #include <memory>
+#include <string>
 
 #include "DX11AppBase.h"
 #include "GeometryGenerator.h"
 #include "Material.h"
 #include "CubeMapping.h"
+#include "TextureResidency.h"
+#include "VertexFormat.h"
 
 namespace FEFE 
 {
@@ -36,12 +39,29 @@ struct BasicPixelConstantBuffer
     bool useTexture;          // 4
     Material material;        // 48
     bool useSmoothstep = false; // 4
-    float dummy[3];     // 16씩 끝어야함
+    int diffuseMode = 0;        // 4, 0: diffuse 큐브맵, 1: 구면 조화 (irradianceSh)
+    int specularMode = 0;       // 4, 0: pow(평균, shininess), 1: split-sum (BRDF LUT), 2: 1 + 팔면체 맵
+    float roughness = 0.5f;     // 4, split-sum 거칠기 (합친 재질 텍스춰의 G에 곱함)
+    Vector4 irradianceSh[9];    // 144, SphericalHarmonics::ToIrradiance() (w는 사용 안 함)
 };
 
 static_assert((sizeof(BasicPixelConstantBuffer) % 16) == 0,
               "Constant Buffer size must be 16-byte aligned");
 
+// 메쉬마다 다른 재질 값 (메쉬를 만들 때 한 번 올림)
+// slice가 -1이면 Texture2DArray 대신 t0/t3의 텍스춰 하나를 사용
+struct MaterialConstantBuffer
+{
+    Vector4 textureRect = Vector4(1.0f, 1.0f, 0.0f, 0.0f); // xy = 크기, zw = 시작 (아틀라스)
+    Vector4 packedRect = Vector4(1.0f, 1.0f, 0.0f, 0.0f);
+    float textureSlice = -1.0f;
+    float packedSlice = -1.0f;
+    float dummy[2];
+};
+
+static_assert((sizeof(MaterialConstantBuffer) % 16) == 0,
+              "Constant Buffer size must be 16-byte aligned");
+
 struct NormalVertexConstantBuffer 
 {
     float scale = 0.1f;
@@ -60,14 +80,90 @@ class ExampleApp : public AppBase // 상속
 
     void InitializeCubeMapping();
 
+    // float 큐브맵은 BC6H로 압축한 파일 (원본 옆 *.bc6h.dds)을 대신 읽음
+    void LoadCubemap(const wchar_t *filename,
+                     ComPtr<ID3D11ShaderResourceView> &resView);
+
+    // specular 큐브맵을 팔면체 2D 맵 (원본 옆 *.oct.dds)으로 바꿔서 읽음 (t7)
+    void LoadSpecularOctahedral();
+
+    // specularMode에 필요한 텍스춰를 읽었는지 (아니면 검게 그려짐)
+    bool CanUseSpecularMode(int specularMode) const;
+
+    // 구와 모델을 읽어서 메쉬, 텍스춰, 노멀 선분을 만듦
+    // m_vertexFormat 등 읽기 설정을 바꾸면 이전 모델을 해제하고 다시 호출
+    void CreateModel();
+
+    // 개발용 검사와 벤치마크 (콘솔 출력, 끝날 때까지 프레임이 멈춤)
+    void RunChecks();
+
+    // 화면에서의 크기로 인스턴스마다 LOD 선택
+    void SelectLods(const Matrix &model, const Vector3 &eyeWorld);
+
+    // 이번 프레임에 그리는 인스턴스의 텍스춰를 화면 크기로 요청하고 예산 안에서 올림
+    void UpdateResidency();
+
+    // 선택된 LOD의 meshlet 중 시야 안에 있고 앞면이 보이는 것만 남김
+    // viewProj: 전치하기 전 행렬
+    void CullMeshlets(const Matrix &model, const Matrix &viewProj,
+                      const Vector3 &eyeWorld);
+
+    // scene.meshes를 T_VERTEX 형식으로 변환해서 버퍼, 쉐이더, 입력 레이아웃 생성
+    // 노드 계층에서 메쉬를 그릴 위치(인스턴스)도 함께 만듦
+    template <typename T_VERTEX>
+    void CreateModelMeshes(const SceneView &scene,
+                           ComPtr<ID3D11Buffer> &vertexConstantBuffer,
+                           ComPtr<ID3D11Buffer> &pixelConstantBuffer);
+
   protected:
     ComPtr<ID3D11VertexShader> m_basicVertexShader;
     ComPtr<ID3D11PixelShader> m_basicPixelShader;
     ComPtr<ID3D11InputLayout> m_basicInputLayout;
 
+    // 모델 버텍스 형식 (CreateModel()에서 적용, GUI에서 바꾸면 다시 만듦)
+    // 0: Vertex (32 bytes), 1: VertexPacked (16 bytes), 2: VertexCompact (12 bytes)
+    int m_vertexFormat = 0;
+    bool m_modelDirtyFlag = false;
+    PackedVertexConstantBuffer m_packedVertexConstantBufferData;
+    ComPtr<ID3D11Buffer> m_packedVertexConstantBuffer;
+
+    // 디코딩이 끝나고 올리기를 기다리는 텍스춰 최대 개수 (CPU 메모리 상한)
+    size_t m_maxQueuedTextures = 4;
+    // mip 생성과 BC 압축 설정 (압축 결과는 텍스춰 옆 .dds 파일에 캐시)
+    TextureLoadOptions m_textureOptions;
+    // 모델을 여러 개 읽어도 같은 이미지는 한 번만 올림
+    TextureCache m_textureCache;
+    // float 큐브맵을 BC6H로 압축해서 사용 (결과는 원본 옆 .bc6h.dds 파일, GUI에서 켬)
+    bool m_compressCubemaps = false;
+    // 합친 재질 텍스춰(t3)가 없는 메쉬에 대신 바인딩
+    ComPtr<ID3D11Texture2D> m_defaultPackedTexture;
+    ComPtr<ID3D11ShaderResourceView> m_defaultPackedResView;
+
+    // 재질 텍스춰를 Texture2DArray로 묶어서 메쉬마다 다시 바인딩하지 않음
+    // 배열은 한 번에 만들어야 하므로 모든 slice가 모일 때까지 새 텍스춰를 CPU 메모리에
+    // 한 벌 둠 (TextureLoader의 maxQueuedImages 제한보다 큼, 복사본은 만들지 않음)
+    // GUI에서 켜면 모델을 다시 만듦
+    bool m_batchTextures = false;
+    TextureArrayOptions m_textureArrayOptions;
+    struct TextureArray
+    {
+        ComPtr<ID3D11Texture2D> texture;
+        ComPtr<ID3D11ShaderResourceView> resourceView;
+    };
+    std::vector<TextureArray> m_textureArrays; // TextureSlot::arrayIndex
+
+    // 재질 텍스춰를 처음 보일 때 읽고 GPU 메모리 예산 안에서 mip을 조절
+    // 켜면 텍스춰를 배열로 묶지 않음 (m_batchTextures 무시)
+    bool m_useResidency = false;
+    TextureResidency m_residency;
+
     // 하나의 3D 모델이 내부적으로 여러개의 메쉬로 구성
     std::vector<shared_ptr<Mesh>> m_meshes;
 
+    // 같은 메쉬를 여러 노드에서 그릴 수 있음 (버퍼는 m_meshes와 공유)
+    std::vector<MeshRenderInstance> m_instances;
+    Matrix m_modelMatrix; // GUI로 조절하는 모델 전체의 변환
+
     ComPtr<ID3D11SamplerState> m_samplerState;
 
     BasicVertexConstantBuffer m_BasicVertexConstantBufferData;
@@ -83,6 +179,18 @@ class ExampleApp : public AppBase // 상속
     float m_nearZ = 0.01f;
     float m_farZ = 100.0f;
 
+    // LOD 오차가 화면에서 이 픽셀 수 이하인 가장 단순한 LOD 사용
+    bool m_useLod = true;
+    float m_lodPixelError = 1.0f;
+    size_t m_numDrawnTriangles = 0;
+
+    // 절두체 + 노멀 콘 컬링 (MeshletBuilder)
+    bool m_useMeshletCulling = true;
+    size_t m_numMeshlets = 0;
+    size_t m_numDrawnMeshlets = 0;
+    size_t m_numDrawCalls = 0;
+    size_t m_numTextureBinds = 0; // 이번 프레임의 PSSetShaderResources() 횟수
+
    /* int m_lightType = 0;
     Light m_lightFromGUI;*/
     float m_materialDiffuse = 1.0f;
@@ -91,7 +199,7 @@ class ExampleApp : public AppBase // 상속
     // 노멀 벡터 그리기
     ComPtr<ID3D11VertexShader> m_normalVertexShader;
     ComPtr<ID3D11PixelShader> m_normalPixelShader;
-    // ComPtr<ID3D11InputLayout> m_normalInputLayout; // 다른 쉐이더와 같이 사용
+    ComPtr<ID3D11InputLayout> m_normalInputLayout; // 노멀 선분은 항상 Vertex
 
     shared_ptr<Mesh> m_normalLines;
     NormalVertexConstantBuffer m_normalVertexConstantBufferData;
@@ -100,6 +208,18 @@ class ExampleApp : public AppBase // 상속
 
     // 큐브 매핑
     CubeMapping m_cubeMapping;
+    // diffuse 큐브맵은 diffuseMode 0일 때 읽음 (구면 조화로 시작하면 GUI에서 고를 때)
+    // 환경에 맞는 diffuse 큐브맵이 없으면 비어 있음 (구면 조화만 사용)
+    std::wstring m_diffuseCubemapFilename;
+    // 환경 큐브맵을 구면 조화로 투영했는지 (아니면 diffuseMode 1을 고를 수 없음)
+    bool m_hasIrradianceSh = false;
+    // specularMode 2에서 처음 읽음 (OctahedralEnvMap, 큐브맵보다 작고 배열로 묶기 쉬움)
+    std::wstring m_specularCubemapFilename;
+    ComPtr<ID3D11Texture2D> m_specularOctahedralTexture;
+    ComPtr<ID3D11ShaderResourceView> m_specularOctahedralResView;
+    // split-sum의 (scale, bias), 없거나 옵션이 바뀌면 BrdfLut로 새로 만듦
+    ComPtr<ID3D11Texture2D> m_brdfLutTexture;
+    ComPtr<ID3D11ShaderResourceView> m_brdfLutResView;
 
 }; 
 } // namespace FEFE
\ No newline at end of file
@@ -0,0 +1,516 @@
+﻿#include "DdsFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "MappedFile.h"
+
+namespace FEFE
+{
+
+namespace
+{
+
+const uint32_t ddsMagic = 0x20534444; // "DDS "
+
+constexpr uint32_t MakeFourCC(char a, char b, char c, char d)
+{
+    return uint32_t(uint8_t(a)) | (uint32_t(uint8_t(b)) << 8) |
+           (uint32_t(uint8_t(c)) << 16) | (uint32_t(uint8_t(d)) << 24);
+}
+
+// dwReserved1에 쓰는 표시 (이 프로그램이 만든 캐시 파일인지 확인)
+const uint32_t writerFourCC = MakeFourCC('F', 'E', 'F', 'E');
+
+const uint32_t ddsdCaps = 0x1;
+const uint32_t ddsdHeight = 0x2;
+const uint32_t ddsdWidth = 0x4;
+const uint32_t ddsdPitch = 0x8;
+const uint32_t ddsdPixelFormat = 0x1000;
+const uint32_t ddsdMipMapCount = 0x20000;
+const uint32_t ddsdLinearSize = 0x80000;
+
+const uint32_t ddpfAlphaPixels = 0x1;
+const uint32_t ddpfFourCC = 0x4;
+const uint32_t ddpfRgb = 0x40;
+const uint32_t ddpfLuminance = 0x20000;
+
+const uint32_t ddsCapsComplex = 0x8;
+const uint32_t ddsCapsTexture = 0x1000;
+const uint32_t ddsCapsMipMap = 0x400000;
+const uint32_t ddsCaps2Cubemap = 0xFE00; // CUBEMAP | 모든 면
+
+const uint32_t dimensionTexture2D = 3;
+const uint32_t miscTextureCube = 0x4;
+
+struct DdsPixelFormat
+{
+    uint32_t size;
+    uint32_t flags;
+    uint32_t fourCC;
+    uint32_t rgbBitCount;
+    uint32_t rBitMask;
+    uint32_t gBitMask;
+    uint32_t bBitMask;
+    uint32_t aBitMask;
+};
+
+struct DdsHeader
+{
+    uint32_t size;
+    uint32_t flags;
+    uint32_t height;
+    uint32_t width;
+    uint32_t pitchOrLinearSize;
+    uint32_t depth;
+    uint32_t mipMapCount;
+    uint32_t reserved1[11];
+    DdsPixelFormat pixelFormat;
+    uint32_t caps;
+    uint32_t caps2;
+    uint32_t caps3;
+    uint32_t caps4;
+    uint32_t reserved2;
+};
+
+struct DdsHeaderDx10
+{
+    uint32_t dxgiFormat;
+    uint32_t resourceDimension;
+    uint32_t miscFlag;
+    uint32_t arraySize;
+    uint32_t miscFlags2;
+};
+
+static_assert(sizeof(DdsHeader) == 124, "DDS_HEADER layout");
+static_assert(sizeof(DdsHeaderDx10) == 20, "DDS_HEADER_DXT10 layout");
+
+// DX10 헤더가 없는 예전 파일
+// FourCC는 BC 형식이나 D3DFORMAT 번호 (float 형식)
+uint32_t FormatFromFourCC(uint32_t fourCC)
+{
+    switch (fourCC)
+    {
+    case MakeFourCC('D', 'X', 'T', '1'):
+        return DxgiFormat::BC1_Unorm;
+    case MakeFourCC('D', 'X', 'T', '2'):
+    case MakeFourCC('D', 'X', 'T', '3'):
+        return DxgiFormat::BC2_Unorm;
+    case MakeFourCC('D', 'X', 'T', '4'):
+    case MakeFourCC('D', 'X', 'T', '5'):
+        return DxgiFormat::BC3_Unorm;
+    case MakeFourCC('A', 'T', 'I', '1'):
+    case MakeFourCC('B', 'C', '4', 'U'):
+        return DxgiFormat::BC4_Unorm;
+    case MakeFourCC('B', 'C', '4', 'S'):
+        return DxgiFormat::BC4_Snorm;
+    case MakeFourCC('A', 'T', 'I', '2'):
+    case MakeFourCC('B', 'C', '5', 'U'):
+        return DxgiFormat::BC5_Unorm;
+    case MakeFourCC('B', 'C', '5', 'S'):
+        return DxgiFormat::BC5_Snorm;
+    case 111: // D3DFMT_R16F
+        return DxgiFormat::R16_Float;
+    case 112: // D3DFMT_G16R16F
+        return DxgiFormat::R16G16_Float;
+    case 113: // D3DFMT_A16B16G16R16F
+        return DxgiFormat::R16G16B16A16_Float;
+    case 114: // D3DFMT_R32F
+        return DxgiFormat::R32_Float;
+    case 115: // D3DFMT_G32R32F
+        return DxgiFormat::R32G32_Float;
+    case 116: // D3DFMT_A32B32G32R32F
+        return DxgiFormat::R32G32B32A32_Float;
+    default:
+        return DxgiFormat::Unknown;
+    }
+}
+
+// 비트 마스크로 표시한 예전 8비트 형식
+uint32_t FormatFromMasks(const DdsPixelFormat &pf)
+{
+    if ((pf.flags & ddpfRgb) && pf.rgbBitCount == 32)
+    {
+        if (pf.rBitMask == 0x000000FF && pf.gBitMask == 0x0000FF00 &&
+            pf.bBitMask == 0x00FF0000)
+            return DxgiFormat::R8G8B8A8_Unorm;
+        if (pf.rBitMask == 0x00FF0000 && pf.gBitMask == 0x0000FF00 &&
+            pf.bBitMask == 0x000000FF)
+        {
+            return (pf.flags & ddpfAlphaPixels) ? DxgiFormat::B8G8R8A8_Unorm
+                                                : DxgiFormat::B8G8R8X8_Unorm;
+        }
+    }
+    if ((pf.flags & ddpfLuminance) && pf.rgbBitCount == 8)
+        return DxgiFormat::R8_Unorm;
+    if ((pf.flags & ddpfLuminance) && pf.rgbBitCount == 16 &&
+        (pf.flags & ddpfAlphaPixels))
+        return DxgiFormat::R8G8_Unorm;
+    return DxgiFormat::Unknown;
+}
+
+} // namespace
+
+size_t DdsFile::GetBlockSize(uint32_t format)
+{
+    switch (format)
+    {
+    case DxgiFormat::BC1_Unorm:
+    case DxgiFormat::BC1_Unorm_Srgb:
+    case DxgiFormat::BC4_Unorm:
+    case DxgiFormat::BC4_Snorm:
+        return 8;
+    case DxgiFormat::BC2_Unorm:
+    case DxgiFormat::BC2_Unorm_Srgb:
+    case DxgiFormat::BC3_Unorm:
+    case DxgiFormat::BC3_Unorm_Srgb:
+    case DxgiFormat::BC5_Unorm:
+    case DxgiFormat::BC5_Snorm:
+    case DxgiFormat::BC6H_UF16:
+    case DxgiFormat::BC6H_SF16:
+    case DxgiFormat::BC7_Unorm:
+    case DxgiFormat::BC7_Unorm_Srgb:
+        return 16;
+    default:
+        return 0;
+    }
+}
+
+size_t DdsFile::GetPixelSize(uint32_t format)
+{
+    switch (format)
+    {
+    case DxgiFormat::R32G32B32A32_Float:
+        return 16;
+    case DxgiFormat::R32G32B32_Float:
+        return 12;
+    case DxgiFormat::R16G16B16A16_Float:
+    case DxgiFormat::R32G32_Float:
+        return 8;
+    case DxgiFormat::R11G11B10_Float:
+    case DxgiFormat::R8G8B8A8_Unorm:
+    case DxgiFormat::R8G8B8A8_Unorm_Srgb:
+    case DxgiFormat::R16G16_Float:
+    case DxgiFormat::R32_Float:
+    case DxgiFormat::B8G8R8A8_Unorm:
+    case DxgiFormat::B8G8R8X8_Unorm:
+    case DxgiFormat::B8G8R8A8_Unorm_Srgb:
+        return 4;
+    case DxgiFormat::R8G8_Unorm:
+    case DxgiFormat::R16_Float:
+        return 2;
+    case DxgiFormat::R8_Unorm:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+const char *DdsFile::GetFormatName(uint32_t format)
+{
+    switch (format)
+    {
+    case DxgiFormat::R32G32B32A32_Float: return "R32G32B32A32_FLOAT";
+    case DxgiFormat::R32G32B32_Float: return "R32G32B32_FLOAT";
+    case DxgiFormat::R16G16B16A16_Float: return "R16G16B16A16_FLOAT";
+    case DxgiFormat::R32G32_Float: return "R32G32_FLOAT";
+    case DxgiFormat::R11G11B10_Float: return "R11G11B10_FLOAT";
+    case DxgiFormat::R8G8B8A8_Unorm: return "R8G8B8A8_UNORM";
+    case DxgiFormat::R8G8B8A8_Unorm_Srgb: return "R8G8B8A8_UNORM_SRGB";
+    case DxgiFormat::R16G16_Float: return "R16G16_FLOAT";
+    case DxgiFormat::R32_Float: return "R32_FLOAT";
+    case DxgiFormat::R8G8_Unorm: return "R8G8_UNORM";
+    case DxgiFormat::R16_Float: return "R16_FLOAT";
+    case DxgiFormat::R8_Unorm: return "R8_UNORM";
+    case DxgiFormat::BC1_Unorm: return "BC1_UNORM";
+    case DxgiFormat::BC1_Unorm_Srgb: return "BC1_UNORM_SRGB";
+    case DxgiFormat::BC2_Unorm: return "BC2_UNORM";
+    case DxgiFormat::BC2_Unorm_Srgb: return "BC2_UNORM_SRGB";
+    case DxgiFormat::BC3_Unorm: return "BC3_UNORM";
+    case DxgiFormat::BC3_Unorm_Srgb: return "BC3_UNORM_SRGB";
+    case DxgiFormat::BC4_Unorm: return "BC4_UNORM";
+    case DxgiFormat::BC4_Snorm: return "BC4_SNORM";
+    case DxgiFormat::BC5_Unorm: return "BC5_UNORM";
+    case DxgiFormat::BC5_Snorm: return "BC5_SNORM";
+    case DxgiFormat::B8G8R8A8_Unorm: return "B8G8R8A8_UNORM";
+    case DxgiFormat::B8G8R8X8_Unorm: return "B8G8R8X8_UNORM";
+    case DxgiFormat::B8G8R8A8_Unorm_Srgb: return "B8G8R8A8_UNORM_SRGB";
+    case DxgiFormat::BC6H_UF16: return "BC6H_UF16";
+    case DxgiFormat::BC6H_SF16: return "BC6H_SF16";
+    case DxgiFormat::BC7_Unorm: return "BC7_UNORM";
+    case DxgiFormat::BC7_Unorm_Srgb: return "BC7_UNORM_SRGB";
+    default: return "UNKNOWN";
+    }
+}
+
+size_t DdsFile::GetRowPitch(uint32_t format, uint32_t width)
+{
+    const size_t blockSize = GetBlockSize(format);
+    if (blockSize > 0)
+        return std::max<size_t>((width + 3) / 4, 1) * blockSize;
+    return size_t(width) * GetPixelSize(format);
+}
+
+size_t DdsFile::GetNumRows(uint32_t format, uint32_t height)
+{
+    if (GetBlockSize(format) > 0)
+        return std::max<size_t>((height + 3) / 4, 1);
+    return height;
+}
+
+size_t DdsFile::GetLevelSize(uint32_t format, uint32_t width, uint32_t height)
+{
+    return GetRowPitch(format, width) * GetNumRows(format, height);
+}
+
+size_t DdsFile::GetDataSize(const DdsDesc &desc)
+{
+    size_t size = 0;
+    for (uint32_t level = 0; level < desc.mipLevels; level++)
+    {
+        size += GetLevelSize(desc.format, std::max(desc.width >> level, 1u),
+                             std::max(desc.height >> level, 1u));
+    }
+    return size * desc.arraySize;
+}
+
+bool DdsFile::Write(const std::string &filename, const DdsDesc &desc,
+                    const uint8_t *data, size_t size, uint32_t writerVersion)
+{
+    if (GetRowPitch(desc.format, 1) == 0 || size != GetDataSize(desc))
+    {
+        std::cout << "DdsFile::Write() invalid format or size: " << filename
+                  << std::endl;
+        return false;
+    }
+
+    DdsHeader header = {};
+    header.size = sizeof(DdsHeader);
+    header.flags = ddsdCaps | ddsdHeight | ddsdWidth | ddsdPixelFormat |
+                   ddsdMipMapCount |
+                   (GetBlockSize(desc.format) ? ddsdLinearSize : ddsdPitch);
+    header.height = desc.height;
+    header.width = desc.width;
+    header.pitchOrLinearSize = uint32_t(
+        GetBlockSize(desc.format) ? GetLevelSize(desc.format, desc.width, desc.height)
+                                  : GetRowPitch(desc.format, desc.width));
+    header.depth = 1;
+    header.mipMapCount = desc.mipLevels;
+    header.reserved1[0] = writerFourCC;
+    header.reserved1[1] = writerVersion;
+    header.pixelFormat.size = sizeof(DdsPixelFormat);
+    header.pixelFormat.flags = ddpfFourCC;
+    header.pixelFormat.fourCC = MakeFourCC('D', 'X', '1', '0');
+    header.caps = ddsCapsTexture;
+    if (desc.mipLevels > 1)
+        header.caps |= ddsCapsComplex | ddsCapsMipMap;
+    if (desc.cubemap)
+    {
+        header.caps |= ddsCapsComplex;
+        header.caps2 = ddsCaps2Cubemap;
+    }
+
+    DdsHeaderDx10 dx10 = {};
+    dx10.dxgiFormat = desc.format;
+    dx10.resourceDimension = dimensionTexture2D;
+    dx10.miscFlag = desc.cubemap ? miscTextureCube : 0;
+    dx10.arraySize = desc.cubemap ? desc.arraySize / 6 : desc.arraySize;
+
+    // 쓰는 도중에 실패해도 읽는 쪽이 깨진 파일을 보지 않도록 임시 파일에 쓰고 이름 변경
+    const std::string tempFilename = filename + ".tmp";
+    {
+        std::ofstream file(tempFilename, std::ios::binary);
+        if (!file)
+        {
+            std::cout << "DdsFile::Write() failed to open " << tempFilename
+                      << std::endl;
+            return false;
+        }
+        file.write(reinterpret_cast<const char *>(&ddsMagic), 4);
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(&dx10), sizeof(dx10));
+        file.write(reinterpret_cast<const char *>(data), size);
+        if (!file)
+        {
+            std::cout << "DdsFile::Write() failed: " << tempFilename
+                      << std::endl;
+            return false;
+        }
+    }
+
+    std::remove(filename.c_str());
+    if (std::rename(tempFilename.c_str(), filename.c_str()) != 0)
+    {
+        std::remove(tempFilename.c_str());
+        return false;
+    }
+    return true;
+}
+
+namespace
+{
+
+// 헤더를 읽고 데이터가 시작하는 위치를 돌려줌 (0이면 실패)
+// 헤더가 말하는 데이터가 파일(limit 바이트)에 들어가는지 (오버플로 없이)
+bool FitsInFile(const DdsDesc &desc, size_t limit)
+{
+    size_t size = 0;
+    for (uint32_t level = 0; level < desc.mipLevels; level++)
+    {
+        const uint32_t width = std::max(desc.width >> level, 1u);
+        const uint32_t height = std::max(desc.height >> level, 1u);
+        const size_t rowPitch = DdsFile::GetRowPitch(desc.format, width);
+        const size_t numRows = DdsFile::GetNumRows(desc.format, height);
+        if (rowPitch > limit / numRows)
+            return false;
+        size += rowPitch * numRows;
+        if (size > limit)
+            return false;
+    }
+    return desc.arraySize > 0 && size <= limit / desc.arraySize;
+}
+
+size_t ParseHeader(const uint8_t *p, size_t fileSize, DdsDesc &desc)
+{
+    size_t offset = 4 + sizeof(DdsHeader);
+    if (fileSize < offset)
+        return 0;
+
+    uint32_t magic;
+    DdsHeader header;
+    std::memcpy(&magic, p, 4);
+    std::memcpy(&header, p + 4, sizeof(header));
+    if (magic != ddsMagic || header.size != sizeof(DdsHeader))
+        return 0;
+
+    desc = DdsDesc();
+    desc.width = header.width;
+    desc.height = header.height;
+    desc.mipLevels = std::max(header.mipMapCount, 1u);
+    desc.cubemap = (header.caps2 & 0x200) != 0;
+    desc.arraySize = desc.cubemap ? 6 : 1;
+    if (header.reserved1[0] == writerFourCC)
+        desc.writerVersion = header.reserved1[1];
+
+    if (header.pixelFormat.fourCC == MakeFourCC('D', 'X', '1', '0'))
+    {
+        if (fileSize < offset + sizeof(DdsHeaderDx10))
+            return 0;
+        DdsHeaderDx10 dx10;
+        std::memcpy(&dx10, p + offset, sizeof(dx10));
+        offset += sizeof(dx10);
+
+        if (dx10.resourceDimension != dimensionTexture2D)
+            return 0;
+        desc.format = dx10.dxgiFormat;
+        desc.cubemap = (dx10.miscFlag & miscTextureCube) != 0;
+        desc.arraySize = std::max(dx10.arraySize, 1u) * (desc.cubemap ? 6 : 1);
+    }
+    else if (header.pixelFormat.flags & ddpfFourCC)
+    {
+        desc.format = FormatFromFourCC(header.pixelFormat.fourCC);
+    }
+    else
+    {
+        desc.format = FormatFromMasks(header.pixelFormat);
+    }
+
+    if (DdsFile::GetRowPitch(desc.format, 1) == 0 || desc.width == 0 ||
+        desc.height == 0)
+        return 0;
+
+    // 밉 개수는 floor(log2(max(w, h))) + 1 까지만
+    uint32_t maxLevels = 1;
+    for (uint32_t size = std::max(desc.width, desc.height); size > 1; size >>= 1)
+        maxLevels++;
+    desc.mipLevels = std::min(desc.mipLevels, maxLevels);
+
+    if (!FitsInFile(desc, fileSize - offset))
+        return 0;
+    return offset;
+}
+
+} // namespace
+
+bool DdsFile::ReadDesc(const std::string &filename, DdsDesc &desc)
+{
+    MappedFile file;
+    return file.Open(filename) &&
+           ParseHeader(file.GetData(), file.GetSize(), desc) > 0;
+}
+
+bool DdsFile::Read(const std::string &filename, DdsDesc &desc,
+                   std::vector<uint8_t> &data)
+{
+    DdsImage image;
+    if (!image.Open(filename))
+        return false;
+
+    desc = image.GetDesc();
+    data.assign(image.GetData(), image.GetData() + image.GetDataSize());
+    return true;
+}
+
+bool DdsImage::Open(const std::string &filename)
+{
+    Close();
+
+    if (!m_file.Open(filename))
+        return false;
+
+    const size_t offset = ParseHeader(m_file.GetData(), m_file.GetSize(), m_desc);
+    if (offset == 0)
+    {
+        std::cout << "DdsImage::Open() unsupported format: " << filename
+                  << std::endl;
+        Close();
+        return false;
+    }
+
+    m_dataSize = DdsFile::GetDataSize(m_desc);
+    if (m_file.GetSize() < offset + m_dataSize)
+    {
+        std::cout << "DdsImage::Open() truncated file: " << filename
+                  << std::endl;
+        Close();
+        return false;
+    }
+    m_data = m_file.GetData() + offset;
+
+    // 파일 안의 위치만 계산 (복사 X)
+    m_subresources.reserve(size_t(m_desc.arraySize) * m_desc.mipLevels);
+    size_t position = 0;
+    for (uint32_t item = 0; item < m_desc.arraySize; item++)
+    {
+        for (uint32_t level = 0; level < m_desc.mipLevels; level++)
+        {
+            const uint32_t width = std::max(m_desc.width >> level, 1u);
+            const uint32_t height = std::max(m_desc.height >> level, 1u);
+
+            DdsSubresource subresource;
+            subresource.data = m_data + position;
+            subresource.rowPitch =
+                uint32_t(DdsFile::GetRowPitch(m_desc.format, width));
+            subresource.slicePitch =
+                uint32_t(DdsFile::GetLevelSize(m_desc.format, width, height));
+            m_subresources.push_back(subresource);
+
+            position += subresource.slicePitch;
+        }
+    }
+    return true;
+}
+
+void DdsImage::Close()
+{
+    m_file.Close();
+    m_desc = DdsDesc();
+    m_data = nullptr;
+    m_dataSize = 0;
+    m_subresources.clear();
+}
+
+} // namespace FEFE
@@ -0,0 +1,146 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+
+namespace FEFE
+{
+
+// DXGI_FORMAT 값 (d3d11.h 없이 빌드할 수 있도록 필요한 것만)
+namespace DxgiFormat
+{
+const uint32_t Unknown = 0;
+const uint32_t R32G32B32A32_Float = 2;
+const uint32_t R32G32B32_Float = 6;
+const uint32_t R16G16B16A16_Float = 10;
+const uint32_t R32G32_Float = 16;
+const uint32_t R11G11B10_Float = 26;
+const uint32_t R8G8B8A8_Unorm = 28;
+const uint32_t R8G8B8A8_Unorm_Srgb = 29;
+const uint32_t R16G16_Float = 34;
+const uint32_t R32_Float = 41;
+const uint32_t R8G8_Unorm = 49;
+const uint32_t R16_Float = 54;
+const uint32_t R8_Unorm = 61;
+const uint32_t BC1_Unorm = 71;
+const uint32_t BC1_Unorm_Srgb = 72;
+const uint32_t BC2_Unorm = 74;
+const uint32_t BC2_Unorm_Srgb = 75;
+const uint32_t BC3_Unorm = 77;
+const uint32_t BC3_Unorm_Srgb = 78;
+const uint32_t BC4_Unorm = 80;
+const uint32_t BC4_Snorm = 81;
+const uint32_t BC5_Unorm = 83;
+const uint32_t BC5_Snorm = 84;
+const uint32_t B8G8R8A8_Unorm = 87;
+const uint32_t B8G8R8X8_Unorm = 88;
+const uint32_t B8G8R8A8_Unorm_Srgb = 91;
+const uint32_t BC6H_UF16 = 95;
+const uint32_t BC6H_SF16 = 96;
+const uint32_t BC7_Unorm = 98;
+const uint32_t BC7_Unorm_Srgb = 99;
+} // namespace DxgiFormat
+
+struct DdsDesc
+{
+    uint32_t format = DxgiFormat::Unknown;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t mipLevels = 1;
+    uint32_t arraySize = 1; // 큐브맵이면 면 개수 (6의 배수, 큐브맵 배열이면 6 * n)
+    bool cubemap = false;
+
+    // DdsFile::Write()에 넘긴 값 (다른 프로그램이 쓴 파일이면 0)
+    uint32_t writerVersion = 0;
+};
+
+// 파일 안의 subresource 하나 (배열 원소 하나의 mip 레벨 하나)
+// D3D11_SUBRESOURCE_DATA와 같은 배치라서 배열째로 CreateTexture2D()에 넘길 수 있음
+// (DX11AppBase.cpp에서 static_assert로 확인)
+struct DdsSubresource
+{
+    const void *data;
+    uint32_t rowPitch;   // 한 줄 (BC 형식은 블록 한 줄)
+    uint32_t slicePitch; // 레벨 전체
+};
+
+// DDS 파일 읽기/쓰기 (DX10 확장 헤더, 예전 헤더는 읽기만)
+// 데이터는 배열 원소(큐브맵 면)마다 mip 0, 1, ... 순서로 빈틈없이 이어짐
+// d3d11.h 없이 빌드되므로 CPU 도구(압축, 변환, 생성)에서도 사용
+class DdsFile
+{
+  public:
+    // BC 형식이면 4x4 블록 하나의 바이트 수, 아니면 0
+    static size_t GetBlockSize(uint32_t format);
+
+    // 픽셀 하나의 바이트 수 (BC 형식이면 0)
+    static size_t GetPixelSize(uint32_t format);
+
+    // 한 줄(BC 형식은 블록 한 줄)의 바이트 수와 줄 수
+    static size_t GetRowPitch(uint32_t format, uint32_t width);
+    static size_t GetNumRows(uint32_t format, uint32_t height);
+
+    static size_t GetLevelSize(uint32_t format, uint32_t width,
+                               uint32_t height);
+
+    // 모든 배열 원소와 mip 레벨의 전체 크기
+    static size_t GetDataSize(const DdsDesc &desc);
+
+    // 로그/도구 출력용 이름 ("BC7_UNORM", ...), 모르는 형식이면 "UNKNOWN"
+    static const char *GetFormatName(uint32_t format);
+
+    static bool Write(const std::string &filename, const DdsDesc &desc,
+                      const uint8_t *data, size_t size, uint32_t writerVersion);
+
+    // 데이터를 data로 복사 (수정하거나 파일보다 오래 쓸 때)
+    // 복사가 필요 없으면 DdsImage 사용
+    static bool Read(const std::string &filename, DdsDesc &desc,
+                     std::vector<uint8_t> &data);
+
+    // 헤더만 읽음 (지원하지 않는 형식이면 false)
+    static bool ReadDesc(const std::string &filename, DdsDesc &desc);
+};
+
+// 메모리 매핑한 DDS 파일, 데이터를 복사하지 않고 파일 안을 그대로 가리킴
+//
+// DdsImage image;
+// if (image.Open(filename))
+//     device->CreateTexture2D(&desc, (const D3D11_SUBRESOURCE_DATA *)
+//                                        image.GetSubresources(), ...);
+class DdsImage
+{
+  public:
+    bool Open(const std::string &filename);
+    void Close();
+
+    bool IsOpen() const { return m_file.IsOpen(); }
+    const DdsDesc &GetDesc() const { return m_desc; }
+
+    // 헤더 뒤의 전체 데이터 (DdsFile::GetDataSize() 바이트)
+    const uint8_t *GetData() const { return m_data; }
+    size_t GetDataSize() const { return m_dataSize; }
+
+    // D3D11 subresource 순서 (item * mipLevels + level)
+    const DdsSubresource *GetSubresources() const
+    {
+        return m_subresources.data();
+    }
+    size_t GetNumSubresources() const { return m_subresources.size(); }
+    const DdsSubresource &GetSubresource(uint32_t item, uint32_t level) const
+    {
+        return m_subresources[size_t(item) * m_desc.mipLevels + level];
+    }
+
+  private:
+    MappedFile m_file;
+    DdsDesc m_desc;
+    const uint8_t *m_data = nullptr;
+    size_t m_dataSize = 0;
+    std::vector<DdsSubresource> m_subresources;
+};
+
+} // namespace FEFE
@@ -0,0 +1,360 @@
+﻿#include "EquirectConverter.h"
+
+#include "stb_image.h" // .hdr (구현은 TextureLoader.cpp)
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+
+#include "BlockCompressor.h"
+#include "DdsFile.h"
+#include "TextureLoader.h"
+#include "ThreadPool.h"
+
+// VertexKernels.cpp와 같은 기준 (x64는 항상 SSE2)
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FEFE_EQUIRECT_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace FEFE
+{
+
+namespace
+{
+
+// 결과 파일 형식이나 필터가 바뀌면 올려서 예전 파일을 다시 만듦
+const uint32_t equirectVersion = 1;
+
+const float pi = 3.14159265358979f;
+
+// Area 필터의 한 축 서브샘플 최대 개수
+const int maxSubsamples = 8;
+
+struct Panorama
+{
+    int width;
+    int height;
+    const float *rgba;
+};
+
+std::string GetExtension(const std::string &filename)
+{
+    std::string extension = std::filesystem::path(filename).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return char(std::tolower(c)); });
+    return extension;
+}
+
+// 가로는 반복, 세로는 clamp
+void SampleBilinear(const Panorama &panorama, float u, float v, float weight,
+                    float *sum)
+{
+    const float x = u * float(panorama.width) - 0.5f;
+    const float y = std::clamp(v * float(panorama.height) - 0.5f, 0.0f,
+                               float(panorama.height - 1));
+    const float floorX = std::floor(x);
+    const float fx = x - floorX;
+    int x0 = int(floorX) % panorama.width;
+    if (x0 < 0)
+        x0 += panorama.width;
+    const int x1 = x0 + 1 < panorama.width ? x0 + 1 : 0;
+    const int y0 = int(y);
+    const int y1 = std::min(y0 + 1, panorama.height - 1);
+    const float fy = y - float(y0);
+
+    const float *p00 = panorama.rgba + (size_t(y0) * panorama.width + x0) * 4;
+    const float *p10 = panorama.rgba + (size_t(y0) * panorama.width + x1) * 4;
+    const float *p01 = panorama.rgba + (size_t(y1) * panorama.width + x0) * 4;
+    const float *p11 = panorama.rgba + (size_t(y1) * panorama.width + x1) * 4;
+    for (int ch = 0; ch < 3; ch++)
+    {
+        const float top = p00[ch] + (p10[ch] - p00[ch]) * fx;
+        const float bottom = p01[ch] + (p11[ch] - p01[ch]) * fx;
+        sum[ch] += (top + (bottom - top) * fy) * weight;
+    }
+}
+
+// 정규화된 방향 -> 파노라마 좌표
+inline void SampleDirection(const Panorama &panorama, float x, float y,
+                            float z, float weight, float *sum)
+{
+    const float u = 0.5f + std::atan2(x, z) * (0.5f / pi);
+    const float v = std::acos(std::clamp(y, -1.0f, 1.0f)) * (1.0f / pi);
+    SampleBilinear(panorama, u, v, weight, sum);
+}
+
+void ConvertRow(const Panorama &panorama, int face, int y, int size,
+                int subsamples, float *row)
+{
+    float axes[3][3];
+    FloatCubemap::GetFaceAxes(face, axes);
+
+    const float texelSize = 2.0f / float(size);
+    const float weight = 1.0f / float(subsamples * subsamples);
+    std::fill(row, row + size_t(size) * 4, 0.0f);
+
+    for (int sy = 0; sy < subsamples; sy++)
+    {
+        const float v =
+            (float(y) + (float(sy) + 0.5f) / float(subsamples)) * texelSize -
+            1.0f;
+        // 방향 = u * axes[i][0] + (v * axes[i][1] + axes[i][2])
+        float base[3];
+        for (int i = 0; i < 3; i++)
+            base[i] = v * axes[i][1] + axes[i][2];
+
+        for (int sx = 0; sx < subsamples; sx++)
+        {
+            const float offset = (float(sx) + 0.5f) / float(subsamples);
+            int x = 0;
+
+#ifdef FEFE_EQUIRECT_SSE2
+            const __m128 one = _mm_set1_ps(1.0f);
+            for (; x + 4 <= size; x += 4)
+            {
+                const __m128 u = _mm_sub_ps(
+                    _mm_mul_ps(
+                        _mm_add_ps(_mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f),
+                                   _mm_set1_ps(float(x) + offset)),
+                        _mm_set1_ps(texelSize)),
+                    one);
+
+                __m128 d[3];
+                for (int i = 0; i < 3; i++)
+                {
+                    d[i] = _mm_add_ps(_mm_mul_ps(u, _mm_set1_ps(axes[i][0])),
+                                      _mm_set1_ps(base[i]));
+                }
+                const __m128 lengthSquared = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(d[0], d[0]), _mm_mul_ps(d[1], d[1])),
+                    _mm_mul_ps(d[2], d[2]));
+                const __m128 invLength =
+                    _mm_div_ps(one, _mm_sqrt_ps(lengthSquared));
+
+                alignas(16) float dx[4], dy[4], dz[4];
+                _mm_store_ps(dx, _mm_mul_ps(d[0], invLength));
+                _mm_store_ps(dy, _mm_mul_ps(d[1], invLength));
+                _mm_store_ps(dz, _mm_mul_ps(d[2], invLength));
+
+                // atan2, acos와 샘플은 lane마다
+                for (int lane = 0; lane < 4; lane++)
+                {
+                    SampleDirection(panorama, dx[lane], dy[lane], dz[lane],
+                                    weight, row + size_t(x + lane) * 4);
+                }
+            }
+#endif
+
+            for (; x < size; x++)
+            {
+                const float u = (float(x) + offset) * texelSize - 1.0f;
+                float d[3];
+                for (int i = 0; i < 3; i++)
+                    d[i] = u * axes[i][0] + base[i];
+                const float invLength =
+                    1.0f / std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+                SampleDirection(panorama, d[0] * invLength, d[1] * invLength,
+                                d[2] * invLength, weight, row + size_t(x) * 4);
+            }
+        }
+    }
+
+    for (int x = 0; x < size; x++)
+        row[size_t(x) * 4 + 3] = 1.0f;
+}
+
+} // namespace
+
+bool EquirectConverter::Read(const std::string &filename, int &width,
+                             int &height, std::vector<float> &rgba)
+{
+    const std::string extension = GetExtension(filename);
+
+    if (extension == ".dds")
+    {
+        DdsImage image;
+        if (!image.Open(filename) || image.GetDesc().cubemap ||
+            (image.GetDesc().format != DxgiFormat::R16G16B16A16_Float &&
+             image.GetDesc().format != DxgiFormat::R32G32B32A32_Float))
+        {
+            std::cout << "EquirectConverter::Read() unsupported DDS: "
+                      << filename << std::endl;
+            return false;
+        }
+        const DdsDesc &desc = image.GetDesc();
+        width = int(desc.width);
+        height = int(desc.height);
+        rgba.resize(size_t(width) * height * 4);
+        const void *data = image.GetSubresource(0, 0).data;
+        if (desc.format == DxgiFormat::R32G32B32A32_Float)
+        {
+            std::copy_n(static_cast<const float *>(data), rgba.size(),
+                        rgba.data());
+        }
+        else
+        {
+            const uint16_t *halfs = static_cast<const uint16_t *>(data);
+            for (size_t i = 0; i < rgba.size(); i++)
+                rgba[i] = BlockCompressor::HalfToFloat(halfs[i]);
+        }
+        return true;
+    }
+
+    if (stbi_is_hdr(filename.c_str()))
+    {
+        int channels;
+        float *pixels = stbi_loadf(filename.c_str(), &width, &height, &channels, 4);
+        if (!pixels)
+        {
+            std::cout << "stbi_loadf() failed: " << filename << " ("
+                      << stbi_failure_reason() << ")" << std::endl;
+            return false;
+        }
+        rgba.assign(pixels, pixels + size_t(width) * height * 4);
+        stbi_image_free(pixels);
+        return true;
+    }
+
+    ImageData image;
+    if (!TextureLoader::Decode(filename, image))
+        return false;
+
+    float toLinear[256];
+    for (int i = 0; i < 256; i++)
+    {
+        const float c = float(i) / 255.0f;
+        toLinear[i] = c <= 0.04045f ? c / 12.92f
+                                    : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+
+    width = image.width;
+    height = image.height;
+    rgba.resize(image.pixels.size());
+    for (size_t i = 0; i < rgba.size(); i++)
+    {
+        rgba[i] = i % 4 == 3 ? float(image.pixels[i]) / 255.0f
+                             : toLinear[image.pixels[i]];
+    }
+    return true;
+}
+
+FloatCubemap EquirectConverter::Convert(const float *rgba, int width,
+                                        int height,
+                                        const EquirectOptions &options)
+{
+    int size = options.faceSize;
+    if (size <= 0)
+    {
+        size = 1;
+        while (size * 2 <= width / 4)
+            size *= 2;
+    }
+
+    // 적도에서 큐브맵 텍셀 하나 (pi / 2 / size)가 덮는 파노라마 픽셀 (2 pi / width) 수
+    int subsamples = 1;
+    if (options.filter == EquirectFilter::Area)
+    {
+        subsamples = std::clamp(
+            int(std::ceil(float(width) / (4.0f * float(size)) - 1e-3f)), 1,
+            maxSubsamples);
+    }
+
+    FloatCubemap cubemap;
+    cubemap.Resize(size);
+    const Panorama panorama = {width, height, rgba};
+    ThreadPool::Get().ParallelFor(size_t(size) * 6, [&](size_t i) {
+        const int face = int(i / size_t(size));
+        const int y = int(i % size_t(size));
+        ConvertRow(panorama, face, y, size, subsamples,
+                   cubemap.GetFace(face) + size_t(y) * size * 4);
+    });
+    return cubemap;
+}
+
+bool EquirectConverter::Generate(const std::string &panoramaFilename,
+                                 const std::string &outputFilename,
+                                 const EquirectOptions &options)
+{
+    int width, height;
+    std::vector<float> rgba;
+    if (!Read(panoramaFilename, width, height, rgba))
+        return false;
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<FloatCubemap> levels = {
+        Convert(rgba.data(), width, height, options)};
+    while (options.mipmaps && levels.back().size > 1)
+        levels.push_back(levels.back().Downsample());
+    const double ms = std::chrono::duration<double, std::milli>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+
+    DdsDesc desc;
+    desc.format = DxgiFormat::R16G16B16A16_Float;
+    desc.width = desc.height = uint32_t(levels[0].size);
+    desc.mipLevels = uint32_t(levels.size());
+    desc.arraySize = 6;
+    desc.cubemap = true;
+
+    // 면마다 mip 0, 1, ... 순서
+    std::vector<uint16_t> halfs;
+    halfs.reserve(DdsFile::GetDataSize(desc) / sizeof(uint16_t));
+    for (int face = 0; face < 6; face++)
+    {
+        for (const FloatCubemap &level : levels)
+        {
+            const float *texels = level.GetFace(face);
+            const size_t count = size_t(level.size) * level.size * 4;
+            for (size_t i = 0; i < count; i++)
+                halfs.push_back(BlockCompressor::FloatToHalf(texels[i]));
+        }
+    }
+
+    std::cout << panoramaFilename << " -> cubemap: " << width << "x" << height
+              << " -> " << desc.width << "x" << desc.height << " x 6, "
+              << desc.mipLevels << " levels, "
+              << (options.filter == EquirectFilter::Area ? "area" : "bilinear")
+              << ", " << GetInstructionSet() << ", " << ms << " ms"
+              << std::endl;
+
+    return DdsFile::Write(outputFilename, desc,
+                          reinterpret_cast<const uint8_t *>(halfs.data()),
+                          halfs.size() * sizeof(uint16_t), equirectVersion);
+}
+
+bool EquirectConverter::Update(const std::string &panoramaFilename,
+                               const std::string &outputFilename,
+                               const EquirectOptions &options)
+{
+    std::error_code errorCode;
+    const auto panoramaTime =
+        std::filesystem::last_write_time(panoramaFilename, errorCode);
+    if (errorCode)
+        return false;
+
+    const auto outputTime =
+        std::filesystem::last_write_time(outputFilename, errorCode);
+    DdsDesc desc;
+    if (!errorCode && outputTime >= panoramaTime &&
+        DdsFile::ReadDesc(outputFilename, desc) &&
+        desc.writerVersion == equirectVersion)
+        return true;
+
+    return Generate(panoramaFilename, outputFilename, options);
+}
+
+const char *EquirectConverter::GetInstructionSet()
+{
+#ifdef FEFE_EQUIRECT_SSE2
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace FEFE
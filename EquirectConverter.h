@@ -0,0 +1,52 @@
+﻿#pragma once
+
+#include <string>
+#include <vector>
+
+#include "FloatCubemap.h"
+
+namespace FEFE
+{
+
+enum class EquirectFilter
+{
+    Bilinear, // 큐브맵 텍셀 중심 하나
+    Area,     // 텍셀이 덮는 파노라마 픽셀 수만큼 k x k 서브샘플 평균 (박스 필터 근사)
+};
+
+struct EquirectOptions
+{
+    int faceSize = 0; // 0이면 파노라마 너비 / 4 이하의 2의 거듭제곱
+    EquirectFilter filter = EquirectFilter::Area;
+    bool mipmaps = true; // 2x2 평균으로 1x1까지
+};
+
+// 위경도 (equirectangular) 파노라마 -> 큐브맵
+// 가운데 (u = 0.5)가 +Z, 오른쪽 (u = 0.75)이 +X, 맨 위가 +Y
+class EquirectConverter
+{
+  public:
+    // 파노라마를 선형 float RGBA로 읽음
+    // .hdr는 float 그대로, 8비트 이미지 (jpg, png)는 sRGB -> 선형
+    // .dds는 R16G16B16A16/R32G32B32A32 float 2D 텍스춰
+    static bool Read(const std::string &filename, int &width, int &height,
+                     std::vector<float> &rgba);
+
+    // 면의 행마다 병렬, 한 행 안의 방향은 4개씩 SIMD로 만듦
+    static FloatCubemap Convert(const float *rgba, int width, int height,
+                                const EquirectOptions &options);
+
+    // 파노라마 -> R16G16B16A16_FLOAT 큐브맵 DDS (CubemapPrefilter의 입력으로 사용)
+    static bool Generate(const std::string &panoramaFilename,
+                         const std::string &outputFilename,
+                         const EquirectOptions &options = EquirectOptions());
+
+    // outputFilename이 없거나 파노라마보다 오래됐으면 새로 만듦 (파노라마가 없으면 false)
+    static bool Update(const std::string &panoramaFilename,
+                       const std::string &outputFilename,
+                       const EquirectOptions &options = EquirectOptions());
+
+    static const char *GetInstructionSet();
+};
+
+} // namespace FEFE
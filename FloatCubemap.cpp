@@ -0,0 +1,240 @@
+﻿#include "FloatCubemap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#include "BlockCompressor.h"
+#include "DdsFile.h"
+
+namespace FEFE
+{
+
+namespace
+{
+
+// 면마다 (u, v, 1)에 곱할 계수
+const float faceAxes[6][3][3] = {
+    {{0, 0, 1}, {0, -1, 0}, {-1, 0, 0}}, // +X: (1, -v, -u)
+    {{0, 0, -1}, {0, -1, 0}, {1, 0, 0}}, // -X: (-1, -v, u)
+    {{1, 0, 0}, {0, 0, 1}, {0, 1, 0}},   // +Y: (u, 1, v)
+    {{1, 0, 0}, {0, 0, -1}, {0, -1, 0}}, // -Y: (u, -1, -v)
+    {{1, 0, 0}, {0, -1, 0}, {0, 0, 1}},  // +Z: (u, -v, 1)
+    {{-1, 0, 0}, {0, -1, 0}, {0, 0, -1}}, // -Z: (-u, -v, -1)
+};
+
+float SrgbToLinear(float c)
+{
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+bool OpenCubemap(const std::string &filename, DdsImage &image)
+{
+    if (!image.Open(filename))
+    {
+        std::cout << "FloatCubemap::Read() failed to read " << filename
+                  << std::endl;
+        return false;
+    }
+    const DdsDesc &desc = image.GetDesc();
+    if (!desc.cubemap || desc.width != desc.height)
+    {
+        std::cout << "FloatCubemap::Read() not a cubemap: " << filename
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// DdsImage의 한 레벨을 float RGBA로
+bool ReadLevel(const DdsImage &image, uint32_t level,
+               const std::string &filename, FloatCubemap &cubemap)
+{
+    const DdsDesc &desc = image.GetDesc();
+    int &size = cubemap.size;
+    size = int(std::max(desc.width >> level, 1u));
+
+    const size_t numPixels = size_t(size) * size;
+    std::vector<float> &pixels = cubemap.pixels;
+    pixels.resize(numPixels * 6 * 4);
+    for (int face = 0; face < 6; face++)
+    {
+        const uint8_t *src = static_cast<const uint8_t *>(
+            image.GetSubresource(uint32_t(face), level).data);
+        float *dst = cubemap.GetFace(face);
+
+        switch (desc.format)
+        {
+        case DxgiFormat::R32G32B32A32_Float:
+            std::memcpy(dst, src, numPixels * 4 * sizeof(float));
+            break;
+        case DxgiFormat::R16G16B16A16_Float:
+        {
+            const uint16_t *halfs = reinterpret_cast<const uint16_t *>(src);
+            for (size_t i = 0; i < numPixels * 4; i++)
+                dst[i] = BlockCompressor::HalfToFloat(halfs[i]);
+            break;
+        }
+        case DxgiFormat::BC6H_UF16:
+            BlockCompressor::DecompressBC6H(src, size, size, dst);
+            break;
+        case DxgiFormat::R8G8B8A8_Unorm:
+        case DxgiFormat::R8G8B8A8_Unorm_Srgb:
+        case DxgiFormat::B8G8R8A8_Unorm:
+        case DxgiFormat::B8G8R8A8_Unorm_Srgb:
+        {
+            const bool srgb = desc.format == DxgiFormat::R8G8B8A8_Unorm_Srgb ||
+                              desc.format == DxgiFormat::B8G8R8A8_Unorm_Srgb;
+            const bool bgra = desc.format == DxgiFormat::B8G8R8A8_Unorm ||
+                              desc.format == DxgiFormat::B8G8R8A8_Unorm_Srgb;
+            for (size_t i = 0; i < numPixels * 4; i++)
+            {
+                // BGRA는 R과 B를 바꿔서 읽음
+                const size_t channel = i % 4;
+                const size_t j = bgra && channel != 3 ? i - channel + 2 - channel : i;
+                const float c = src[j] / 255.0f;
+                dst[i] = srgb && channel != 3 ? SrgbToLinear(c) : c;
+            }
+            break;
+        }
+        default:
+            std::cout << "FloatCubemap::Read() unsupported format "
+                      << DdsFile::GetFormatName(desc.format) << ": "
+                      << filename << std::endl;
+            pixels.clear();
+            size = 0;
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool FloatCubemap::Read(const std::string &filename, int maxSize)
+{
+    DdsImage image;
+    if (!OpenCubemap(filename, image))
+        return false;
+    const DdsDesc &desc = image.GetDesc();
+
+    uint32_t level = 0;
+    while (maxSize > 0 && level + 1 < desc.mipLevels &&
+           int(desc.width >> level) > maxSize)
+        level++;
+    return ReadLevel(image, level, filename, *this);
+}
+
+bool FloatCubemap::ReadMipChain(const std::string &filename,
+                                std::vector<FloatCubemap> &levels)
+{
+    DdsImage image;
+    if (!OpenCubemap(filename, image))
+        return false;
+
+    levels.resize(image.GetDesc().mipLevels);
+    for (uint32_t level = 0; level < image.GetDesc().mipLevels; level++)
+    {
+        if (!ReadLevel(image, level, filename, levels[level]))
+        {
+            levels.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+void FloatCubemap::GetDirection(int face, float u, float v,
+                                float direction[3])
+{
+    for (int i = 0; i < 3; i++)
+    {
+        direction[i] = u * faceAxes[face][i][0] + v * faceAxes[face][i][1] +
+                       faceAxes[face][i][2];
+    }
+}
+
+void FloatCubemap::GetFaceAxes(int face, float axes[3][3])
+{
+    std::memcpy(axes, faceAxes[face], sizeof(faceAxes[face]));
+}
+
+int FloatCubemap::GetFace(const float direction[3], float &u, float &v)
+{
+    const float x = direction[0], y = direction[1], z = direction[2];
+    const float ax = std::fabs(x), ay = std::fabs(y), az = std::fabs(z);
+    if (ax >= ay && ax >= az)
+    {
+        u = (x > 0.0f ? -z : z) / ax;
+        v = -y / ax;
+        return x > 0.0f ? 0 : 1;
+    }
+    if (ay >= az)
+    {
+        u = x / ay;
+        v = (y > 0.0f ? z : -z) / ay;
+        return y > 0.0f ? 2 : 3;
+    }
+    u = (z > 0.0f ? x : -x) / az;
+    v = -y / az;
+    return z > 0.0f ? 4 : 5;
+}
+
+void FloatCubemap::Sample(const float direction[3], float rgb[3]) const
+{
+    float u, v;
+    const int face = GetFace(direction, u, v);
+
+    // 텍셀 중심이 정수가 되도록
+    const float maxCoord = float(size - 1);
+    const float s = std::clamp((u + 1.0f) * 0.5f * size - 0.5f, 0.0f, maxCoord);
+    const float t = std::clamp((v + 1.0f) * 0.5f * size - 0.5f, 0.0f, maxCoord);
+    const int x0 = int(s), y0 = int(t);
+    const int x1 = std::min(x0 + 1, size - 1), y1 = std::min(y0 + 1, size - 1);
+    const float fx = s - float(x0), fy = t - float(y0);
+
+    const float *texels = GetFace(face);
+    const float *p00 = texels + (size_t(y0) * size + x0) * 4;
+    const float *p10 = texels + (size_t(y0) * size + x1) * 4;
+    const float *p01 = texels + (size_t(y1) * size + x0) * 4;
+    const float *p11 = texels + (size_t(y1) * size + x1) * 4;
+    for (int ch = 0; ch < 3; ch++)
+    {
+        const float top = p00[ch] + (p10[ch] - p00[ch]) * fx;
+        const float bottom = p01[ch] + (p11[ch] - p01[ch]) * fx;
+        rgb[ch] = top + (bottom - top) * fy;
+    }
+}
+
+FloatCubemap FloatCubemap::Downsample() const
+{
+    FloatCubemap result;
+    result.Resize(std::max(size / 2, 1));
+    for (int face = 0; face < 6; face++)
+    {
+        const float *src = GetFace(face);
+        float *dst = result.GetFace(face);
+        for (int y = 0; y < result.size; y++)
+        {
+            const int y0 = std::min(y * 2, size - 1);
+            const int y1 = std::min(y * 2 + 1, size - 1);
+            for (int x = 0; x < result.size; x++)
+            {
+                const int x0 = std::min(x * 2, size - 1);
+                const int x1 = std::min(x * 2 + 1, size - 1);
+                for (int ch = 0; ch < 4; ch++)
+                {
+                    dst[(size_t(y) * result.size + x) * 4 + ch] =
+                        0.25f * (src[(size_t(y0) * size + x0) * 4 + ch] +
+                                 src[(size_t(y0) * size + x1) * 4 + ch] +
+                                 src[(size_t(y1) * size + x0) * 4 + ch] +
+                                 src[(size_t(y1) * size + x1) * 4 + ch]);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace FEFE
@@ -0,0 +1,55 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace FEFE
+{
+
+// 큐브맵 한 레벨을 float RGBA로 (면 6개를 +X, -X, +Y, -Y, +Z, -Z 순서로 이어서)
+// IBL 계산 (구면 조화, 프리필터 등)에서 DDS 형식과 관계없이 사용
+struct FloatCubemap
+{
+    int size = 0;
+    std::vector<float> pixels; // 6 * size * size * 4
+
+    float *GetFace(int face) { return pixels.data() + size_t(face) * size * size * 4; }
+    const float *GetFace(int face) const
+    {
+        return pixels.data() + size_t(face) * size * size * 4;
+    }
+
+    void Resize(int faceSize)
+    {
+        size = faceSize;
+        pixels.assign(size_t(6) * size * size * 4, 0.0f);
+    }
+
+    // 큐브맵 DDS에서 한 변이 maxSize 이하인 가장 큰 레벨을 읽음 (0이면 레벨 0)
+    // R16G16B16A16/R32G32B32A32 float, BC6H, R8G8B8A8/B8G8R8A8 (sRGB면 선형으로)
+    bool Read(const std::string &filename, int maxSize = 0);
+
+    // 모든 mip 레벨 (프리필터한 specular 큐브맵을 레벨별로 옮길 때)
+    static bool ReadMipChain(const std::string &filename,
+                             std::vector<FloatCubemap> &levels);
+
+    // 면 face의 텍스춰 좌표 (u, v) ∈ [-1, 1] (v는 아래 방향)의 방향 (정규화 안 됨)
+    // D3D 큐브맵 규약: +X면은 (1, -v, -u), -X면은 (-1, -v, u), ...
+    static void GetDirection(int face, float u, float v, float direction[3]);
+
+    // (u, v)를 3차원으로 옮기는 계수, direction[i] = u * m[i][0] + v * m[i][1] + m[i][2]
+    // 한 행의 텍셀들을 SIMD로 계산할 때 사용
+    static void GetFaceAxes(int face, float axes[3][3]);
+
+    // GetDirection()의 반대: 방향 (정규화 안 해도 됨)이 가리키는 면과 (u, v)
+    static int GetFace(const float direction[3], float &u, float &v);
+
+    // 방향의 bilinear 샘플 (면 경계에서는 면 안쪽으로 clamp)
+    void Sample(const float direction[3], float rgb[3]) const;
+
+    // 2x2 평균으로 한 변이 절반인 큐브맵 (크기는 2의 거듭제곱)
+    FloatCubemap Downsample() const;
+};
+
+} // namespace FEFE
@@ -1,6 +1,18 @@
 ﻿#include "GeometryGenerator.h"
 
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <utility>
+
+#include "ChannelPacker.h"
+#include "GltfLoader.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "MeshletBuilder.h"
 #include "ModelLoader.h"
+#include "ThreadPool.h"
+#include "VertexKernels.h"
 
 namespace FEFE
 {
@@ -506,47 +518,247 @@ MeshData GeometryGenerator::SubdivideToSphere(const float radius,
 
     return newMesh;
 }
-vector<MeshData> GeometryGenerator::ReadFromFile(std::string basePath,
-                                                 std::string filename)
+
+float GeometryGenerator::ComputeUvDensity(const MeshData &meshData)
+{
+    const auto &v = meshData.vertices;
+    const auto &indices = meshData.indices;
+
+    double area = 0.0;
+    double uvArea = 0.0;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        const Vertex &v0 = v[indices[i]];
+        const Vertex &v1 = v[indices[i + 1]];
+        const Vertex &v2 = v[indices[i + 2]];
+
+        area += (v1.position - v0.position)
+                    .Cross(v2.position - v0.position)
+                    .Length() *
+                0.5;
+
+        const Vector2 e1 = v1.texcoord - v0.texcoord;
+        const Vector2 e2 = v2.texcoord - v0.texcoord;
+        uvArea += std::abs(e1.x * e2.y - e1.y * e2.x) * 0.5;
+    }
+
+    if (area <= 0.0 || uvArea <= 0.0)
+        return 0.0f;
+    return float(std::sqrt(uvArea / area));
+}
+
+SceneData GeometryGenerator::ReadFromFile(std::string basePath,
+                                         std::string filename)
 {
 
     using namespace DirectX;
 
-    ModelLoader modelLoader;
-    modelLoader.Load(basePath, filename);
-    vector<MeshData> &meshes = modelLoader.meshes;
+    // glTF는 Assimp를 거치지 않고 바로 읽기 (지원하지 않는 파일이면 Assimp로)
+    // 두 로더 모두 노드 행렬을 버텍스에 곱하지 않고 인스턴스로 남김
+    SceneData scene;
+    GltfLoader gltfLoader;
+    if (gltfLoader.Load(basePath, filename))
+    {
+        scene.meshes = std::move(gltfLoader.meshes);
+        scene.nodes = std::move(gltfLoader.nodes);
+        scene.instances = std::move(gltfLoader.instances);
+    }
+    else
+    {
+        ModelLoader modelLoader;
+        modelLoader.Load(basePath, filename);
+        scene.meshes = std::move(modelLoader.meshes);
+        scene.nodes = std::move(modelLoader.nodes);
+        scene.instances = std::move(modelLoader.instances);
+    }
+    vector<MeshData> &meshes = scene.meshes;
+
+    // 재질마다 AO/거칠기/금속성/높이를 텍스춰 하나로 (메쉬를 나누기 전에 한 번만)
+    ChannelPacker::PackMeshes(meshes, filename);
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Normalize: 인스턴스마다 메쉬 AABB의 꼭지점 8개를 월드로 옮겨서 전체 범위를 구하고
+    // 버텍스 대신 루트 노드 행렬에 적용 (인스턴스 수와 관계없이 메쉬 크기만큼만 읽음)
+    vector<Vector3> meshMin(meshes.size(), Vector3(FLT_MAX));
+    vector<Vector3> meshMax(meshes.size(), Vector3(-FLT_MAX));
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+        VertexKernels::ComputeBounds(meshes[i].vertices.data(),
+                                     meshes[i].vertices.size(), meshMin[i],
+                                     meshMax[i]);
+    }
+
+    const vector<Matrix> world =
+        ComputeWorldTransforms(scene.nodes.data(), scene.nodes.size());
+
+    Vector3 vmin(FLT_MAX);
+    Vector3 vmax(-FLT_MAX);
+    for (const auto &instance : scene.instances)
+    {
+        const Vector3 &lo = meshMin[instance.meshIndex];
+        const Vector3 &hi = meshMax[instance.meshIndex];
+        if (lo.x > hi.x)
+            continue; // 빈 메쉬
+
+        for (int c = 0; c < 8; c++)
+        {
+            const Vector3 corner(c & 1 ? hi.x : lo.x, c & 2 ? hi.y : lo.y,
+                                 c & 4 ? hi.z : lo.z);
+            const Vector3 p =
+                Vector3::Transform(corner, world[instance.nodeIndex]);
+            vmin = Vector3::Min(vmin, p);
+            vmax = Vector3::Max(vmax, p);
+        }
+    }
 
-    // Normalize vertices
-    Vector3 vmin(1000, 1000, 1000);
-    Vector3 vmax(-1000, -1000, -1000);
-    for (auto &mesh : meshes) 
+    if (vmin.x <= vmax.x)
     {
-        for (auto &v : mesh.vertices) 
+        float dx = vmax.x - vmin.x, dy = vmax.y - vmin.y, dz = vmax.z - vmin.z;
+        float dl = XMMax(XMMax(dx, dy), dz);
+        const Vector3 center = (vmax + vmin) * 0.5f;
+
+        const Matrix normalize = Matrix::CreateTranslation(-center) *
+                                 Matrix::CreateScale(1.0f / dl);
+        for (auto &node : scene.nodes)
         {
-            vmin.x = XMMin(vmin.x, v.position.x);
-            vmin.y = XMMin(vmin.y, v.position.y);
-            vmin.z = XMMin(vmin.z, v.position.z);
-            vmax.x = XMMax(vmax.x, v.position.x);
-            vmax.y = XMMax(vmax.y, v.position.y);
-            vmax.z = XMMax(vmax.z, v.position.z);
+            if (node.parent < 0)
+                node.transform = node.transform * normalize;
         }
     }
 
-    float dx = vmax.x - vmin.x, dy = vmax.y - vmin.y, dz = vmax.z - vmin.z;
-    float dl = XMMax(XMMax(dx, dy), dz);
-    float cx = (vmax.x + vmin.x) * 0.5f, cy = (vmax.y + vmin.y) * 0.5f,
-          cz = (vmax.z + vmin.z) * 0.5f;
+    std::cout << filename << ": normalize "
+              << std::chrono::duration<double, std::milli>(
+                     std::chrono::steady_clock::now() - start)
+                     .count()
+              << " ms" << std::endl;
+
+    // 버텍스 합치기 + 캐시/오버드로우/fetch 순서 최적화 (메쉬마다 병렬)
+    start = std::chrono::steady_clock::now();
+    ThreadPool::Get().ParallelFor(meshes.size(), [&](size_t i) {
+        MeshOptimizer::Optimize(meshes[i],
+                                filename + "[" + std::to_string(i) + "]");
+    });
+
+    std::cout << filename << ": optimize "
+              << std::chrono::duration<double, std::milli>(
+                     std::chrono::steady_clock::now() - start)
+                     .count()
+              << " ms" << std::endl;
+
+    // 텍스춰 mip 선택에 쓰는 uv 밀도 (나눠도 그대로 물려받음)
+    ThreadPool::Get().ParallelFor(meshes.size(), [&](size_t i) {
+        meshes[i].uvDensity = ComputeUvDensity(meshes[i]);
+    });
+
+    // 16비트 인덱스로 그릴 수 있도록 큰 메쉬 나누기
+    // 나뉜 조각들은 원래 메쉬의 인스턴스를 그대로 물려받음
+    vector<MeshData> splitMeshes;
+    vector<size_t> firstPart(meshes.size() + 1, 0);
+    splitMeshes.reserve(meshes.size());
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+        firstPart[i] = splitMeshes.size();
+        for (auto &part :
+             MeshOptimizer::SplitForShortIndices(std::move(meshes[i])))
+            splitMeshes.push_back(std::move(part));
+    }
+    firstPart[meshes.size()] = splitMeshes.size();
 
-    for (auto &mesh : meshes) 
+    if (splitMeshes.size() != meshes.size())
     {
-        for (auto &v : mesh.vertices) 
+        std::cout << filename << ": split " << meshes.size() << " -> "
+                  << splitMeshes.size() << " meshes for 16-bit indices"
+                  << std::endl;
+
+        vector<MeshInstance> splitInstances;
+        for (const auto &instance : scene.instances)
         {
-            v.position.x = (v.position.x - cx) / dl;
-            v.position.y = (v.position.y - cy) / dl;
-            v.position.z = (v.position.z - cz) / dl;
+            for (size_t part = firstPart[instance.meshIndex];
+                 part < firstPart[instance.meshIndex + 1]; part++)
+                splitInstances.push_back({uint32_t(part), instance.nodeIndex});
         }
+        scene.instances = std::move(splitInstances);
+    }
+    meshes = std::move(splitMeshes);
+
+    // LOD 체인 (나눈 메쉬마다 병렬)
+    start = std::chrono::steady_clock::now();
+    ThreadPool::Get().ParallelFor(meshes.size(), [&](size_t i) {
+        MeshSimplifier::BuildLods(meshes[i],
+                                  filename + "[" + std::to_string(i) + "]");
+    });
+
+    std::cout << filename << ": LOD "
+              << std::chrono::duration<double, std::milli>(
+                     std::chrono::steady_clock::now() - start)
+                     .count()
+              << " ms" << std::endl;
+
+    // LOD 구간마다 meshlet으로 나눠서 컬링 단위 만들기
+    start = std::chrono::steady_clock::now();
+    ThreadPool::Get().ParallelFor(meshes.size(), [&](size_t i) {
+        MeshletBuilder::Build(meshes[i],
+                              filename + "[" + std::to_string(i) + "]");
+    });
+
+    std::cout << filename << ": meshlets "
+              << std::chrono::duration<double, std::milli>(
+                     std::chrono::steady_clock::now() - start)
+                     .count()
+              << " ms" << std::endl;
+
+    std::cout << filename << ": " << meshes.size() << " unique meshes, "
+              << scene.instances.size() << " instances, " << scene.nodes.size()
+              << " nodes" << std::endl;
+
+    return scene;
+}
+
+bool GeometryGenerator::ReadFromFileCached(std::string basePath,
+                                           std::string filename,
+                                           MeshCache &meshCache)
+{
+    const std::string sourceFilename = basePath + filename;
+    const std::string cacheFilename = sourceFilename + ".meshcache";
+
+    auto start = std::chrono::steady_clock::now();
+
+    const uint64_t key =
+        MeshCache::MakeKey(sourceFilename, ModelLoader::importFlags);
+    if (key == 0)
+    {
+        std::cout << "Failed to read file: " << sourceFilename << std::endl;
+        return false;
+    }
+
+    // Warm start: 매핑만 하고 끝
+    if (meshCache.Open(cacheFilename, key))
+    {
+        std::cout << filename << ": mesh cache hit, "
+                  << std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - start)
+                         .count()
+                  << " ms" << std::endl;
+        return true;
+    }
+
+    // Cold start: 원래 경로로 읽고 캐시 생성
+    SceneData scene = ReadFromFile(basePath, filename);
+    if (scene.meshes.empty())
+        return false;
+
+    if (MeshCache::Write(cacheFilename, key, scene) &&
+        meshCache.Open(cacheFilename, key))
+    {
+        return true;
     }
 
-    return meshes;
+    // 캐시만 못 만든 것이므로 읽은 결과는 그대로 사용 (다음 실행에서 다시 시도)
+    std::cout << filename
+              << ": failed to create mesh cache, using in-memory scene"
+              << std::endl;
+    meshCache.Adopt(std::move(scene));
+    return true;
 }
 } // namespace FEFE
\ No newline at end of file
@@ -6,6 +6,7 @@
 
 #include "Vertex.h"
 #include "MeshData.h"
+#include "MeshCache.h"
 
 namespace FEFE
 {
@@ -13,8 +14,19 @@ namespace FEFE
 class GeometryGenerator
 {
   public:
-    static vector<MeshData> ReadFromFile(std::string basePath,
-                                         std::string filename);
+    // 고유한 메쉬 + 노드 트리 + 인스턴스
+    // 정규화(크기 1, 중심 0)는 루트 노드 행렬에 들어감
+    static SceneData ReadFromFile(std::string basePath, std::string filename);
+
+    // 캐시 파일(filename + ".meshcache")이 유효하면 Assimp를 건너뛰고
+    // 캐시를 매핑만 함. 없거나 원본이 바뀌었으면 ReadFromFile() 후 캐시 생성
+    // 캐시 생성에 실패해도 읽은 SceneData를 meshCache가 들고 있음
+    static bool ReadFromFileCached(std::string basePath, std::string filename,
+                                   MeshCache &meshCache);
+
+    // 모델 좌표 넓이 대비 uv 넓이로 구한 평균 uv 밀도 (uv / 모델 좌표 1)
+    // uv가 없거나 넓이가 0이면 0
+    static float ComputeUvDensity(const MeshData &meshData);
 
     static MeshData MakeSquare();
     static MeshData MakeBox(const float scale = 1.0f);
@@ -0,0 +1,959 @@
+﻿#include "GltfLoader.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+#include <emmintrin.h> // SSE2
+
+#include "MappedFile.h"
+#include "ThreadPool.h"
+#include "VertexKernels.h"
+
+namespace FEFE
+{
+
+using namespace DirectX::SimpleMath;
+
+namespace
+{
+
+// glTF에 필요한 만큼만 구현한 JSON 파서
+struct JsonValue
+{
+    enum Type
+    {
+        Null,
+        Bool,
+        Number,
+        String,
+        Array,
+        Object
+    };
+
+    Type type = Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object;
+
+    const JsonValue *Find(const char *key) const
+    {
+        for (const auto &member : object)
+        {
+            if (member.first == key)
+                return &member.second;
+        }
+        return nullptr;
+    }
+
+    const JsonValue &operator[](const char *key) const
+    {
+        static const JsonValue null;
+        const JsonValue *v = Find(key);
+        return v ? *v : null;
+    }
+
+    const JsonValue &operator[](size_t i) const
+    {
+        static const JsonValue null;
+        return i < array.size() ? array[i] : null;
+    }
+
+    const JsonValue &operator[](int i) const
+    {
+        return (*this)[i < 0 ? array.size() : size_t(i)];
+    }
+
+    size_t Size() const { return array.size(); }
+    bool IsNull() const { return type == Null; }
+    int AsInt(int defaultValue = -1) const
+    {
+        return type == Number ? int(number) : defaultValue;
+    }
+    float AsFloat(float defaultValue = 0.0f) const
+    {
+        return type == Number ? float(number) : defaultValue;
+    }
+};
+
+class JsonParser
+{
+  public:
+    JsonParser(const char *begin, const char *end) : m_p(begin), m_end(end) {}
+
+    bool Parse(JsonValue &out)
+    {
+        if (!ParseValue(out))
+            return false;
+        SkipSpace();
+        return m_p == m_end;
+    }
+
+  private:
+    void SkipSpace()
+    {
+        while (m_p < m_end &&
+               (*m_p == ' ' || *m_p == '\t' || *m_p == '\n' || *m_p == '\r'))
+            m_p++;
+    }
+
+    bool Match(const char *word)
+    {
+        const size_t n = std::strlen(word);
+        if (size_t(m_end - m_p) < n || std::strncmp(m_p, word, n) != 0)
+            return false;
+        m_p += n;
+        return true;
+    }
+
+    bool ParseValue(JsonValue &out)
+    {
+        SkipSpace();
+        if (m_p >= m_end)
+            return false;
+
+        switch (*m_p)
+        {
+        case '{':
+            return ParseObject(out);
+        case '[':
+            return ParseArray(out);
+        case '"':
+            out.type = JsonValue::String;
+            return ParseString(out.string);
+        case 't':
+            out.type = JsonValue::Bool;
+            out.boolean = true;
+            return Match("true");
+        case 'f':
+            out.type = JsonValue::Bool;
+            out.boolean = false;
+            return Match("false");
+        case 'n':
+            out.type = JsonValue::Null;
+            return Match("null");
+        default:
+            return ParseNumber(out);
+        }
+    }
+
+    bool ParseNumber(JsonValue &out)
+    {
+        char *numberEnd = nullptr;
+        // strtod는 널 종료 문자열이 필요하지만 JSON 숫자 뒤에는
+        // 항상 구분 문자가 오고 버퍼 끝에 '\0'을 붙여두었으므로 안전
+        out.number = std::strtod(m_p, &numberEnd);
+        if (numberEnd == m_p)
+            return false;
+        out.type = JsonValue::Number;
+        m_p = numberEnd;
+        return true;
+    }
+
+    bool ParseString(std::string &out)
+    {
+        m_p++; // "
+        out.clear();
+        while (m_p < m_end && *m_p != '"')
+        {
+            if (*m_p == '\\' && m_p + 1 < m_end)
+            {
+                m_p++;
+                switch (*m_p)
+                {
+                case 'n':
+                    out.push_back('\n');
+                    break;
+                case 't':
+                    out.push_back('\t');
+                    break;
+                case 'r':
+                    out.push_back('\r');
+                    break;
+                case 'b':
+                    out.push_back('\b');
+                    break;
+                case 'f':
+                    out.push_back('\f');
+                    break;
+                case 'u':
+                {
+                    if (m_end - m_p < 5)
+                        return false;
+                    const unsigned code =
+                        unsigned(std::strtoul(std::string(m_p + 1, 4).c_str(),
+                                              nullptr, 16));
+                    // 경로/이름에만 쓰이므로 UTF-8로만 변환 (서로게이트 쌍 무시)
+                    if (code < 0x80)
+                    {
+                        out.push_back(char(code));
+                    }
+                    else if (code < 0x800)
+                    {
+                        out.push_back(char(0xC0 | (code >> 6)));
+                        out.push_back(char(0x80 | (code & 0x3F)));
+                    }
+                    else
+                    {
+                        out.push_back(char(0xE0 | (code >> 12)));
+                        out.push_back(char(0x80 | ((code >> 6) & 0x3F)));
+                        out.push_back(char(0x80 | (code & 0x3F)));
+                    }
+                    m_p += 4;
+                    break;
+                }
+                default: // \" \\ \/
+                    out.push_back(*m_p);
+                    break;
+                }
+                m_p++;
+            }
+            else
+            {
+                out.push_back(*m_p++);
+            }
+        }
+        if (m_p >= m_end)
+            return false;
+        m_p++; // "
+        return true;
+    }
+
+    bool ParseArray(JsonValue &out)
+    {
+        out.type = JsonValue::Array;
+        m_p++; // [
+        SkipSpace();
+        if (m_p < m_end && *m_p == ']')
+        {
+            m_p++;
+            return true;
+        }
+        while (true)
+        {
+            out.array.emplace_back();
+            if (!ParseValue(out.array.back()))
+                return false;
+            SkipSpace();
+            if (m_p >= m_end)
+                return false;
+            if (*m_p == ',')
+            {
+                m_p++;
+                continue;
+            }
+            if (*m_p == ']')
+            {
+                m_p++;
+                return true;
+            }
+            return false;
+        }
+    }
+
+    bool ParseObject(JsonValue &out)
+    {
+        out.type = JsonValue::Object;
+        m_p++; // {
+        SkipSpace();
+        if (m_p < m_end && *m_p == '}')
+        {
+            m_p++;
+            return true;
+        }
+        while (true)
+        {
+            SkipSpace();
+            if (m_p >= m_end || *m_p != '"')
+                return false;
+            out.object.emplace_back();
+            if (!ParseString(out.object.back().first))
+                return false;
+            SkipSpace();
+            if (m_p >= m_end || *m_p != ':')
+                return false;
+            m_p++;
+            if (!ParseValue(out.object.back().second))
+                return false;
+            SkipSpace();
+            if (m_p >= m_end)
+                return false;
+            if (*m_p == ',')
+            {
+                m_p++;
+                continue;
+            }
+            if (*m_p == '}')
+            {
+                m_p++;
+                return true;
+            }
+            return false;
+        }
+    }
+
+    const char *m_p;
+    const char *m_end;
+};
+
+// glTF componentType
+enum ComponentType
+{
+    ComponentByte = 5120,
+    ComponentUnsignedByte = 5121,
+    ComponentShort = 5122,
+    ComponentUnsignedShort = 5123,
+    ComponentUnsignedInt = 5125,
+    ComponentFloat = 5126
+};
+
+// bufferView/byteOffset/byteStride를 풀어놓은 accessor
+struct Accessor
+{
+    const uint8_t *data = nullptr;
+    const uint8_t *bufferEnd = nullptr; // SIMD로 넘어 읽어도 되는 한계
+    size_t count = 0;
+    size_t stride = 0;
+    int componentType = 0;
+    int numComponents = 0;
+    bool normalized = false;
+};
+
+size_t ComponentSize(int componentType)
+{
+    switch (componentType)
+    {
+    case ComponentByte:
+    case ComponentUnsignedByte:
+        return 1;
+    case ComponentShort:
+    case ComponentUnsignedShort:
+        return 2;
+    case ComponentUnsignedInt:
+    case ComponentFloat:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+int NumComponents(const std::string &type)
+{
+    if (type == "SCALAR")
+        return 1;
+    if (type == "VEC2")
+        return 2;
+    if (type == "VEC3")
+        return 3;
+    if (type == "VEC4")
+        return 4;
+    return 0;
+}
+
+// 정수 형식 -> float 변환 배율 (KHR_mesh_quantization)
+float ComponentScale(int componentType, bool normalized)
+{
+    if (!normalized)
+        return 1.0f;
+
+    switch (componentType)
+    {
+    case ComponentByte:
+        return 1.0f / 127.0f;
+    case ComponentUnsignedByte:
+        return 1.0f / 255.0f;
+    case ComponentShort:
+        return 1.0f / 32767.0f;
+    case ComponentUnsignedShort:
+        return 1.0f / 65535.0f;
+    default:
+        return 1.0f;
+    }
+}
+
+// 성분 4개를 읽어서 float4로 변환 (SSE2)
+// 원소가 3개 이하여도 4개를 읽기 때문에 호출 전에 범위를 확인해야 함
+template <typename T> __m128 LoadComponents(const uint8_t *p);
+
+template <> __m128 LoadComponents<float>(const uint8_t *p)
+{
+    return _mm_loadu_ps(reinterpret_cast<const float *>(p));
+}
+
+template <> __m128 LoadComponents<int16_t>(const uint8_t *p)
+{
+    __m128i x = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p));
+    x = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16); // 부호 확장
+    return _mm_cvtepi32_ps(x);
+}
+
+template <> __m128 LoadComponents<uint16_t>(const uint8_t *p)
+{
+    __m128i x = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p));
+    x = _mm_unpacklo_epi16(x, _mm_setzero_si128());
+    return _mm_cvtepi32_ps(x);
+}
+
+template <> __m128 LoadComponents<int8_t>(const uint8_t *p)
+{
+    int32_t w;
+    std::memcpy(&w, p, 4);
+    __m128i x = _mm_cvtsi32_si128(w);
+    x = _mm_unpacklo_epi8(x, x);
+    x = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 24); // 부호 확장
+    return _mm_cvtepi32_ps(x);
+}
+
+template <> __m128 LoadComponents<uint8_t>(const uint8_t *p)
+{
+    int32_t w;
+    std::memcpy(&w, p, 4);
+    __m128i x = _mm_cvtsi32_si128(w);
+    x = _mm_unpacklo_epi8(x, _mm_setzero_si128());
+    x = _mm_unpacklo_epi16(x, _mm_setzero_si128());
+    return _mm_cvtepi32_ps(x);
+}
+
+// accessor 하나를 Vertex 배열의 한 필드(position/normal/texcoord)로 디코딩
+// src와 dst의 stride가 달라도 원소마다 SIMD 한 번씩 읽고 씀
+template <typename T>
+void DecodeAttribute(const Accessor &a, Vertex *vertices, size_t fieldOffset,
+                     int numComponents)
+{
+    const float scale = ComponentScale(a.componentType, a.normalized);
+    const bool clampToMinusOne = a.normalized && T(-1) < T(0) &&
+                                 a.componentType != ComponentFloat;
+
+    const __m128 scale4 = _mm_set1_ps(scale);
+    const __m128 minusOne = _mm_set1_ps(-1.0f);
+    const size_t loadBytes = 4 * sizeof(T);
+
+    for (size_t i = 0; i < a.count; i++)
+    {
+        const uint8_t *src = a.data + i * a.stride;
+        float *dst = reinterpret_cast<float *>(
+            reinterpret_cast<uint8_t *>(vertices + i) + fieldOffset);
+
+        if (src + loadBytes <= a.bufferEnd)
+        {
+            __m128 v = _mm_mul_ps(LoadComponents<T>(src), scale4);
+            if (clampToMinusOne)
+                v = _mm_max_ps(v, minusOne);
+
+            // 필요한 성분만 저장 (옆 필드를 건드리지 않음)
+            _mm_storel_pi(reinterpret_cast<__m64 *>(dst), v);
+            if (numComponents == 3)
+                _mm_store_ss(dst + 2, _mm_movehl_ps(v, v));
+        }
+        else
+        {
+            // 버퍼 마지막 원소: 넘어 읽지 않도록 하나씩
+            for (int c = 0; c < numComponents; c++)
+            {
+                T value;
+                std::memcpy(&value, src + c * sizeof(T), sizeof(T));
+                float f = float(value) * scale;
+                dst[c] = clampToMinusOne ? (f < -1.0f ? -1.0f : f) : f;
+            }
+        }
+    }
+}
+
+bool DecodeAttribute(const Accessor &a, Vertex *vertices, size_t fieldOffset,
+                     int numComponents)
+{
+    if (a.numComponents < numComponents)
+        return false;
+
+    switch (a.componentType)
+    {
+    case ComponentFloat:
+        DecodeAttribute<float>(a, vertices, fieldOffset, numComponents);
+        return true;
+    case ComponentShort:
+        DecodeAttribute<int16_t>(a, vertices, fieldOffset, numComponents);
+        return true;
+    case ComponentUnsignedShort:
+        DecodeAttribute<uint16_t>(a, vertices, fieldOffset, numComponents);
+        return true;
+    case ComponentByte:
+        DecodeAttribute<int8_t>(a, vertices, fieldOffset, numComponents);
+        return true;
+    case ComponentUnsignedByte:
+        DecodeAttribute<uint8_t>(a, vertices, fieldOffset, numComponents);
+        return true;
+    default:
+        return false;
+    }
+}
+
+// 인덱스를 uint32로 넓히기
+bool DecodeIndices(const Accessor &a, uint32_t *indices)
+{
+    const size_t count = a.count;
+
+    switch (a.componentType)
+    {
+    case ComponentUnsignedInt:
+        if (a.stride == 4)
+        {
+            std::memcpy(indices, a.data, count * 4);
+            return true;
+        }
+        for (size_t i = 0; i < count; i++)
+            std::memcpy(indices + i, a.data + i * a.stride, 4);
+        return true;
+
+    case ComponentUnsignedShort:
+    {
+        size_t i = 0;
+        if (a.stride == 2)
+        {
+            // 8개씩 16비트 -> 32비트
+            const __m128i zero = _mm_setzero_si128();
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m128i x = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i *>(a.data + i * 2));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(indices + i),
+                                 _mm_unpacklo_epi16(x, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(indices + i + 4),
+                                 _mm_unpackhi_epi16(x, zero));
+            }
+        }
+        for (; i < count; i++)
+        {
+            uint16_t value;
+            std::memcpy(&value, a.data + i * a.stride, 2);
+            indices[i] = value;
+        }
+        return true;
+    }
+
+    case ComponentUnsignedByte:
+        for (size_t i = 0; i < count; i++)
+            indices[i] = a.data[i * a.stride];
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+// 노드 행렬 (glTF는 column vector, column-major 저장)
+// column-major 배열을 그대로 row-major로 읽으면 SimpleMath(row vector)용 행렬
+Matrix NodeMatrix(const JsonValue &node)
+{
+    const JsonValue &matrix = node["matrix"];
+    if (matrix.Size() == 16)
+    {
+        Matrix m;
+        float *mTemp = &m._11;
+        for (int t = 0; t < 16; t++)
+            mTemp[t] = matrix[t].AsFloat();
+        return m;
+    }
+
+    Vector3 translation(0.0f);
+    Quaternion rotation;
+    Vector3 scale(1.0f);
+
+    const JsonValue &t = node["translation"];
+    if (t.Size() == 3)
+        translation = Vector3(t[0].AsFloat(), t[1].AsFloat(), t[2].AsFloat());
+
+    const JsonValue &r = node["rotation"];
+    if (r.Size() == 4)
+        rotation = Quaternion(r[0].AsFloat(), r[1].AsFloat(), r[2].AsFloat(),
+                              r[3].AsFloat());
+
+    const JsonValue &s = node["scale"];
+    if (s.Size() == 3)
+        scale = Vector3(s[0].AsFloat(), s[1].AsFloat(), s[2].AsFloat());
+
+    // T * R * S (column vector) -> S * R * T (row vector)
+    return Matrix::CreateScale(scale) * Matrix::CreateFromQuaternion(rotation) *
+           Matrix::CreateTranslation(translation);
+}
+
+// 노멀이 없는 primitive용 (면 노멀을 넓이 가중치로 누적)
+void ComputeNormals(MeshData &mesh)
+{
+    for (auto &v : mesh.vertices)
+        v.normal = Vector3(0.0f);
+
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+    {
+        Vertex &v0 = mesh.vertices[mesh.indices[i]];
+        Vertex &v1 = mesh.vertices[mesh.indices[i + 1]];
+        Vertex &v2 = mesh.vertices[mesh.indices[i + 2]];
+        const Vector3 faceNormal =
+            (v1.position - v0.position).Cross(v2.position - v0.position);
+        v0.normal += faceNormal;
+        v1.normal += faceNormal;
+        v2.normal += faceNormal;
+    }
+}
+
+bool ParseJsonFile(const std::string &filename, JsonValue &out)
+{
+    std::string text;
+    {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file)
+            return false;
+        std::ostringstream ss;
+        ss << file.rdbuf();
+        text = ss.str();
+    }
+
+    JsonParser parser(text.c_str(), text.c_str() + text.size());
+    return parser.Parse(out);
+}
+
+} // namespace
+
+std::vector<std::string>
+GltfLoader::GetBufferFilenames(std::string basePath, std::string filename)
+{
+    std::vector<std::string> filenames;
+
+    if (std::filesystem::path(filename).extension().string() != ".gltf")
+        return filenames;
+
+    JsonValue gltf;
+    if (!ParseJsonFile(basePath + filename, gltf))
+        return filenames;
+
+    const JsonValue &buffers = gltf["buffers"];
+    for (size_t i = 0; i < buffers.Size(); i++)
+    {
+        const std::string &uri = buffers[i]["uri"].string;
+        if (!uri.empty() && uri.compare(0, 5, "data:") != 0)
+            filenames.push_back(basePath + uri);
+    }
+    return filenames;
+}
+
+bool GltfLoader::Load(std::string basePath, std::string filename)
+{
+    this->basePath = basePath;
+    meshes.clear();
+    nodes.clear();
+    instances.clear();
+
+    const auto extension = std::filesystem::path(filename).extension().string();
+    if (extension != ".gltf")
+        return false;
+
+    auto start = std::chrono::steady_clock::now();
+
+    // 1. JSON 파싱 (한 번만)
+    JsonValue gltf;
+    if (!ParseJsonFile(basePath + filename, gltf))
+    {
+        std::cout << filename << ": glTF JSON parse error" << std::endl;
+        return false;
+    }
+
+    // 지원하지 않는 확장이 필수면 Assimp로
+    const JsonValue &required = gltf["extensionsRequired"];
+    for (size_t i = 0; i < required.Size(); i++)
+    {
+        if (required[i].string != "KHR_mesh_quantization")
+            return false;
+    }
+
+    // 2. .bin 버퍼 매핑
+    const JsonValue &buffers = gltf["buffers"];
+    std::vector<MappedFile> mappedBuffers(buffers.Size());
+    for (size_t i = 0; i < buffers.Size(); i++)
+    {
+        const std::string &uri = buffers[i]["uri"].string;
+        if (uri.empty() || uri.compare(0, 5, "data:") == 0)
+            return false;
+
+        if (!mappedBuffers[i].Open(basePath + uri))
+        {
+            std::cout << "Failed to map buffer: " << basePath + uri
+                      << std::endl;
+            return false;
+        }
+
+        if (mappedBuffers[i].GetSize() <
+            size_t(buffers[i]["byteLength"].AsInt(0)))
+            return false;
+    }
+
+    const double parseMs = std::chrono::duration<double, std::milli>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+
+    const JsonValue &accessors = gltf["accessors"];
+    const JsonValue &bufferViews = gltf["bufferViews"];
+
+    auto GetAccessor = [&](int index, Accessor &out) -> bool {
+        const JsonValue &accessor = accessors[size_t(index)];
+        if (accessor.IsNull() || !accessor["sparse"].IsNull())
+            return false;
+
+        const JsonValue &view = bufferViews[size_t(accessor["bufferView"].AsInt())];
+        if (view.IsNull())
+            return false;
+
+        const int bufferIndex = view["buffer"].AsInt();
+        if (bufferIndex < 0 || size_t(bufferIndex) >= mappedBuffers.size())
+            return false;
+        const MappedFile &buffer = mappedBuffers[bufferIndex];
+
+        out.componentType = accessor["componentType"].AsInt();
+        out.numComponents = NumComponents(accessor["type"].string);
+        out.normalized = accessor["normalized"].boolean;
+        out.count = size_t(accessor["count"].AsInt(0));
+
+        const size_t elementSize =
+            ComponentSize(out.componentType) * size_t(out.numComponents);
+        if (elementSize == 0)
+            return false;
+
+        const size_t viewOffset = size_t(view["byteOffset"].AsInt(0));
+        const size_t viewLength = size_t(view["byteLength"].AsInt(0));
+        const size_t offset = viewOffset + size_t(accessor["byteOffset"].AsInt(0));
+        out.stride = size_t(view["byteStride"].AsInt(0));
+        if (out.stride == 0)
+            out.stride = elementSize;
+
+        if (out.count > 0 &&
+            offset + out.stride * (out.count - 1) + elementSize >
+                viewOffset + viewLength)
+            return false;
+        if (viewOffset + viewLength > buffer.GetSize())
+            return false;
+
+        out.data = buffer.GetData() + offset;
+        out.bufferEnd = buffer.GetData() + buffer.GetSize();
+        return true;
+    };
+
+    // 3. 노드 트리와 인스턴스 목록
+    //    여러 노드가 같은 glTF 메쉬를 가리키면 primitive는 한 번만 디코딩
+    start = std::chrono::steady_clock::now();
+
+    // Assimp의 aiProcess_ConvertToLeftHanded와 같은 변환: z 뒤집기 (F)
+    // 메쉬는 F를 곱해두고 노드 행렬은 F * M * F로 바꾸면
+    // 월드 행렬을 곱한 결과가 예전처럼 (버텍스 * M * F)가 됨
+    const Matrix toLeftHanded = Matrix::CreateScale(Vector3(1.0f, 1.0f, -1.0f));
+
+    const JsonValue &gltfNodes = gltf["nodes"];
+    const JsonValue &gltfMeshes = gltf["meshes"];
+    std::vector<const JsonValue *> items; // meshes와 같은 순서의 primitive
+    std::vector<int> meshRemap(gltfMeshes.Size(), -1); // 첫 primitive의 번호
+
+    std::function<void(size_t, int, int)> collect =
+        [&](size_t nodeIndex, int parent, int depth) {
+            const JsonValue &node = gltfNodes[nodeIndex];
+            if (node.IsNull() || depth > 256) // 잘못된 파일의 순환 참조 방지
+                return;
+
+            const int index = int(nodes.size());
+            SceneNode newNode;
+            newNode.parent = parent;
+            newNode.transform = toLeftHanded * NodeMatrix(node) * toLeftHanded;
+            nodes.push_back(newNode);
+
+            const int meshIndex = node["mesh"].AsInt();
+            if (meshIndex >= 0 && size_t(meshIndex) < meshRemap.size())
+            {
+                const JsonValue &primitives =
+                    gltfMeshes[size_t(meshIndex)]["primitives"];
+                if (meshRemap[meshIndex] < 0)
+                {
+                    meshRemap[meshIndex] = int(items.size());
+                    for (size_t p = 0; p < primitives.Size(); p++)
+                        items.push_back(&primitives[p]);
+                }
+                for (size_t p = 0; p < primitives.Size(); p++)
+                {
+                    instances.push_back(
+                        {uint32_t(meshRemap[meshIndex] + int(p)), uint32_t(index)});
+                }
+            }
+
+            const JsonValue &children = node["children"];
+            for (size_t c = 0; c < children.Size(); c++)
+                collect(size_t(children[c].AsInt()), index, depth + 1);
+        };
+
+    const JsonValue &scenes = gltf["scenes"];
+    const JsonValue &scene = scenes[size_t(gltf["scene"].AsInt(0))];
+    const JsonValue &rootNodes = scene["nodes"];
+    for (size_t i = 0; i < rootNodes.Size(); i++)
+        collect(size_t(rootNodes[i].AsInt()), -1, 0);
+
+    for (const auto *item : items)
+    {
+        const int mode = (*item)["mode"].AsInt(4);
+        if (mode != 4) // TRIANGLES만 지원
+            return false;
+    }
+
+    const double flattenMs = std::chrono::duration<double, std::milli>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count();
+
+    // 4. primitive마다 병렬로 디코딩
+    start = std::chrono::steady_clock::now();
+
+    const JsonValue &materials = gltf["materials"];
+    const JsonValue &textures = gltf["textures"];
+    const JsonValue &images = gltf["images"];
+
+    meshes.resize(items.size());
+    std::vector<char> succeeded(items.size(), 0);
+
+    ThreadPool::Get().ParallelFor(items.size(), [&](size_t i) {
+        const JsonValue &primitive = *items[i];
+        const JsonValue &attributes = primitive["attributes"];
+        MeshData &mesh = meshes[i];
+
+        Accessor position;
+        if (!GetAccessor(attributes["POSITION"].AsInt(), position))
+            return;
+
+        mesh.vertices.resize(position.count);
+        if (!DecodeAttribute(position, mesh.vertices.data(),
+                             offsetof(Vertex, position), 3))
+            return;
+
+        Accessor normal;
+        const bool hasNormals = GetAccessor(attributes["NORMAL"].AsInt(), normal) &&
+                                normal.count == position.count &&
+                                DecodeAttribute(normal, mesh.vertices.data(),
+                                                offsetof(Vertex, normal), 3);
+
+        // 정수로 양자화된 normal은 복원해도 길이가 정확히 1이 아님
+        // (조명과 여기서 구하는 탄젠트가 틀어지므로 바로 정규화)
+        if (hasNormals && normal.componentType != ComponentFloat)
+        {
+            for (auto &v : mesh.vertices)
+                v.normal.Normalize();
+        }
+
+        Accessor texcoord;
+        if (!(GetAccessor(attributes["TEXCOORD_0"].AsInt(), texcoord) &&
+              texcoord.count == position.count &&
+              DecodeAttribute(texcoord, mesh.vertices.data(),
+                              offsetof(Vertex, texcoord), 2)))
+        {
+            for (auto &v : mesh.vertices)
+                v.texcoord = Vector2(0.0f);
+        }
+
+        Accessor index;
+        if (GetAccessor(primitive["indices"].AsInt(), index))
+        {
+            mesh.indices.resize(index.count);
+            if (!DecodeIndices(index, mesh.indices.data()))
+                return;
+        }
+        else
+        {
+            mesh.indices.resize(position.count);
+            for (size_t j = 0; j < position.count; j++)
+                mesh.indices[j] = uint32_t(j);
+        }
+
+        mesh.indices.resize(mesh.indices.size() / 3 * 3);
+        for (const uint32_t idx : mesh.indices)
+        {
+            if (idx >= position.count)
+                return;
+        }
+
+        // 왼손 좌표계 (노드 행렬은 인스턴스에서 곱함)
+        // z 뒤집기는 역행렬의 전치가 자기 자신이라 normal도 같은 행렬
+        if (hasNormals)
+        {
+            VertexKernels::TransformVertices(mesh.vertices.data(),
+                                             mesh.vertices.size(), toLeftHanded);
+        }
+        else
+        {
+            VertexKernels::TransformPositions(mesh.vertices.data(),
+                                              mesh.vertices.size(), toLeftHanded);
+        }
+
+        // 좌표계를 뒤집었으므로 와인딩 순서도 뒤집기
+        for (size_t j = 0; j + 2 < mesh.indices.size(); j += 3)
+            std::swap(mesh.indices[j + 1], mesh.indices[j + 2]);
+
+        if (!hasNormals)
+        {
+            ComputeNormals(mesh);
+            for (auto &v : mesh.vertices)
+                v.normal.Normalize();
+        }
+
+        // 텍스춰는 ModelLoader와 같이 파일 이름만 사용
+        auto GetTextureFilename = [&](const JsonValue &textureInfo) {
+            const int textureIndex = textureInfo["index"].AsInt();
+            const JsonValue &image =
+                images[size_t(textures[size_t(textureIndex)]["source"].AsInt())];
+            if (textureIndex < 0 || image["uri"].string.empty())
+                return std::string();
+            return basePath +
+                   std::filesystem::path(image["uri"].string).filename().string();
+        };
+
+        // baseColorTexture -> textureFilename
+        const JsonValue &material =
+            materials[size_t(primitive["material"].AsInt())];
+        const JsonValue &pbr = material["pbrMetallicRoughness"];
+        mesh.textureFilename = GetTextureFilename(pbr["baseColorTexture"]);
+
+        // glTF 규칙: occlusion은 R, metallicRoughness는 G = 거칠기, B = 금속성
+        MaterialTextures &materialTextures = mesh.materialTextures;
+        materialTextures.occlusion.filename =
+            GetTextureFilename(material["occlusionTexture"]);
+        materialTextures.occlusion.channel = 0;
+        const std::string metallicRoughness =
+            GetTextureFilename(pbr["metallicRoughnessTexture"]);
+        materialTextures.roughness = {metallicRoughness, 1};
+        materialTextures.metallic = {metallicRoughness, 2};
+
+        succeeded[i] = 1;
+    });
+
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        if (!succeeded[i])
+        {
+            std::cout << filename << ": unsupported glTF primitive, "
+                      << "falling back to Assimp" << std::endl;
+            meshes.clear();
+            nodes.clear();
+            instances.clear();
+            return false;
+        }
+    }
+
+    const double decodeMs = std::chrono::duration<double, std::milli>(
+                                std::chrono::steady_clock::now() - start)
+                                .count();
+
+    std::cout << filename << ": " << meshes.size() << " meshes, "
+              << instances.size() << " instances (glTF fast path), parse " << parseMs
+              << " ms, flatten " << flattenMs << " ms, decode " << decodeMs
+              << " ms" << std::endl;
+
+    return true;
+}
+
+} // namespace FEFE
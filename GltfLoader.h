@@ -0,0 +1,36 @@
+﻿#pragma once
+
+#include <string>
+#include <vector>
+
+#include "MeshData.h"
+
+namespace FEFE
+{
+
+// glTF 2.0 (.gltf + 외부 .bin) 전용 로더
+// JSON은 한 번만 파싱하고 .bin은 메모리 매핑해서 accessor를 Vertex 배열로
+// 바로 디코딩 (KHR_mesh_quantization의 정수 형식도 지원)
+//
+// ModelLoader(Assimp)와 같은 결과가 나오도록
+// 왼손 좌표계 변환과 와인딩 순서 뒤집기를 같이 처리
+// 지원하지 않는 파일(.glb, data URI, sparse accessor 등)이면 false를 반환하고
+// 호출하는 쪽에서 ModelLoader로 넘어감
+class GltfLoader
+{
+  public:
+    bool Load(std::string basePath, std::string filename);
+
+    // .gltf가 참조하는 외부 버퍼(.bin) 경로 (data URI 제외)
+    // 메쉬 캐시 키에 버퍼 변경을 반영할 때 사용
+    static std::vector<std::string> GetBufferFilenames(std::string basePath,
+                                                       std::string filename);
+
+  public:
+    std::string basePath;
+    std::vector<MeshData> meshes; // primitive 하나당 하나 (노드 행렬 적용 X)
+    std::vector<SceneNode> nodes;
+    std::vector<MeshInstance> instances;
+};
+
+} // namespace FEFE
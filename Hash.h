@@ -0,0 +1,46 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace FEFE
+{
+
+// 캐시 키/중복 검사용 64비트 해시 (암호학적 용도 X)
+// 8바이트씩 처리하므로 큰 파일도 빠르게 해시할 수 있음
+inline uint64_t HashBytes(const void *data, size_t size, uint64_t seed = 0)
+{
+    const uint64_t prime = 0x9E3779B97F4A7C15ull;
+
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    uint64_t h = seed ^ (uint64_t(size) * prime);
+
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t w;
+        std::memcpy(&w, bytes + i, 8);
+        h = (h ^ w) * prime;
+        h ^= h >> 29;
+    }
+
+    uint64_t tail = 0;
+    std::memcpy(&tail, bytes + i, size - i);
+    h = (h ^ tail) * prime;
+
+    // murmur3 fmix64
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+inline uint64_t HashCombine(uint64_t h, uint64_t value)
+{
+    return HashBytes(&value, sizeof(value), h);
+}
+
+} // namespace FEFE
@@ -0,0 +1,1753 @@
+﻿#include "ImageDecoder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+
+#include "MappedFile.h"
+#include "TextureLoader.h" // ExpandToRgba()
+#include "ThreadPool.h"
+#include "stb_image.h"     // Benchmark()에서 비교용 (구현은 TextureLoader.cpp)
+
+// TextureLoader.cpp와 같은 기준 (x64는 항상 SSE2)
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FEFE_DECODER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace FEFE
+{
+
+namespace
+{
+
+// ---------------------------------------------------------------------------
+// JPEG
+// ---------------------------------------------------------------------------
+
+// 지그재그 순서 -> 자연 순서, 깨진 파일에서 k가 63을 넘어도 63에 쓰도록 여유
+const uint8_t zigzag[64 + 16] = {
+    0,  1,  8,  16, 9,  2,  3,  10, 17, 24, 32, 25, 18, 11, 4,  5,
+    12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6,  7,  14, 21, 28,
+    35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+    58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+    63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63};
+
+// 코드 길이 fastBits 이하는 표 한 번으로 디코딩
+const int jpegFastBits = 9;
+
+struct JpegHuffman
+{
+    uint16_t fast[1 << jpegFastBits] = {}; // (길이 << 8) | 심볼, 0이면 긴 코드
+    uint8_t symbols[256] = {};
+    int32_t maxCode[18] = {};     // 길이마다 (마지막 코드 + 1) << (16 - 길이)
+    int32_t valueOffset[17] = {}; // 코드 -> symbols 위치
+    bool defined = false;
+};
+
+bool BuildJpegHuffman(const uint8_t counts[16], const uint8_t *symbols,
+                      int numSymbols, JpegHuffman &table)
+{
+    table = JpegHuffman();
+    std::memcpy(table.symbols, symbols, size_t(numSymbols));
+
+    int code = 0;
+    int k = 0;
+    for (int length = 1; length <= 16; length++)
+    {
+        table.valueOffset[length] = k - code;
+        for (int i = 0; i < counts[length - 1]; i++, k++, code++)
+        {
+            if (length <= jpegFastBits)
+            {
+                const int shift = jpegFastBits - length;
+                for (int j = 0; j < (1 << shift); j++)
+                {
+                    table.fast[(code << shift) + j] =
+                        uint16_t(length << 8 | symbols[k]);
+                }
+            }
+        }
+        if (code > (1 << length))
+            return false;
+        table.maxCode[length] = code << (16 - length);
+        code <<= 1;
+    }
+    table.maxCode[17] = INT32_MAX;
+    table.defined = true;
+    return true;
+}
+
+// 엔트로피 부호 구간을 읽음 (왼쪽 정렬 64비트 버퍼)
+// 0xFF00은 0xFF, 다른 마커를 만나면 더 읽지 않고 0을 채움
+struct JpegBits
+{
+    const uint8_t *pos;
+    const uint8_t *end;
+    uint64_t bits = 0;
+    int count = 0;
+
+    void Fill()
+    {
+        while (count <= 56)
+        {
+            uint32_t byte = 0;
+            if (pos < end)
+            {
+                byte = *pos++;
+                if (byte == 0xFF)
+                {
+                    if (pos < end && *pos == 0x00)
+                        pos++;
+                    else
+                    {
+                        byte = 0;
+                        pos = end;
+                    }
+                }
+            }
+            bits |= uint64_t(byte) << (56 - count);
+            count += 8;
+        }
+    }
+
+    uint32_t Peek(int n) const { return uint32_t(bits >> (64 - n)); }
+    void Skip(int n)
+    {
+        bits <<= n;
+        count -= n;
+    }
+};
+
+// 호출 전에 32비트 이상 채워져 있어야 함 (심볼 16 + 값 16)
+inline int DecodeJpegSymbol(JpegBits &reader, const JpegHuffman &table)
+{
+    const uint32_t fast = table.fast[reader.Peek(jpegFastBits)];
+    if (fast)
+    {
+        reader.Skip(int(fast >> 8));
+        return int(fast & 0xFF);
+    }
+
+    const int32_t code = int32_t(reader.Peek(16));
+    for (int length = jpegFastBits + 1; length <= 16; length++)
+    {
+        if (code < table.maxCode[length])
+        {
+            reader.Skip(length);
+            const int index =
+                (code >> (16 - length)) + table.valueOffset[length];
+            return index < 256 ? table.symbols[index] : -1;
+        }
+    }
+    return -1;
+}
+
+inline int ReceiveExtend(JpegBits &reader, int size)
+{
+    const int value = int(reader.Peek(size));
+    reader.Skip(size);
+    return value < (1 << (size - 1)) ? value - (1 << size) + 1 : value;
+}
+
+// 블록 하나의 계수 (자연 순서, block은 0으로 초기화되어 있어야 함)
+bool DecodeJpegBlock(JpegBits &reader, const JpegHuffman &dc,
+                     const JpegHuffman &ac, int &dcPredictor, int16_t *block)
+{
+    if (reader.count < 32)
+        reader.Fill();
+    const int dcSize = DecodeJpegSymbol(reader, dc);
+    if (dcSize < 0 || dcSize > 15)
+        return false;
+    if (dcSize)
+        dcPredictor += ReceiveExtend(reader, dcSize);
+    block[0] = int16_t(dcPredictor);
+
+    for (int k = 1; k < 64;)
+    {
+        if (reader.count < 32)
+            reader.Fill();
+        const int rs = DecodeJpegSymbol(reader, ac);
+        if (rs < 0)
+            return false;
+        const int run = rs >> 4;
+        const int size = rs & 15;
+        if (size == 0)
+        {
+            if (run != 15)
+                break; // EOB
+            k += 16;
+            continue;
+        }
+        k += run;
+        block[zigzag[k]] = int16_t(ReceiveExtend(reader, size));
+        k++;
+    }
+    return true;
+}
+
+struct JpegComponent
+{
+    int id = 0;
+    int h = 1; // 샘플링 비율
+    int v = 1;
+    int quantTable = 0;
+    int dcTable = 0;
+    int acTable = 0;
+
+    int width = 0;  // 실제 샘플 수
+    int height = 0;
+    int blocksW = 0; // MCU 단위로 채운 블록 수
+    int blocksH = 0;
+    std::vector<int16_t> coefficients; // 블록마다 64개 (자연 순서)
+    std::vector<uint8_t> plane;        // blocksW * 8 x blocksH * 8
+};
+
+struct Jpeg
+{
+    uint16_t quant[4][64] = {}; // 자연 순서
+    JpegHuffman dc[4];
+    JpegHuffman ac[4];
+
+    int width = 0;
+    int height = 0;
+    int hMax = 1;
+    int vMax = 1;
+    int mcusX = 0;
+    int mcusY = 0;
+    int restartInterval = 0;
+    int adobeTransform = -1;
+    std::vector<JpegComponent> components;
+
+    // SOS 다음의 엔트로피 부호 (재시작 마커로 나눈 구간)
+    std::vector<const uint8_t *> intervalBegins;
+    std::vector<const uint8_t *> intervalEnds;
+};
+
+inline int ReadU16(const uint8_t *p) { return p[0] << 8 | p[1]; }
+
+bool ParseJpegTables(const uint8_t *segment, size_t size, uint8_t marker,
+                     Jpeg &jpeg)
+{
+    size_t pos = 0;
+    if (marker == 0xDB) // DQT
+    {
+        while (pos < size)
+        {
+            const int precision = segment[pos] >> 4;
+            const int index = segment[pos] & 15;
+            const size_t bytes = precision ? 128 : 64;
+            if (index > 3 || pos + 1 + bytes > size)
+                return false;
+            for (int k = 0; k < 64; k++)
+            {
+                jpeg.quant[index][zigzag[k]] =
+                    uint16_t(precision ? ReadU16(segment + pos + 1 + k * 2)
+                                       : segment[pos + 1 + k]);
+            }
+            pos += 1 + bytes;
+        }
+        return true;
+    }
+
+    // DHT
+    while (pos < size)
+    {
+        if (pos + 17 > size)
+            return false;
+        const int tableClass = segment[pos] >> 4;
+        const int index = segment[pos] & 15;
+        const uint8_t *counts = segment + pos + 1;
+        int numSymbols = 0;
+        for (int i = 0; i < 16; i++)
+            numSymbols += counts[i];
+        if (tableClass > 1 || index > 3 || numSymbols > 256 ||
+            pos + 17 + numSymbols > size)
+            return false;
+        JpegHuffman &table = tableClass ? jpeg.ac[index] : jpeg.dc[index];
+        if (!BuildJpegHuffman(counts, segment + pos + 17, numSymbols, table))
+            return false;
+        pos += 17 + size_t(numSymbols);
+    }
+    return true;
+}
+
+bool ParseJpegFrame(const uint8_t *segment, size_t size, Jpeg &jpeg)
+{
+    if (size < 6 || segment[0] != 8)
+        return false; // 8비트만
+    jpeg.height = ReadU16(segment + 1);
+    jpeg.width = ReadU16(segment + 3);
+    const int numComponents = segment[5];
+    if (jpeg.width == 0 || jpeg.height == 0 ||
+        (numComponents != 1 && numComponents != 3) ||
+        size < 6 + size_t(numComponents) * 3)
+        return false; // DNL, CMYK 등은 stbi
+
+    jpeg.components.resize(size_t(numComponents));
+    for (int c = 0; c < numComponents; c++)
+    {
+        JpegComponent &component = jpeg.components[size_t(c)];
+        const uint8_t *p = segment + 6 + c * 3;
+        component.id = p[0];
+        component.h = p[1] >> 4;
+        component.v = p[1] & 15;
+        component.quantTable = p[2];
+        if (component.h < 1 || component.h > 4 || component.v < 1 ||
+            component.v > 4 || component.quantTable > 3)
+            return false;
+    }
+    return true;
+}
+
+bool ParseJpegScan(const uint8_t *segment, size_t size, Jpeg &jpeg)
+{
+    // 모든 성분이 한 스캔에 들어있는 경우만 (baseline은 거의 항상)
+    const size_t numComponents = size ? segment[0] : 0;
+    if (jpeg.components.empty() || numComponents != jpeg.components.size() ||
+        size < 1 + numComponents * 2 + 3)
+        return false;
+
+    for (size_t i = 0; i < numComponents; i++)
+    {
+        const uint8_t *p = segment + 1 + i * 2;
+        auto it = std::find_if(
+            jpeg.components.begin(), jpeg.components.end(),
+            [&](const JpegComponent &component) { return component.id == p[0]; });
+        if (it == jpeg.components.end())
+            return false;
+        it->dcTable = p[1] >> 4;
+        it->acTable = p[1] & 15;
+        if (it->dcTable > 3 || it->acTable > 3 || !jpeg.dc[it->dcTable].defined ||
+            !jpeg.ac[it->acTable].defined)
+            return false;
+    }
+    return true;
+}
+
+// 마커를 읽고 SOS 다음 엔트로피 부호를 재시작 구간으로 나눔
+bool ParseJpeg(const uint8_t *data, size_t size, Jpeg &jpeg)
+{
+    size_t pos = 2;
+    const uint8_t *scan = nullptr;
+    while (!scan)
+    {
+        if (pos + 4 > size || data[pos] != 0xFF)
+            return false;
+        const uint8_t marker = data[pos + 1];
+        if (marker == 0xFF) // 채우기 바이트
+        {
+            pos++;
+            continue;
+        }
+        pos += 2;
+        if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8))
+            continue; // 길이 없는 마커
+        if (marker == 0xD9)
+            return false;
+
+        const size_t length = size_t(ReadU16(data + pos));
+        if (length < 2 || pos + length > size)
+            return false;
+        const uint8_t *segment = data + pos + 2;
+        const size_t segmentSize = length - 2;
+
+        switch (marker)
+        {
+        case 0xDB:
+        case 0xC4:
+            if (!ParseJpegTables(segment, segmentSize, marker, jpeg))
+                return false;
+            break;
+        case 0xC0: // baseline
+        case 0xC1: // extended (허프만)
+            if (!ParseJpegFrame(segment, segmentSize, jpeg))
+                return false;
+            break;
+        case 0xDD:
+            if (segmentSize < 2)
+                return false;
+            jpeg.restartInterval = ReadU16(segment);
+            break;
+        case 0xEE:
+            if (segmentSize >= 12 && std::memcmp(segment, "Adobe", 5) == 0)
+                jpeg.adobeTransform = segment[11];
+            break;
+        case 0xDA:
+            if (!ParseJpegScan(segment, segmentSize, jpeg))
+                return false;
+            scan = segment + segmentSize;
+            break;
+        default:
+            // progressive, lossless, 산술 부호 등은 stbi
+            if (marker >= 0xC2 && marker <= 0xCF)
+                return false;
+            break;
+        }
+        pos += length;
+    }
+
+    // 재시작 마커 위치 찾기 (0xFF 다음 0x00은 데이터)
+    const uint8_t *end = data + size;
+    const uint8_t *p = scan;
+    jpeg.intervalBegins.push_back(scan);
+    for (;;)
+    {
+        p = static_cast<const uint8_t *>(std::memchr(p, 0xFF, size_t(end - p)));
+        if (!p || p + 1 >= end)
+        {
+            jpeg.intervalEnds.push_back(end);
+            break;
+        }
+        const uint8_t next = p[1];
+        if (next == 0x00 || next == 0xFF)
+        {
+            p += next == 0x00 ? 2 : 1;
+            continue;
+        }
+        jpeg.intervalEnds.push_back(p);
+        if (next < 0xD0 || next > 0xD7)
+            break; // EOI 또는 다음 세그먼트
+        p += 2;
+        jpeg.intervalBegins.push_back(p);
+    }
+    return true;
+}
+
+bool SetupJpeg(Jpeg &jpeg)
+{
+    // 회색은 MCU가 블록 하나 (샘플링 비율 무시)
+    if (jpeg.components.size() == 1)
+    {
+        jpeg.components[0].h = 1;
+        jpeg.components[0].v = 1;
+    }
+    else
+    {
+        // Adobe RGB, 성분 id가 'R' 'G' 'B'인 파일은 YCbCr가 아님
+        if (jpeg.adobeTransform == 0 ||
+            (jpeg.components[0].id == 'R' && jpeg.components[1].id == 'G' &&
+             jpeg.components[2].id == 'B'))
+            return false;
+    }
+
+    for (const JpegComponent &component : jpeg.components)
+    {
+        jpeg.hMax = std::max(jpeg.hMax, component.h);
+        jpeg.vMax = std::max(jpeg.vMax, component.v);
+    }
+    if (size_t(jpeg.width) * jpeg.height > (size_t(1) << 28))
+        return false;
+
+    jpeg.mcusX = (jpeg.width + 8 * jpeg.hMax - 1) / (8 * jpeg.hMax);
+    jpeg.mcusY = (jpeg.height + 8 * jpeg.vMax - 1) / (8 * jpeg.vMax);
+    for (JpegComponent &component : jpeg.components)
+    {
+        if (jpeg.hMax % component.h || jpeg.vMax % component.v)
+            return false;
+        component.width =
+            (jpeg.width * component.h + jpeg.hMax - 1) / jpeg.hMax;
+        component.height =
+            (jpeg.height * component.v + jpeg.vMax - 1) / jpeg.vMax;
+        component.blocksW = jpeg.mcusX * component.h;
+        component.blocksH = jpeg.mcusY * component.v;
+        component.coefficients.assign(
+            size_t(component.blocksW) * component.blocksH * 64, 0);
+    }
+
+    // 재시작 구간 수가 맞지 않으면 깨진 파일
+    const size_t numMcus = size_t(jpeg.mcusX) * jpeg.mcusY;
+    const size_t numIntervals =
+        jpeg.restartInterval
+            ? (numMcus + jpeg.restartInterval - 1) / jpeg.restartInterval
+            : 1;
+    if (jpeg.intervalBegins.size() < numIntervals)
+        return false;
+    jpeg.intervalBegins.resize(numIntervals);
+    jpeg.intervalEnds.resize(numIntervals);
+    return true;
+}
+
+// 재시작 구간 하나 (DC 예측값은 구간마다 0부터)
+bool DecodeJpegInterval(Jpeg &jpeg, size_t interval)
+{
+    const size_t numMcus = size_t(jpeg.mcusX) * jpeg.mcusY;
+    const size_t intervalMcus =
+        jpeg.restartInterval ? size_t(jpeg.restartInterval) : numMcus;
+    const size_t begin = interval * intervalMcus;
+    const size_t end = std::min(begin + intervalMcus, numMcus);
+
+    JpegBits reader{jpeg.intervalBegins[interval], jpeg.intervalEnds[interval]};
+    int dcPredictors[3] = {};
+    for (size_t mcu = begin; mcu < end; mcu++)
+    {
+        const int mx = int(mcu % size_t(jpeg.mcusX));
+        const int my = int(mcu / size_t(jpeg.mcusX));
+        for (size_t c = 0; c < jpeg.components.size(); c++)
+        {
+            JpegComponent &component = jpeg.components[c];
+            for (int by = 0; by < component.v; by++)
+            {
+                for (int bx = 0; bx < component.h; bx++)
+                {
+                    const size_t block =
+                        size_t(my * component.v + by) * component.blocksW +
+                        size_t(mx * component.h + bx);
+                    if (!DecodeJpegBlock(reader, jpeg.dc[component.dcTable],
+                                         jpeg.ac[component.acTable],
+                                         dcPredictors[c],
+                                         component.coefficients.data() +
+                                             block * 64))
+                        return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// AAN 방식 1차원 IDCT (libjpeg jidctflt.c)
+// 입력은 역양자화하면서 aanScale을 곱해둔 값
+template <typename T> inline void Idct8(T (&v)[8])
+{
+    // 짝수 항
+    const T tmp10 = v[0] + v[4];
+    const T tmp11 = v[0] - v[4];
+    const T tmp13 = v[2] + v[6];
+    const T tmp12 = (v[2] - v[6]) * 1.414213562f - tmp13;
+    const T even0 = tmp10 + tmp13;
+    const T even3 = tmp10 - tmp13;
+    const T even1 = tmp11 + tmp12;
+    const T even2 = tmp11 - tmp12;
+
+    // 홀수 항
+    const T z13 = v[5] + v[3];
+    const T z10 = v[5] - v[3];
+    const T z11 = v[1] + v[7];
+    const T z12 = v[1] - v[7];
+    const T odd7 = z11 + z13;
+    const T odd11 = (z11 - z13) * 1.414213562f;
+    const T z5 = (z10 + z12) * 1.847759065f;
+    const T odd10 = z5 - z12 * 1.082392200f;
+    const T odd12 = z5 - z10 * 2.613125930f;
+    const T odd6 = odd12 - odd7;
+    const T odd5 = odd11 - odd6;
+    const T odd4 = odd10 - odd5;
+
+    v[0] = even0 + odd7;
+    v[7] = even0 - odd7;
+    v[1] = even1 + odd6;
+    v[6] = even1 - odd6;
+    v[2] = even2 + odd5;
+    v[5] = even2 - odd5;
+    v[3] = even3 + odd4;
+    v[4] = even3 - odd4;
+}
+
+// 역양자화 표에 AAN 배율과 1/8을 미리 곱해둠
+void MakeIdctTable(const uint16_t quant[64], float table[64])
+{
+    const float aanScale[8] = {1.0f,         1.387039845f, 1.306562965f,
+                               1.175875602f, 1.0f,         0.785694958f,
+                               0.541196100f, 0.275899379f};
+    for (int row = 0; row < 8; row++)
+    {
+        for (int col = 0; col < 8; col++)
+        {
+            table[row * 8 + col] =
+                float(quant[row * 8 + col]) * aanScale[row] * aanScale[col] /
+                8.0f;
+        }
+    }
+}
+
+inline uint8_t ClampToByte(int value)
+{
+    return uint8_t(std::min(std::max(value, 0), 255));
+}
+
+#ifdef FEFE_DECODER_SSE2
+
+struct Float4
+{
+    __m128 v;
+};
+inline Float4 operator+(Float4 a, Float4 b) { return {_mm_add_ps(a.v, b.v)}; }
+inline Float4 operator-(Float4 a, Float4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline Float4 operator*(Float4 a, float b)
+{
+    return {_mm_mul_ps(a.v, _mm_set1_ps(b))};
+}
+
+inline void Transpose4(Float4 *rows)
+{
+    _MM_TRANSPOSE4_PS(rows[0].v, rows[1].v, rows[2].v, rows[3].v);
+}
+
+// 8x8 블록을 왼쪽 (열 0~3), 오른쪽 (열 4~7) 반으로 나눠서 행 단위로 4개씩
+// 세로 IDCT -> 전치 -> 세로 IDCT -> 전치
+void IdctBlock(const int16_t *coefficients, const float *table, uint8_t *out,
+               size_t stride)
+{
+    const __m128i *rows = reinterpret_cast<const __m128i *>(coefficients);
+
+    // AC가 모두 0이면 DC 값으로 채움 (대부분의 크로마 블록)
+    __m128i ac = _mm_and_si128(_mm_loadu_si128(rows),
+                               _mm_set_epi16(-1, -1, -1, -1, -1, -1, -1, 0));
+    for (int row = 1; row < 8; row++)
+        ac = _mm_or_si128(ac, _mm_loadu_si128(rows + row));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(ac, _mm_setzero_si128())) == 0xFFFF)
+    {
+        const int value =
+            int(std::lround(coefficients[0] * table[0])) + 128;
+        for (int y = 0; y < 8; y++)
+            std::memset(out + y * stride, ClampToByte(value), 8);
+        return;
+    }
+
+    Float4 left[8];
+    Float4 right[8];
+    for (int row = 0; row < 8; row++)
+    {
+        const __m128i c = _mm_loadu_si128(rows + row);
+        const __m128i sign = _mm_srai_epi16(c, 15);
+        left[row].v = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(c, sign)),
+                                 _mm_loadu_ps(table + row * 8));
+        right[row].v = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(c, sign)),
+                                  _mm_loadu_ps(table + row * 8 + 4));
+    }
+
+    auto Transpose8 = [](Float4(&l)[8], Float4(&r)[8]) {
+        Transpose4(l);
+        Transpose4(l + 4);
+        Transpose4(r);
+        Transpose4(r + 4);
+        for (int i = 0; i < 4; i++)
+            std::swap(l[i + 4], r[i]);
+    };
+
+    Idct8(left);
+    Idct8(right);
+    Transpose8(left, right);
+    Idct8(left);
+    Idct8(right);
+    Transpose8(left, right);
+
+    const __m128 bias = _mm_set1_ps(128.0f);
+    for (int y = 0; y < 8; y++)
+    {
+        const __m128i lo = _mm_cvtps_epi32(_mm_add_ps(left[y].v, bias));
+        const __m128i hi = _mm_cvtps_epi32(_mm_add_ps(right[y].v, bias));
+        const __m128i packed16 = _mm_packs_epi32(lo, hi);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + y * stride),
+                         _mm_packus_epi16(packed16, packed16));
+    }
+}
+
+#else
+
+void IdctBlock(const int16_t *coefficients, const float *table, uint8_t *out,
+               size_t stride)
+{
+    float block[64];
+    for (int i = 0; i < 64; i++)
+        block[i] = coefficients[i] * table[i];
+
+    for (int col = 0; col < 8; col++)
+    {
+        float v[8];
+        for (int i = 0; i < 8; i++)
+            v[i] = block[i * 8 + col];
+        Idct8(v);
+        for (int i = 0; i < 8; i++)
+            block[i * 8 + col] = v[i];
+    }
+    for (int y = 0; y < 8; y++)
+    {
+        float v[8];
+        std::memcpy(v, block + y * 8, sizeof(v));
+        Idct8(v);
+        for (int x = 0; x < 8; x++)
+            out[y * stride + x] = ClampToByte(int(std::lround(v[x])) + 128);
+    }
+}
+
+#endif
+
+// 크로마 업샘플링 (stb_image와 같은 방식, 결과는 out[0, width))
+// near: 같은 위치의 행, far: 위 또는 아래 행
+void UpsampleRow(const JpegComponent &component, int hScale, int vScale,
+                 int y, uint8_t *out)
+{
+    const size_t stride = size_t(component.blocksW) * 8;
+    const int w = component.width;
+    const int nearRow = y / vScale;
+    const uint8_t *nearLine = component.plane.data() + nearRow * stride;
+
+    if (hScale == 2 && vScale <= 2)
+    {
+        // 세로 먼저: vScale이 2면 3 * near + far, 1이면 4 * near
+        const uint8_t *farLine = nearLine;
+        if (vScale == 2)
+        {
+            const int farRow = (y & 1) ? std::min(nearRow + 1, component.height - 1)
+                                       : std::max(nearRow - 1, 0);
+            farLine = component.plane.data() + farRow * stride;
+        }
+        auto T = [&](int x) { return 3 * nearLine[x] + farLine[x]; };
+
+        if (w == 1)
+        {
+            out[0] = out[1] = uint8_t((T(0) + 2) >> 2);
+            return;
+        }
+        int t1 = T(0);
+        out[0] = uint8_t((t1 + 2) >> 2);
+        for (int x = 1; x < w; x++)
+        {
+            const int t0 = t1;
+            t1 = T(x);
+            out[x * 2 - 1] = uint8_t((3 * t0 + t1 + 8) >> 4);
+            out[x * 2] = uint8_t((3 * t1 + t0 + 8) >> 4);
+        }
+        out[w * 2 - 1] = uint8_t((t1 + 2) >> 2);
+        return;
+    }
+
+    if (hScale == 1 && vScale == 2)
+    {
+        const int farRow = (y & 1) ? std::min(nearRow + 1, component.height - 1)
+                                   : std::max(nearRow - 1, 0);
+        const uint8_t *farLine = component.plane.data() + farRow * stride;
+        for (int x = 0; x < w; x++)
+            out[x] = uint8_t((3 * nearLine[x] + farLine[x] + 2) >> 2);
+        return;
+    }
+
+    // 나머지 비율은 가장 가까운 샘플
+    for (int x = 0; x < w * hScale; x++)
+        out[x] = nearLine[x / hScale];
+}
+
+// YCbCr -> RGBA, 16비트 고정소수점 (값 x 16, 계수 x 8192 / 128)
+// SSE2와 스칼라가 같은 결과
+const int16_t crToR = 11485;  // 1.402
+const int16_t cbToG = -2819;  // -0.344136
+const int16_t crToG = -5850;  // -0.714136
+const int16_t cbToB = 14516;  // 1.772
+
+inline int MulHigh(int a, int b) { return (a * b) >> 16; }
+
+void YCbCrToRgba(const uint8_t *y, const uint8_t *cb, const uint8_t *cr,
+                 int width, uint8_t *out)
+{
+    int x = 0;
+#ifdef FEFE_DECODER_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i offset = _mm_set1_epi16(128);
+    const __m128i round = _mm_set1_epi16(8);
+    const __m128i alpha = _mm_set1_epi8(char(0xFF));
+    for (; x + 8 <= width; x += 8)
+    {
+        const __m128i y16 = _mm_add_epi16(
+            _mm_slli_epi16(
+                _mm_unpacklo_epi8(
+                    _mm_loadl_epi64(reinterpret_cast<const __m128i *>(y + x)),
+                    zero),
+                4),
+            round);
+        const __m128i cb16 = _mm_slli_epi16(
+            _mm_sub_epi16(
+                _mm_unpacklo_epi8(
+                    _mm_loadl_epi64(reinterpret_cast<const __m128i *>(cb + x)),
+                    zero),
+                offset),
+            7);
+        const __m128i cr16 = _mm_slli_epi16(
+            _mm_sub_epi16(
+                _mm_unpacklo_epi8(
+                    _mm_loadl_epi64(reinterpret_cast<const __m128i *>(cr + x)),
+                    zero),
+                offset),
+            7);
+
+        const __m128i r = _mm_srai_epi16(
+            _mm_add_epi16(y16, _mm_mulhi_epi16(cr16, _mm_set1_epi16(crToR))), 4);
+        const __m128i g = _mm_srai_epi16(
+            _mm_add_epi16(
+                _mm_add_epi16(y16, _mm_mulhi_epi16(cb16, _mm_set1_epi16(cbToG))),
+                _mm_mulhi_epi16(cr16, _mm_set1_epi16(crToG))),
+            4);
+        const __m128i b = _mm_srai_epi16(
+            _mm_add_epi16(y16, _mm_mulhi_epi16(cb16, _mm_set1_epi16(cbToB))), 4);
+
+        const __m128i r8 = _mm_packus_epi16(r, r);
+        const __m128i g8 = _mm_packus_epi16(g, g);
+        const __m128i b8 = _mm_packus_epi16(b, b);
+        const __m128i rg = _mm_unpacklo_epi8(r8, g8);
+        const __m128i ba = _mm_unpacklo_epi8(b8, alpha);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + x * 4),
+                         _mm_unpacklo_epi16(rg, ba));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + x * 4 + 16),
+                         _mm_unpackhi_epi16(rg, ba));
+    }
+#endif
+    for (; x < width; x++)
+    {
+        const int y16 = y[x] * 16 + 8;
+        const int cb16 = (cb[x] - 128) * 128;
+        const int cr16 = (cr[x] - 128) * 128;
+        out[x * 4 + 0] = ClampToByte((y16 + MulHigh(cr16, crToR)) >> 4);
+        out[x * 4 + 1] = ClampToByte(
+            (y16 + MulHigh(cb16, cbToG) + MulHigh(cr16, crToG)) >> 4);
+        out[x * 4 + 2] = ClampToByte((y16 + MulHigh(cb16, cbToB)) >> 4);
+        out[x * 4 + 3] = 255;
+    }
+}
+
+bool DecodeJpeg(const uint8_t *data, size_t size, int &width, int &height,
+                int &channels, std::vector<uint8_t> &pixels)
+{
+    Jpeg jpeg;
+    if (!ParseJpeg(data, size, jpeg) || !SetupJpeg(jpeg))
+        return false;
+
+    ThreadPool &pool = ThreadPool::Get();
+
+    // 1. 허프만 디코딩 (재시작 구간마다 병렬)
+    std::atomic<bool> failed(false);
+    pool.ParallelFor(jpeg.intervalBegins.size(), [&](size_t interval) {
+        if (!DecodeJpegInterval(jpeg, interval))
+            failed = true;
+    });
+    if (failed)
+        return false;
+
+    // 2. 성분마다 블록 행 단위로 병렬 IDCT
+    float tables[4][64];
+    for (int i = 0; i < 4; i++)
+        MakeIdctTable(jpeg.quant[i], tables[i]);
+
+    std::vector<std::pair<size_t, int>> blockRows; // (성분, 블록 행)
+    for (size_t c = 0; c < jpeg.components.size(); c++)
+    {
+        JpegComponent &component = jpeg.components[c];
+        component.plane.resize(size_t(component.blocksW) * component.blocksH * 64);
+        for (int row = 0; row < component.blocksH; row++)
+            blockRows.push_back({c, row});
+    }
+    pool.ParallelFor(blockRows.size(), [&](size_t i) {
+        JpegComponent &component = jpeg.components[blockRows[i].first];
+        const int row = blockRows[i].second;
+        const size_t stride = size_t(component.blocksW) * 8;
+        const float *table = tables[component.quantTable];
+        for (int col = 0; col < component.blocksW; col++)
+        {
+            const size_t block = size_t(row) * component.blocksW + col;
+            IdctBlock(component.coefficients.data() + block * 64, table,
+                      component.plane.data() + row * 8 * stride + col * 8,
+                      stride);
+        }
+    });
+    for (JpegComponent &component : jpeg.components)
+        std::vector<int16_t>().swap(component.coefficients);
+
+    // 3. 출력 행마다 업샘플링 + 색 변환
+    width = jpeg.width;
+    height = jpeg.height;
+    channels = int(jpeg.components.size());
+    pixels.resize(size_t(width) * height * 4);
+
+    const size_t rowsPerChunk = 16;
+    pool.ParallelForChunks(size_t(height), rowsPerChunk, [&](size_t begin,
+                                                             size_t end) {
+        // 업샘플링한 성분 행 (전체 해상도 성분은 plane을 바로 사용)
+        std::vector<uint8_t> lines[3];
+        for (auto &line : lines)
+            line.resize(size_t(jpeg.mcusX) * jpeg.hMax * 8 + 16);
+
+        for (size_t y = begin; y < end; y++)
+        {
+            const uint8_t *rows[3] = {};
+            for (size_t c = 0; c < jpeg.components.size(); c++)
+            {
+                const JpegComponent &component = jpeg.components[c];
+                const int hScale = jpeg.hMax / component.h;
+                const int vScale = jpeg.vMax / component.v;
+                if (hScale == 1 && vScale == 1)
+                {
+                    rows[c] = component.plane.data() +
+                              y * size_t(component.blocksW) * 8;
+                }
+                else
+                {
+                    UpsampleRow(component, hScale, vScale, int(y),
+                                lines[c].data());
+                    rows[c] = lines[c].data();
+                }
+            }
+
+            uint8_t *out = pixels.data() + y * size_t(width) * 4;
+            if (channels == 1)
+                TextureLoader::ExpandToRgba(rows[0], 1, size_t(width), out);
+            else
+                YCbCrToRgba(rows[0], rows[1], rows[2], width, out);
+        }
+    });
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// PNG
+// ---------------------------------------------------------------------------
+
+// 코드 길이 inflateFastBits 이하는 표 한 번으로 디코딩
+const int inflateFastBits = 10;
+
+struct InflateHuffman
+{
+    uint16_t fast[1 << inflateFastBits] = {}; // (길이 << 9) | 심볼, 0이면 긴 코드
+    uint16_t firstCode[16] = {};
+    uint16_t firstSymbol[16] = {};
+    int32_t maxCode[17] = {}; // 비트를 뒤집은 16비트 값과 비교
+    uint16_t symbols[288] = {};
+};
+
+inline int ReverseBits(int value, int bits)
+{
+    int reversed = 0;
+    for (int i = 0; i < bits; i++)
+    {
+        reversed = (reversed << 1) | (value & 1);
+        value >>= 1;
+    }
+    return reversed;
+}
+
+bool BuildInflateHuffman(const uint8_t *lengths, int numSymbols,
+                         InflateHuffman &table)
+{
+    table = InflateHuffman();
+    int counts[16] = {};
+    for (int i = 0; i < numSymbols; i++)
+        counts[lengths[i]]++;
+    counts[0] = 0;
+
+    int nextCode[16] = {};
+    int code = 0;
+    int k = 0;
+    for (int length = 1; length < 16; length++)
+    {
+        nextCode[length] = code;
+        table.firstCode[length] = uint16_t(code);
+        table.firstSymbol[length] = uint16_t(k);
+        code += counts[length];
+        if (counts[length] && code - 1 >= (1 << length))
+            return false;
+        table.maxCode[length] = code << (16 - length);
+        code <<= 1;
+        k += counts[length];
+    }
+    table.maxCode[16] = 0x10000;
+
+    for (int symbol = 0; symbol < numSymbols; symbol++)
+    {
+        const int length = lengths[symbol];
+        if (!length)
+            continue;
+        const int index = table.firstSymbol[length] +
+                          (nextCode[length] - table.firstCode[length]);
+        table.symbols[index] = uint16_t(symbol);
+        if (length <= inflateFastBits)
+        {
+            for (int j = ReverseBits(nextCode[length], length);
+                 j < (1 << inflateFastBits); j += 1 << length)
+                table.fast[j] = uint16_t(length << 9 | symbol);
+        }
+        nextCode[length]++;
+    }
+    return true;
+}
+
+// deflate 비트 (LSB부터, 64비트 버퍼)
+struct InflateBits
+{
+    const uint8_t *pos;
+    const uint8_t *end;
+    uint64_t bits = 0;
+    int count = 0;
+    size_t overrun = 0; // 끝을 지나서 0으로 채운 바이트 수
+
+    void Fill()
+    {
+        if (end - pos >= 8)
+        {
+            // 리틀 엔디언 8바이트를 한 번에 (x86/x64)
+            uint64_t word;
+            std::memcpy(&word, pos, 8);
+            bits |= word << count;
+            pos += (63 - count) >> 3;
+            count |= 56;
+            return;
+        }
+        while (count <= 56)
+        {
+            if (pos < end)
+                bits |= uint64_t(*pos++) << count;
+            else
+                overrun++;
+            count += 8;
+        }
+    }
+
+    uint32_t Read(int n)
+    {
+        if (count < n)
+            Fill();
+        const uint32_t value = uint32_t(bits & ((uint64_t(1) << n) - 1));
+        bits >>= n;
+        count -= n;
+        return value;
+    }
+};
+
+// 호출 전에 15비트 이상 채워져 있어야 함
+inline int DecodeInflateSymbol(InflateBits &reader, const InflateHuffman &table)
+{
+    const uint32_t fast = table.fast[reader.bits & ((1 << inflateFastBits) - 1)];
+    if (fast)
+    {
+        const int length = int(fast >> 9);
+        reader.bits >>= length;
+        reader.count -= length;
+        return int(fast & 511);
+    }
+
+    const int code = ReverseBits(int(reader.bits & 0xFFFF), 16);
+    for (int length = inflateFastBits + 1; length < 16; length++)
+    {
+        if (code < table.maxCode[length])
+        {
+            reader.bits >>= length;
+            reader.count -= length;
+            const int index = (code >> (16 - length)) -
+                              table.firstCode[length] +
+                              table.firstSymbol[length];
+            return index < 288 ? table.symbols[index] : -1;
+        }
+    }
+    return -1;
+}
+
+const uint16_t lengthBase[29] = {3,  4,  5,  6,  7,  8,  9,  10,  11,  13,
+                                 15, 17, 19, 23, 27, 31, 35, 43,  51,  59,
+                                 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const uint8_t lengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+const uint16_t distanceBase[30] = {
+    1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,   65,    97,    129,
+    193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+const uint8_t distanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                   6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+// 압축 블록 하나 (out은 끝에 8바이트 여유가 있어야 함)
+bool InflateBlock(InflateBits &reader, const InflateHuffman &literals,
+                  const InflateHuffman &distances, uint8_t *begin,
+                  uint8_t *&out, uint8_t *end)
+{
+    for (;;)
+    {
+        // 길이 15 + 5, 거리 15 + 13
+        if (reader.count < 48)
+            reader.Fill();
+        int symbol = DecodeInflateSymbol(reader, literals);
+        if (symbol < 256)
+        {
+            if (symbol < 0 || out >= end)
+                return false;
+            *out++ = uint8_t(symbol);
+            continue;
+        }
+        if (symbol == 256)
+            return true;
+
+        symbol -= 257;
+        if (symbol >= 29)
+            return false;
+        size_t length = lengthBase[symbol];
+        if (lengthExtra[symbol])
+        {
+            length += reader.bits & ((1u << lengthExtra[symbol]) - 1);
+            reader.bits >>= lengthExtra[symbol];
+            reader.count -= lengthExtra[symbol];
+        }
+
+        symbol = DecodeInflateSymbol(reader, distances);
+        if (symbol < 0 || symbol >= 30)
+            return false;
+        size_t distance = distanceBase[symbol];
+        if (distanceExtra[symbol])
+        {
+            distance += reader.bits & ((1u << distanceExtra[symbol]) - 1);
+            reader.bits >>= distanceExtra[symbol];
+            reader.count -= distanceExtra[symbol];
+        }
+
+        if (distance > size_t(out - begin) || length > size_t(end - out))
+            return false;
+
+        // 거리가 8 이상이면 8바이트씩 (끝을 최대 7바이트 넘어서 씀)
+        const uint8_t *src = out - distance;
+        if (distance >= 8)
+        {
+            for (size_t i = 0; i < length; i += 8)
+                std::memcpy(out + i, src + i, 8);
+        }
+        else if (distance == 1)
+        {
+            std::memset(out, *src, length);
+        }
+        else
+        {
+            for (size_t i = 0; i < length; i++)
+                out[i] = src[i];
+        }
+        out += length;
+    }
+}
+
+// zlib 스트림을 size 바이트로 풀기 (정확히 size 바이트가 나와야 성공)
+bool Inflate(const uint8_t *data, size_t dataSize, std::vector<uint8_t> &output,
+             size_t size)
+{
+    if (dataSize < 2 || (data[0] & 15) != 8 || (data[0] << 8 | data[1]) % 31 ||
+        (data[1] & 0x20))
+        return false;
+
+    output.resize(size + 8);
+    uint8_t *begin = output.data();
+    uint8_t *out = begin;
+    uint8_t *end = begin + size;
+
+    InflateBits reader{data + 2, data + dataSize};
+    InflateHuffman literals;
+    InflateHuffman distances;
+
+    bool last = false;
+    while (!last)
+    {
+        last = reader.Read(1) != 0;
+        const uint32_t type = reader.Read(2);
+
+        if (type == 0)
+        {
+            // 저장 블록: 바이트 경계로 맞추고 그대로 복사
+            reader.Read(reader.count & 7);
+            const uint32_t length = reader.Read(16);
+            const uint32_t inverse = reader.Read(16);
+            if ((length ^ 0xFFFF) != inverse || length > size_t(end - out))
+                return false;
+            uint32_t copied = 0;
+            while (copied < length && reader.count >= 8)
+            {
+                *out++ = uint8_t(reader.Read(8));
+                copied++;
+            }
+            if (reader.overrun || size_t(reader.end - reader.pos) < length - copied)
+                return false;
+            std::memcpy(out, reader.pos, length - copied);
+            out += length - copied;
+            reader.pos += length - copied;
+            reader.bits = 0; // 미리 읽어둔 비트는 복사한 바이트
+            reader.count = 0;
+            continue;
+        }
+
+        if (type == 1)
+        {
+            uint8_t lengths[288 + 32];
+            std::memset(lengths, 8, 144);
+            std::memset(lengths + 144, 9, 112);
+            std::memset(lengths + 256, 7, 24);
+            std::memset(lengths + 280, 8, 8);
+            std::memset(lengths + 288, 5, 32);
+            BuildInflateHuffman(lengths, 288, literals);
+            BuildInflateHuffman(lengths + 288, 30, distances);
+        }
+        else if (type == 2)
+        {
+            const int numLiterals = int(reader.Read(5)) + 257;
+            const int numDistances = int(reader.Read(5)) + 1;
+            const int numCodeLengths = int(reader.Read(4)) + 4;
+
+            const uint8_t order[19] = {16, 17, 18, 0, 8,  7, 9,  6, 10, 5,
+                                       11, 4,  12, 3, 13, 2, 14, 1, 15};
+            uint8_t codeLengths[19] = {};
+            for (int i = 0; i < numCodeLengths; i++)
+                codeLengths[order[i]] = uint8_t(reader.Read(3));
+            InflateHuffman codeLengthTable;
+            if (!BuildInflateHuffman(codeLengths, 19, codeLengthTable))
+                return false;
+
+            uint8_t lengths[288 + 32] = {};
+            const int total = numLiterals + numDistances;
+            for (int i = 0; i < total;)
+            {
+                if (reader.count < 16)
+                    reader.Fill();
+                const int symbol = DecodeInflateSymbol(reader, codeLengthTable);
+                if (symbol < 0)
+                    return false;
+                if (symbol < 16)
+                {
+                    lengths[i++] = uint8_t(symbol);
+                    continue;
+                }
+
+                int repeat = 0;
+                uint8_t value = 0;
+                if (symbol == 16)
+                {
+                    if (i == 0)
+                        return false;
+                    repeat = 3 + int(reader.Read(2));
+                    value = lengths[i - 1];
+                }
+                else if (symbol == 17)
+                    repeat = 3 + int(reader.Read(3));
+                else
+                    repeat = 11 + int(reader.Read(7));
+                if (i + repeat > total)
+                    return false;
+                std::memset(lengths + i, value, size_t(repeat));
+                i += repeat;
+            }
+
+            if (!BuildInflateHuffman(lengths, numLiterals, literals) ||
+                !BuildInflateHuffman(lengths + numLiterals, numDistances,
+                                     distances))
+                return false;
+        }
+        else
+        {
+            return false;
+        }
+
+        if (!InflateBlock(reader, literals, distances, begin, out, end))
+            return false;
+        if (reader.overrun > 8)
+            return false;
+    }
+
+    output.resize(size);
+    return out == end;
+}
+
+inline int Paeth(int a, int b, int c)
+{
+    const int pa = std::abs(b - c);
+    const int pb = std::abs(a - c);
+    const int pc = std::abs(a + b - 2 * c);
+    if (pa <= pb && pa <= pc)
+        return a;
+    return pb <= pc ? b : c;
+}
+
+#ifdef FEFE_DECODER_SSE2
+
+inline __m128i LoadPixel(const uint8_t *p, int bpp)
+{
+    int32_t value = 0;
+    std::memcpy(&value, p, size_t(bpp));
+    return _mm_cvtsi32_si128(value);
+}
+
+inline void StorePixel(uint8_t *p, __m128i value, int bpp)
+{
+    const int32_t v = _mm_cvtsi128_si32(value);
+    std::memcpy(p, &v, size_t(bpp));
+}
+
+// 픽셀 3, 4바이트의 Sub/Avg/Paeth (픽셀 하나의 채널들을 한 번에)
+// 앞 픽셀에 의존하므로 픽셀 단위로 진행 (libpng filter_sse2_intrinsics.c)
+void UnfilterPixels(int filter, uint8_t *row, const uint8_t *prior,
+                    size_t rowBytes, int bpp)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i a = zero; // 왼쪽 (복원된 값)
+    __m128i c = zero; // 왼쪽 위
+    for (size_t x = 0; x + size_t(bpp) <= rowBytes; x += size_t(bpp))
+    {
+        const __m128i d = LoadPixel(row + x, bpp);
+        if (filter == 1)
+        {
+            a = _mm_add_epi8(d, a);
+        }
+        else if (filter == 3)
+        {
+            // (a + b) / 2, avg_epu8는 올림이라서 홀수일 때 1 빼기
+            const __m128i b = LoadPixel(prior + x, bpp);
+            __m128i average = _mm_avg_epu8(a, b);
+            average = _mm_sub_epi8(
+                average, _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi8(1)));
+            a = _mm_add_epi8(d, average);
+        }
+        else
+        {
+            const __m128i b = LoadPixel(prior + x, bpp);
+            const __m128i a16 = _mm_unpacklo_epi8(a, zero);
+            const __m128i b16 = _mm_unpacklo_epi8(b, zero);
+            const __m128i c16 = _mm_unpacklo_epi8(c, zero);
+
+            const __m128i paS = _mm_sub_epi16(b16, c16); // p - a
+            const __m128i pbS = _mm_sub_epi16(a16, c16); // p - b
+            const __m128i pcS = _mm_add_epi16(paS, pbS); // p - c
+            auto Abs = [&](__m128i x16) {
+                return _mm_max_epi16(x16, _mm_sub_epi16(zero, x16));
+            };
+            const __m128i pa = Abs(paS);
+            const __m128i pb = Abs(pbS);
+            const __m128i pc = Abs(pcS);
+            const __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+
+            // 같으면 a, b, c 순서로 우선
+            auto Select = [](__m128i mask, __m128i x16, __m128i y16) {
+                return _mm_or_si128(_mm_and_si128(mask, x16),
+                                    _mm_andnot_si128(mask, y16));
+            };
+            __m128i nearest =
+                Select(_mm_cmpeq_epi16(smallest, pb), b16, c16);
+            nearest = Select(_mm_cmpeq_epi16(smallest, pa), a16, nearest);
+
+            a = _mm_add_epi8(d, _mm_packus_epi16(nearest, nearest));
+            c = b;
+        }
+        StorePixel(row + x, a, bpp);
+    }
+}
+
+#endif
+
+// 행 하나의 필터 복원 (prior: 복원이 끝난 위 행, 첫 행은 0)
+void UnfilterRow(int filter, uint8_t *row, const uint8_t *prior,
+                 size_t rowBytes, int bpp)
+{
+    size_t x = 0;
+    switch (filter)
+    {
+    case 0:
+        return;
+
+    case 2: // Up
+#ifdef FEFE_DECODER_SSE2
+        for (; x + 16 <= rowBytes; x += 16)
+        {
+            __m128i *p = reinterpret_cast<__m128i *>(row + x);
+            _mm_storeu_si128(
+                p, _mm_add_epi8(_mm_loadu_si128(p),
+                                _mm_loadu_si128(
+                                    reinterpret_cast<const __m128i *>(prior + x))));
+        }
+#endif
+        for (; x < rowBytes; x++)
+            row[x] = uint8_t(row[x] + prior[x]);
+        return;
+
+    case 1:
+    case 3:
+    case 4:
+#ifdef FEFE_DECODER_SSE2
+        if (bpp == 3 || bpp == 4)
+        {
+            UnfilterPixels(filter, row, prior, rowBytes, bpp);
+            return;
+        }
+#endif
+        for (; x < rowBytes; x++)
+        {
+            const int a = x >= size_t(bpp) ? row[x - bpp] : 0;
+            const int b = prior[x];
+            const int c = x >= size_t(bpp) ? prior[x - bpp] : 0;
+            const int predictor =
+                filter == 1 ? a : filter == 3 ? (a + b) >> 1 : Paeth(a, b, c);
+            row[x] = uint8_t(row[x] + predictor);
+        }
+        return;
+    }
+}
+
+inline uint32_t ReadU32(const uint8_t *p)
+{
+    return uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8 |
+           p[3];
+}
+
+bool DecodePng(const uint8_t *data, size_t size, int &width, int &height,
+               int &channels, std::vector<uint8_t> &pixels)
+{
+    uint32_t w = 0, h = 0;
+    int bitDepth = 0;
+    int colorType = -1;
+    uint8_t palette[256][4];
+    int numPalette = 0;
+    bool hasKey = false;
+    uint16_t key[3] = {};
+    std::vector<std::pair<const uint8_t *, size_t>> chunks; // IDAT
+
+    size_t pos = 8;
+    for (;;)
+    {
+        if (pos + 12 > size)
+            return false;
+        const uint32_t length = ReadU32(data + pos);
+        const uint8_t *type = data + pos + 4;
+        const uint8_t *chunk = data + pos + 8;
+        if (length > size - pos - 12)
+            return false;
+        pos += 12 + size_t(length);
+
+        if (std::memcmp(type, "IHDR", 4) == 0)
+        {
+            if (length < 13)
+                return false;
+            w = ReadU32(chunk);
+            h = ReadU32(chunk + 4);
+            bitDepth = chunk[8];
+            colorType = chunk[9];
+            if (chunk[10] != 0 || chunk[11] != 0 || chunk[12] != 0)
+                return false; // 인터레이스는 stbi
+            const bool valid =
+                (colorType == 0 && (bitDepth == 1 || bitDepth == 2 ||
+                                    bitDepth == 4 || bitDepth == 8)) ||
+                (colorType == 3 && (bitDepth == 1 || bitDepth == 2 ||
+                                    bitDepth == 4 || bitDepth == 8)) ||
+                ((colorType == 2 || colorType == 4 || colorType == 6) &&
+                 bitDepth == 8);
+            if (!valid || w == 0 || h == 0 ||
+                uint64_t(w) * h > (uint64_t(1) << 28))
+                return false; // 16비트는 stbi
+        }
+        else if (std::memcmp(type, "PLTE", 4) == 0)
+        {
+            numPalette = int(std::min<uint32_t>(length / 3, 256));
+            for (int i = 0; i < numPalette; i++)
+            {
+                std::memcpy(palette[i], chunk + i * 3, 3);
+                palette[i][3] = 255;
+            }
+        }
+        else if (std::memcmp(type, "tRNS", 4) == 0)
+        {
+            if (colorType == 3)
+            {
+                for (uint32_t i = 0; i < length && int(i) < numPalette; i++)
+                    palette[i][3] = chunk[i];
+            }
+            else if (colorType == 0 && length >= 2)
+            {
+                hasKey = true;
+                key[0] = uint16_t(chunk[0] << 8 | chunk[1]);
+            }
+            else if (colorType == 2 && length >= 6)
+            {
+                hasKey = true;
+                for (int i = 0; i < 3; i++)
+                    key[i] = uint16_t(chunk[i * 2] << 8 | chunk[i * 2 + 1]);
+            }
+        }
+        else if (std::memcmp(type, "IDAT", 4) == 0)
+        {
+            chunks.push_back({chunk, size_t(length)});
+        }
+        else if (std::memcmp(type, "IEND", 4) == 0)
+        {
+            break;
+        }
+        else if (!(type[0] & 0x20))
+        {
+            return false; // 모르는 필수 청크 (CgBI 등)
+        }
+    }
+    if (colorType < 0 || chunks.empty() || (colorType == 3 && numPalette == 0))
+        return false;
+
+    // IDAT가 여러 개면 이어 붙임
+    std::vector<uint8_t> joined;
+    const uint8_t *compressed = chunks[0].first;
+    size_t compressedSize = chunks[0].second;
+    if (chunks.size() > 1)
+    {
+        for (const auto &chunk : chunks)
+            joined.insert(joined.end(), chunk.first, chunk.first + chunk.second);
+        compressed = joined.data();
+        compressedSize = joined.size();
+    }
+
+    const int samples = colorType == 2   ? 3
+                        : colorType == 4 ? 2
+                        : colorType == 6 ? 4
+                                         : 1;
+    const size_t rowBytes = (size_t(w) * samples * bitDepth + 7) / 8;
+    const int bpp = std::max(samples * bitDepth / 8, 1);
+
+    std::vector<uint8_t> filtered;
+    if (!Inflate(compressed, compressedSize, filtered, (rowBytes + 1) * h))
+        return false;
+    std::vector<uint8_t>().swap(joined);
+
+    // 필터 복원 (위 행에 의존하므로 순서대로)
+    const std::vector<uint8_t> zeros(rowBytes, 0);
+    for (uint32_t y = 0; y < h; y++)
+    {
+        uint8_t *row = filtered.data() + y * (rowBytes + 1);
+        if (row[0] > 4)
+            return false;
+        const uint8_t *prior = y ? row - rowBytes : zeros.data();
+        UnfilterRow(row[0], row + 1, prior, rowBytes, bpp);
+    }
+
+    width = int(w);
+    height = int(h);
+    channels = colorType == 3 ? 3 : samples;
+    if (colorType == 3)
+    {
+        for (int i = 0; i < numPalette; i++)
+        {
+            if (palette[i][3] != 255)
+                channels = 4;
+        }
+    }
+    else if (hasKey)
+    {
+        channels++;
+    }
+    pixels.resize(size_t(w) * h * 4);
+
+    // RGBA로 변환 (행마다 독립이라서 병렬)
+    ThreadPool::Get().ParallelForChunks(h, 64, [&](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; y++)
+        {
+            const uint8_t *row = filtered.data() + y * (rowBytes + 1) + 1;
+            uint8_t *out = pixels.data() + y * size_t(w) * 4;
+
+            if (bitDepth == 8 && colorType != 3)
+            {
+                TextureLoader::ExpandToRgba(row, samples, w, out);
+                if (hasKey)
+                {
+                    for (uint32_t x = 0; x < w; x++)
+                    {
+                        const uint8_t *p = row + x * samples;
+                        const bool match =
+                            colorType == 0 ? p[0] == key[0]
+                                           : p[0] == key[0] && p[1] == key[1] &&
+                                                 p[2] == key[2];
+                        if (match)
+                            out[x * 4 + 3] = 0;
+                    }
+                }
+                continue;
+            }
+
+            // 팔레트 또는 8비트 미만 회색
+            const int mask = (1 << bitDepth) - 1;
+            const int scale = colorType == 0 ? 255 / mask : 1;
+            for (uint32_t x = 0; x < w; x++)
+            {
+                const size_t bit = size_t(x) * bitDepth;
+                const int value =
+                    (row[bit >> 3] >> (8 - bitDepth - int(bit & 7))) & mask;
+                if (colorType == 3)
+                {
+                    if (value < numPalette)
+                        std::memcpy(out + x * 4, palette[value], 4);
+                    else
+                        std::memset(out + x * 4, 0, 4);
+                    continue;
+                }
+                const uint8_t gray = uint8_t(value * scale);
+                out[x * 4 + 0] = out[x * 4 + 1] = out[x * 4 + 2] = gray;
+                out[x * 4 + 3] = hasKey && value == key[0] ? 0 : 255;
+            }
+        }
+    });
+    return true;
+}
+
+} // namespace
+
+bool ImageDecoder::IsJpeg(const uint8_t *data, size_t size)
+{
+    return size >= 3 && data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF;
+}
+
+bool ImageDecoder::IsPng(const uint8_t *data, size_t size)
+{
+    const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    return size >= 8 && std::memcmp(data, signature, 8) == 0;
+}
+
+bool ImageDecoder::Decode(const uint8_t *data, size_t size, int &width,
+                          int &height, int &channels,
+                          std::vector<uint8_t> &pixels)
+{
+    bool decoded = false;
+    if (IsJpeg(data, size))
+        decoded = DecodeJpeg(data, size, width, height, channels, pixels);
+    else if (IsPng(data, size))
+        decoded = DecodePng(data, size, width, height, channels, pixels);
+    if (!decoded)
+        pixels.clear();
+    return decoded;
+}
+
+const char *ImageDecoder::GetInstructionSet()
+{
+#ifdef FEFE_DECODER_SSE2
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+void ImageDecoder::Benchmark(const std::string &directory, int repeat)
+{
+    namespace fs = std::filesystem;
+
+    std::vector<std::string> filenames;
+    std::error_code error;
+    for (fs::recursive_directory_iterator it(directory, error), end;
+         !error && it != end; it.increment(error))
+    {
+        std::string extension = it->path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+                       [](unsigned char c) { return char(std::tolower(c)); });
+        if (extension == ".jpg" || extension == ".jpeg" || extension == ".png")
+            filenames.push_back(it->path().string());
+    }
+    std::sort(filenames.begin(), filenames.end());
+
+    auto Measure = [&](const std::function<bool()> &func, double &best) {
+        best = 1e30;
+        bool succeeded = true;
+        for (int i = 0; i < std::max(repeat, 1); i++)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            succeeded = func() && succeeded;
+            best = std::min(best, std::chrono::duration<double, std::milli>(
+                                      std::chrono::steady_clock::now() - start)
+                                      .count());
+        }
+        return succeeded;
+    };
+
+    // 형식마다 합계 (출력 RGBA 바이트 / 시간)
+    struct Total
+    {
+        double fastMs = 0.0;
+        double stbiMs = 0.0;
+        size_t bytes = 0;
+        int files = 0;
+        int fallbacks = 0;
+    };
+    Total totals[2]; // JPEG, PNG
+
+    const size_t numThreads = ThreadPool::Get().GetNumThreads() + 1;
+    for (const std::string &filename : filenames)
+    {
+        MappedFile file;
+        if (!file.Open(filename))
+            continue;
+        const uint8_t *data = file.GetData();
+        const size_t size = file.GetSize();
+        Total &total = totals[IsPng(data, size) ? 1 : 0];
+
+        int width = 0, height = 0, channels = 0;
+        std::vector<uint8_t> pixels;
+        double fastMs = 0.0;
+        const bool decoded = Measure(
+            [&] { return Decode(data, size, width, height, channels, pixels); },
+            fastMs);
+
+        int stbiWidth = 0, stbiHeight = 0, stbiChannels = 0;
+        stbi_uc *stbiPixels = nullptr;
+        double stbiMs = 0.0;
+        Measure(
+            [&] {
+                stbi_image_free(stbiPixels);
+                stbiPixels = stbi_load_from_memory(data, int(size), &stbiWidth,
+                                                   &stbiHeight, &stbiChannels, 4);
+                return stbiPixels != nullptr;
+            },
+            stbiMs);
+        if (!stbiPixels)
+        {
+            std::cout << "ImageDecoder " << filename << ": stbi failed ("
+                      << stbi_failure_reason() << ")" << std::endl;
+            continue;
+        }
+
+        // 지원하지 않는 파일은 실제로도 stbi로 읽으므로 같은 시간
+        int maxDifference = 0;
+        if (decoded && width == stbiWidth && height == stbiHeight)
+        {
+            for (size_t i = 0; i < pixels.size(); i++)
+            {
+                maxDifference = std::max(
+                    maxDifference, std::abs(int(pixels[i]) - int(stbiPixels[i])));
+            }
+        }
+        else if (decoded)
+        {
+            maxDifference = 255;
+        }
+        else
+        {
+            fastMs = stbiMs;
+            total.fallbacks++;
+        }
+        stbi_image_free(stbiPixels);
+
+        const size_t bytes = size_t(stbiWidth) * stbiHeight * 4;
+        total.fastMs += fastMs;
+        total.stbiMs += stbiMs;
+        total.bytes += bytes;
+        total.files++;
+
+        std::cout << "ImageDecoder " << filename << " " << stbiWidth << "x"
+                  << stbiHeight << "x" << stbiChannels << ": ";
+        if (decoded)
+        {
+            std::cout << fastMs << " ms, stbi " << stbiMs << " ms (x"
+                      << stbiMs / std::max(fastMs, 1e-6)
+                      << "), max difference " << maxDifference;
+        }
+        else
+        {
+            std::cout << "not supported, stbi " << stbiMs << " ms";
+        }
+        std::cout << std::endl;
+    }
+
+    const char *names[2] = {"JPEG", "PNG"};
+    for (int i = 0; i < 2; i++)
+    {
+        const Total &total = totals[i];
+        if (!total.files)
+            continue;
+        const double megabytes = double(total.bytes) / (1024.0 * 1024.0);
+        std::cout << "ImageDecoder " << names[i] << " " << total.files
+                  << " files (" << total.fallbacks << " stbi fallback): "
+                  << GetInstructionSet() << " x" << numThreads << " "
+                  << megabytes / (total.fastMs / 1000.0) << " MB/s, stbi "
+                  << megabytes / (total.stbiMs / 1000.0) << " MB/s" << std::endl;
+    }
+}
+
+} // namespace FEFE
@@ -0,0 +1,48 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace FEFE
+{
+
+// 이미지 파일 디코딩 방식
+enum class ImageDecoderBackend
+{
+    Fast, // ImageDecoder, 지원하지 않는 파일은 stbi로 다시 시도
+    Stbi, // 항상 stb_image
+};
+
+// JPEG/PNG를 RGBA 8비트로 디코딩 (stb_image보다 빠른 경로)
+//
+// JPEG: baseline (SOF0/SOF1), 8비트, 회색 또는 YCbCr
+//   1. 허프만 디코딩 (재시작 구간(DRI)이 있으면 구간마다 병렬)
+//   2. 블록 행마다 병렬로 IDCT (SSE2, 0이 아닌 AC가 없는 블록은 DC만)
+//   3. 출력 행마다 병렬로 크로마 업샘플링 + YCbCr -> RGB (SSE2 고정소수점)
+//   업샘플링은 stb_image와 같은 방식 (2x1, 2x2는 삼각 필터)
+// PNG: 8비트 이하, 인터레이스 없음
+//   1. 자체 inflate (빠른 허프만 테이블, 겹치지 않는 복사는 8바이트씩)
+//   2. 행 필터 복원 (Up은 16바이트씩, 3/4바이트 픽셀의 Sub/Avg/Paeth는 SSE2)
+//
+// progressive JPEG, 16비트 PNG, 인터레이스 PNG 등은 false (stbi로 읽음)
+class ImageDecoder
+{
+  public:
+    // 파일 내용을 RGBA로 디코딩, 지원하지 않는 형식이거나 깨진 파일이면 false
+    // channels: 원본 채널 수 (1~4)
+    static bool Decode(const uint8_t *data, size_t size, int &width,
+                       int &height, int &channels, std::vector<uint8_t> &pixels);
+
+    static bool IsJpeg(const uint8_t *data, size_t size);
+    static bool IsPng(const uint8_t *data, size_t size);
+
+    static const char *GetInstructionSet();
+
+    // directory 아래 (하위 폴더 포함) .jpg/.jpeg/.png를 stbi와 비교해서 콘솔 출력
+    // 형식마다 출력 RGBA 기준 MB/s, 파일마다 시간과 stbi와의 최대 차이
+    static void Benchmark(const std::string &directory, int repeat = 3);
+};
+
+} // namespace FEFE
@@ -0,0 +1,40 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace FEFE
+{
+
+// 읽기 전용 메모리 매핑 파일
+// 파일 내용을 별도 버퍼로 복사하지 않고 포인터로 바로 접근
+class MappedFile
+{
+  public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    bool Open(const std::string &filename);
+    void Close();
+
+    bool IsOpen() const { return m_data != nullptr; }
+    const uint8_t *GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+
+  private:
+    const uint8_t *m_data = nullptr;
+    size_t m_size = 0;
+
+#ifdef _WIN32
+    void *m_file = nullptr;
+    void *m_mapping = nullptr;
+#endif
+};
+
+} // namespace FEFE
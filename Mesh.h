@@ -2,14 +2,20 @@
 
 #include <d3d11.h>
 #include <DirectXMath.h>
+#include <directxtk/SimpleMath.h>
 #include <vector>
 #include <iostream>
+#include <memory>
+#include <utility>
 
 #include <d3d11.h>
 #include <windows.h>
 #include <wrl.h> // ComPtr
 #include <vector>
 
+#include "MeshData.h" // MeshLod, Meshlet
+#include "TextureCache.h"
+
 namespace FEFE 
 {
 
@@ -23,10 +29,46 @@ struct Mesh
     ComPtr<ID3D11Buffer> indexBuffer;
     ComPtr<ID3D11Buffer> vertexConstantBuffer;
     ComPtr<ID3D11Buffer> pixelConstantBuffer;
+    ComPtr<ID3D11Buffer> materialConstantBuffer; // MaterialConstantBuffer
+
+    // 같은 이미지를 쓰는 메쉬끼리 공유 (TextureCache)
+    std::shared_ptr<CachedTexture> texture;
+
+    // R = AO, G = 거칠기, B = 금속성, A = 높이 (ChannelPacker)
+    // 원본이 없던 값은 채널이 -1이고 텍스춰에는 기본값이 들어있음
+    std::shared_ptr<CachedTexture> packedTexture;
+    MaterialChannels packedChannels;
 
-    ComPtr<ID3D11Texture2D> texture;
-    ComPtr<ID3D11ShaderResourceView> textureResourceView;
+    // 모델 좌표 1당 uv 변화량 (TextureResidency가 필요한 mip을 정할 때 사용)
+    float m_uvDensity = 0.0f;
 
     UINT m_indexCount = 0;
+    UINT m_vertexStride = 0; // sizeof(Vertex), sizeof(VertexPacked) 등
+    DXGI_FORMAT m_indexFormat = DXGI_FORMAT_R32_UINT; // R16_UINT 또는 R32_UINT
+
+    // 인덱스 버퍼 안의 LOD 구간 (비어있으면 m_indexCount 전체를 그림)
+    std::vector<MeshLod> m_lods;
+
+    // LOD 선택에 사용하는 경계 구 (모델 좌표)
+    DirectX::SimpleMath::Vector3 m_boundingCenter;
+    float m_boundingRadius = 0.0f;
+
+    // LOD마다 나눈 meshlet (MeshletBuilder)
+    std::vector<Meshlet> m_meshlets;
+};
+
+// 같은 Mesh(버퍼)를 다른 위치에 그릴 때 하나씩 (SceneData의 MeshInstance)
+// LOD와 컬링 결과는 화면에서의 위치에 따라 다르므로 인스턴스마다 가짐
+struct MeshRenderInstance
+{
+    std::shared_ptr<Mesh> mesh;
+    DirectX::SimpleMath::Matrix m_transform; // 노드의 월드 행렬
+
+    size_t m_lodLevel = 0; // 이번 프레임에 그릴 LOD
+    float m_pixelsPerUnit = 0.0f; // 이번 프레임에 모델 좌표 1이 화면에서 몇 픽셀인지
+
+    // 이번 프레임에 컬링하고 남은 인덱스 구간 (시작 인덱스, 인덱스 수)
+    // 연속된 meshlet은 하나로 합쳐서 DrawIndexed() 호출 수를 줄임
+    std::vector<std::pair<UINT, UINT>> m_drawRanges;
 };
 } // namespace FEFE
@@ -0,0 +1,318 @@
+﻿#include "MeshCache.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+#include "GltfLoader.h"
+#include "Hash.h"
+
+namespace FEFE
+{
+
+namespace
+{
+
+const char cacheMagic[8] = {'F', 'E', 'F', 'E', 'M', 'E', 'S', 'H'};
+const size_t cacheAlignment = 16;
+
+struct MeshCacheHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t numMeshes;
+    uint64_t key;
+    uint64_t fileSize;
+    uint64_t nodeOffset;
+    uint64_t instanceOffset;
+    uint32_t numNodes;
+    uint32_t numInstances;
+};
+
+struct MeshCacheEntry
+{
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+    uint64_t textureOffset;
+    uint64_t lodOffset;
+    uint64_t meshletOffset;
+    uint64_t packedTextureOffset;
+    uint32_t numVertices;
+    uint32_t numIndices;
+    uint32_t textureLength;
+    uint32_t numLods;
+    uint32_t numMeshlets;
+    uint32_t packedTextureLength;
+    MaterialChannels packedChannels;
+    float uvDensity;
+};
+
+static_assert(sizeof(MeshCacheHeader) == 56, "MeshCacheHeader layout");
+static_assert(sizeof(MeshCacheEntry) == 80, "MeshCacheEntry layout");
+
+size_t AlignUp(size_t offset)
+{
+    return (offset + cacheAlignment - 1) & ~(cacheAlignment - 1);
+}
+
+} // namespace
+
+uint64_t MeshCache::MakeKey(const std::string &sourceFilename,
+                            uint32_t importFlags)
+{
+    MappedFile source;
+    if (!source.Open(sourceFilename))
+        return 0;
+
+    // 텍스춰 경로가 basePath를 포함하므로 경로도 키에 포함
+    uint64_t key = HashBytes(source.GetData(), source.GetSize());
+    key = HashBytes(sourceFilename.data(), sourceFilename.size(), key);
+    key = HashCombine(key, importFlags);
+    key = HashCombine(key, version);
+    key = HashCombine(key, sizeof(Vertex));
+
+    // .gltf는 JSON만 작고 실제 데이터는 외부 .bin에 있으므로
+    // 버퍼 파일의 크기와 수정 시각도 키에 포함 (내용 해시는 warm start가 느려짐)
+    const std::filesystem::path path(sourceFilename);
+    for (const std::string &bufferFilename : GltfLoader::GetBufferFilenames(
+             path.parent_path().string() + "/", path.filename().string()))
+    {
+        std::error_code errorCode;
+        const uint64_t size =
+            std::filesystem::file_size(bufferFilename, errorCode);
+        if (errorCode)
+            return 0;
+        const auto writeTime =
+            std::filesystem::last_write_time(bufferFilename, errorCode);
+        if (errorCode)
+            return 0;
+
+        key = HashBytes(bufferFilename.data(), bufferFilename.size(), key);
+        key = HashCombine(key, size);
+        key = HashCombine(key, uint64_t(writeTime.time_since_epoch().count()));
+    }
+    return key;
+}
+
+bool MeshCache::Write(const std::string &cacheFilename, uint64_t key,
+                      const SceneData &scene)
+{
+    const std::vector<MeshData> &meshes = scene.meshes;
+
+    // 1. 각 배열이 들어갈 위치 계산
+    std::vector<MeshCacheEntry> entries(meshes.size());
+
+    size_t offset = sizeof(MeshCacheHeader) +
+                    sizeof(MeshCacheEntry) * meshes.size();
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+        MeshCacheEntry &e = entries[i];
+        e = MeshCacheEntry();
+        e.numVertices = uint32_t(meshes[i].vertices.size());
+        e.numIndices = uint32_t(meshes[i].indices.size());
+        e.textureLength = uint32_t(meshes[i].textureFilename.size());
+        e.numLods = uint32_t(meshes[i].lods.size());
+        e.numMeshlets = uint32_t(meshes[i].meshlets.size());
+        e.packedTextureLength =
+            uint32_t(meshes[i].packedTextureFilename.size());
+        e.packedChannels = meshes[i].packedChannels;
+        e.uvDensity = meshes[i].uvDensity;
+
+        offset = AlignUp(offset);
+        e.vertexOffset = offset;
+        offset += sizeof(Vertex) * e.numVertices;
+
+        offset = AlignUp(offset);
+        e.indexOffset = offset;
+        offset += sizeof(uint32_t) * e.numIndices;
+
+        e.lodOffset = offset;
+        offset += sizeof(MeshLod) * e.numLods;
+
+        e.meshletOffset = offset;
+        offset += sizeof(Meshlet) * e.numMeshlets;
+
+        e.textureOffset = offset;
+        offset += e.textureLength;
+
+        e.packedTextureOffset = offset;
+        offset += e.packedTextureLength;
+    }
+
+    MeshCacheHeader header;
+    std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+    header.version = version;
+    header.numMeshes = uint32_t(meshes.size());
+    header.key = key;
+    header.numNodes = uint32_t(scene.nodes.size());
+    header.numInstances = uint32_t(scene.instances.size());
+
+    // 노드/인스턴스는 메쉬 뒤에
+    offset = AlignUp(offset);
+    header.nodeOffset = offset;
+    offset += sizeof(SceneNode) * header.numNodes;
+    header.instanceOffset = offset;
+    offset += sizeof(MeshInstance) * header.numInstances;
+
+    header.fileSize = offset;
+
+    // 2. 한 번에 메모리에서 조립 후 저장
+    std::vector<uint8_t> blob(offset, 0);
+    std::memcpy(blob.data(), &header, sizeof(header));
+    std::memcpy(blob.data() + sizeof(header), entries.data(),
+                sizeof(MeshCacheEntry) * entries.size());
+
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+        const MeshCacheEntry &e = entries[i];
+        std::memcpy(blob.data() + e.vertexOffset, meshes[i].vertices.data(),
+                    sizeof(Vertex) * e.numVertices);
+        std::memcpy(blob.data() + e.indexOffset, meshes[i].indices.data(),
+                    sizeof(uint32_t) * e.numIndices);
+        std::memcpy(blob.data() + e.lodOffset, meshes[i].lods.data(),
+                    sizeof(MeshLod) * e.numLods);
+        std::memcpy(blob.data() + e.meshletOffset, meshes[i].meshlets.data(),
+                    sizeof(Meshlet) * e.numMeshlets);
+        std::memcpy(blob.data() + e.textureOffset,
+                    meshes[i].textureFilename.data(), e.textureLength);
+        std::memcpy(blob.data() + e.packedTextureOffset,
+                    meshes[i].packedTextureFilename.data(),
+                    e.packedTextureLength);
+    }
+    std::memcpy(blob.data() + header.nodeOffset, scene.nodes.data(),
+                sizeof(SceneNode) * header.numNodes);
+    std::memcpy(blob.data() + header.instanceOffset, scene.instances.data(),
+                sizeof(MeshInstance) * header.numInstances);
+
+    std::ofstream file(cacheFilename, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        std::cout << "MeshCache::Write() failed: " << cacheFilename
+                  << std::endl;
+        return false;
+    }
+    file.write(reinterpret_cast<const char *>(blob.data()),
+               std::streamsize(blob.size()));
+
+    return bool(file);
+}
+
+bool MeshCache::Open(const std::string &cacheFilename, uint64_t key)
+{
+    Close();
+
+    if (key == 0 || !m_file.Open(cacheFilename))
+        return false;
+
+    const uint8_t *data = m_file.GetData();
+    const size_t size = m_file.GetSize();
+
+    if (size < sizeof(MeshCacheHeader))
+    {
+        Close();
+        return false;
+    }
+
+    MeshCacheHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0 ||
+        header.version != version || header.key != key ||
+        header.fileSize != size ||
+        sizeof(header) + sizeof(MeshCacheEntry) * size_t(header.numMeshes) > size ||
+        header.nodeOffset + sizeof(SceneNode) * uint64_t(header.numNodes) > size ||
+        header.instanceOffset +
+                sizeof(MeshInstance) * uint64_t(header.numInstances) >
+            size)
+    {
+        Close();
+        return false;
+    }
+
+    const MeshCacheEntry *entries =
+        reinterpret_cast<const MeshCacheEntry *>(data + sizeof(header));
+
+    m_view.meshes.resize(header.numMeshes);
+    for (uint32_t i = 0; i < header.numMeshes; i++)
+    {
+        const MeshCacheEntry &e = entries[i];
+
+        if (e.vertexOffset + sizeof(Vertex) * uint64_t(e.numVertices) > size ||
+            e.indexOffset + sizeof(uint32_t) * uint64_t(e.numIndices) > size ||
+            e.lodOffset + sizeof(MeshLod) * uint64_t(e.numLods) > size ||
+            e.meshletOffset + sizeof(Meshlet) * uint64_t(e.numMeshlets) > size ||
+            e.textureOffset + e.textureLength > size ||
+            e.packedTextureOffset + e.packedTextureLength > size)
+        {
+            Close();
+            return false;
+        }
+
+        // 파일 안을 그대로 가리킴 (파싱, 복사 X)
+        MeshDataView &view = m_view.meshes[i];
+        view.vertices = reinterpret_cast<const Vertex *>(data + e.vertexOffset);
+        view.numVertices = e.numVertices;
+        view.indices = reinterpret_cast<const uint32_t *>(data + e.indexOffset);
+        view.numIndices = e.numIndices;
+        view.lods = reinterpret_cast<const MeshLod *>(data + e.lodOffset);
+        view.numLods = e.numLods;
+        view.meshlets =
+            reinterpret_cast<const Meshlet *>(data + e.meshletOffset);
+        view.numMeshlets = e.numMeshlets;
+        view.textureFilename.assign(
+            reinterpret_cast<const char *>(data + e.textureOffset),
+            e.textureLength);
+        view.packedTextureFilename.assign(
+            reinterpret_cast<const char *>(data + e.packedTextureOffset),
+            e.packedTextureLength);
+        view.packedChannels = e.packedChannels;
+        view.uvDensity = e.uvDensity;
+    }
+
+    m_view.nodes = reinterpret_cast<const SceneNode *>(data + header.nodeOffset);
+    m_view.numNodes = header.numNodes;
+    m_view.instances =
+        reinterpret_cast<const MeshInstance *>(data + header.instanceOffset);
+    m_view.numInstances = header.numInstances;
+
+    // 부모가 항상 앞에 있어야 ComputeWorldTransforms()를 한 번에 할 수 있음
+    for (size_t i = 0; i < m_view.numNodes; i++)
+    {
+        if (m_view.nodes[i].parent >= int32_t(i))
+        {
+            Close();
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < m_view.numInstances; i++)
+    {
+        if (m_view.instances[i].meshIndex >= header.numMeshes ||
+            m_view.instances[i].nodeIndex >= header.numNodes)
+        {
+            Close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void MeshCache::Close()
+{
+    m_view = SceneView();
+    m_scene = SceneData();
+    m_file.Close();
+}
+
+void MeshCache::Adopt(SceneData &&scene)
+{
+    Close();
+
+    m_scene = std::move(scene);
+    m_view = SceneView::From(m_scene);
+}
+
+} // namespace FEFE
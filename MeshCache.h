@@ -0,0 +1,54 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+#include "MeshData.h"
+
+namespace FEFE
+{
+
+// ReadFromFile()의 최종 결과(SceneData)를 저장하는 바이너리 캐시 파일
+//
+// [Header][Entry x numMeshes][vertices/indices/LOD/meshlet/texture 경로 ...]
+// [노드][인스턴스]
+// 버텍스와 인덱스 배열은 16바이트 정렬로 저장하기 때문에 매핑한 포인터를
+// 그대로 CreateVertexBuffer()/CreateIndexBuffer()에 넘길 수 있음
+class MeshCache
+{
+  public:
+    static const uint32_t version = 9;
+
+    // 원본 파일 내용 + 외부 버퍼(.bin) 크기/수정 시각 + 임포트 옵션 +
+    // 버텍스 형식으로 만드는 키
+    // 원본이 바뀌면 키가 달라져서 캐시를 다시 만듦
+    static uint64_t MakeKey(const std::string &sourceFilename,
+                            uint32_t importFlags);
+
+    static bool Write(const std::string &cacheFilename, uint64_t key,
+                      const SceneData &scene);
+
+    // 키가 맞지 않거나 파일이 깨져있으면 false
+    bool Open(const std::string &cacheFilename, uint64_t key);
+    void Close();
+
+    // 캐시 파일 대신 메모리의 SceneData를 들고 있음 (캐시 생성 실패 시)
+    // 뷰는 파일을 매핑했을 때와 같은 방식으로 사용
+    void Adopt(SceneData &&scene);
+
+    size_t GetNumMeshes() const { return m_view.meshes.size(); }
+    const std::vector<MeshDataView> &GetMeshViews() const
+    {
+        return m_view.meshes;
+    }
+    const SceneView &GetSceneView() const { return m_view; }
+
+  private:
+    MappedFile m_file;
+    SceneData m_scene; // Adopt()로 넘겨받은 경우에만 사용
+    SceneView m_view;
+};
+
+} // namespace FEFE
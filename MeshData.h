@@ -2,8 +2,10 @@
 
 #pragma once
 
+#include <cstdint>
 #include <directxtk/SimpleMath.h>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "Vertex.h"
@@ -13,11 +15,192 @@ namespace FEFE
 
 using std::vector;
 
-struct MeshData 
+// LOD ϳ = ε 迭   (ؽ 迭  LOD )
+struct MeshLod
 {
-    std::vector<Vertex> vertices;
-    std::vector<uint32_t> indices; // uint32 // 16   
+    uint32_t indexOffset = 0;
+    uint32_t indexCount = 0;
+    float error = 0.0f; //  ޽ Ÿ  ( ǥ)
+
+    //  LOD   meshlet (TMeshData::meshlets  )
+    uint32_t meshletOffset = 0;
+    uint32_t meshletCount = 0;
+};
+
+// ﰢ ִ 124, ؽ ִ 64¥  (MeshletBuilder)
+// ε 迭 ӵ ̹Ƿ CPU øϰ   ׸
+struct Meshlet
+{
+    uint32_t indexOffset = 0;
+    uint32_t indexCount = 0;
+
+    //   ( ǥ)
+    DirectX::SimpleMath::Vector3 center;
+    float radius = 0.0f;
+
+    //  :  ﰢ  coneAxis ̷  ȿ 
+    // coneCutoff = sin( ), 1̸ ޸ ø Ұ
+    DirectX::SimpleMath::Vector3 coneAxis;
+    float coneCutoff = 1.0f;
+};
+
+//  Į  ϳ ִ ̹ (channel: 0~3 = RGBA)
+//  ̹ RGB  Ƿ 0
+struct ScalarTexture
+{
+    std::string filename; //  
+    int channel = 0;
+};
+
+// δ ã  Į ؽ (ChannelPacker ؽ ϳ ħ)
+//  ȸ ϰ ޽ ĳÿ ģ  
+struct MaterialTextures
+{
+    ScalarTexture occlusion;
+    ScalarTexture roughness;
+    ScalarTexture metallic;
+    ScalarTexture height;
+};
+
+// ģ ؽ翡  ִ ä (0~3 = RGBA, -1̸  -> ⺻ )
+struct MaterialChannels
+{
+    int8_t occlusion = -1;
+    int8_t roughness = -1;
+    int8_t metallic = -1;
+    int8_t height = -1;
+};
+
+// T_VERTEX: Vertex, VertexPacked, VertexCompact (VertexFormat.h)
+template <typename T_VERTEX> struct TMeshData
+{
+    std::vector<T_VERTEX> vertices;
+    std::vector<uint32_t> indices; // ۸   ϸ uint16 ȯ
+    std::string textureFilename;
+
+    // AO/ĥ/ݼӼ/̸ ģ ؽ (ChannelPacker::PackMeshes())
+    MaterialTextures materialTextures;
+    std::string packedTextureFilename;
+    MaterialChannels packedChannels;
+
+    //  ǥ 1ŭ uv  (ﰢ ̷ , TextureResidency mip )
+    float uvDensity = 0.0f;
+
+    //  indices ü LOD 0
+    //  indices = [LOD 0][LOD 1]... (MeshSimplifier::BuildLods())
+    std::vector<MeshLod> lods;
+
+    // LOD   meshlet (MeshletBuilder::Build())
+    std::vector<Meshlet> meshlets;
+};
+
+// ε/ó  float ؽ ϰ ۸   
+using MeshData = TMeshData<Vertex>;
+
+// MeshData ޽ ĳ (MeshCache)  ͸   Ŵ
+// Ű  ۸   ־ 
+struct MeshDataView
+{
+    const Vertex *vertices = nullptr;
+    size_t numVertices = 0;
+    const uint32_t *indices = nullptr;
+    size_t numIndices = 0;
     std::string textureFilename;
+    std::string packedTextureFilename;
+    MaterialChannels packedChannels;
+    float uvDensity = 0.0f;
+    const MeshLod *lods = nullptr;
+    size_t numLods = 0;
+    const Meshlet *meshlets = nullptr;
+    size_t numMeshlets = 0;
+
+    static MeshDataView From(const MeshData &meshData)
+    {
+        MeshDataView view;
+        view.vertices = meshData.vertices.data();
+        view.numVertices = meshData.vertices.size();
+        view.indices = meshData.indices.data();
+        view.numIndices = meshData.indices.size();
+        view.textureFilename = meshData.textureFilename;
+        view.packedTextureFilename = meshData.packedTextureFilename;
+        view.packedChannels = meshData.packedChannels;
+        view.uvDensity = meshData.uvDensity;
+        view.lods = meshData.lods.data();
+        view.numLods = meshData.lods.size();
+        view.meshlets = meshData.meshlets.data();
+        view.numMeshlets = meshData.meshlets.size();
+        return view;
+    }
+};
+
+//  Ʈ (θ ׻ ڽĺ տ  )
+struct SceneNode
+{
+    int32_t parent = -1;                   // Ʈ -1
+    DirectX::SimpleMath::Matrix transform; // θ  
+};
+
+// ޽ ϳ   ġ ׸
+//  ޽  尡 ѵ ؽ/ε   
+struct MeshInstance
+{
+    uint32_t meshIndex = 0;
+    uint32_t nodeIndex = 0;
+};
+
+// θ ı  帶  
+inline std::vector<DirectX::SimpleMath::Matrix>
+ComputeWorldTransforms(const SceneNode *nodes, size_t numNodes)
+{
+    std::vector<DirectX::SimpleMath::Matrix> world(numNodes);
+    for (size_t i = 0; i < numNodes; i++)
+    {
+        world[i] = nodes[i].parent < 0
+                       ? nodes[i].transform
+                       : nodes[i].transform * world[size_t(nodes[i].parent)];
+    }
+    return world;
+}
+
+// δ :  ޽ +  Ʈ + νϽ
+struct SceneData
+{
+    std::vector<MeshData> meshes;
+    std::vector<SceneNode> nodes;
+    std::vector<MeshInstance> instances;
+
+    //  ϳ( ) ޽ νϽ ϳ
+    static SceneData FromMeshes(std::vector<MeshData> &&meshes)
+    {
+        SceneData scene;
+        scene.meshes = std::move(meshes);
+        scene.nodes.resize(1);
+        for (size_t i = 0; i < scene.meshes.size(); i++)
+            scene.instances.push_back({uint32_t(i), 0});
+        return scene;
+    }
+};
+
+// SceneData ޽ ĳ (MeshCache)   Ŵ
+struct SceneView
+{
+    std::vector<MeshDataView> meshes;
+    const SceneNode *nodes = nullptr;
+    size_t numNodes = 0;
+    const MeshInstance *instances = nullptr;
+    size_t numInstances = 0;
+
+    static SceneView From(const SceneData &scene)
+    {
+        SceneView view;
+        for (const auto &meshData : scene.meshes)
+            view.meshes.push_back(MeshDataView::From(meshData));
+        view.nodes = scene.nodes.data();
+        view.numNodes = scene.nodes.size();
+        view.instances = scene.instances.data();
+        view.numInstances = scene.instances.size();
+        return view;
+    }
 };
 
 } // namespace FEFE
\ No newline at end of file
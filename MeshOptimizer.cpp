@@ -0,0 +1,440 @@
+﻿#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+
+#include "Hash.h"
+
+namespace FEFE
+{
+
+using namespace DirectX::SimpleMath;
+
+namespace
+{
+
+const uint32_t invalidIndex = ~0u;
+
+// FIFO 캐시 시뮬레이터
+// 캐시에 들어온 시점(timestamp)만 기록하고 현재 시점과의 차이로 적중 여부 판단
+class FifoCache
+{
+  public:
+    explicit FifoCache(size_t numVertices)
+        : m_timestamps(numVertices, 0), m_time(MeshOptimizer::cacheSize + 1)
+    {
+    }
+
+    // 미스면 1
+    uint32_t Access(uint32_t v)
+    {
+        if (m_time - m_timestamps[v] > MeshOptimizer::cacheSize)
+        {
+            m_timestamps[v] = m_time++;
+            return 1;
+        }
+        return 0;
+    }
+
+    void Reset() { m_time += MeshOptimizer::cacheSize + 1; }
+
+  private:
+    std::vector<uint32_t> m_timestamps;
+    uint32_t m_time;
+};
+
+// 버텍스 -> 인접 삼각형 목록 (CSR 형식)
+struct Adjacency
+{
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> triangles;
+
+    Adjacency(const std::vector<uint32_t> &indices, size_t numVertices)
+        : offsets(numVertices + 1, 0), triangles(indices.size())
+    {
+        for (const uint32_t v : indices)
+            offsets[v + 1]++;
+        for (size_t v = 0; v < numVertices; v++)
+            offsets[v + 1] += offsets[v];
+
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++)
+            triangles[fill[indices[i]]++] = uint32_t(i / 3);
+    }
+
+    uint32_t Count(uint32_t v) const { return offsets[v + 1] - offsets[v]; }
+};
+
+} // namespace
+
+void MeshOptimizer::Optimize(MeshData &meshData, const std::string &name)
+{
+    const size_t numVerticesBefore = meshData.vertices.size();
+    const VertexCacheStatistics before = AnalyzeVertexCache(meshData);
+
+    WeldVertices(meshData);
+    OptimizeVertexCache(meshData);
+    OptimizeOverdraw(meshData);
+    OptimizeVertexFetch(meshData);
+
+    const VertexCacheStatistics after = AnalyzeVertexCache(meshData);
+
+    std::cout << name << ": vertices " << numVerticesBefore << " -> "
+              << meshData.vertices.size() << ", ACMR " << before.acmr
+              << " -> " << after.acmr << ", ATVR " << before.atvr << " -> "
+              << after.atvr << std::endl;
+}
+
+void MeshOptimizer::WeldVertices(MeshData &meshData)
+{
+    static_assert(sizeof(Vertex) == 32, "Vertex must not have padding");
+
+    const auto &vertices = meshData.vertices;
+    if (vertices.empty())
+        return;
+
+    // 오픈 어드레싱 해시 테이블 (크기는 2의 거듭제곱)
+    size_t tableSize = 1;
+    while (tableSize < vertices.size() * 2)
+        tableSize *= 2;
+    std::vector<uint32_t> table(tableSize, invalidIndex);
+
+    std::vector<uint32_t> remap(vertices.size());
+    std::vector<Vertex> welded;
+    welded.reserve(vertices.size());
+
+    for (size_t i = 0; i < vertices.size(); i++)
+    {
+        const Vertex &v = vertices[i];
+        size_t slot = HashBytes(&v, sizeof(Vertex)) & (tableSize - 1);
+
+        while (table[slot] != invalidIndex &&
+               std::memcmp(&welded[table[slot]], &v, sizeof(Vertex)) != 0)
+            slot = (slot + 1) & (tableSize - 1);
+
+        if (table[slot] == invalidIndex)
+        {
+            table[slot] = uint32_t(welded.size());
+            welded.push_back(v);
+        }
+        remap[i] = table[slot];
+    }
+
+    for (auto &index : meshData.indices)
+        index = remap[index];
+
+    meshData.vertices = std::move(welded);
+}
+
+// Sander et al., "Fast Triangle Reordering for Vertex Locality and Reduced
+// Overdraw" (Tipsify)
+void MeshOptimizer::OptimizeVertexCache(MeshData &meshData)
+{
+    OptimizeVertexCache(meshData.indices, meshData.vertices.size());
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t> &indices,
+                                        size_t numVertices)
+{
+    const size_t numTriangles = indices.size() / 3;
+    if (numTriangles == 0)
+        return;
+
+    const Adjacency adjacency(indices, numVertices);
+
+    std::vector<uint32_t> live(numVertices);
+    for (uint32_t v = 0; v < numVertices; v++)
+        live[v] = adjacency.Count(v);
+
+    std::vector<uint32_t> cacheTime(numVertices, 0);
+    std::vector<char> emitted(numTriangles, 0);
+    std::vector<uint32_t> deadEnd;
+    std::vector<uint32_t> candidates;
+
+    std::vector<uint32_t> output;
+    output.reserve(numTriangles * 3);
+
+    uint32_t time = cacheSize + 1;
+    uint32_t cursor = 0;
+    uint32_t fanning = 0;
+
+    while (fanning != invalidIndex)
+    {
+        // 현재 버텍스에 붙은 삼각형을 모두 출력
+        candidates.clear();
+        for (uint32_t a = adjacency.offsets[fanning];
+             a < adjacency.offsets[fanning + 1]; a++)
+        {
+            const uint32_t t = adjacency.triangles[a];
+            if (emitted[t])
+                continue;
+            emitted[t] = 1;
+
+            for (int k = 0; k < 3; k++)
+            {
+                const uint32_t v = indices[t * 3 + k];
+                output.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                live[v]--;
+                if (time - cacheTime[v] > cacheSize)
+                    cacheTime[v] = time++;
+            }
+        }
+
+        // 다음 버텍스: 출력 후에도 캐시에 남아있을 것 중 가장 오래된 것
+        uint32_t next = invalidIndex;
+        int bestPriority = -1;
+        for (const uint32_t v : candidates)
+        {
+            if (live[v] == 0)
+                continue;
+            int priority = 0;
+            if (time - cacheTime[v] + 2 * live[v] <= cacheSize)
+                priority = int(time - cacheTime[v]);
+            if (priority > bestPriority)
+            {
+                bestPriority = priority;
+                next = v;
+            }
+        }
+
+        // 막혔으면 최근에 쓴 버텍스부터, 그것도 없으면 아직 남은 버텍스
+        while (next == invalidIndex && !deadEnd.empty())
+        {
+            const uint32_t v = deadEnd.back();
+            deadEnd.pop_back();
+            if (live[v] > 0)
+                next = v;
+        }
+        while (next == invalidIndex && cursor < numVertices)
+        {
+            if (live[cursor] > 0)
+                next = cursor;
+            cursor++;
+        }
+
+        fanning = next;
+    }
+
+    indices = std::move(output);
+}
+
+// 캐시 효율이 크게 나빠지지 않는 선에서 삼각형을 클러스터로 나누고
+// 바깥을 향하는 클러스터부터 그려서 뒤쪽 픽셀이 깊이 테스트에서 걸러지게 함
+void MeshOptimizer::OptimizeOverdraw(MeshData &meshData, float threshold)
+{
+    auto &indices = meshData.indices;
+    const auto &vertices = meshData.vertices;
+    const size_t numTriangles = indices.size() / 3;
+    if (numTriangles == 0)
+        return;
+
+    FifoCache cache(vertices.size());
+    auto TriangleMisses = [&](size_t t) {
+        return cache.Access(indices[t * 3]) + cache.Access(indices[t * 3 + 1]) +
+               cache.Access(indices[t * 3 + 2]);
+    };
+
+    // 1. 세 버텍스가 모두 미스인 곳에서 나누기 (hard boundary)
+    //    첫 삼각형은 미스 수와 관계없이 (퇴화 삼각형 등) 항상 클러스터의 시작
+    std::vector<uint32_t> hardClusters = {0};
+    for (size_t t = 0; t < numTriangles; t++)
+    {
+        if (TriangleMisses(t) == 3 && t > 0)
+            hardClusters.push_back(uint32_t(t));
+    }
+    hardClusters.push_back(uint32_t(numTriangles));
+
+    // 2. 클러스터 앞부분의 ACMR이 전체의 threshold배 이하가 되면 나누기
+    std::vector<uint32_t> clusters;
+    for (size_t c = 0; c + 1 < hardClusters.size(); c++)
+    {
+        const uint32_t start = hardClusters[c];
+        const uint32_t end = hardClusters[c + 1];
+
+        cache.Reset();
+        uint32_t clusterMisses = 0;
+        for (uint32_t t = start; t < end; t++)
+            clusterMisses += TriangleMisses(t);
+        const float clusterThreshold =
+            threshold * float(clusterMisses) / float(end - start);
+
+        cache.Reset();
+        clusters.push_back(start);
+        uint32_t runningStart = start;
+        uint32_t runningMisses = 0;
+        for (uint32_t t = start; t < end; t++)
+        {
+            runningMisses += TriangleMisses(t);
+            if (t + 1 < end &&
+                float(runningMisses) / float(t + 1 - runningStart) <=
+                    clusterThreshold)
+            {
+                clusters.push_back(t + 1);
+                runningStart = t + 1;
+                runningMisses = 0;
+                cache.Reset();
+            }
+        }
+    }
+    clusters.push_back(uint32_t(numTriangles));
+
+    // 3. 클러스터마다 (중심 - 메쉬 중심) · 평균 노멀을 계산해서 큰 것부터
+    Vector3 meshCenter(0.0f);
+    float meshArea = 0.0f;
+    const size_t numClusters = clusters.size() - 1;
+    std::vector<Vector3> clusterCenters(numClusters, Vector3(0.0f));
+    std::vector<Vector3> clusterNormals(numClusters, Vector3(0.0f));
+
+    for (size_t c = 0; c < numClusters; c++)
+    {
+        float clusterArea = 0.0f;
+        for (uint32_t t = clusters[c]; t < clusters[c + 1]; t++)
+        {
+            const Vector3 &p0 = vertices[indices[t * 3]].position;
+            const Vector3 &p1 = vertices[indices[t * 3 + 1]].position;
+            const Vector3 &p2 = vertices[indices[t * 3 + 2]].position;
+
+            const Vector3 n = (p1 - p0).Cross(p2 - p0);
+            const float area = n.Length();
+            const Vector3 center = (p0 + p1 + p2) * (area / 3.0f);
+
+            clusterCenters[c] += center;
+            clusterNormals[c] += n;
+            clusterArea += area;
+            meshCenter += center;
+            meshArea += area;
+        }
+        if (clusterArea > 0.0f)
+            clusterCenters[c] /= clusterArea;
+        clusterNormals[c].Normalize();
+    }
+    if (meshArea > 0.0f)
+        meshCenter /= meshArea;
+
+    std::vector<float> sortKeys(numClusters);
+    std::vector<uint32_t> order(numClusters);
+    for (size_t c = 0; c < numClusters; c++)
+    {
+        sortKeys[c] = (clusterCenters[c] - meshCenter).Dot(clusterNormals[c]);
+        order[c] = uint32_t(c);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return sortKeys[a] > sortKeys[b];
+    });
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+    for (const uint32_t c : order)
+    {
+        output.insert(output.end(), indices.begin() + clusters[c] * 3,
+                      indices.begin() + clusters[c + 1] * 3);
+    }
+    assert(output.size() == indices.size());
+    indices = std::move(output);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(MeshData &meshData)
+{
+    std::vector<uint32_t> remap(meshData.vertices.size(), invalidIndex);
+    std::vector<Vertex> vertices;
+    vertices.reserve(meshData.vertices.size());
+
+    for (auto &index : meshData.indices)
+    {
+        if (remap[index] == invalidIndex)
+        {
+            remap[index] = uint32_t(vertices.size());
+            vertices.push_back(meshData.vertices[index]);
+        }
+        index = remap[index];
+    }
+
+    meshData.vertices = std::move(vertices);
+}
+
+std::vector<MeshData> MeshOptimizer::SplitForShortIndices(MeshData &&meshData,
+                                                          size_t maxVertices)
+{
+    std::vector<MeshData> parts;
+    if (meshData.vertices.size() <= maxVertices)
+    {
+        parts.push_back(std::move(meshData));
+        return parts;
+    }
+
+    // 원래 인덱스 -> 현재 조각 안의 인덱스
+    // stamp가 현재 조각 번호와 다르면 아직 조각에 없는 버텍스
+    std::vector<uint32_t> remap(meshData.vertices.size());
+    std::vector<uint32_t> stamp(meshData.vertices.size(), invalidIndex);
+
+    const auto &indices = meshData.indices;
+    for (size_t t = 0; t + 2 < indices.size(); t += 3)
+    {
+        uint32_t numNew = 0;
+        if (!parts.empty())
+        {
+            for (int k = 0; k < 3; k++)
+                numNew += stamp[indices[t + k]] != uint32_t(parts.size() - 1);
+        }
+
+        if (parts.empty() ||
+            parts.back().vertices.size() + numNew > maxVertices)
+        {
+            parts.emplace_back();
+            parts.back().textureFilename = meshData.textureFilename;
+            parts.back().materialTextures = meshData.materialTextures;
+            parts.back().packedTextureFilename = meshData.packedTextureFilename;
+            parts.back().packedChannels = meshData.packedChannels;
+            parts.back().uvDensity = meshData.uvDensity;
+        }
+
+        MeshData &part = parts.back();
+        const uint32_t partIndex = uint32_t(parts.size() - 1);
+        for (int k = 0; k < 3; k++)
+        {
+            const uint32_t v = indices[t + k];
+            if (stamp[v] != partIndex)
+            {
+                stamp[v] = partIndex;
+                remap[v] = uint32_t(part.vertices.size());
+                part.vertices.push_back(meshData.vertices[v]);
+            }
+            part.indices.push_back(remap[v]);
+        }
+    }
+
+    return parts;
+}
+
+VertexCacheStatistics
+MeshOptimizer::AnalyzeVertexCache(const MeshData &meshData)
+{
+    VertexCacheStatistics stats;
+    if (meshData.indices.empty() || meshData.vertices.empty())
+        return stats;
+
+    FifoCache cache(meshData.vertices.size());
+    std::vector<char> used(meshData.vertices.size(), 0);
+
+    size_t misses = 0;
+    size_t numUsed = 0;
+    for (const uint32_t index : meshData.indices)
+    {
+        misses += cache.Access(index);
+        if (!used[index])
+        {
+            used[index] = 1;
+            numUsed++;
+        }
+    }
+
+    stats.acmr = float(misses) / float(meshData.indices.size() / 3);
+    stats.atvr = float(misses) / float(numUsed);
+    return stats;
+}
+
+} // namespace FEFE
@@ -0,0 +1,57 @@
+﻿#pragma once
+
+#include <string>
+#include <vector>
+
+#include "MeshData.h"
+
+namespace FEFE
+{
+
+// post-transform 캐시 효율 측정값
+// ACMR: 삼각형당 버텍스 쉐이더 실행 횟수 (최소 약 0.5, 최악 3)
+// ATVR: 버텍스당 실행 횟수 (1이면 각 버텍스를 한 번씩만 처리)
+struct VertexCacheStatistics
+{
+    float acmr = 0.0f;
+    float atvr = 0.0f;
+};
+
+// MeshData를 GPU가 처리하기 좋은 순서로 바꾸는 전처리
+// 1. 완전히 같은 버텍스 합치기 (welding)
+// 2. 버텍스 캐시를 위한 삼각형 순서 (Tipsify)
+// 3. 오버드로우를 줄이도록 클러스터 순서 정렬
+// 4. 인덱스에서 처음 쓰이는 순서대로 버텍스 배열 재배치 (fetch)
+// 그려지는 결과는 바뀌지 않고 순서만 바뀜
+class MeshOptimizer
+{
+  public:
+    static const uint32_t cacheSize = 16; // FIFO 캐시 크기 (시뮬레이션용)
+
+    // 모든 단계를 실행하고 전후 ACMR/ATVR 출력
+    static void Optimize(MeshData &meshData, const std::string &name);
+
+    // 비트 단위로 같은 Vertex를 하나로 합침
+    static void WeldVertices(MeshData &meshData);
+
+    static void OptimizeVertexCache(MeshData &meshData);
+    static void OptimizeVertexCache(std::vector<uint32_t> &indices,
+                                    size_t numVertices);
+
+    // threshold: 클러스터를 나눌 때 허용하는 ACMR 증가 비율 (1.05 = 5%)
+    static void OptimizeOverdraw(MeshData &meshData, float threshold = 1.05f);
+
+    // 쓰이지 않는 버텍스는 제거됨
+    static void OptimizeVertexFetch(MeshData &meshData);
+
+    static VertexCacheStatistics AnalyzeVertexCache(const MeshData &meshData);
+
+    // 버텍스가 maxVertices개를 넘으면 삼각형 순서대로 잘라서 여러 메쉬로 나눔
+    // 나눈 메쉬는 모두 16비트 인덱스로 그릴 수 있음
+    static const size_t maxShortIndexVertices = 65536;
+    static std::vector<MeshData>
+    SplitForShortIndices(MeshData &&meshData,
+                         size_t maxVertices = maxShortIndexVertices);
+};
+
+} // namespace FEFE
@@ -0,0 +1,359 @@
+﻿#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <unordered_set>
+
+#include "Hash.h"
+#include "MeshOptimizer.h"
+
+namespace FEFE
+{
+
+using namespace DirectX::SimpleMath;
+
+namespace
+{
+
+// 평면까지 거리 제곱의 합 (넓이 가중치)
+struct Quadric
+{
+    double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+    double b0 = 0, b1 = 0, b2 = 0, c = 0;
+    double weight = 0;
+
+    static Quadric FromPlane(const Vector3 &n, float d, double w)
+    {
+        Quadric q;
+        q.a00 = w * n.x * n.x;
+        q.a01 = w * n.x * n.y;
+        q.a02 = w * n.x * n.z;
+        q.a11 = w * n.y * n.y;
+        q.a12 = w * n.y * n.z;
+        q.a22 = w * n.z * n.z;
+        q.b0 = w * n.x * d;
+        q.b1 = w * n.y * d;
+        q.b2 = w * n.z * d;
+        q.c = w * d * d;
+        q.weight = w;
+        return q;
+    }
+
+    Quadric &operator+=(const Quadric &o)
+    {
+        a00 += o.a00, a01 += o.a01, a02 += o.a02;
+        a11 += o.a11, a12 += o.a12, a22 += o.a22;
+        b0 += o.b0, b1 += o.b1, b2 += o.b2;
+        c += o.c;
+        weight += o.weight;
+        return *this;
+    }
+
+    // 가중치로 나눈 값 = 평균 거리 제곱
+    double Evaluate(const Vector3 &p) const
+    {
+        const double x = p.x, y = p.y, z = p.z;
+        const double e = a00 * x * x + a11 * y * y + a22 * z * z +
+                         2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                         2.0 * (b0 * x + b1 * y + b2 * z) + c;
+        return weight > 0.0 ? std::max(e, 0.0) / weight : 0.0;
+    }
+};
+
+struct Collapse
+{
+    uint32_t from;
+    uint32_t to;
+    double cost;
+};
+
+// 비트 단위로 같은 위치끼리 같은 번호
+std::vector<uint32_t> BuildPositionRemap(const std::vector<Vertex> &vertices,
+                                         uint32_t &numPositions)
+{
+    size_t tableSize = 1;
+    while (tableSize < vertices.size() * 2)
+        tableSize *= 2;
+    std::vector<uint32_t> table(tableSize, ~0u);
+
+    std::vector<uint32_t> remap(vertices.size());
+    numPositions = 0;
+
+    for (size_t i = 0; i < vertices.size(); i++)
+    {
+        const Vector3 &p = vertices[i].position;
+        size_t slot = HashBytes(&p, sizeof(Vector3)) & (tableSize - 1);
+        while (table[slot] != ~0u &&
+               std::memcmp(&vertices[table[slot]].position, &p,
+                           sizeof(Vector3)) != 0)
+            slot = (slot + 1) & (tableSize - 1);
+
+        if (table[slot] == ~0u)
+        {
+            table[slot] = uint32_t(i);
+            remap[i] = numPositions++;
+        }
+        else
+        {
+            remap[i] = remap[table[slot]];
+        }
+    }
+    return remap;
+}
+
+Vector3 TriangleNormal(const Vector3 &p0, const Vector3 &p1, const Vector3 &p2)
+{
+    return (p1 - p0).Cross(p2 - p0);
+}
+
+} // namespace
+
+std::vector<uint32_t> MeshSimplifier::Simplify(
+    const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices,
+    size_t targetIndexCount, float &error)
+{
+    error = 0.0f;
+    std::vector<uint32_t> result = indices;
+    if (result.size() <= targetIndexCount || vertices.empty())
+        return result;
+
+    const size_t numVertices = vertices.size();
+
+    // 1. 움직이면 안 되는 버텍스 표시
+    //    - 같은 위치에 다른 버텍스가 있음 (텍스춰/노멀 이음매)
+    //    - 반대 방향 edge가 없는 경계
+    uint32_t numPositions = 0;
+    const std::vector<uint32_t> positionRemap =
+        BuildPositionRemap(vertices, numPositions);
+
+    std::vector<uint32_t> verticesPerPosition(numPositions, 0);
+    for (size_t v = 0; v < numVertices; v++)
+        verticesPerPosition[positionRemap[v]]++;
+
+    std::vector<char> locked(numVertices, 0);
+    for (size_t v = 0; v < numVertices; v++)
+        locked[v] = verticesPerPosition[positionRemap[v]] > 1;
+
+    std::unordered_set<uint64_t> edges;
+    edges.reserve(indices.size());
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        for (int k = 0; k < 3; k++)
+        {
+            edges.insert(uint64_t(indices[i + k]) << 32 |
+                         indices[i + (k + 1) % 3]);
+        }
+    }
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        for (int k = 0; k < 3; k++)
+        {
+            const uint32_t a = indices[i + k];
+            const uint32_t b = indices[i + (k + 1) % 3];
+            if (edges.count(uint64_t(b) << 32 | a) == 0)
+                locked[a] = locked[b] = 1;
+        }
+    }
+
+    // 2. 위치마다 주변 삼각형 평면의 quadric
+    std::vector<Quadric> quadrics(numPositions);
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        const Vector3 &p0 = vertices[indices[i]].position;
+        const Vector3 &p1 = vertices[indices[i + 1]].position;
+        const Vector3 &p2 = vertices[indices[i + 2]].position;
+
+        Vector3 n = TriangleNormal(p0, p1, p2);
+        const float area = n.Length() * 0.5f;
+        if (area <= 0.0f)
+            continue;
+        n.Normalize();
+
+        const Quadric q = Quadric::FromPlane(n, -n.Dot(p0), area);
+        for (int k = 0; k < 3; k++)
+            quadrics[positionRemap[indices[i + k]]] += q;
+    }
+
+    auto CollapseCost = [&](uint32_t from, uint32_t to) {
+        Quadric q = quadrics[positionRemap[from]];
+        q += quadrics[positionRemap[to]];
+        return q.Evaluate(vertices[to].position);
+    };
+
+    // 3. 비용이 작은 edge부터 여러 개씩 collapse하는 패스 반복
+    double maxCost = 0.0;
+    std::vector<Collapse> candidates;
+    std::vector<uint32_t> adjacencyOffsets;
+    std::vector<uint32_t> adjacency;
+    std::vector<uint32_t> collapseTo(numVertices);
+    std::vector<char> touched(numVertices);
+
+    while (result.size() > targetIndexCount)
+    {
+        const size_t numTriangles = result.size() / 3;
+
+        // 버텍스 -> 삼각형
+        adjacencyOffsets.assign(numVertices + 1, 0);
+        for (const uint32_t v : result)
+            adjacencyOffsets[v + 1]++;
+        for (size_t v = 0; v < numVertices; v++)
+            adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+        adjacency.resize(result.size());
+        {
+            std::vector<uint32_t> fill(adjacencyOffsets.begin(),
+                                       adjacencyOffsets.end() - 1);
+            for (size_t i = 0; i < result.size(); i++)
+                adjacency[fill[result[i]]++] = uint32_t(i / 3);
+        }
+
+        candidates.clear();
+        for (size_t t = 0; t < numTriangles; t++)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                const uint32_t a = result[t * 3 + k];
+                const uint32_t b = result[t * 3 + (k + 1) % 3];
+                if (!locked[a])
+                    candidates.push_back({a, b, CollapseCost(a, b)});
+                if (!locked[b])
+                    candidates.push_back({b, a, CollapseCost(b, a)});
+            }
+        }
+        if (candidates.empty())
+            break;
+
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const Collapse &x, const Collapse &y) {
+                      return x.cost < y.cost;
+                  });
+
+        // 한 번에 너무 비싼 collapse까지 하지 않도록 이번 패스의 상한
+        // (edge 하나가 후보에 약 4번 들어가고 collapse 하나에 삼각형 2개가 줄어듦)
+        const size_t trianglesToRemove =
+            (result.size() - targetIndexCount + 2) / 3;
+        const double costLimit =
+            candidates[std::min(candidates.size() - 1, trianglesToRemove * 2)]
+                .cost;
+
+        std::iota(collapseTo.begin(), collapseTo.end(), 0u);
+        std::fill(touched.begin(), touched.end(), 0);
+
+        size_t removed = 0;
+        for (const Collapse &c : candidates)
+        {
+            if (removed >= trianglesToRemove || c.cost > costLimit)
+                break;
+            if (touched[c.from] || touched[c.to])
+                continue;
+
+            // 뒤집히는 삼각형이 생기면 건너뜀
+            bool flips = false;
+            size_t shared = 0;
+            for (uint32_t a = adjacencyOffsets[c.from];
+                 a < adjacencyOffsets[c.from + 1] && !flips; a++)
+            {
+                const uint32_t *tri = &result[adjacency[a] * 3];
+                if (tri[0] == c.to || tri[1] == c.to || tri[2] == c.to)
+                {
+                    shared++;
+                    continue;
+                }
+
+                Vector3 p[3], q[3];
+                for (int k = 0; k < 3; k++)
+                {
+                    p[k] = vertices[tri[k]].position;
+                    q[k] = tri[k] == c.from ? vertices[c.to].position : p[k];
+                }
+                const Vector3 n0 = TriangleNormal(p[0], p[1], p[2]);
+                const Vector3 n1 = TriangleNormal(q[0], q[1], q[2]);
+                flips = n0.Dot(n1) <= 0.0f;
+            }
+            if (flips)
+                continue;
+
+            collapseTo[c.from] = c.to;
+            for (uint32_t a = adjacencyOffsets[c.from];
+                 a < adjacencyOffsets[c.from + 1]; a++)
+            {
+                const uint32_t *tri = &result[adjacency[a] * 3];
+                touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = 1;
+            }
+
+            quadrics[positionRemap[c.to]] += quadrics[positionRemap[c.from]];
+            maxCost = std::max(maxCost, c.cost);
+            removed += shared;
+        }
+
+        if (removed == 0)
+            break;
+
+        // collapse 적용 후 면적이 없어진 삼각형 제거
+        size_t write = 0;
+        for (size_t t = 0; t < numTriangles; t++)
+        {
+            const uint32_t v0 = collapseTo[result[t * 3]];
+            const uint32_t v1 = collapseTo[result[t * 3 + 1]];
+            const uint32_t v2 = collapseTo[result[t * 3 + 2]];
+            if (v0 == v1 || v1 == v2 || v0 == v2)
+                continue;
+            result[write++] = v0;
+            result[write++] = v1;
+            result[write++] = v2;
+        }
+        result.resize(write);
+    }
+
+    error = float(std::sqrt(maxCost));
+    return result;
+}
+
+void MeshSimplifier::BuildLods(MeshData &meshData, const std::string &name,
+                               const std::vector<float> &ratios)
+{
+    const std::vector<uint32_t> lod0 = meshData.indices;
+
+    meshData.lods.clear();
+    meshData.lods.push_back({0, uint32_t(lod0.size()), 0.0f});
+
+    size_t previousCount = lod0.size();
+    for (const float ratio : ratios)
+    {
+        const size_t target = size_t(float(lod0.size()) * ratio) / 3 * 3;
+        if (target < 3)
+            break;
+
+        // 오차가 쌓이지 않도록 매번 LOD 0에서 단순화
+        float error = 0.0f;
+        std::vector<uint32_t> lod =
+            Simplify(meshData.vertices, lod0, target, error);
+
+        // 이음매/경계가 많아서 더 줄어들지 않음
+        if (lod.size() * 10 > previousCount * 9)
+            break;
+
+        MeshOptimizer::OptimizeVertexCache(lod, meshData.vertices.size());
+
+        MeshLod level;
+        level.indexOffset = uint32_t(meshData.indices.size());
+        level.indexCount = uint32_t(lod.size());
+        level.error = error;
+        meshData.lods.push_back(level);
+        meshData.indices.insert(meshData.indices.end(), lod.begin(), lod.end());
+
+        previousCount = lod.size();
+    }
+
+    std::cout << name << ": LOD";
+    for (const auto &level : meshData.lods)
+    {
+        std::cout << " " << level.indexCount / 3 << " tris (error "
+                  << level.error << ")";
+    }
+    std::cout << std::endl;
+}
+
+} // namespace FEFE
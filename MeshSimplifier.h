@@ -0,0 +1,34 @@
+﻿#pragma once
+
+#include <string>
+#include <vector>
+
+#include "MeshData.h"
+
+namespace FEFE
+{
+
+// Quadric Error Metric 기반 edge collapse 단순화 (Garland & Heckbert 1997)
+// 버텍스 배열은 그대로 두고 인덱스만 새로 만들기 때문에
+// 모든 LOD가 하나의 버텍스 버퍼를 공유할 수 있음
+//
+// 텍스춰 이음매(같은 위치에 속성이 다른 버텍스)와 열린 경계의 버텍스는
+// 움직이지 않으므로 이음매가 벌어지지 않음
+class MeshSimplifier
+{
+  public:
+    // indices를 targetIndexCount 이하로 줄인 인덱스 반환
+    // error: 원래 표면과의 RMS 거리 오차 (모델 좌표)
+    static std::vector<uint32_t> Simplify(const std::vector<Vertex> &vertices,
+                                          const std::vector<uint32_t> &indices,
+                                          size_t targetIndexCount,
+                                          float &error);
+
+    // meshData.indices를 LOD 0으로 두고 ratios 비율의 LOD를 뒤에 붙임
+    // 더 줄일 수 없으면 거기서 멈춤
+    static void BuildLods(MeshData &meshData, const std::string &name,
+                          const std::vector<float> &ratios = {0.5f, 0.25f,
+                                                              0.125f, 0.0625f});
+};
+
+} // namespace FEFE
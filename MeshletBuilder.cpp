@@ -0,0 +1,311 @@
+﻿#include "MeshletBuilder.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <iostream>
+
+namespace FEFE
+{
+
+using namespace DirectX::SimpleMath;
+
+namespace
+{
+
+// 노멀이 다른 삼각형을 넣을 때의 추가 비용 (새 버텍스 하나 = 1)
+const float coneWeight = 0.5f;
+
+// 평균 노멀과 30도 넘게 벌어지는 삼각형은 넣지 않음
+// 콘이 넓으면 뒷면 컬링이 거의 안 되므로 meshlet이 작아지더라도 콘을 좁게 유지
+// (dota 모델 기준 30도: 보이는 삼각형 약 76%, 제한 없음: 약 98%)
+const float minConeDot = 0.866f;
+
+// 붙어있는 삼각형이 없을 때 가까운 삼각형을 찾아볼 범위
+const size_t fallbackSearchWindow = 1024;
+
+} // namespace
+
+void MeshletBuilder::Build(MeshData &meshData, const std::string &name)
+{
+    if (meshData.lods.empty())
+    {
+        MeshLod lod0;
+        lod0.indexCount = uint32_t(meshData.indices.size());
+        meshData.lods.push_back(lod0);
+    }
+
+    meshData.meshlets.clear();
+    for (auto &lod : meshData.lods)
+    {
+        lod.meshletOffset = uint32_t(meshData.meshlets.size());
+        BuildRange(meshData.vertices, meshData.indices.data() + lod.indexOffset,
+                   lod.indexCount, lod.indexOffset, meshData.meshlets);
+        lod.meshletCount =
+            uint32_t(meshData.meshlets.size()) - lod.meshletOffset;
+    }
+
+    const MeshLod &lod0 = meshData.lods[0];
+    std::cout << name << ": meshlets";
+    for (const auto &lod : meshData.lods)
+        std::cout << " " << lod.meshletCount;
+    if (lod0.meshletCount > 0)
+    {
+        std::cout << " (LOD 0 avg "
+                  << float(lod0.indexCount / 3) / float(lod0.meshletCount)
+                  << " tris)";
+    }
+    std::cout << std::endl;
+}
+
+bool MeshletBuilder::IsBackFacing(const Meshlet &meshlet, const Vector3 &eye)
+{
+    // 경계 구 안의 어느 점에서 봐도 콘 전체가 눈 반대쪽을 향하는지
+    // (meshoptimizer의 meshopt_computeMeshletBounds()와 같은 판정)
+    if (meshlet.coneCutoff >= 1.0f)
+        return false;
+
+    const Vector3 d = meshlet.center - eye;
+    return d.Dot(meshlet.coneAxis) >=
+           meshlet.coneCutoff * d.Length() + meshlet.radius;
+}
+
+bool MeshletBuilder::IsBackFacingDirection(const Meshlet &meshlet,
+                                           const Vector3 &viewDir)
+{
+    if (meshlet.coneCutoff >= 1.0f)
+        return false;
+
+    return viewDir.Dot(meshlet.coneAxis) >= meshlet.coneCutoff;
+}
+
+void MeshletBuilder::BuildRange(const std::vector<Vertex> &vertices,
+                                uint32_t *indices, size_t numIndices,
+                                uint32_t indexOffset,
+                                std::vector<Meshlet> &meshlets)
+{
+    const size_t numTriangles = numIndices / 3;
+    if (numTriangles == 0)
+        return;
+
+    const size_t numVertices = vertices.size();
+
+    // 1. 삼각형 노멀과 중심
+    //    그리는 방향(winding)이 파일마다 다를 수 있어서
+    //    버텍스 노멀 쪽을 앞면으로 봄
+    std::vector<Vector3> normals(numTriangles);
+    std::vector<Vector3> centroids(numTriangles);
+    for (size_t t = 0; t < numTriangles; t++)
+    {
+        const Vertex &v0 = vertices[indices[t * 3]];
+        const Vertex &v1 = vertices[indices[t * 3 + 1]];
+        const Vertex &v2 = vertices[indices[t * 3 + 2]];
+
+        Vector3 n = (v1.position - v0.position).Cross(v2.position - v0.position);
+        if (n.Dot(v0.normal + v1.normal + v2.normal) < 0.0f)
+            n = -n;
+        const float length = n.Length();
+        normals[t] = length > 0.0f ? n / length : Vector3(0.0f);
+        centroids[t] = (v0.position + v1.position + v2.position) / 3.0f;
+    }
+
+    // 2. 버텍스 -> 삼각형
+    std::vector<uint32_t> adjacencyOffsets(numVertices + 1, 0);
+    for (size_t i = 0; i < numIndices; i++)
+        adjacencyOffsets[indices[i] + 1]++;
+    for (size_t v = 0; v < numVertices; v++)
+        adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+    std::vector<uint32_t> adjacency(numIndices);
+    {
+        std::vector<uint32_t> fill(adjacencyOffsets.begin(),
+                                   adjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < numIndices; i++)
+            adjacency[fill[indices[i]]++] = uint32_t(i / 3);
+    }
+
+    // 3. 아직 안 쓴 첫 삼각형에서 시작해서 붙어있는 삼각형으로 키움
+    //    새 버텍스가 적게 늘고 노멀이 비슷한 삼각형 우선
+    //    노멀이 콘을 벗어나는 삼각형만 남으면 다음 meshlet 시작
+    std::vector<char> emitted(numTriangles, 0);
+    std::vector<uint32_t> vertexTag(numVertices, ~0u); // 현재 meshlet 번호
+    std::vector<uint32_t> meshletVertices;
+    std::vector<uint32_t> meshletTriangles;
+    std::vector<uint32_t> output;
+    output.reserve(numTriangles * 3);
+
+    // 삼각형을 넣었을 때 새로 늘어나는 버텍스 수
+    uint32_t tag = 0;
+    auto ExtraVertices = [&](size_t t) {
+        const uint32_t a = indices[t * 3];
+        const uint32_t b = indices[t * 3 + 1];
+        const uint32_t c = indices[t * 3 + 2];
+        size_t extra = vertexTag[a] != tag;
+        extra += vertexTag[b] != tag && b != a;
+        extra += vertexTag[c] != tag && c != a && c != b;
+        return extra;
+    };
+
+    // 면적이 없는 삼각형은 어느 meshlet에 들어가도 상관 없음
+    auto FitsCone = [&](size_t t, const Vector3 &axis) {
+        return normals[t].LengthSquared() == 0.0f ||
+               normals[t].Dot(axis) >= minConeDot;
+    };
+
+    size_t cursor = 0;
+    while (true)
+    {
+        while (cursor < numTriangles && emitted[cursor])
+            cursor++;
+        if (cursor == numTriangles)
+            break;
+
+        meshletVertices.clear();
+        meshletTriangles.clear();
+        Vector3 normalSum(0.0f);
+        Vector3 centroidSum(0.0f);
+
+        auto AddTriangle = [&](size_t t) {
+            emitted[t] = 1;
+            meshletTriangles.push_back(uint32_t(t));
+            for (int k = 0; k < 3; k++)
+            {
+                const uint32_t v = indices[t * 3 + k];
+                if (vertexTag[v] != tag)
+                {
+                    vertexTag[v] = tag;
+                    meshletVertices.push_back(v);
+                }
+            }
+            normalSum += normals[t];
+            centroidSum += centroids[t];
+        };
+
+        AddTriangle(cursor);
+
+        while (meshletTriangles.size() < maxTriangles)
+        {
+            Vector3 axis = normalSum;
+            if (axis.LengthSquared() > 0.0f)
+                axis.Normalize();
+            const Vector3 center = centroidSum / float(meshletTriangles.size());
+
+            size_t best = numTriangles;
+            float bestCost = FLT_MAX;
+            for (const uint32_t v : meshletVertices)
+            {
+                for (uint32_t a = adjacencyOffsets[v];
+                     a < adjacencyOffsets[v + 1]; a++)
+                {
+                    const uint32_t t = adjacency[a];
+                    if (emitted[t])
+                        continue;
+
+                    if (!FitsCone(t, axis))
+                        continue;
+
+                    const size_t extra = ExtraVertices(t);
+                    if (meshletVertices.size() + extra > maxVertices)
+                        continue;
+
+                    const float cost =
+                        float(extra) + coneWeight * (1.0f - normals[t].Dot(axis));
+                    if (cost < bestCost)
+                    {
+                        bestCost = cost;
+                        best = t;
+                    }
+                }
+            }
+
+            // 붙어있는 삼각형이 없으면 (조각난 메쉬) 경계 구를 크게
+            // 벌리지 않는 가까운 삼각형으로 이어감
+            if (best == numTriangles)
+            {
+                float radiusSquared = 0.0f;
+                for (const uint32_t v : meshletVertices)
+                {
+                    radiusSquared = std::max(
+                        radiusSquared,
+                        (vertices[v].position - center).LengthSquared());
+                }
+
+                float bestDistance = 4.0f * radiusSquared;
+                size_t checked = 0;
+                for (size_t t = cursor;
+                     t < numTriangles && checked < fallbackSearchWindow; t++)
+                {
+                    if (emitted[t])
+                        continue;
+                    checked++;
+                    if (!FitsCone(t, axis))
+                        continue;
+                    if (meshletVertices.size() + ExtraVertices(t) > maxVertices)
+                        continue;
+
+                    const float distance =
+                        (centroids[t] - center).LengthSquared();
+                    if (distance <= bestDistance)
+                    {
+                        bestDistance = distance;
+                        best = t;
+                    }
+                }
+            }
+
+            if (best == numTriangles)
+                break;
+
+            AddTriangle(best);
+        }
+
+        // 4. 인덱스 출력 + 경계 구 + 노멀 콘
+        Meshlet meshlet;
+        meshlet.indexOffset = indexOffset + uint32_t(output.size());
+        meshlet.indexCount = uint32_t(meshletTriangles.size() * 3);
+        for (const uint32_t t : meshletTriangles)
+        {
+            output.push_back(indices[t * 3]);
+            output.push_back(indices[t * 3 + 1]);
+            output.push_back(indices[t * 3 + 2]);
+        }
+
+        Vector3 vmin = vertices[meshletVertices[0]].position;
+        Vector3 vmax = vmin;
+        for (const uint32_t v : meshletVertices)
+        {
+            vmin = Vector3::Min(vmin, vertices[v].position);
+            vmax = Vector3::Max(vmax, vertices[v].position);
+        }
+        meshlet.center = (vmin + vmax) * 0.5f;
+        for (const uint32_t v : meshletVertices)
+        {
+            meshlet.radius = std::max(
+                meshlet.radius, (vertices[v].position - meshlet.center).Length());
+        }
+
+        // 콘 각도 = 평균 노멀과 가장 많이 벌어진 삼각형 노멀 사이의 각도
+        // 90도 이상 벌어지면 어느 방향에서든 앞면이 보일 수 있음
+        meshlet.coneAxis = normalSum;
+        meshlet.coneCutoff = 1.0f;
+        if (meshlet.coneAxis.LengthSquared() > 0.0f)
+        {
+            meshlet.coneAxis.Normalize();
+
+            float minDot = 1.0f;
+            for (const uint32_t t : meshletTriangles)
+            {
+                if (normals[t].LengthSquared() > 0.0f)
+                    minDot = std::min(minDot, normals[t].Dot(meshlet.coneAxis));
+            }
+            if (minDot > 0.0f)
+                meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+        }
+
+        meshlets.push_back(meshlet);
+        tag++;
+    }
+
+    std::copy(output.begin(), output.end(), indices);
+}
+
+} // namespace FEFE
@@ -0,0 +1,43 @@
+﻿#pragma once
+
+#include <string>
+#include <vector>
+
+#include "MeshData.h"
+
+namespace FEFE
+{
+
+// 인덱스 배열을 작은 삼각형 묶음(meshlet)으로 나누는 클래스
+// 각 LOD 구간 안의 삼각형 순서를 meshlet 단위로 다시 정렬하기 때문에
+// meshlet 하나가 인덱스 배열의 연속된 구간이 됨
+//
+// meshlet마다 경계 구와 노멀 콘을 계산해두면 CPU에서
+// 시야 밖/뒷면인 meshlet을 빼고 남은 구간만 DrawIndexed()할 수 있음
+class MeshletBuilder
+{
+  public:
+    static const size_t maxVertices = 64;
+    static const size_t maxTriangles = 124;
+
+    // meshData.lods의 구간마다 meshlet을 만들어 meshData.meshlets에 저장
+    // lods가 비어있으면 indices 전체를 LOD 0으로 추가
+    static void Build(MeshData &meshData, const std::string &name);
+
+    // 눈(모델 좌표)에서 meshlet의 모든 삼각형이 뒷면으로 보이면 true
+    static bool IsBackFacing(const Meshlet &meshlet,
+                             const DirectX::SimpleMath::Vector3 &eye);
+
+    // 직교 투영: 보는 방향(모델 좌표)으로 판단
+    static bool IsBackFacingDirection(const Meshlet &meshlet,
+                                      const DirectX::SimpleMath::Vector3 &viewDir);
+
+  private:
+    // indices[0, numIndices)를 meshlet 순서로 바꾸고 meshlets에 추가
+    static void BuildRange(const std::vector<Vertex> &vertices,
+                           uint32_t *indices, size_t numIndices,
+                           uint32_t indexOffset,
+                           std::vector<Meshlet> &meshlets);
+};
+
+} // namespace FEFE
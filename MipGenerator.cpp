@@ -0,0 +1,371 @@
+﻿#include "MipGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+#include "ThreadPool.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FEFE_MIP_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace FEFE
+{
+
+namespace
+{
+
+// Kaiser 필터: 반지름 3 (줄인 이미지의 픽셀 단위), alpha 4 (NVTT 기본값과 같음)
+const float kaiserWidth = 3.0f;
+const float kaiserAlpha = 4.0f;
+
+// 한 번에 처리하는 결과 줄 수 (병렬 단위)
+const int bandRows = 32;
+
+struct Tap
+{
+    int index;
+    float weight;
+};
+
+// 결과 픽셀 d가 사용하는 원본 픽셀들: taps[offsets[d], offsets[d + 1])
+struct Taps
+{
+    std::vector<size_t> offsets;
+    std::vector<Tap> taps;
+};
+
+float BesselI0(float x)
+{
+    // 급수 전개, 항이 충분히 작아질 때까지
+    float sum = 1.0f;
+    float term = 1.0f;
+    const float y = x * x * 0.25f;
+    for (int k = 1; k < 32 && term > sum * 1e-8f; k++)
+    {
+        term *= y / float(k * k);
+        sum += term;
+    }
+    return sum;
+}
+
+float Sinc(float x)
+{
+    if (std::fabs(x) < 1e-6f)
+        return 1.0f;
+    const float px = 3.14159265f * x;
+    return std::sin(px) / px;
+}
+
+float KaiserWeight(float x) // x: 줄인 이미지의 픽셀 단위
+{
+    const float t = x / kaiserWidth;
+    if (t <= -1.0f || t >= 1.0f)
+        return 0.0f;
+    return Sinc(x) * BesselI0(kaiserAlpha * std::sqrt(1.0f - t * t)) /
+           BesselI0(kaiserAlpha);
+}
+
+int ResolveEdge(int i, int size, MipEdge edge)
+{
+    if (edge == MipEdge::Wrap)
+        return ((i % size) + size) % size;
+    return std::min(std::max(i, 0), size - 1);
+}
+
+Taps ComputeTaps(int srcSize, int dstSize, const MipOptions &options)
+{
+    Taps result;
+    result.offsets.push_back(0);
+
+    const float scale = float(srcSize) / float(dstSize);
+    for (int d = 0; d < dstSize; d++)
+    {
+        const size_t first = result.taps.size();
+        const float center = (float(d) + 0.5f) * scale; // 원본 좌표
+
+        if (options.filter == MipFilter::Box)
+        {
+            // 결과 픽셀이 덮는 [center - r, center + r]와 겹치는 면적
+            const float r = 0.5f * scale;
+            for (int i = int(std::floor(center - r)); float(i) < center + r; i++)
+            {
+                const float overlap = std::min(float(i + 1), center + r) -
+                                      std::max(float(i), center - r);
+                if (overlap > 0.0f)
+                    result.taps.push_back(
+                        {ResolveEdge(i, srcSize, options.edge), overlap});
+            }
+        }
+        else
+        {
+            const float r = kaiserWidth * scale;
+            for (int i = int(std::floor(center - r)); float(i) < center + r; i++)
+            {
+                const float w = KaiserWeight((float(i) + 0.5f - center) / scale);
+                if (w != 0.0f)
+                    result.taps.push_back(
+                        {ResolveEdge(i, srcSize, options.edge), w});
+            }
+        }
+
+        float sum = 0.0f;
+        for (size_t t = first; t < result.taps.size(); t++)
+            sum += result.taps[t].weight;
+        for (size_t t = first; t < result.taps.size(); t++)
+            result.taps[t].weight /= sum;
+
+        result.offsets.push_back(result.taps.size());
+    }
+    return result;
+}
+
+// out[0, count) += w * in[0, count) (count는 4의 배수, RGBA)
+inline void MulAdd(float *out, const float *in, size_t count, float w)
+{
+    size_t i = 0;
+#ifdef FEFE_MIP_SSE2
+    const __m128 w4 = _mm_set1_ps(w);
+    for (; i < count; i += 4)
+    {
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i),
+                                          _mm_mul_ps(_mm_loadu_ps(in + i), w4)));
+    }
+#endif
+    for (; i < count; i++)
+        out[i] += w * in[i];
+}
+
+// 가로 방향: 원본 한 줄 (srcWidth) -> 결과 한 줄 (dstWidth)
+void FilterRow(const float *src, const Taps &taps, int dstWidth, float *dst)
+{
+    for (int x = 0; x < dstWidth; x++)
+    {
+#ifdef FEFE_MIP_SSE2
+        __m128 sum = _mm_setzero_ps();
+        for (size_t t = taps.offsets[x]; t < taps.offsets[x + 1]; t++)
+        {
+            const Tap &tap = taps.taps[t];
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src + tap.index * 4),
+                                             _mm_set1_ps(tap.weight)));
+        }
+        _mm_storeu_ps(dst + x * 4, sum);
+#else
+        float sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        for (size_t t = taps.offsets[x]; t < taps.offsets[x + 1]; t++)
+        {
+            const Tap &tap = taps.taps[t];
+            for (int c = 0; c < 4; c++)
+                sum[c] += src[tap.index * 4 + c] * tap.weight;
+        }
+        std::memcpy(dst + x * 4, sum, sizeof(sum));
+#endif
+    }
+}
+
+// 원본의 y번째 줄을 float RGBA로 (scratch는 변환이 필요할 때 사용하는 버퍼)
+using RowSource = std::function<const float *(int y, float *scratch)>;
+
+// 결과 줄 bandRows개마다: 필요한 원본 줄만 가로로 줄이고 세로로 합침
+// 원본 전체를 가로로 줄인 중간 이미지를 만들지 않아서 메모리가 적음
+void Downsample(const RowSource &source, int srcWidth, int srcHeight,
+                int dstWidth, int dstHeight, const MipOptions &options,
+                float *dst)
+{
+    const Taps tapsX = ComputeTaps(srcWidth, dstWidth, options);
+    const Taps tapsY = ComputeTaps(srcHeight, dstHeight, options);
+    const size_t dstRowSize = size_t(dstWidth) * 4;
+
+    const size_t numBands = (dstHeight + bandRows - 1) / bandRows;
+    ThreadPool::Get().ParallelFor(numBands, [&](size_t band) {
+        const int y0 = int(band) * bandRows;
+        const int y1 = std::min(y0 + bandRows, dstHeight);
+
+        std::vector<int> rows;
+        for (size_t t = tapsY.offsets[y0]; t < tapsY.offsets[y1]; t++)
+            rows.push_back(tapsY.taps[t].index);
+        std::sort(rows.begin(), rows.end());
+        rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+        std::vector<float> scratch(size_t(srcWidth) * 4);
+        std::vector<float> filtered(rows.size() * dstRowSize);
+        for (size_t r = 0; r < rows.size(); r++)
+        {
+            FilterRow(source(rows[r], scratch.data()), tapsX, dstWidth,
+                      filtered.data() + r * dstRowSize);
+        }
+
+        for (int y = y0; y < y1; y++)
+        {
+            float *out = dst + size_t(y) * dstRowSize;
+            std::fill(out, out + dstRowSize, 0.0f);
+            for (size_t t = tapsY.offsets[y]; t < tapsY.offsets[y + 1]; t++)
+            {
+                const Tap &tap = tapsY.taps[t];
+                const size_t slot =
+                    std::lower_bound(rows.begin(), rows.end(), tap.index) -
+                    rows.begin();
+                MulAdd(out, filtered.data() + slot * dstRowSize, dstRowSize,
+                       tap.weight);
+            }
+        }
+    });
+}
+
+template <typename T_PIXEL>
+TMipChain<T_PIXEL> AllocateChain(int width, int height)
+{
+    TMipChain<T_PIXEL> chain;
+    size_t offset = 0;
+    const size_t numLevels = MipGenerator::GetNumLevels(width, height);
+    for (size_t level = 0; level < numLevels; level++)
+    {
+        MipLevel mip;
+        mip.width = std::max(width >> level, 1);
+        mip.height = std::max(height >> level, 1);
+        mip.offset = offset;
+        chain.levels.push_back(mip);
+        offset += size_t(mip.width) * mip.height * 4;
+    }
+    chain.pixels.resize(offset);
+    return chain;
+}
+
+// 8비트 <-> 선형 float 변환표
+const float *SrgbToLinearTable()
+{
+    static const std::vector<float> table = []() {
+        std::vector<float> t(256);
+        for (int i = 0; i < 256; i++)
+        {
+            const float c = float(i) / 255.0f;
+            t[i] = c <= 0.04045f ? c / 12.92f
+                                 : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        return t;
+    }();
+    return table.data();
+}
+
+// 선형 [0, 1]을 16비트로 양자화한 값 -> sRGB 8비트
+// 어두운 쪽에서도 8비트 한 단계보다 훨씬 촘촘함
+const uint8_t *LinearToSrgbTable()
+{
+    static const std::vector<uint8_t> table = []() {
+        std::vector<uint8_t> t(65536);
+        for (int i = 0; i < 65536; i++)
+        {
+            const float c = float(i) / 65535.0f;
+            const float s = c <= 0.0031308f
+                                ? c * 12.92f
+                                : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+            t[i] = uint8_t(std::min(std::max(s, 0.0f), 1.0f) * 255.0f + 0.5f);
+        }
+        return t;
+    }();
+    return table.data();
+}
+
+inline float Saturate(float x) { return std::min(std::max(x, 0.0f), 1.0f); }
+
+} // namespace
+
+size_t MipGenerator::GetNumLevels(int width, int height)
+{
+    size_t numLevels = 1;
+    for (int size = std::max(width, height); size > 1; size >>= 1)
+        numLevels++;
+    return numLevels;
+}
+
+TMipChain<uint8_t> MipGenerator::Generate(const uint8_t *rgba, int width,
+                                          int height,
+                                          const MipOptions &options)
+{
+    TMipChain<uint8_t> chain = AllocateChain<uint8_t>(width, height);
+    std::copy(rgba, rgba + chain.levels[0].width * size_t(height) * 4,
+              chain.pixels.begin());
+
+    const float *toLinear = SrgbToLinearTable();
+    const uint8_t *toSrgb = LinearToSrgbTable();
+
+    // 레벨 0만 8비트에서 읽고, 그 다음부터는 바로 위 레벨의 float를 사용
+    // (8비트로 반올림한 값을 다시 줄이면 오차가 쌓임)
+    std::vector<float> previous, current;
+    for (size_t level = 1; level < chain.levels.size(); level++)
+    {
+        const MipLevel &src = chain.levels[level - 1];
+        const MipLevel &dst = chain.levels[level];
+
+        RowSource source;
+        if (level == 1)
+        {
+            source = [&](int y, float *scratch) {
+                const uint8_t *row = rgba + size_t(y) * width * 4;
+                for (int i = 0; i < width * 4; i++)
+                {
+                    scratch[i] = options.srgb && (i & 3) != 3
+                                     ? toLinear[row[i]]
+                                     : float(row[i]) / 255.0f;
+                }
+                return (const float *)scratch;
+            };
+        }
+        else
+        {
+            source = [&](int y, float *) {
+                return (const float *)previous.data() + size_t(y) * src.width * 4;
+            };
+        }
+
+        current.resize(size_t(dst.width) * dst.height * 4);
+        Downsample(source, src.width, src.height, dst.width, dst.height,
+                   options, current.data());
+
+        uint8_t *out = chain.pixels.data() + dst.offset;
+        ThreadPool::Get().ParallelForChunks(
+            current.size(), 64 * 1024, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++)
+                {
+                    const float c = Saturate(current[i]);
+                    out[i] = options.srgb && (i & 3) != 3
+                                 ? toSrgb[int(c * 65535.0f + 0.5f)]
+                                 : uint8_t(c * 255.0f + 0.5f);
+                }
+            });
+
+        std::swap(previous, current);
+    }
+
+    return chain;
+}
+
+TMipChain<float> MipGenerator::Generate(const float *rgba, int width,
+                                        int height, const MipOptions &options)
+{
+    TMipChain<float> chain = AllocateChain<float>(width, height);
+    std::copy(rgba, rgba + size_t(width) * height * 4, chain.pixels.begin());
+
+    // 결과를 바로 체인에 쓰고 다음 레벨의 입력으로 사용
+    for (size_t level = 1; level < chain.levels.size(); level++)
+    {
+        const MipLevel &src = chain.levels[level - 1];
+        const MipLevel &dst = chain.levels[level];
+        const float *srcPixels = chain.pixels.data() + src.offset;
+
+        Downsample(
+            [&](int y, float *) {
+                return srcPixels + size_t(y) * src.width * 4;
+            },
+            src.width, src.height, dst.width, dst.height, options,
+            chain.pixels.data() + dst.offset);
+    }
+
+    return chain;
+}
+
+} // namespace FEFE
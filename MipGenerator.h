@@ -0,0 +1,72 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace FEFE
+{
+
+enum class MipFilter
+{
+    Box,    // 2x2 평균 (크기가 홀수면 겹치는 면적으로 가중치)
+    Kaiser, // Kaiser 창을 씌운 sinc, 더 선명하지만 조금 느림
+};
+
+enum class MipEdge
+{
+    Wrap,  // 반복되는 텍스춰 (uv가 0~1 밖으로 나감)
+    Clamp, // 가장자리 픽셀 반복
+};
+
+struct MipOptions
+{
+    MipFilter filter = MipFilter::Box;
+    MipEdge edge = MipEdge::Wrap;
+
+    // 8비트 이미지의 RGB를 sRGB로 보고 선형 공간에서 평균 (알파는 항상 선형)
+    // 노멀맵/러프니스처럼 색이 아닌 데이터는 false
+    bool srgb = true;
+};
+
+// pixels 안에서 mip 레벨 하나의 위치 (offset은 원소 단위, RGBA라서 픽셀 * 4)
+struct MipLevel
+{
+    int width = 0;
+    int height = 0;
+    size_t offset = 0;
+};
+
+// 레벨 0부터 1x1까지 모든 레벨을 한 배열에 이어서 저장
+// D3D11_SUBRESOURCE_DATA 배열이나 DDS 파일에 그대로 쓸 수 있음
+template <typename T_PIXEL> struct TMipChain
+{
+    std::vector<MipLevel> levels;
+    std::vector<T_PIXEL> pixels; // RGBA
+
+    const T_PIXEL *GetLevel(size_t level) const
+    {
+        return pixels.data() + levels[level].offset;
+    }
+};
+
+// RGBA 이미지의 mip 체인을 CPU에서 만드는 클래스
+// D3D를 쓰지 않기 때문에 로딩 중(작업 스레드)이나 오프라인 변환에서 모두 사용
+// 각 레벨은 바로 위 레벨을 가로/세로로 나눠서(separable) 줄이고
+// 세로 방향 줄(band)마다 ThreadPool에서 병렬, 픽셀 하나(float4)를 SSE로 계산
+class MipGenerator
+{
+  public:
+    // width x height에서 1x1까지의 레벨 수
+    static size_t GetNumLevels(int width, int height);
+
+    // 8비트 RGBA, 레벨 0은 입력을 그대로 복사
+    static TMipChain<uint8_t> Generate(const uint8_t *rgba, int width,
+                                       int height, const MipOptions &options);
+
+    // float RGBA (HDR), options.srgb는 무시 (이미 선형)
+    static TMipChain<float> Generate(const float *rgba, int width, int height,
+                                     const MipOptions &options);
+};
+
+} // namespace FEFE
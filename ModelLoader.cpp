@@ -1,73 +1,133 @@
 ﻿#include "ModelLoader.h"
 
+#include <chrono>
 #include <filesystem>
 
+#include "ChannelPacker.h"
+#include "ThreadPool.h"
+
 namespace FEFE 
 {
 
 using namespace DirectX::SimpleMath;
 
+static double ElapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+// assimp 행렬을 SimpleMath 행렬로 변환 (assimp는 column vector 기준)
+static Matrix ToMatrix(const aiMatrix4x4 &transformation)
+{
+    Matrix m;
+    const ai_real *temp = &transformation.a1;
+    float *mTemp = &m._11;
+    for (int t = 0; t < 16; t++) 
+    {
+        mTemp[t] = float(temp[t]);
+    }
+    return m.Transpose();
+}
+
 void ModelLoader::Load(std::string basePath, std::string filename) 
 {
     this->basePath = basePath;
+    this->timings = ModelLoadTimings();
+    meshes.clear();
+    nodes.clear();
+    instances.clear();
      
     Assimp::Importer importer;
 
-    const aiScene *pScene = importer.ReadFile(
-        this->basePath + filename,
-        aiProcess_Triangulate | aiProcess_ConvertToLeftHanded);
+    auto start = std::chrono::steady_clock::now();
+
+    const aiScene *pScene =
+        importer.ReadFile(this->basePath + filename, importFlags);
+
+    timings.readFile = ElapsedMs(start);
 
     if (!pScene) {
         std::cout << "Failed to read file: " << this->basePath + filename
                   << std::endl;
     } else {
-        Matrix tr; // Initial transformation
-        ProcessNode(pScene->mRootNode, pScene, tr);
+        // 1. 노드 트리와 인스턴스 목록 (행렬은 버텍스에 곱하지 않음)
+        start = std::chrono::steady_clock::now();
+        meshRemap.assign(pScene->mNumMeshes, -1);
+        sourceMeshes.clear();
+        ProcessNode(pScene->mRootNode, pScene, -1);
+        timings.flatten = ElapsedMs(start);
+
+        // 2. 고유한 aiMesh만 추출
+        //    미리 자리를 만들어 두고 각 작업이 자기 자리에만 씀
+        //    -> 스레드 개수와 상관없이 결과 순서가 항상 같음
+        start = std::chrono::steady_clock::now();
+        meshes.resize(sourceMeshes.size());
+        auto Extract = [&](size_t i) {
+            meshes[i] = this->ProcessMesh(sourceMeshes[i], pScene);
+        };
+        if (useParallel)
+        {
+            ThreadPool::Get().ParallelFor(sourceMeshes.size(), Extract);
+        }
+        else
+        {
+            for (size_t i = 0; i < sourceMeshes.size(); i++)
+                Extract(i);
+        }
+        timings.extract = ElapsedMs(start);
     }
+
+    std::cout << filename << ": " << meshes.size() << " meshes, "
+              << instances.size() << " instances, read "
+              << timings.readFile << " ms, flatten " << timings.flatten
+              << " ms, extract " << timings.extract << " ms"
+              << (useParallel ? " (parallel)" : " (serial)") << std::endl;
 }
 
-void ModelLoader::ProcessNode(aiNode *node, const aiScene *scene, Matrix tr) 
+void ModelLoader::ProcessNode(aiNode *node, const aiScene *scene, int parent)
 {
+    const int nodeIndex = int(nodes.size());
 
-    Matrix m;
-    ai_real *temp = &node->mTransformation.a1;
-    float *mTemp = &m._11;
-    for (int t = 0; t < 16; t++) 
-    {
-        mTemp[t] = float(temp[t]);
-    }
-    m = m.Transpose() * tr;
+    SceneNode newNode;
+    newNode.parent = parent;
+    newNode.transform = ToMatrix(node->mTransformation);
+    nodes.push_back(newNode);
 
-    for (UINT i = 0; i < node->mNumMeshes; i++) 
+    for (UINT i = 0; i < node->mNumMeshes; i++)
     {
-
-        aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
-        auto newMesh = this->ProcessMesh(mesh, scene);
-
-        for (auto &v : newMesh.vertices) 
+        const UINT sourceIndex = node->mMeshes[i];
+        if (meshRemap[sourceIndex] < 0)
         {
-            v.position = DirectX::SimpleMath::Vector3::Transform(v.position, m);
+            meshRemap[sourceIndex] = int(sourceMeshes.size());
+            sourceMeshes.push_back(scene->mMeshes[sourceIndex]);
         }
 
-        meshes.push_back(newMesh);
+        MeshInstance instance;
+        instance.meshIndex = uint32_t(meshRemap[sourceIndex]);
+        instance.nodeIndex = uint32_t(nodeIndex);
+        instances.push_back(instance);
     }
 
-    for (UINT i = 0; i < node->mNumChildren; i++) 
+    for (UINT i = 0; i < node->mNumChildren; i++)
     {
-        this->ProcessNode(node->mChildren[i], scene, m);
+        this->ProcessNode(node->mChildren[i], scene, nodeIndex);
     }
 }
 
 MeshData ModelLoader::ProcessMesh(aiMesh *mesh, const aiScene *scene)
 {
     // cpu에서 정의
-    std::vector<Vertex> vertices;
-    std::vector<uint32_t> indices;
+    // 개수를 미리 알고 있으므로 한 번에 할당하고 자리에 바로 씀
+    MeshData newMesh;
+    std::vector<Vertex> &vertices = newMesh.vertices;
+    std::vector<uint32_t> &indices = newMesh.indices;
 
-   
+    vertices.resize(mesh->mNumVertices);
     for (UINT i = 0; i < mesh->mNumVertices; i++) 
     {
-        Vertex vertex;
+        Vertex &vertex = vertices[i];
 
         vertex.position.x = mesh->mVertices[i].x;
         vertex.position.y = mesh->mVertices[i].y;
@@ -83,39 +143,64 @@ MeshData ModelLoader::ProcessMesh(aiMesh *mesh, const aiScene *scene)
             vertex.texcoord.x = (float)mesh->mTextureCoords[0][i].x;
             vertex.texcoord.y = (float)mesh->mTextureCoords[0][i].y;
         }
-
-        vertices.push_back(vertex);
     }
 
+    // aiProcess_Triangulate를 사용하므로 대부분 면당 3개
+    indices.reserve(size_t(mesh->mNumFaces) * 3);
     for (UINT i = 0; i < mesh->mNumFaces; i++) 
     {
-        aiFace face = mesh->mFaces[i];
-        for (UINT j = 0; j < face.mNumIndices; j++)
-            indices.push_back(face.mIndices[j]);
+        const aiFace &face = mesh->mFaces[i];
+        indices.insert(indices.end(), face.mIndices,
+                       face.mIndices + face.mNumIndices);
     }
 
-    MeshData newMesh;
-    newMesh.vertices = vertices;
-    newMesh.indices = indices;
-
     // http://assimp.sourceforge.net/lib_html/materials.html
     if (mesh->mMaterialIndex >= 0) 
     {
         aiMaterial *material = scene->mMaterials[mesh->mMaterialIndex];
 
-        if (material->GetTextureCount(aiTextureType_DIFFUSE) > 0)
-        {
-            aiString filepath;
-            material->GetTexture(aiTextureType_DIFFUSE, 0, &filepath);
+        auto GetTextureFilename = [&](aiTextureType type) {
+            if (material->GetTextureCount(type) == 0)
+                return std::string();
 
-            std::string fullPath =
-                this->basePath +
-                std::string(std::filesystem::path(filepath.C_Str())
-                                .filename()
-                                .string());
-
-            newMesh.textureFilename = fullPath;
+            aiString filepath;
+            material->GetTexture(type, 0, &filepath);
+
+            return this->basePath +
+                   std::string(std::filesystem::path(filepath.C_Str())
+                                   .filename()
+                                   .string());
+        };
+
+        newMesh.textureFilename = GetTextureFilename(aiTextureType_DIFFUSE);
+
+        // 스칼라 텍스춰는 흑백 이미지 (채널 0)
+        MaterialTextures &textures = newMesh.materialTextures;
+        textures.occlusion.filename =
+            GetTextureFilename(aiTextureType_AMBIENT_OCCLUSION);
+        if (textures.occlusion.filename.empty())
+            textures.occlusion.filename =
+                GetTextureFilename(aiTextureType_LIGHTMAP);
+        textures.roughness.filename =
+            GetTextureFilename(aiTextureType_DIFFUSE_ROUGHNESS);
+        textures.metallic.filename = GetTextureFilename(aiTextureType_METALNESS);
+        textures.height.filename = GetTextureFilename(aiTextureType_HEIGHT);
+        if (textures.height.filename.empty())
+            textures.height.filename =
+                GetTextureFilename(aiTextureType_DISPLACEMENT);
+
+        // 거칠기와 금속성이 같은 이미지면 glTF식 ORM 배치 (G = 거칠기, B = 금속성)
+        if (!textures.metallic.filename.empty() &&
+            textures.metallic.filename == textures.roughness.filename)
+        {
+            textures.roughness.channel = 1;
+            textures.metallic.channel = 2;
         }
+
+        // 파일에 기록되지 않은 텍스춰는 재질 이름 규칙으로 찾기
+        // (Substance Painter 등이 내보내는 <재질>_Metallic.png 등)
+        ChannelPacker::FindBySuffix(this->basePath,
+                                    material->GetName().C_Str(), textures);
     }
 
     return newMesh;
@@ -16,18 +16,41 @@
 
 namespace FEFE 
 {
+
+// 단계별 로딩 시간 (ms)
+struct ModelLoadTimings
+{
+    double readFile = 0.0;
+    double flatten = 0.0;
+    double extract = 0.0;
+};
+
 class ModelLoader
 {
   public:
+    // Load()에서 사용하는 assimp 옵션 (메쉬 캐시 키에도 사용)
+    static const unsigned int importFlags =
+        aiProcess_Triangulate | aiProcess_ConvertToLeftHanded;
+
     void Load(std::string basePath, std::string filename);
 
-    void ProcessNode(aiNode *node, const aiScene *scene,
-                     DirectX::SimpleMath::Matrix tr);
+    // 노드 트리를 그대로 nodes에 옮기고 (전위 순회, 부모가 먼저)
+    // 노드가 가리키는 aiMesh는 처음 나올 때 한 번만 meshes에 자리를 만듦
+    void ProcessNode(aiNode *node, const aiScene *scene, int parent);
 
     MeshData ProcessMesh(aiMesh *mesh, const aiScene *scene);
 
   public:
     std::string basePath;
-    std::vector<MeshData> meshes;
+    std::vector<MeshData> meshes; // aiMesh 하나당 하나 (노드 행렬 적용 X)
+    std::vector<SceneNode> nodes;
+    std::vector<MeshInstance> instances;
+
+    bool useParallel = true; // false면 메쉬를 하나씩 처리
+    ModelLoadTimings timings;
+
+  private:
+    std::vector<int> meshRemap;         // aiScene 메쉬 번호 -> meshes 번호
+    std::vector<aiMesh *> sourceMeshes; // meshes 순서의 aiMesh
 };
 } // namespace FEFE
\ No newline at end of file
@@ -0,0 +1,368 @@
+﻿#include "OctahedralEnvMap.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+
+#include "BlockCompressor.h"
+#include "DdsFile.h"
+#include "ThreadPool.h"
+
+namespace FEFE
+{
+
+namespace
+{
+
+// 결과 파일 형식이나 매핑이 바뀌면 올려서 예전 파일을 다시 만듦
+const uint32_t octahedralVersion = 1;
+
+// 방향 -> [-1, 1]^2 (VertexFormat.cpp와 같은 매핑)
+void OctahedralEncode(const float n[3], float e[2])
+{
+    const float l1 = std::fabs(n[0]) + std::fabs(n[1]) + std::fabs(n[2]);
+    e[0] = n[0] / l1;
+    e[1] = n[1] / l1;
+    if (n[2] < 0.0f)
+    {
+        const float x = e[0], y = e[1];
+        e[0] = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        e[1] = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+    }
+}
+
+void OctahedralDecode(const float e[2], float n[3])
+{
+    n[0] = e[0];
+    n[1] = e[1];
+    n[2] = 1.0f - std::fabs(e[0]) - std::fabs(e[1]);
+    const float t = std::clamp(-n[2], 0.0f, 1.0f);
+    n[0] += n[0] >= 0.0f ? -t : t;
+    n[1] += n[1] >= 0.0f ? -t : t;
+}
+
+// [-1, 1]^2 밖 (테두리)은 가장자리의 가운데를 기준으로 접음
+// 팔면체의 같은 모서리를 공유하는 반대편 텍셀이 됨
+void FoldBorder(float e[2])
+{
+    for (int axis = 0; axis < 2; axis++)
+    {
+        if (e[axis] > 1.0f)
+        {
+            e[axis] = 2.0f - e[axis];
+            e[1 - axis] = -e[1 - axis];
+        }
+        else if (e[axis] < -1.0f)
+        {
+            e[axis] = -2.0f - e[axis];
+            e[1 - axis] = -e[1 - axis];
+        }
+    }
+}
+
+int GetOctahedralSize(int cubemapSize, float scale)
+{
+    return std::max((int(std::lround(cubemapSize * scale)) + 2) / 4 * 4, 4);
+}
+
+// 레벨마다 R16G16B16A16 / BC6H 바이트 수
+void GetMemory(const std::vector<int> &sizes, size_t &floatBytes,
+               size_t &bc6hBytes)
+{
+    floatBytes = bc6hBytes = 0;
+    for (int size : sizes)
+    {
+        floatBytes += DdsFile::GetLevelSize(DxgiFormat::R16G16B16A16_Float,
+                                            uint32_t(size), uint32_t(size));
+        bc6hBytes += DdsFile::GetLevelSize(DxgiFormat::BC6H_UF16,
+                                           uint32_t(size), uint32_t(size));
+    }
+}
+
+// 원본 큐브맵 레벨 0의 텍셀 방향에서 상대 오차와 RMSE
+// 큐브맵 모서리의 작은 텍셀이 더 많이 세어지지 않도록 텍셀의 입체각으로 가중치
+template <typename T_SAMPLE>
+void MeasureError(const FloatCubemap &reference, T_SAMPLE sample,
+                  double &meanRelative, double &rmse)
+{
+    double sumError = 0.0, sumReference = 0.0, sumSquared = 0.0;
+    double sumWeight = 0.0;
+    const int size = reference.size;
+    for (int face = 0; face < 6; face++)
+    {
+        for (int y = 0; y < size; y++)
+        {
+            for (int x = 0; x < size; x++)
+            {
+                const float u = (x + 0.5f) * 2.0f / size - 1.0f;
+                const float v = (y + 0.5f) * 2.0f / size - 1.0f;
+                float d[3];
+                FloatCubemap::GetDirection(face, u, v, d);
+                const double invLength = 1.0 / std::sqrt(1.0 + u * u + v * v);
+                const double weight = invLength * invLength * invLength;
+
+                float rgb[3];
+                sample(d, rgb);
+                const float *texel =
+                    reference.GetFace(face) + (size_t(y) * size + x) * 4;
+                for (int ch = 0; ch < 3; ch++)
+                {
+                    const double error = double(rgb[ch]) - texel[ch];
+                    sumSquared += error * error * weight;
+                    sumError += std::fabs(error) * weight;
+                    sumReference += std::fabs(texel[ch]) * weight;
+                }
+                sumWeight += weight * 3.0;
+            }
+        }
+    }
+    meanRelative = sumReference > 0.0 ? sumError / sumReference : 0.0;
+    rmse = std::sqrt(sumSquared / sumWeight);
+}
+
+} // namespace
+
+std::vector<OctahedralLevel>
+OctahedralEnvMap::Convert(const std::vector<FloatCubemap> &cubemapLevels,
+                          const OctahedralOptions &options)
+{
+    std::vector<OctahedralLevel> levels;
+    if (cubemapLevels.empty())
+        return levels;
+
+    const int border = std::max(options.border, 0);
+    const int size = GetOctahedralSize(cubemapLevels[0].size, options.scale);
+    for (size_t m = 0; m < cubemapLevels.size(); m++)
+    {
+        const int levelSize = std::max(size >> m, 1);
+        if (levelSize - 2 * border < 2)
+            break;
+        levels.emplace_back();
+        levels.back().size = levelSize;
+        levels.back().pixels.resize(size_t(levelSize) * levelSize * 4);
+    }
+
+    // 안쪽이 너무 작은 레벨을 버렸으면 남은 레벨에 거칠기 0 ~ 1을 다시 나눔
+    // 레벨 m은 큐브맵의 실수 레벨 m * (큐브맵 레벨 수 - 1) / (레벨 수 - 1)
+    const float levelScale =
+        levels.size() > 1 ? float(cubemapLevels.size() - 1) /
+                                float(levels.size() - 1)
+                          : 0.0f;
+
+    struct Row
+    {
+        size_t level;
+        int y;
+    };
+    std::vector<Row> rows;
+    for (size_t m = 0; m < levels.size(); m++)
+    {
+        for (int y = 0; y < levels[m].size; y++)
+            rows.push_back({m, y});
+    }
+
+    ThreadPool::Get().ParallelFor(rows.size(), [&](size_t i) {
+        OctahedralLevel &level = levels[rows[i].level];
+        const int y = rows[i].y;
+
+        const float lod = float(rows[i].level) * levelScale;
+        const size_t level0 = std::min(size_t(lod), cubemapLevels.size() - 1);
+        const size_t level1 = std::min(level0 + 1, cubemapLevels.size() - 1);
+        const float t = lod - float(level0);
+        const float interior = float(level.size - 2 * border);
+
+        float *row = level.pixels.data() + size_t(y) * level.size * 4;
+        for (int x = 0; x < level.size; x++)
+        {
+            float e[2] = {(float(x - border) + 0.5f) / interior * 2.0f - 1.0f,
+                          (float(y - border) + 0.5f) / interior * 2.0f - 1.0f};
+            FoldBorder(e);
+            float d[3];
+            OctahedralDecode(e, d);
+
+            float *texel = row + size_t(x) * 4;
+            cubemapLevels[level0].Sample(d, texel);
+            if (t > 0.0f && level1 != level0)
+            {
+                float next[3];
+                cubemapLevels[level1].Sample(d, next);
+                for (int ch = 0; ch < 3; ch++)
+                    texel[ch] += (next[ch] - texel[ch]) * t;
+            }
+            texel[3] = 1.0f;
+        }
+    });
+    return levels;
+}
+
+void OctahedralEnvMap::Sample(const OctahedralLevel &level, int border,
+                              const float direction[3], float rgb[3])
+{
+    float e[2];
+    OctahedralEncode(direction, e);
+
+    // 텍셀 중심이 정수가 되도록, 테두리가 있으므로 clamp할 필요가 거의 없음
+    const float interior = float(level.size - 2 * border);
+    const float maxCoord = float(level.size - 1);
+    const float s = std::clamp(float(border) + (e[0] * 0.5f + 0.5f) * interior - 0.5f,
+                               0.0f, maxCoord);
+    const float t = std::clamp(float(border) + (e[1] * 0.5f + 0.5f) * interior - 0.5f,
+                               0.0f, maxCoord);
+    const int x0 = int(s), y0 = int(t);
+    const int x1 = std::min(x0 + 1, level.size - 1);
+    const int y1 = std::min(y0 + 1, level.size - 1);
+    const float fx = s - float(x0), fy = t - float(y0);
+
+    const float *p00 = level.pixels.data() + (size_t(y0) * level.size + x0) * 4;
+    const float *p10 = level.pixels.data() + (size_t(y0) * level.size + x1) * 4;
+    const float *p01 = level.pixels.data() + (size_t(y1) * level.size + x0) * 4;
+    const float *p11 = level.pixels.data() + (size_t(y1) * level.size + x1) * 4;
+    for (int ch = 0; ch < 3; ch++)
+    {
+        const float top = p00[ch] + (p10[ch] - p00[ch]) * fx;
+        const float bottom = p01[ch] + (p11[ch] - p01[ch]) * fx;
+        rgb[ch] = top + (bottom - top) * fy;
+    }
+}
+
+bool OctahedralEnvMap::Generate(const std::string &cubemapFilename,
+                                const std::string &outputFilename,
+                                const OctahedralOptions &options)
+{
+    std::vector<FloatCubemap> cubemapLevels;
+    if (!FloatCubemap::ReadMipChain(cubemapFilename, cubemapLevels))
+        return false;
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::vector<OctahedralLevel> levels = Convert(cubemapLevels, options);
+    const double ms = std::chrono::duration<double, std::milli>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+    if (levels.empty())
+        return false;
+
+    DdsDesc desc;
+    desc.format = DxgiFormat::R16G16B16A16_Float;
+    desc.width = desc.height = uint32_t(levels[0].size);
+    desc.mipLevels = uint32_t(levels.size());
+
+    std::vector<uint16_t> halfs;
+    halfs.reserve(DdsFile::GetDataSize(desc) / sizeof(uint16_t));
+    for (const OctahedralLevel &level : levels)
+    {
+        for (float c : level.pixels)
+            halfs.push_back(BlockCompressor::FloatToHalf(c));
+    }
+
+    size_t cubemapBytes = 0;
+    for (size_t m = 0; m < levels.size(); m++)
+    {
+        cubemapBytes += 6 * DdsFile::GetLevelSize(
+                                DxgiFormat::R16G16B16A16_Float,
+                                uint32_t(cubemapLevels[m].size),
+                                uint32_t(cubemapLevels[m].size));
+    }
+
+    std::cout << cubemapFilename << " -> octahedral: " << cubemapLevels[0].size
+              << "x" << cubemapLevels[0].size << " x 6 -> " << desc.width
+              << "x" << desc.height << ", " << desc.mipLevels << " levels, "
+              << cubemapBytes / 1024 << " KB -> "
+              << halfs.size() * sizeof(uint16_t) / 1024 << " KB, " << ms
+              << " ms" << std::endl;
+
+    return DdsFile::Write(outputFilename, desc,
+                          reinterpret_cast<const uint8_t *>(halfs.data()),
+                          halfs.size() * sizeof(uint16_t), octahedralVersion);
+}
+
+bool OctahedralEnvMap::Update(const std::string &cubemapFilename,
+                              const std::string &outputFilename,
+                              const OctahedralOptions &options)
+{
+    std::error_code errorCode;
+    const auto cubemapTime =
+        std::filesystem::last_write_time(cubemapFilename, errorCode);
+    if (errorCode)
+        return false;
+
+    const auto outputTime =
+        std::filesystem::last_write_time(outputFilename, errorCode);
+    DdsDesc desc;
+    if (!errorCode && outputTime >= cubemapTime &&
+        DdsFile::ReadDesc(outputFilename, desc) &&
+        desc.writerVersion == octahedralVersion)
+        return true;
+
+    return Generate(cubemapFilename, outputFilename, options);
+}
+
+void OctahedralEnvMap::Report(const std::string &cubemapFilename)
+{
+    std::vector<FloatCubemap> cubemapLevels;
+    if (!FloatCubemap::ReadMipChain(cubemapFilename, cubemapLevels))
+        return;
+    const FloatCubemap &reference = cubemapLevels[0];
+
+    auto Print = [](const char *name, int size, int faces,
+                    const std::vector<int> &sizes, double meanRelative,
+                    double rmse) {
+        size_t floatBytes, bc6hBytes;
+        GetMemory(sizes, floatBytes, bc6hBytes);
+        std::cout << "  " << name << " " << size << "x" << size << " x "
+                  << faces << ": " << floatBytes * faces / 1024 << " KB (bc6h "
+                  << bc6hBytes * faces / 1024 << " KB), mean relative error "
+                  << meanRelative << ", rmse " << rmse << std::endl;
+    };
+
+    std::cout << "OctahedralEnvMap::Report() " << cubemapFilename << ", "
+              << reference.size << "x" << reference.size << " x 6, "
+              << cubemapLevels.size() << " levels" << std::endl;
+
+    // 기준: 원본 큐브맵과 한 변이 절반인 큐브맵 (2x2 평균을 bilinear로 늘림)
+    // 프리필터한 큐브맵의 레벨 1은 거칠기가 다르므로 쓰지 않음
+    std::vector<int> cubemapSizes;
+    for (const FloatCubemap &level : cubemapLevels)
+        cubemapSizes.push_back(level.size);
+    Print("cubemap", reference.size, 6, cubemapSizes, 0.0, 0.0);
+    if (cubemapLevels.size() > 1)
+    {
+        double meanRelative, rmse;
+        const FloatCubemap half = reference.Downsample();
+        MeasureError(
+            reference,
+            [&](const float d[3], float rgb[3]) { half.Sample(d, rgb); },
+            meanRelative, rmse);
+        Print("cubemap", half.size, 6,
+              std::vector<int>(cubemapSizes.begin() + 1, cubemapSizes.end()),
+              meanRelative, rmse);
+    }
+
+    // 1.25면 텍셀 수가 한 변이 절반인 큐브맵과 거의 같음 (1.5625 s^2 : 1.5 s^2)
+    const float scales[] = {1.0f, 1.25f, 1.5f, 2.0f};
+    for (float scale : scales)
+    {
+        OctahedralOptions options;
+        options.scale = scale;
+        const std::vector<OctahedralLevel> levels =
+            Convert(cubemapLevels, options);
+        if (levels.empty())
+            continue;
+
+        double meanRelative, rmse;
+        MeasureError(
+            reference,
+            [&](const float d[3], float rgb[3]) {
+                Sample(levels[0], options.border, d, rgb);
+            },
+            meanRelative, rmse);
+
+        std::vector<int> sizes;
+        for (const OctahedralLevel &level : levels)
+            sizes.push_back(level.size);
+        Print("octahedral", levels[0].size, 1, sizes, meanRelative, rmse);
+    }
+}
+
+} // namespace FEFE
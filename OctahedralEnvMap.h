@@ -0,0 +1,61 @@
+﻿#pragma once
+
+#include <string>
+#include <vector>
+
+#include "FloatCubemap.h"
+
+namespace FEFE
+{
+
+struct OctahedralOptions
+{
+    // 결과 한 변 = 큐브맵 한 변 * scale (4의 배수로 반올림)
+    // 2면 텍셀 수가 6 s^2 -> 4 s^2 (Report()로 크기별 오차 확인)
+    float scale = 2.0f;
+    // mip 레벨마다 둘레에 두는 텍셀 수, 반대편 가장자리를 이어 붙여서 bilinear가 끊기지 않음
+    int border = 1;
+};
+
+// float RGBA 2D 이미지 한 레벨 (테두리 포함)
+struct OctahedralLevel
+{
+    int size = 0;
+    std::vector<float> pixels; // size * size * 4
+};
+
+// 큐브맵 -> 팔면체 (octahedral) 2D 환경맵 (Engelhardt & Dachsbacher 2008)
+// 면 6개 대신 텍스춰 한 장이라서 같은 품질에 메모리가 적고 Texture2DArray로 묶기 쉬움
+// 가운데가 +Z, 네 모서리가 -Z (VertexFormat의 노멀 압축과 같은 매핑)
+// 레벨 m은 큐브맵 레벨 m에서 만듦 (프리필터한 거칠기별 mip 체인을 그대로 유지)
+// 작은 레벨을 버려서 레벨 수가 줄면 거칠기 0 ~ 1을 남은 레벨에 다시 나눔
+// 쉐이더는 Common.hlsli의 SampleOctahedral()
+class OctahedralEnvMap
+{
+  public:
+    // 큐브맵 레벨마다 팔면체 맵 한 레벨, 안쪽이 2텍셀보다 작아지는 레벨부터는 버림
+    // 레벨과 줄 단위로 병렬
+    static std::vector<OctahedralLevel>
+    Convert(const std::vector<FloatCubemap> &cubemapLevels,
+            const OctahedralOptions &options);
+
+    // 방향 (정규화 안 해도 됨)의 bilinear 샘플, SampleOctahedral()의 한 레벨과 같은 계산
+    static void Sample(const OctahedralLevel &level, int border,
+                       const float direction[3], float rgb[3]);
+
+    // 큐브맵 DDS -> R16G16B16A16_FLOAT 2D DDS (mip 체인)
+    static bool Generate(const std::string &cubemapFilename,
+                         const std::string &outputFilename,
+                         const OctahedralOptions &options = OctahedralOptions());
+
+    // outputFilename이 없거나 큐브맵보다 오래됐으면 새로 만듦
+    static bool Update(const std::string &cubemapFilename,
+                       const std::string &outputFilename,
+                       const OctahedralOptions &options = OctahedralOptions());
+
+    // scale마다 레벨 0의 오차 (원본 큐브맵 텍셀 방향에서)와 메모리를 출력
+    // 같은 텍셀 수의 큐브맵 (한 변 절반)도 기준으로 함께 출력
+    static void Report(const std::string &cubemapFilename);
+};
+
+} // namespace FEFE
@@ -0,0 +1,52 @@
+#include "Common.hlsli"
+
+cbuffer BasicVertexConstantBuffer : register(b0)
+{
+    matrix model;
+    matrix invTranspose;
+    matrix view;
+    matrix projection;
+};
+
+// ȭ   ǥ ǵ   (VertexFormat.h)
+cbuffer PackedVertexConstantBuffer : register(b1)
+{
+    float3 positionScale;
+    float dummy1;
+    float3 positionOffset;
+    float dummy2;
+    float2 texcoordScale;
+    float2 texcoordOffset;
+};
+
+// VertexPacked, VertexCompact 
+// SNORM/UNORM  Է ܰ迡 float ٲ 
+struct PackedVertexShaderInput
+{
+    float3 posPacked : POSITION;
+    float2 normalPacked : NORMAL; // 8ü ڵ
+    float2 texcoordPacked : TEXCOORD0;
+};
+
+PixelShaderInput main(PackedVertexShaderInput input)
+{
+    PixelShaderInput output;
+    float3 posModel = input.posPacked * positionScale + positionOffset;
+    float4 pos = float4(posModel, 1.0f);
+    pos = mul(pos, model);
+    
+    output.posWorld = pos.xyz; //  ġ  
+
+    pos = mul(pos, view);
+    pos = mul(pos, projection);
+
+    output.posProj = pos;
+    output.texcoord = input.texcoordPacked * texcoordScale + texcoordOffset;
+    output.color = float3(0.0f, 0.0f, 0.0f); // ٸ ̴ 
+    
+    float4 normal = float4(OctahedralDecode(input.normalPacked), 0.0f);
+    output.normalWorld = mul(normal, invTranspose).xyz;
+    output.normalWorld = normalize(output.normalWorld);
+
+    return output;
+}
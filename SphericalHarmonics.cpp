@@ -0,0 +1,300 @@
+﻿#include "SphericalHarmonics.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "ThreadPool.h"
+
+// VertexKernels.cpp와 같은 기준 (x64는 항상 SSE2)
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FEFE_SH_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace FEFE
+{
+
+namespace
+{
+
+const float pi = 3.14159265358979f;
+
+// 기저 Y_lm = basisScale[k] * (1, y, z, x, xy, yz, 3z^2 - 1, xz, x^2 - y^2)[k]
+const float basisScale[9] = {0.282095f, 0.488603f, 0.488603f,
+                             0.488603f, 1.092548f, 1.092548f,
+                             0.315392f, 1.092548f, 0.546274f};
+const int basisBand[9] = {0, 1, 1, 1, 2, 2, 2, 2, 2};
+
+// 텍셀 하나 (또는 4개)의 상수를 뺀 기저 값
+template <typename T>
+inline void EvaluateBasis(T x, T y, T z, T three, T one, T basis[9])
+{
+    basis[0] = one;
+    basis[1] = y;
+    basis[2] = z;
+    basis[3] = x;
+    basis[4] = x * y;
+    basis[5] = y * z;
+    basis[6] = three * z * z - one;
+    basis[7] = x * z;
+    basis[8] = x * x - y * y;
+}
+
+// 한 행의 합 (기저 9개 x RGB, 마지막은 가중치 합)
+using RowSums = std::array<double, 28>;
+
+void AccumulateTexel(const float *texel, float u, float v,
+                     const float (&axes)[3][3], float (&sums)[28])
+{
+    const float invLength = 1.0f / std::sqrt(1.0f + u * u + v * v);
+    const float weight = invLength * invLength * invLength; // 입체각 (상수 제외)
+    float d[3];
+    for (int i = 0; i < 3; i++)
+        d[i] = (u * axes[i][0] + v * axes[i][1] + axes[i][2]) * invLength;
+
+    float basis[9];
+    EvaluateBasis(d[0], d[1], d[2], 3.0f, 1.0f, basis);
+    for (int k = 0; k < 9; k++)
+    {
+        for (int ch = 0; ch < 3; ch++)
+            sums[k * 3 + ch] += weight * basis[k] * texel[ch];
+    }
+    sums[27] += weight;
+}
+
+#ifdef FEFE_SH_SSE2
+
+struct Float4
+{
+    __m128 v;
+};
+inline Float4 operator+(Float4 a, Float4 b) { return {_mm_add_ps(a.v, b.v)}; }
+inline Float4 operator-(Float4 a, Float4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline Float4 operator*(Float4 a, Float4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+
+inline float HorizontalSum(__m128 v)
+{
+    const __m128 pairs = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+}
+
+#endif
+
+RowSums ProjectRow(const FloatCubemap &cubemap, int face, int y)
+{
+    const int size = cubemap.size;
+    const float *row = cubemap.GetFace(face) + size_t(y) * size * 4;
+    const float texelSize = 2.0f / float(size);
+    const float v = (float(y) + 0.5f) * texelSize - 1.0f;
+
+    float axes[3][3];
+    FloatCubemap::GetFaceAxes(face, axes);
+
+    float sums[28] = {};
+    int x = 0;
+
+#ifdef FEFE_SH_SSE2
+    // 텍셀 4개를 열 방향으로: u는 lane마다 다르고 v는 같음
+    __m128 acc[28];
+    for (auto &a : acc)
+        a = _mm_setzero_ps();
+
+    const Float4 one{_mm_set1_ps(1.0f)};
+    const Float4 three{_mm_set1_ps(3.0f)};
+    const __m128 vv = _mm_set1_ps(v);
+    for (; x + 4 <= size; x += 4)
+    {
+        const __m128 u = _mm_sub_ps(
+            _mm_mul_ps(_mm_add_ps(_mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f),
+                                  _mm_set1_ps(float(x))),
+                       _mm_set1_ps(texelSize)),
+            _mm_set1_ps(1.0f));
+
+        const __m128 invLength = _mm_div_ps(
+            one.v,
+            _mm_sqrt_ps(_mm_add_ps(
+                _mm_add_ps(one.v, _mm_mul_ps(u, u)), _mm_mul_ps(vv, vv))));
+        const __m128 weight =
+            _mm_mul_ps(_mm_mul_ps(invLength, invLength), invLength);
+
+        Float4 d[3];
+        for (int i = 0; i < 3; i++)
+        {
+            d[i].v = _mm_mul_ps(
+                _mm_add_ps(_mm_add_ps(_mm_mul_ps(u, _mm_set1_ps(axes[i][0])),
+                                      _mm_set1_ps(v * axes[i][1])),
+                           _mm_set1_ps(axes[i][2])),
+                invLength);
+        }
+
+        // RGBA 4개 -> R 4개, G 4개, B 4개
+        __m128 r = _mm_loadu_ps(row + x * 4);
+        __m128 g = _mm_loadu_ps(row + x * 4 + 4);
+        __m128 b = _mm_loadu_ps(row + x * 4 + 8);
+        __m128 a = _mm_loadu_ps(row + x * 4 + 12);
+        _MM_TRANSPOSE4_PS(r, g, b, a);
+        const __m128 colors[3] = {_mm_mul_ps(r, weight), _mm_mul_ps(g, weight),
+                                  _mm_mul_ps(b, weight)};
+
+        Float4 basis[9];
+        EvaluateBasis(d[0], d[1], d[2], three, one, basis);
+        for (int k = 0; k < 9; k++)
+        {
+            for (int ch = 0; ch < 3; ch++)
+            {
+                acc[k * 3 + ch] = _mm_add_ps(acc[k * 3 + ch],
+                                             _mm_mul_ps(basis[k].v, colors[ch]));
+            }
+        }
+        acc[27] = _mm_add_ps(acc[27], weight);
+    }
+    for (int i = 0; i < 28; i++)
+        sums[i] = HorizontalSum(acc[i]);
+#endif
+
+    for (; x < size; x++)
+    {
+        const float u = (float(x) + 0.5f) * texelSize - 1.0f;
+        AccumulateTexel(row + x * 4, u, v, axes, sums);
+    }
+
+    RowSums result;
+    for (int i = 0; i < 28; i++)
+        result[size_t(i)] = sums[i];
+    return result;
+}
+
+} // namespace
+
+SHCoefficients SphericalHarmonics::Project(const FloatCubemap &cubemap)
+{
+    // 행마다 따로 더하고 마지막에 double로 합침 (스레드 수와 관계없이 같은 결과)
+    const size_t numRows = size_t(cubemap.size) * 6;
+    std::vector<RowSums> rows(numRows);
+    ThreadPool::Get().ParallelFor(numRows, [&](size_t i) {
+        rows[i] = ProjectRow(cubemap, int(i / size_t(cubemap.size)),
+                             int(i % size_t(cubemap.size)));
+    });
+
+    RowSums total = {};
+    for (const RowSums &row : rows)
+    {
+        for (size_t i = 0; i < total.size(); i++)
+            total[i] += row[i];
+    }
+
+    // 가중치 합이 구 전체 (4pi)가 되도록
+    SHCoefficients radiance;
+    if (total[27] <= 0.0)
+        return radiance;
+    const double scale = 4.0 * pi / total[27];
+    for (int k = 0; k < 9; k++)
+    {
+        for (int ch = 0; ch < 3; ch++)
+            radiance.c[k][ch] = float(total[size_t(k * 3 + ch)] * scale * basisScale[k]);
+    }
+    return radiance;
+}
+
+bool SphericalHarmonics::ProjectCubemap(const std::string &filename,
+                                        SHCoefficients &radiance, int maxSize)
+{
+    FloatCubemap cubemap;
+    if (!cubemap.Read(filename, maxSize))
+        return false;
+    radiance = Project(cubemap);
+    return true;
+}
+
+SHCoefficients SphericalHarmonics::ToIrradiance(const SHCoefficients &radiance)
+{
+    // 코사인 로브의 대역별 계수 / pi
+    const float bandScale[3] = {1.0f, 2.0f / 3.0f, 0.25f};
+
+    SHCoefficients irradiance;
+    for (int k = 0; k < 9; k++)
+    {
+        for (int ch = 0; ch < 3; ch++)
+        {
+            irradiance.c[k][ch] =
+                radiance.c[k][ch] * bandScale[basisBand[k]] * basisScale[k];
+        }
+    }
+    return irradiance;
+}
+
+void SphericalHarmonics::EvaluateIrradiance(const SHCoefficients &irradiance,
+                                            const float normal[3], float rgb[3])
+{
+    float basis[9];
+    EvaluateBasis(normal[0], normal[1], normal[2], 3.0f, 1.0f, basis);
+    for (int ch = 0; ch < 3; ch++)
+    {
+        rgb[ch] = 0.0f;
+        for (int k = 0; k < 9; k++)
+            rgb[ch] += irradiance.c[k][ch] * basis[k];
+    }
+}
+
+void SphericalHarmonics::CompareWithCubemap(const SHCoefficients &irradiance,
+                                            const std::string &diffuseFilename)
+{
+    FloatCubemap cubemap;
+    if (!cubemap.Read(diffuseFilename, 32))
+        return;
+
+    auto Luminance = [](const float *rgb) {
+        return 0.2126f * rgb[0] + 0.7152f * rgb[1] + 0.0722f * rgb[2];
+    };
+
+    double sumError = 0.0;
+    double sumReference = 0.0;
+    float maxError = 0.0f;
+    for (int face = 0; face < 6; face++)
+    {
+        for (int y = 0; y < cubemap.size; y++)
+        {
+            for (int x = 0; x < cubemap.size; x++)
+            {
+                const float u = (x + 0.5f) * 2.0f / cubemap.size - 1.0f;
+                const float v = (y + 0.5f) * 2.0f / cubemap.size - 1.0f;
+                float d[3];
+                FloatCubemap::GetDirection(face, u, v, d);
+                const float length =
+                    std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+                for (float &c : d)
+                    c /= length;
+
+                float rgb[3];
+                EvaluateIrradiance(irradiance, d, rgb);
+                const float reference = Luminance(
+                    cubemap.GetFace(face) + (size_t(y) * cubemap.size + x) * 4);
+                const float error = std::fabs(Luminance(rgb) - reference);
+                sumError += error;
+                sumReference += reference;
+                maxError = std::max(maxError,
+                                    error / std::max(reference, 1e-4f));
+            }
+        }
+    }
+
+    std::cout << "SphericalHarmonics vs " << diffuseFilename
+              << ": mean relative error "
+              << (sumReference > 0.0 ? sumError / sumReference : 0.0)
+              << ", max " << maxError << std::endl;
+}
+
+const char *SphericalHarmonics::GetInstructionSet()
+{
+#ifdef FEFE_SH_SSE2
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace FEFE
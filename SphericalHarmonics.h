@@ -0,0 +1,53 @@
+﻿#pragma once
+
+#include <string>
+
+#include "FloatCubemap.h"
+
+namespace FEFE
+{
+
+// 구면 조화 (real SH) 대역 0~2의 계수 9개 (RGB)
+// 순서: Y00, Y1-1, Y10, Y11, Y2-2, Y2-1, Y20, Y21, Y22
+struct SHCoefficients
+{
+    float c[9][3] = {};
+};
+
+// 환경 큐브맵의 diffuse 조명을 SH 9개로 근사 (Ramamoorthi & Hanrahan 2001)
+// diffuse 큐브맵 대신 상수 버퍼의 계수로 쉐이딩 (텍스춰 읽기와 큐브맵 하나가 없어짐)
+//
+// SHCoefficients radiance;
+// SphericalHarmonics::ProjectCubemap("..._specularIBL.dds", radiance);
+// const SHCoefficients irradiance = SphericalHarmonics::ToIrradiance(radiance);
+// ... irradiance.c를 BasicPixelConstantBuffer::irradianceSh로 ...
+class SphericalHarmonics
+{
+  public:
+    // 방사 휘도 투영: L_lm = ∫ L(w) Y_lm(w) dw (텍셀의 입체각으로 가중치)
+    // 면의 행마다 병렬, 한 행 안에서는 텍셀 4개씩 SIMD
+    static SHCoefficients Project(const FloatCubemap &cubemap);
+
+    // 큐브맵 DDS에서 한 변이 maxSize 이하인 레벨을 읽어서 투영
+    // 대역 2까지는 저주파라서 작은 레벨로도 충분
+    static bool ProjectCubemap(const std::string &filename,
+                               SHCoefficients &radiance, int maxSize = 128);
+
+    // 쉐이더에서 바로 쓰는 계수로 변환
+    // 코사인 로브 컨볼루션 (A0 = pi, A1 = 2pi/3, A2 = pi/4), 1/pi, 기저의 상수를 곱함
+    // 결과는 diffuse 큐브맵과 같은 E(n) / pi
+    //   c0 + c1 y + c2 z + c3 x + c4 xy + c5 yz + c6 (3z^2 - 1) + c7 xz + c8 (x^2 - y^2)
+    static SHCoefficients ToIrradiance(const SHCoefficients &radiance);
+
+    // ToIrradiance() 결과를 normal (정규화된 방향)에서 계산 (쉐이더와 같은 식)
+    static void EvaluateIrradiance(const SHCoefficients &irradiance,
+                                   const float normal[3], float rgb[3]);
+
+    // diffuse 큐브맵과 비교해서 휘도의 평균/최대 상대 오차 출력
+    static void CompareWithCubemap(const SHCoefficients &irradiance,
+                                   const std::string &diffuseFilename);
+
+    static const char *GetInstructionSet();
+};
+
+} // namespace FEFE
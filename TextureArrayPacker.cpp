@@ -0,0 +1,417 @@
+﻿#include "TextureArrayPacker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <tuple>
+#include <utility>
+
+#include "ThreadPool.h"
+
+namespace FEFE
+{
+
+namespace
+{
+
+bool IsPowerOfTwo(int x)
+{
+    return x > 0 && (x & (x - 1)) == 0;
+}
+
+int AlignUp4(int x)
+{
+    return (x + 3) & ~3;
+}
+
+// 풀어서 다시 압축할 수 있는 형식 (BlockCompressor가 지원하는 것)
+bool GetAtlasFormat(uint32_t format, bool &compressed, BlockFormat &blockFormat)
+{
+    compressed = true;
+    switch (format)
+    {
+    case DxgiFormat::R8G8B8A8_Unorm:
+        compressed = false;
+        return true;
+    case DxgiFormat::BC1_Unorm:
+        blockFormat = BlockFormat::BC1;
+        return true;
+    case DxgiFormat::BC3_Unorm:
+        blockFormat = BlockFormat::BC3;
+        return true;
+    case DxgiFormat::BC5_Unorm:
+        blockFormat = BlockFormat::BC5;
+        return true;
+    case DxgiFormat::BC7_Unorm:
+        blockFormat = BlockFormat::BC7;
+        return true;
+    default:
+        return false;
+    }
+}
+
+// 아틀라스 안의 칸 하나 (둘레 포함, 4의 배수라서 블록 경계에 맞음)
+struct AtlasItem
+{
+    size_t image = 0;
+    int width = 0;
+    int height = 0;
+    int x = 0;
+    int y = 0;
+    int page = 0;
+};
+
+// 높이 순으로 정렬된 칸을 선반(shelf)에 왼쪽부터 채움
+// 쓴 페이지 수를 돌려줌 (한 페이지보다 큰 칸이 있으면 0)
+int ShelfPack(std::vector<AtlasItem> &items, int size)
+{
+    int page = 0;
+    int x = 0;
+    int y = 0;
+    int shelfHeight = 0;
+    for (AtlasItem &item : items)
+    {
+        if (item.width > size || item.height > size)
+            return 0;
+
+        if (x + item.width > size)
+        {
+            x = 0;
+            y += shelfHeight;
+            shelfHeight = 0;
+        }
+        if (y + item.height > size)
+        {
+            page++;
+            x = 0;
+            y = 0;
+            shelfHeight = 0;
+        }
+
+        item.x = x;
+        item.y = y;
+        item.page = page;
+        x += item.width;
+        shelfHeight = std::max(shelfHeight, item.height);
+    }
+    return page + 1;
+}
+
+// 아틀라스 한 장에 둘레까지 들어가는 최대 입력 크기
+int GetMaxAtlasInput(const TextureArrayOptions &options)
+{
+    const int padding = std::max(options.atlasPadding, 1);
+    return std::min(options.maxAtlasInput, options.maxAtlasSize - 2 * padding);
+}
+
+} // namespace
+
+TextureArrayPacker::TextureArrayPacker(const TextureArrayOptions &options)
+    : m_options(options)
+{
+}
+
+TextureArrayPacker::ArrayKey
+TextureArrayPacker::MakeArrayKey(const ImageData &image)
+{
+    return ArrayKey(image.format, image.width, image.height,
+                    std::max<size_t>(image.mipLevels.size(), 1));
+}
+
+size_t TextureArrayPacker::GetArray(const ImageData &image)
+{
+    const ArrayKey key = MakeArrayKey(image);
+    const auto found = m_arrayIndices.find(key);
+    if (found != m_arrayIndices.end())
+        return found->second;
+
+    TextureArrayData array;
+    array.format = image.format;
+    array.width = image.width;
+    array.height = image.height;
+    array.mipLevels = image.mipLevels;
+    if (array.mipLevels.empty())
+        array.mipLevels.push_back({image.width, image.height, 0});
+    array.sliceSize = image.pixels.size();
+
+    m_arrayIndices[key] = m_arrays.size();
+    m_arrays.push_back(std::move(array));
+    return m_arrays.size() - 1;
+}
+
+bool TextureArrayPacker::AppendSlice(size_t arrayIndex, ImageData &image,
+                                     TextureSlot &slot)
+{
+    TextureArrayData &array = m_arrays[arrayIndex];
+    if (image.pixels.size() != array.sliceSize)
+        return false;
+
+    slot.arrayIndex = int(arrayIndex);
+    slot.slice = int(array.slices.size());
+    array.slices.push_back(std::move(image.pixels));
+    image.pixels.clear();
+    return true;
+}
+
+size_t TextureArrayPacker::Add(ImageData &image, TextureUsage usage)
+{
+    const size_t index = m_slots.size();
+    m_slots.emplace_back();
+    if (image.pixels.empty())
+        return index;
+
+    // 아틀라스에 들어갈 수 있는 작은 텍스춰는 짝이 있는지 알 때까지 남겨둠
+    const int maxInput = GetMaxAtlasInput(m_options);
+    bool compressed;
+    BlockFormat blockFormat;
+    if (image.width <= maxInput && image.height <= maxInput &&
+        GetAtlasFormat(image.format, compressed, blockFormat))
+    {
+        std::vector<uint8_t> pixels = std::move(image.pixels);
+        image.pixels.clear();
+        m_pendingImages.push_back(image);
+        m_pendingImages.back().pixels = std::move(pixels);
+        m_pendingUsages.push_back(usage);
+        m_pendingSlots.push_back(index);
+        return index;
+    }
+
+    // 나머지는 바로 배열의 slice로 (mip까지 그대로)
+    // 넣지 못하면 Finish()에서 돌려주도록 픽셀을 받아둠
+    if (!AppendSlice(GetArray(image), image, m_slots[index]))
+    {
+        m_rejected.emplace_back(index, image);
+        m_rejected.back().second.pixels = std::move(image.pixels);
+        image.pixels.clear();
+    }
+    return index;
+}
+
+void TextureArrayPacker::Finish(std::vector<TextureArrayData> &arrays,
+                                std::vector<TextureSlot> &slots,
+                                std::vector<ImageData> &unplaced)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    const TextureArrayOptions &options = m_options;
+    std::vector<ImageData> &images = m_pendingImages;
+    const std::vector<TextureUsage> &usages = m_pendingUsages;
+
+    // 1. 남겨둔 작은 텍스춰 중 형식, 크기, mip 개수가 같은 것끼리
+    std::map<ArrayKey, std::vector<size_t>> groups;
+    for (size_t i = 0; i < images.size(); i++)
+        groups[MakeArrayKey(images[i])].push_back(i);
+
+    // 2. 짝이 없거나 크기가 2의 거듭제곱이 아닌 것은 아틀라스로
+    //    (형식과 sRGB 여부가 같은 것끼리, mip을 다시 만들어야 하므로)
+    const int padding = std::max(options.atlasPadding, 1);
+
+    std::map<std::pair<uint32_t, bool>, std::vector<size_t>> atlasGroups;
+    for (auto it = groups.begin(); it != groups.end();)
+    {
+        const ImageData &first = images[it->second[0]];
+        const bool odd = it->second.size() == 1 || !IsPowerOfTwo(first.width) ||
+                         !IsPowerOfTwo(first.height);
+        if (odd)
+        {
+            for (size_t i : it->second)
+            {
+                atlasGroups[{first.format, usages[i] == TextureUsage::Color}]
+                    .push_back(i);
+            }
+            it = groups.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // 아틀라스에 하나만 들어가면 합칠 이유가 없으므로 배열 한 장으로
+    for (auto it = atlasGroups.begin(); it != atlasGroups.end();)
+    {
+        if (it->second.size() == 1)
+        {
+            groups[MakeArrayKey(images[it->second[0]])].push_back(it->second[0]);
+            it = atlasGroups.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // 3. 배열: mip까지 그대로
+    for (const auto &group : groups)
+    {
+        const size_t arrayIndex = GetArray(images[group.second[0]]);
+        for (size_t i : group.second)
+            AppendSlice(arrayIndex, images[i], m_slots[m_pendingSlots[i]]);
+    }
+
+    // 4. 아틀라스: 레벨 0을 풀어서 둘레를 반복해 채우고 mip, 압축을 다시 함
+    size_t numAtlased = 0;
+    size_t numAtlasPages = 0;
+    for (const auto &group : atlasGroups)
+    {
+        const uint32_t format = group.first.first;
+        const bool srgb = group.first.second;
+        bool compressed;
+        BlockFormat blockFormat = BlockFormat::BC7;
+        GetAtlasFormat(format, compressed, blockFormat);
+
+        std::vector<AtlasItem> items;
+        for (size_t i : group.second)
+        {
+            AtlasItem item;
+            item.image = i;
+            item.width = AlignUp4(images[i].width + 2 * padding);
+            item.height = AlignUp4(images[i].height + 2 * padding);
+            items.push_back(item);
+        }
+        std::stable_sort(items.begin(), items.end(),
+                         [](const AtlasItem &a, const AtlasItem &b) {
+                             return a.height > b.height;
+                         });
+
+        // 한 장에 다 들어가는 가장 작은 크기, 안 되면 가장 큰 크기로 여러 장
+        int size = 64;
+        int numPages = ShelfPack(items, size);
+        while (numPages != 1 && size < options.maxAtlasSize)
+        {
+            size = std::min(size * 2, options.maxAtlasSize);
+            numPages = ShelfPack(items, size);
+        }
+        if (numPages == 0)
+            continue; // 픽셀은 그대로 남아 있으므로 아래에서 돌려줌
+
+        // 둘레가 1픽셀 이상 남는 레벨까지
+        size_t numLevels = 1;
+        while ((padding >> numLevels) > 0 && (size >> numLevels) > 0)
+            numLevels++;
+
+        std::vector<ImageData> pages(static_cast<size_t>(numPages));
+        for (ImageData &page : pages)
+        {
+            page.width = size;
+            page.height = size;
+            page.pixels.assign(size_t(size) * size * 4, 0);
+        }
+
+        // 칸마다 겹치지 않으므로 병렬로 배치
+        ThreadPool::Get().ParallelFor(items.size(), [&](size_t k) {
+            const AtlasItem &item = items[k];
+            const ImageData &image = images[item.image];
+            const int w = image.width;
+            const int h = image.height;
+
+            std::vector<uint8_t> rgba;
+            if (compressed)
+            {
+                rgba.resize(size_t(w) * h * 4);
+                BlockCompressor::Decompress(image.pixels.data(), w, h,
+                                            blockFormat, rgba.data());
+            }
+            const uint8_t *src = compressed ? rgba.data() : image.pixels.data();
+
+            uint8_t *dst = pages[size_t(item.page)].pixels.data();
+            for (int y = -padding; y < h + padding; y++)
+            {
+                const int sy = (y % h + h) % h;
+                uint8_t *row = dst + (size_t(item.y + padding + y) * size +
+                                      size_t(item.x + padding)) * 4;
+                for (int x = -padding; x < w + padding; x++)
+                {
+                    const int sx = (x % w + w) % w;
+                    std::memcpy(row + x * 4, src + (size_t(sy) * w + sx) * 4, 4);
+                }
+            }
+        });
+
+        ThreadPool::Get().ParallelFor(pages.size(), [&](size_t p) {
+            MipOptions mipOptions;
+            mipOptions.srgb = srgb;
+            mipOptions.edge = MipEdge::Clamp;
+            TextureLoader::GenerateMips(pages[p], mipOptions);
+            if (pages[p].mipLevels.size() > numLevels)
+            {
+                pages[p].pixels.resize(pages[p].mipLevels[numLevels].offset);
+                pages[p].mipLevels.resize(numLevels);
+            }
+            if (compressed)
+                TextureLoader::Compress(pages[p], blockFormat, options.bc7Quality);
+        });
+
+        // 아틀라스는 Add()의 배열과 키가 같아도 합치지 않음 (uv 영역이 다름)
+        TextureArrayData array;
+        array.format = pages[0].format;
+        array.width = size;
+        array.height = size;
+        array.mipLevels = pages[0].mipLevels;
+        array.sliceSize = pages[0].pixels.size();
+        array.isAtlas = true;
+        for (ImageData &page : pages)
+            array.slices.push_back(std::move(page.pixels));
+
+        for (const AtlasItem &item : items)
+        {
+            TextureSlot &slot = m_slots[m_pendingSlots[item.image]];
+            slot.arrayIndex = int(m_arrays.size());
+            slot.slice = item.page;
+            slot.scale[0] = float(images[item.image].width) / float(size);
+            slot.scale[1] = float(images[item.image].height) / float(size);
+            slot.offset[0] = float(item.x + padding) / float(size);
+            slot.offset[1] = float(item.y + padding) / float(size);
+        }
+        m_arrays.push_back(std::move(array));
+
+        numAtlased += items.size();
+        numAtlasPages += size_t(numPages);
+    }
+
+    // 5. 묶지 못한 이미지는 픽셀까지 돌려줌 (옮기는 것은 배치에 성공했을 때만)
+    unplaced.clear();
+    unplaced.resize(m_slots.size());
+    for (size_t i = 0; i < images.size(); i++)
+    {
+        if (m_slots[m_pendingSlots[i]].arrayIndex < 0)
+            unplaced[m_pendingSlots[i]] = std::move(images[i]);
+    }
+    for (auto &rejected : m_rejected)
+        unplaced[rejected.first] = std::move(rejected.second);
+
+    size_t numTextures = 0;
+    size_t numUnplaced = 0;
+    for (size_t i = 0; i < m_slots.size(); i++)
+    {
+        numTextures += m_slots[i].arrayIndex >= 0 ? 1 : 0;
+        numUnplaced += unplaced[i].pixels.empty() ? 0 : 1;
+    }
+    size_t bytes = 0;
+    for (const TextureArrayData &array : m_arrays)
+        bytes += array.sliceSize * array.slices.size();
+
+    std::cout << "TextureArrayPacker: " << numTextures << " textures -> "
+              << m_arrays.size() << " arrays (" << numAtlased << " in "
+              << numAtlasPages << " atlas pages), " << numUnplaced
+              << " unplaced, " << bytes / 1024 << " KB, "
+              << std::chrono::duration<double, std::milli>(
+                     std::chrono::steady_clock::now() - start)
+                     .count()
+              << " ms" << std::endl;
+
+    arrays = std::move(m_arrays);
+    slots = std::move(m_slots);
+
+    m_arrays.clear();
+    m_slots.clear();
+    m_arrayIndices.clear();
+    m_pendingImages.clear();
+    m_pendingUsages.clear();
+    m_pendingSlots.clear();
+    m_rejected.clear();
+}
+
+} // namespace FEFE
@@ -0,0 +1,113 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "TextureLoader.h"
+
+namespace FEFE
+{
+
+// 텍스춰 하나가 들어간 위치
+struct TextureSlot
+{
+    int arrayIndex = -1; // TextureArrayPacker::Finish() 결과 배열 번호, -1이면 묶지 않음
+    int slice = 0;
+
+    // 아틀라스 안의 영역: uv' = frac(uv) * scale + offset
+    // 배열 한 장을 통째로 쓰면 scale = 1, offset = 0
+    float scale[2] = {1.0f, 1.0f};
+    float offset[2] = {0.0f, 0.0f};
+};
+
+// Texture2DArray 하나 (모든 slice의 크기, 형식, mip 개수가 같음)
+struct TextureArrayData
+{
+    uint32_t format = DxgiFormat::R8G8B8A8_Unorm;
+    int width = 0;
+    int height = 0;
+    std::vector<MipLevel> mipLevels; // slice 안에서 레벨 위치 (바이트)
+    size_t sliceSize = 0;
+    // slice마다 따로 둬서 이미지 픽셀을 복사 없이 옮겨 받음 (크기는 모두 sliceSize)
+    std::vector<std::vector<uint8_t>> slices;
+    bool isAtlas = false;
+};
+
+struct TextureArrayOptions
+{
+    // 이 크기 이하이면서 같은 형식/크기의 짝이 없거나 2의 거듭제곱이 아닌 텍스춰는
+    // 아틀라스 한 장에 모음
+    int maxAtlasInput = 512;
+    int maxAtlasSize = 2048;
+
+    // 아틀라스 안의 텍스춰 둘레에 반복해서 채우는 폭 (픽셀)
+    // bilinear/mip이 이웃 텍스춰를 섞지 않도록 이 폭이 1픽셀 이상 남는 레벨까지만 mip을 만듦
+    int atlasPadding = 8;
+
+    BC7Quality bc7Quality = BC7Quality::Normal;
+};
+
+// 재질 텍스춰를 Texture2DArray로 묶는 클래스 (CPU)
+// 1. 형식, 크기, mip 개수가 같은 텍스춰는 한 배열의 slice로
+// 2. 작고 크기가 제각각인 텍스춰는 둘레를 채운 아틀라스로 합치고 uv 영역을 기록
+//    (레벨 0을 풀어서 배치한 뒤 mip 생성과 압축을 다시 함)
+// 같은 배열을 쓰는 메쉬들은 SRV를 다시 바인딩하지 않고 slice 번호만 바꿔서 그림
+//
+// TextureArrayPacker packer(options);
+// while (loader.Pop(image))
+//     packer.Add(image, TextureLoader::GuessUsage(image.filename));
+// packer.Finish(arrays, slots, unplaced);
+//
+// 아틀라스에 들어갈 수 없는 큰 텍스춰는 Add()에서 바로 배열의 slice로 옮기므로
+// CPU 메모리에는 새 텍스춰가 한 벌만 있음 (이미지를 모아둔 뒤 배열로 복사 X)
+// 아틀라스 후보(maxAtlasInput 이하)만 Finish()까지 이미지로 남겨둠
+class TextureArrayPacker
+{
+  public:
+    explicit TextureArrayPacker(
+        const TextureArrayOptions &options = TextureArrayOptions());
+
+    // image: TextureLoader::Load() 결과, usage: 아틀라스의 mip을 sRGB로 만들지
+    // 돌려주는 번호가 Finish()의 slots 안의 위치 (넣은 순서대로 0, 1, ...)
+    // 픽셀만 packer로 옮겨가고 (image.pixels는 비워짐) filename 등은 그대로
+    size_t Add(ImageData &image, TextureUsage usage);
+
+    // 남겨둔 작은 텍스춰를 아틀라스나 배열로 묶고 결과를 넘겨줌
+    // 읽지 못했거나 묶지 못한 이미지는 arrayIndex = -1
+    // 묶지 못한 이미지는 unplaced의 같은 위치로 픽셀까지 돌려줌 (따로 텍스춰로 만들 수 있게)
+    // 나머지 unplaced 원소는 비어 있음 (unplaced.size() == slots.size())
+    // 넘겨준 뒤에는 처음 상태로 돌아감
+    void Finish(std::vector<TextureArrayData> &arrays,
+                std::vector<TextureSlot> &slots,
+                std::vector<ImageData> &unplaced);
+
+  private:
+    // 형식, 너비, 높이, mip 개수가 같으면 한 배열
+    using ArrayKey = std::tuple<uint32_t, int, int, size_t>;
+
+    static ArrayKey MakeArrayKey(const ImageData &image);
+
+    // image와 형식, 크기, mip 개수가 같은 배열의 번호 (없으면 새로 만듦)
+    size_t GetArray(const ImageData &image);
+
+    // arrayIndex 배열에 image를 slice로 옮김 (slice 크기가 다르면 그대로 두고 false)
+    bool AppendSlice(size_t arrayIndex, ImageData &image, TextureSlot &slot);
+
+    TextureArrayOptions m_options;
+    std::vector<TextureArrayData> m_arrays;
+    std::vector<TextureSlot> m_slots;
+    std::map<ArrayKey, size_t> m_arrayIndices; // Add()에서 바로 붙이는 배열
+
+    // Finish()까지 남겨둔 아틀라스 후보
+    std::vector<ImageData> m_pendingImages;
+    std::vector<TextureUsage> m_pendingUsages;
+    std::vector<size_t> m_pendingSlots;
+
+    // Add()에서 배열에 넣지 못한 이미지 (slot 번호, 이미지)
+    std::vector<std::pair<size_t, ImageData>> m_rejected;
+};
+
+} // namespace FEFE
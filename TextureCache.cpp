@@ -0,0 +1,181 @@
+﻿#include "TextureCache.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+#include "Hash.h"
+#include "MappedFile.h"
+
+namespace FEFE
+{
+
+namespace
+{
+
+// "./a/../b.png"와 "b.png"처럼 같은 파일을 가리키는 경로를 하나로
+std::string CanonicalPath(const std::string &filename)
+{
+    std::error_code error;
+    std::filesystem::path path =
+        std::filesystem::weakly_canonical(filename, error);
+    if (error)
+        path = filename;
+
+    std::string result = path.lexically_normal().generic_string();
+#ifdef _WIN32
+    // Windows 경로는 대소문자 구분 X
+    std::transform(result.begin(), result.end(), result.begin(),
+                   [](unsigned char c) { return char(std::tolower(c)); });
+#endif
+    return result;
+}
+
+// 해시가 같은 두 파일이 정말 같은지 (크기, 바이트)
+bool SameContents(const CachedTexture &entry, const MappedFile &file)
+{
+    if (entry.sourceSize != file.GetSize())
+        return false;
+
+    MappedFile source;
+    if (!source.Open(entry.sourceFilename) ||
+        source.GetSize() != file.GetSize())
+        return false;
+    return std::memcmp(source.GetData(), file.GetData(), file.GetSize()) == 0;
+}
+
+} // namespace
+
+std::shared_ptr<CachedTexture> TextureCache::Acquire(const std::string &filename,
+                                                     bool &isNew)
+{
+    isNew = false;
+    m_stats.requests++;
+
+    auto Hit = [&](const std::shared_ptr<CachedTexture> &entry) {
+        if (entry->resourceView)
+            m_stats.bytesSaved += entry->bytes;
+        else
+            m_pendingHits[entry->contentHash]++;
+        return entry;
+    };
+
+    // 1. 경로
+    const std::string path = CanonicalPath(filename);
+    auto pathIt = m_pathToHash.find(path);
+    if (pathIt != m_pathToHash.end())
+    {
+        auto entryIt = m_entries.find(pathIt->second);
+        if (entryIt != m_entries.end())
+        {
+            if (auto entry = entryIt->second.lock())
+            {
+                m_stats.pathHits++;
+                return Hit(entry);
+            }
+        }
+    }
+
+    // 2. 파일 내용
+    MappedFile file;
+    if (!file.Open(filename))
+    {
+        std::cout << "TextureCache::Acquire() failed to open " << filename
+                  << std::endl;
+        m_stats.failures++;
+        return nullptr;
+    }
+    const uint64_t hash = HashBytes(file.GetData(), file.GetSize());
+
+    auto entryIt = m_entries.find(hash);
+    if (entryIt != m_entries.end())
+    {
+        if (auto entry = entryIt->second.lock())
+        {
+            if (SameContents(*entry, file))
+            {
+                m_pathToHash[path] = hash;
+                m_stats.contentHits++;
+                return Hit(entry);
+            }
+
+            // 해시만 같은 다른 파일: 공유하지 않고 따로 읽음 (경로도 기록 X)
+            std::cout << "TextureCache: hash collision between " << filename
+                      << " and " << entry->sourceFilename << std::endl;
+            auto unshared = std::make_shared<CachedTexture>();
+            unshared->sourceFilename = filename;
+            unshared->sourceSize = file.GetSize();
+            m_stats.misses++;
+            isNew = true;
+            return unshared;
+        }
+    }
+    m_pathToHash[path] = hash;
+
+    // 3. 새 텍스춰
+    auto entry = std::make_shared<CachedTexture>();
+    entry->contentHash = hash;
+    entry->sourceFilename = filename;
+    entry->sourceSize = file.GetSize();
+    m_entries[hash] = entry;
+    m_pendingHits.erase(hash);
+    m_stats.misses++;
+    isNew = true;
+    return entry;
+}
+
+void TextureCache::SetTexture(CachedTexture &entry,
+                              ComPtr<ID3D11Texture2D> texture,
+                              ComPtr<ID3D11ShaderResourceView> resourceView,
+                              size_t bytes)
+{
+    entry.texture = texture;
+    entry.resourceView = resourceView;
+    entry.bytes = bytes;
+    m_stats.bytesLoaded += bytes;
+
+    auto it = m_pendingHits.find(entry.contentHash);
+    if (it != m_pendingHits.end())
+    {
+        m_stats.bytesSaved += bytes * it->second;
+        m_pendingHits.erase(it);
+    }
+}
+
+void TextureCache::PrintStats() const
+{
+    std::cout << "TextureCache: " << m_stats.requests << " requests, "
+              << m_stats.misses << " loaded, " << m_stats.pathHits
+              << " path hits, " << m_stats.contentHits << " content hits, "
+              << m_stats.failures << " failed, hit rate "
+              << m_stats.GetHitRate() * 100.0 << "%, "
+              << m_stats.bytesLoaded / 1024 << " KB loaded, "
+              << m_stats.bytesSaved / 1024 << " KB saved" << std::endl;
+}
+
+void TextureCache::Purge()
+{
+    for (auto it = m_entries.begin(); it != m_entries.end();)
+    {
+        if (it->second.expired())
+        {
+            m_pendingHits.erase(it->first);
+            it = m_entries.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    for (auto it = m_pathToHash.begin(); it != m_pathToHash.end();)
+    {
+        if (m_entries.count(it->second) == 0)
+            it = m_pathToHash.erase(it);
+        else
+            ++it;
+    }
+}
+
+} // namespace FEFE
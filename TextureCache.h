@@ -0,0 +1,91 @@
+﻿#pragma once
+
+#include <d3d11.h>
+#include <wrl.h> // ComPtr
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "TextureArrayPacker.h" // TextureSlot
+
+namespace FEFE
+{
+
+using Microsoft::WRL::ComPtr;
+
+// 같은 이미지를 쓰는 메쉬들이 공유하는 텍스춰
+// 마지막 shared_ptr이 사라지면 GPU 메모리도 해제됨
+struct CachedTexture
+{
+    ComPtr<ID3D11Texture2D> texture;
+    ComPtr<ID3D11ShaderResourceView> resourceView; // 올리기 전에는 nullptr
+    size_t bytes = 0;          // 모든 mip 레벨의 크기
+    uint64_t contentHash = 0;  // 파일 내용의 해시 (해시가 겹쳐서 공유하지 않으면 0)
+
+    // 해시가 같을 때 내용까지 같은지 확인하는 데 쓰는 처음 읽은 파일
+    std::string sourceFilename;
+    size_t sourceSize = 0;
+
+    // Texture2DArray로 묶었으면 그 안의 위치 (texture/resourceView는 비어있음)
+    TextureSlot slot;
+};
+
+struct TextureCacheStats
+{
+    size_t requests = 0;
+    size_t pathHits = 0;    // 같은 경로
+    size_t contentHits = 0; // 경로는 다르지만 파일 내용이 같음
+    size_t misses = 0;      // 새로 읽어야 하는 텍스춰
+    size_t failures = 0;    // 파일을 열 수 없음
+    size_t bytesLoaded = 0; // 새로 올린 텍스춰 크기
+    size_t bytesSaved = 0;  // 공유해서 올리지 않은 크기
+
+    double GetHitRate() const
+    {
+        return requests ? double(pathHits + contentHits) / requests : 0.0;
+    }
+};
+
+// 텍스춰 파일 -> 공유 텍스춰
+// 1. 정규화한 경로로 찾고 2. 처음 보는 경로면 파일 내용의 해시로 찾음
+//    (복사해둔 같은 이미지가 다른 폴더에 있어도 한 번만 올림)
+//    해시가 같으면 크기와 바이트까지 비교하고, 다르면 공유하지 않고 따로 읽음
+//
+// 캐시는 weak_ptr만 가지고 있어서 참조 수는 받아간 쪽(Mesh)이 관리함
+//
+// bool isNew;
+// auto texture = cache.Acquire(filename, isNew);
+// if (isNew)
+//     ... 디코딩, CreateTexture() 후 cache.SetTexture(*texture, ...) ...
+class TextureCache
+{
+  public:
+    // 캐시에 없으면 빈 CachedTexture를 만들고 isNew = true
+    // 파일을 읽을 수 없으면 nullptr
+    std::shared_ptr<CachedTexture> Acquire(const std::string &filename,
+                                           bool &isNew);
+
+    // isNew로 받은 항목에 올린 텍스춰를 채움 (이미 공유하는 곳에도 보임)
+    void SetTexture(CachedTexture &entry, ComPtr<ID3D11Texture2D> texture,
+                    ComPtr<ID3D11ShaderResourceView> resourceView,
+                    size_t bytes);
+
+    const TextureCacheStats &GetStats() const { return m_stats; }
+    void PrintStats() const;
+
+    // 아무도 쓰지 않는 항목 정리
+    void Purge();
+
+  private:
+    std::unordered_map<std::string, uint64_t> m_pathToHash;
+    std::unordered_map<uint64_t, std::weak_ptr<CachedTexture>> m_entries;
+
+    // 올리기 전에 공유한 횟수 (크기를 알게 되면 bytesSaved에 반영)
+    std::unordered_map<uint64_t, size_t> m_pendingHits;
+
+    TextureCacheStats m_stats;
+};
+
+} // namespace FEFE
@@ -0,0 +1,465 @@
+﻿#include "TextureLoader.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+#include "MappedFile.h"
+#include "ThreadPool.h"
+
+// VertexKernels.cpp와 같은 기준 (x64는 항상 SSE2)
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FEFE_TEXTURE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace FEFE
+{
+
+namespace
+{
+
+// 캐시 파일 형식이나 압축 방법이 바뀌면 올려서 예전 캐시를 무시
+const uint32_t textureCacheVersion = 1;
+
+// 캐시를 만든 설정 (설정이 다르면 다시 압축)
+uint32_t MakeCacheVersion(const TextureLoadOptions &options)
+{
+    return textureCacheVersion << 16 | uint32_t(options.bc7Quality) << 8 |
+           uint32_t(options.preferBC7) << 7 |
+           uint32_t(options.generateMips) << 6 |
+           uint32_t(options.mipOptions.filter) << 2 |
+           uint32_t(options.mipOptions.edge);
+}
+
+bool HasAlpha(const ImageData &image)
+{
+    for (size_t i = 3; i < size_t(image.width) * image.height * 4; i += 4)
+    {
+        if (image.pixels[i] != 255)
+            return true;
+    }
+    return false;
+}
+
+// 2D DDS 파일 하나를 그대로 읽음 (mip 레벨 위치만 계산)
+// writerVersion이 0이 아니면 같은 값으로 쓴 파일만 읽음
+bool ReadDds(const std::string &filename, uint32_t writerVersion,
+             ImageData &image)
+{
+    DdsDesc desc;
+    if (!DdsFile::Read(filename, desc, image.pixels) ||
+        (writerVersion != 0 && desc.writerVersion != writerVersion) ||
+        desc.cubemap || desc.arraySize != 1)
+    {
+        image.pixels.clear();
+        return false;
+    }
+
+    image.width = int(desc.width);
+    image.height = int(desc.height);
+    image.format = desc.format;
+    image.mipLevels.clear();
+    size_t offset = 0;
+    for (uint32_t level = 0; level < desc.mipLevels; level++)
+    {
+        const int width = std::max(image.width >> level, 1);
+        const int height = std::max(image.height >> level, 1);
+        image.mipLevels.push_back({width, height, offset});
+        offset += DdsFile::GetLevelSize(desc.format, width, height);
+    }
+    return true;
+}
+
+// 캐시가 원본보다 새로우면 읽음
+bool ReadCache(const std::string &filename, const std::string &cacheFilename,
+               const TextureLoadOptions &options, ImageData &image)
+{
+    std::error_code error;
+    const auto sourceTime = std::filesystem::last_write_time(filename, error);
+    if (error)
+        return false;
+    const auto cacheTime =
+        std::filesystem::last_write_time(cacheFilename, error);
+    if (error || cacheTime < sourceTime)
+        return false;
+
+    return ReadDds(cacheFilename, MakeCacheVersion(options), image);
+}
+
+bool IsDdsFile(const std::string &filename)
+{
+    std::string extension = std::filesystem::path(filename).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return char(std::tolower(c)); });
+    return extension == ".dds";
+}
+
+} // namespace
+
+TextureLoader::TextureLoader(size_t maxQueuedImages,
+                             const TextureLoadOptions &options)
+    : m_freeSlots(std::max<size_t>(maxQueuedImages, 1)), m_options(options)
+{
+}
+
+TextureLoader::~TextureLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_slotFree.notify_all();
+
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+void TextureLoader::Start(const std::vector<std::string> &filenames)
+{
+    m_remaining = filenames.size();
+    if (filenames.empty())
+        return;
+
+    // ParallelFor()는 끝날 때까지 기다리기 때문에 별도 스레드에서 호출하고
+    // 렌더 스레드는 바로 돌아가서 Pop()으로 끝난 이미지부터 받음
+    m_thread = std::thread([this, filenames]() {
+        ThreadPool::Get().ParallelFor(filenames.size(), [&](size_t i) {
+            DecodeJob(filenames[i]);
+        });
+    });
+}
+
+void TextureLoader::DecodeJob(const std::string &filename)
+{
+    // 큐에 자리가 날 때까지 디코딩을 시작하지 않음 (메모리 상한)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_slotFree.wait(lock, [this]() { return m_freeSlots > 0 || m_stop; });
+        if (m_stop)
+            return;
+        m_freeSlots--;
+    }
+
+    // 실패해도 Pop()의 개수가 맞도록 빈 이미지를 넘김
+    ImageData image;
+    Load(filename, m_options, image);
+    image.filename = filename;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(std::move(image));
+    }
+    m_imageReady.notify_one();
+}
+
+bool TextureLoader::Pop(ImageData &image)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_remaining == 0)
+        return false;
+
+    m_imageReady.wait(lock, [this]() { return !m_queue.empty(); });
+    image = std::move(m_queue.front());
+    m_queue.pop_front();
+    m_remaining--;
+    m_freeSlots++;
+    lock.unlock();
+
+    m_slotFree.notify_one();
+    return true;
+}
+
+bool TextureLoader::Load(const std::string &filename,
+                         const TextureLoadOptions &options, ImageData &image)
+{
+    // 이미 GPU 형식으로 만들어 둔 파일 (ChannelPacker 결과 등)은 변환 없이 그대로
+    if (IsDdsFile(filename))
+    {
+        image.filename = filename;
+        if (ReadDds(filename, 0, image))
+            return true;
+        std::cout << "Failed to read DDS texture: " << filename << std::endl;
+        return false;
+    }
+
+    const std::string cacheFilename = filename + ".dds";
+    if (options.compress && options.useCache &&
+        ReadCache(filename, cacheFilename, options, image))
+    {
+        image.filename = filename;
+        return true;
+    }
+
+    if (!Decode(filename, image, options.decoder))
+        return false;
+
+    const TextureUsage usage = GuessUsage(filename);
+    const bool compress =
+        options.compress && image.width % 4 == 0 && image.height % 4 == 0;
+    const bool hasAlpha = compress && usage == TextureUsage::Color &&
+                          !options.preferBC7 && HasAlpha(image);
+
+    // mip은 압축 전에 만들어야 하므로 레벨 0을 따로 보관 (PSNR 비교용)
+    std::vector<uint8_t> source;
+    if (compress)
+        source.assign(image.pixels.begin(), image.pixels.end());
+
+    if (options.generateMips)
+    {
+        MipOptions mipOptions = options.mipOptions;
+        mipOptions.srgb = mipOptions.srgb && usage == TextureUsage::Color;
+        GenerateMips(image, mipOptions);
+    }
+
+    if (!compress)
+        return true;
+
+    BlockFormat format = BlockFormat::BC7;
+    if (usage == TextureUsage::Normal)
+        format = BlockFormat::BC5;
+    else if (!options.preferBC7)
+        format = hasAlpha ? BlockFormat::BC3 : BlockFormat::BC1;
+
+    const auto start = std::chrono::steady_clock::now();
+    Compress(image, format, options.bc7Quality);
+    const double ms = std::chrono::duration<double, std::milli>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+
+    std::cout << filename << ": " << BlockCompressor::GetName(format) << " "
+              << image.width << "x" << image.height << ", "
+              << image.mipLevels.size() << " levels, "
+              << BlockCompressor::ComputePsnr(source.data(), image.pixels.data(),
+                                              image.width, image.height, format)
+              << " dB, " << ms << " ms" << std::endl;
+
+    if (options.useCache)
+    {
+        DdsDesc desc;
+        desc.format = image.format;
+        desc.width = uint32_t(image.width);
+        desc.height = uint32_t(image.height);
+        desc.mipLevels = uint32_t(image.mipLevels.size());
+        if (!DdsFile::Write(cacheFilename, desc, image.pixels.data(),
+                            image.pixels.size(), MakeCacheVersion(options)))
+        {
+            std::cout << "Failed to write texture cache: " << cacheFilename
+                      << std::endl;
+        }
+    }
+    return true;
+}
+
+TextureUsage TextureLoader::GuessUsage(const std::string &filename)
+{
+    std::string name = std::filesystem::path(filename).filename().string();
+    std::transform(name.begin(), name.end(), name.begin(),
+                   [](unsigned char c) { return char(std::tolower(c)); });
+
+    if (name.find("normal") != std::string::npos)
+        return TextureUsage::Normal;
+
+    const char *dataNames[] = {"metallic", "roughness", "occlusion",
+                               "_orm",     "_ao",       "height"};
+    for (const char *dataName : dataNames)
+    {
+        if (name.find(dataName) != std::string::npos)
+            return TextureUsage::Data;
+    }
+    return TextureUsage::Color;
+}
+
+bool TextureLoader::Decode(const std::string &filename, ImageData &image,
+                           ImageDecoderBackend backend)
+{
+    image.filename = filename;
+    image.pixels.clear();
+    image.mipLevels.clear();
+    image.format = DxgiFormat::R8G8B8A8_Unorm;
+
+    if (backend == ImageDecoderBackend::Fast)
+    {
+        MappedFile file;
+        int channels = 0;
+        if (file.Open(filename) &&
+            ImageDecoder::Decode(file.GetData(), file.GetSize(), image.width,
+                                 image.height, channels, image.pixels))
+            return true;
+    }
+
+    int width, height, channels;
+    unsigned char *img =
+        stbi_load(filename.c_str(), &width, &height, &channels, 0);
+    if (!img)
+    {
+        std::cout << "stbi_load() failed: " << filename << " ("
+                  << stbi_failure_reason() << ")" << std::endl;
+        return false;
+    }
+
+    image.width = width;
+    image.height = height;
+    image.pixels.resize(size_t(width) * height * 4);
+    ExpandToRgba(img, channels, size_t(width) * height, image.pixels.data());
+
+    stbi_image_free(img);
+    return true;
+}
+
+void TextureLoader::GenerateMips(ImageData &image, const MipOptions &options)
+{
+    if (image.pixels.empty())
+        return;
+
+    TMipChain<uint8_t> chain = MipGenerator::Generate(
+        image.pixels.data(), image.width, image.height, options);
+    image.pixels = std::move(chain.pixels);
+    image.mipLevels = std::move(chain.levels);
+}
+
+void TextureLoader::Compress(ImageData &image, BlockFormat format,
+                             BC7Quality quality)
+{
+    if (image.pixels.empty() || image.format != DxgiFormat::R8G8B8A8_Unorm)
+        return;
+
+    std::vector<MipLevel> levels = image.mipLevels;
+    if (levels.empty())
+        levels.push_back({image.width, image.height, 0});
+
+    size_t size = 0;
+    for (const MipLevel &level : levels)
+        size += BlockCompressor::GetCompressedSize(format, level.width, level.height);
+
+    std::vector<uint8_t> blocks(size);
+    size_t offset = 0;
+    for (MipLevel &level : levels)
+    {
+        BlockCompressor::Compress(image.pixels.data() + level.offset, level.width,
+                                  level.height, format, quality,
+                                  blocks.data() + offset);
+        level.offset = offset;
+        offset += BlockCompressor::GetCompressedSize(format, level.width, level.height);
+    }
+
+    image.pixels = std::move(blocks);
+    image.mipLevels = std::move(levels);
+    image.format = BlockCompressor::GetDxgiFormat(format);
+}
+
+void TextureLoader::ExpandToRgba(const uint8_t *src, int channels,
+                                 size_t numPixels, uint8_t *dst)
+{
+    size_t i = 0;
+
+    switch (channels)
+    {
+    case 1:
+#ifdef FEFE_TEXTURE_SSE2
+    {
+        // g -> gg, g -> g255, 두 개를 섞어서 g g g 255
+        const __m128i alpha = _mm_set1_epi8(char(0xFF));
+        for (; i + 16 <= numPixels; i += 16)
+        {
+            const __m128i g =
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+            const __m128i gg0 = _mm_unpacklo_epi8(g, g);
+            const __m128i gg1 = _mm_unpackhi_epi8(g, g);
+            const __m128i ga0 = _mm_unpacklo_epi8(g, alpha);
+            const __m128i ga1 = _mm_unpackhi_epi8(g, alpha);
+            __m128i *out = reinterpret_cast<__m128i *>(dst + i * 4);
+            _mm_storeu_si128(out, _mm_unpacklo_epi16(gg0, ga0));
+            _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(gg0, ga0));
+            _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(gg1, ga1));
+            _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(gg1, ga1));
+        }
+    }
+#endif
+        for (; i < numPixels; i++)
+        {
+            dst[i * 4] = dst[i * 4 + 1] = dst[i * 4 + 2] = src[i];
+            dst[i * 4 + 3] = 255;
+        }
+        break;
+
+    case 2:
+#ifdef FEFE_TEXTURE_SSE2
+    {
+        // ga -> gg (16비트 단위), ga와 섞어서 g g g a
+        const __m128i lowByte = _mm_set1_epi16(0x00FF);
+        for (; i + 8 <= numPixels; i += 8)
+        {
+            const __m128i ga =
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 2));
+            const __m128i g = _mm_and_si128(ga, lowByte);
+            const __m128i gg = _mm_or_si128(g, _mm_slli_epi16(g, 8));
+            __m128i *out = reinterpret_cast<__m128i *>(dst + i * 4);
+            _mm_storeu_si128(out, _mm_unpacklo_epi16(gg, ga));
+            _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(gg, ga));
+        }
+    }
+#endif
+        for (; i < numPixels; i++)
+        {
+            dst[i * 4] = dst[i * 4 + 1] = dst[i * 4 + 2] = src[i * 2];
+            dst[i * 4 + 3] = src[i * 2 + 1];
+        }
+        break;
+
+    case 3:
+#ifdef FEFE_TEXTURE_SSE2
+    {
+        // 16바이트를 읽어서 앞의 12바이트(4픽셀)만 사용
+        // 마지막 16바이트를 넘어서 읽지 않도록 6픽셀 이상 남았을 때만
+        // pshufb(SSSE3) 대신 3, 6, 9바이트 시프트로 픽셀마다 dword 맨 앞에 맞추고
+        // 아래 dword끼리 모음 (메모리 대역폭이 한계라서 속도는 같음)
+        const __m128i alpha = _mm_set1_epi32(int(0xFF000000));
+        for (; i + 6 <= numPixels; i += 4)
+        {
+            const __m128i rgb =
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 3));
+            const __m128i p01 = _mm_unpacklo_epi32(rgb, _mm_srli_si128(rgb, 3));
+            const __m128i p23 = _mm_unpacklo_epi32(_mm_srli_si128(rgb, 6),
+                                                   _mm_srli_si128(rgb, 9));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4),
+                             _mm_or_si128(_mm_unpacklo_epi64(p01, p23), alpha));
+        }
+    }
+#endif
+        // 픽셀마다 4바이트를 읽고 알파 자리만 255로 (다음 픽셀의 r은 버림)
+        // 마지막 픽셀은 넘어서 읽지 않도록 따로
+        for (; i + 1 < numPixels; i++)
+        {
+            uint32_t rgbx;
+            std::memcpy(&rgbx, src + i * 3, 4);
+            rgbx |= 0xFF000000u; // little endian
+            std::memcpy(dst + i * 4, &rgbx, 4);
+        }
+        for (; i < numPixels; i++)
+        {
+            dst[i * 4] = src[i * 3];
+            dst[i * 4 + 1] = src[i * 3 + 1];
+            dst[i * 4 + 2] = src[i * 3 + 2];
+            dst[i * 4 + 3] = 255;
+        }
+        break;
+
+    case 4:
+        std::memcpy(dst, src, numPixels * 4);
+        break;
+
+    default:
+        std::memset(dst, 255, numPixels * 4);
+        break;
+    }
+}
+
+} // namespace FEFE
@@ -0,0 +1,129 @@
+﻿#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BlockCompressor.h"
+#include "DdsFile.h"
+#include "ImageDecoder.h"
+#include "MipGenerator.h"
+
+namespace FEFE
+{
+
+// 디코딩이 끝난 이미지 (RGBA 8비트 또는 BC 블록)
+struct ImageData
+{
+    std::string filename;
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> pixels; // 실패하면 비어있음
+
+    // mip을 만들었으면 pixels 안의 레벨 0, 1, ... 위치 (바이트, 비어있으면 레벨 0만)
+    std::vector<MipLevel> mipLevels;
+
+    uint32_t format = DxgiFormat::R8G8B8A8_Unorm;
+};
+
+// 텍스춰 용도 (mip을 만들 때 sRGB 여부와 압축 형식이 달라짐)
+enum class TextureUsage
+{
+    Color,  // 알베도 등, sRGB 공간에서 평균
+    Data,   // 거칠기/금속성/AO/높이, 값 그대로 평균
+    Normal, // 탄젠트 공간 노멀맵, BC5 (xy만)
+};
+
+struct TextureLoadOptions
+{
+    // JPEG/PNG 디코더 (Fast가 읽지 못하는 파일은 stbi로 다시 시도)
+    ImageDecoderBackend decoder = ImageDecoderBackend::Fast;
+
+    bool generateMips = true;
+    MipOptions mipOptions; // srgb는 용도에 따라 바뀜
+
+    // 크기가 4의 배수인 텍스춰는 BC로 압축 (아니면 RGBA 그대로)
+    bool compress = true;
+    bool preferBC7 = true; // false면 알파 유무에 따라 BC3/BC1
+    BC7Quality bc7Quality = BC7Quality::Normal;
+
+    // 압축 결과를 원본 옆 (filename + ".dds")에 저장하고
+    // 원본보다 새롭고 같은 설정으로 만든 파일이면 디코딩/압축 없이 사용
+    bool useCache = true;
+};
+
+// 이미지 파일을 작업 스레드에서 디코딩하고 렌더 스레드로 넘겨주는 클래스
+//
+// TextureLoader loader;
+// loader.Start(filenames);
+// ImageData image;
+// while (loader.Pop(image))
+//     ... CreateTexture2D() ...
+//
+// 작업 스레드에서 디코딩, mip 생성, BC 압축까지 끝내고 (Load() 참고) 넘겨줌
+//
+// 디코딩이 끝났지만 아직 Pop()하지 않은 이미지는 maxQueuedImages장까지만
+// 메모리에 둠 (작업 스레드는 자리가 날 때까지 다음 파일을 읽지 않음)
+// 그래서 CPU 메모리는 큰 텍스춰 maxQueuedImages + 1장 (렌더 스레드가 올리는 중인 것) 정도
+class TextureLoader
+{
+  public:
+    explicit TextureLoader(size_t maxQueuedImages = 4,
+                           const TextureLoadOptions &options = TextureLoadOptions());
+    ~TextureLoader(); // 남은 작업은 취소하고 기다림
+
+    TextureLoader(const TextureLoader &) = delete;
+    TextureLoader &operator=(const TextureLoader &) = delete;
+
+    // filenames를 ThreadPool에서 디코딩 시작 (한 번만 호출)
+    void Start(const std::vector<std::string> &filenames);
+
+    // 다음으로 끝난 이미지를 꺼냄 (끝난 순서, 파일 순서와 다를 수 있음)
+    // 모든 파일을 꺼냈으면 false
+    bool Pop(ImageData &image);
+
+    // 파일 하나를 GPU에 올릴 형태로 준비 (현재 스레드에서)
+    // 캐시가 유효하면 캐시를 읽고, 아니면 디코딩 -> mip -> BC 압축 후 캐시 저장
+    // .dds 파일은 (2D 텍스춰만) 변환 없이 그대로 읽음
+    static bool Load(const std::string &filename,
+                     const TextureLoadOptions &options, ImageData &image);
+
+    // 파일 이름으로 용도 추측 (glTF/FBX 텍스춰 이름 관례)
+    static TextureUsage GuessUsage(const std::string &filename);
+
+    // 파일 하나를 읽어서 RGBA로 변환 (현재 스레드에서, 안에서 ThreadPool 사용)
+    static bool Decode(const std::string &filename, ImageData &image,
+                       ImageDecoderBackend backend = ImageDecoderBackend::Fast);
+
+    // image.pixels 뒤에 mip 레벨들을 이어 붙임
+    static void GenerateMips(ImageData &image, const MipOptions &options);
+
+    // RGBA 이미지(mip 포함)를 레벨마다 압축
+    static void Compress(ImageData &image, BlockFormat format,
+                         BC7Quality quality);
+
+    // 1~4채널 8비트 픽셀을 RGBA로 확장
+    // 1: 회색 -> (g, g, g, 255), 2: 회색 + 알파 -> (g, g, g, a)
+    // 3: RGB -> (r, g, b, 255), 4: 그대로 복사
+    static void ExpandToRgba(const uint8_t *src, int channels,
+                             size_t numPixels, uint8_t *dst);
+
+  private:
+    void DecodeJob(const std::string &filename);
+
+    std::thread m_thread; // ThreadPool::ParallelFor()를 호출하고 기다리는 스레드
+    std::mutex m_mutex;
+    std::condition_variable m_imageReady;
+    std::condition_variable m_slotFree;
+    std::deque<ImageData> m_queue;
+    size_t m_freeSlots;
+    TextureLoadOptions m_options;
+    size_t m_remaining = 0; // 아직 Pop()하지 않은 파일 수
+    bool m_stop = false;
+};
+
+} // namespace FEFE
@@ -0,0 +1,339 @@
+﻿#include "TextureResidency.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <queue>
+
+namespace FEFE
+{
+
+namespace
+{
+
+// level부터 끝까지만 남긴 이미지
+ImageData TrimLevels(const ImageData &image, int level)
+{
+    const MipLevel &top = image.mipLevels[size_t(level)];
+
+    ImageData trimmed;
+    trimmed.filename = image.filename;
+    trimmed.format = image.format;
+    trimmed.width = top.width;
+    trimmed.height = top.height;
+    trimmed.pixels.assign(image.pixels.begin() + top.offset, image.pixels.end());
+    for (size_t i = size_t(level); i < image.mipLevels.size(); i++)
+    {
+        MipLevel mip = image.mipLevels[i];
+        mip.offset -= top.offset;
+        trimmed.mipLevels.push_back(mip);
+    }
+    return trimmed;
+}
+
+bool IsBlockCompressed(uint32_t format)
+{
+    return DdsFile::GetBlockSize(format) != 0;
+}
+
+} // namespace
+
+TextureResidency::~TextureResidency()
+{
+    for (Entry &entry : m_entries)
+    {
+        if (entry.load.valid())
+            entry.load.wait();
+    }
+}
+
+void TextureResidency::Register(const std::shared_ptr<CachedTexture> &texture,
+                                const std::string &filename)
+{
+    if (!texture || m_index.count(texture.get()))
+        return;
+
+    m_index[texture.get()] = m_entries.size();
+    m_entries.emplace_back();
+    m_entries.back().texture = texture;
+    m_entries.back().filename = filename;
+    m_stats.numTextures = m_entries.size();
+}
+
+void TextureResidency::BeginFrame()
+{
+    for (Entry &entry : m_entries)
+    {
+        entry.priority = 0.0f;
+        entry.requested = false;
+    }
+}
+
+void TextureResidency::Request(const CachedTexture *texture, float pixelsPerUv)
+{
+    if (!texture)
+        return;
+    auto it = m_index.find(texture);
+    if (it == m_index.end())
+        return;
+
+    Entry &entry = m_entries[it->second];
+    entry.requested = true;
+    entry.priority = std::max(entry.priority, pixelsPerUv);
+}
+
+int TextureResidency::GetDesiredLevel(const Entry &entry) const
+{
+    // 레벨 l의 uv 1당 텍셀 수 = 크기 >> l, 화면 픽셀 수보다 작아지지 않는 가장 작은 레벨
+    if (!(entry.priority > 0.0f))
+        return entry.coarsestTop;
+    const float texels = float(std::max(entry.width, entry.height));
+    const int level = int(std::floor(std::log2(texels / entry.priority)));
+    return std::min(std::max(level, 0), entry.coarsestTop);
+}
+
+size_t TextureResidency::GetBytes(const Entry &entry, int level) const
+{
+    size_t bytes = 0;
+    for (size_t i = size_t(std::max(level, 0)); i < entry.levelSizes.size(); i++)
+        bytes += entry.levelSizes[i];
+    return bytes;
+}
+
+void TextureResidency::FinishLoad(Entry &entry,
+                                  const CreateTextureFunc &createTexture)
+{
+    const bool succeeded = entry.load.get();
+    std::unique_ptr<ImageData> image = std::move(entry.image);
+    auto texture = entry.texture.lock();
+    if (!succeeded || !texture || image->pixels.empty())
+    {
+        entry.failed = !succeeded;
+        return;
+    }
+
+    if (!entry.hasInfo)
+    {
+        entry.hasInfo = true;
+        entry.format = image->format;
+        entry.width = image->width;
+        entry.height = image->height;
+
+        const size_t numLevels = std::max<size_t>(image->mipLevels.size(), 1);
+        for (size_t level = 0; level < numLevels; level++)
+        {
+            const uint32_t width = uint32_t(std::max(image->width >> level, 1));
+            const uint32_t height = uint32_t(std::max(image->height >> level, 1));
+            entry.levelSizes.push_back(
+                DdsFile::GetLevelSize(image->format, width, height));
+
+            // BC 텍스춰는 가장 위 레벨이 4의 배수여야 함
+            if (!IsBlockCompressed(image->format) ||
+                (width % 4 == 0 && height % 4 == 0))
+                entry.coarsestTop = int(level);
+        }
+    }
+
+    // 처음 읽은 것이면 이제 크기를 알았으므로 지금 우선순위로 레벨 결정
+    const int level = entry.loadLevel >= 0
+                          ? std::min(entry.loadLevel, entry.coarsestTop)
+                          : GetDesiredLevel(entry);
+
+    ComPtr<ID3D11Texture2D> newTexture;
+    ComPtr<ID3D11ShaderResourceView> newView;
+    if (level > 0)
+        *image = TrimLevels(*image, level);
+    createTexture(*image, newTexture, newView);
+    if (!newView)
+    {
+        entry.failed = true;
+        return;
+    }
+
+    texture->texture = newTexture;
+    texture->resourceView = newView;
+    texture->bytes = GetBytes(entry, level);
+    entry.residentLevel = level;
+    m_stats.numLoads++;
+}
+
+void TextureResidency::DropLevels(Entry &entry, int level, ID3D11Device *device,
+                                  ID3D11DeviceContext *context)
+{
+    auto texture = entry.texture.lock();
+    if (!texture || !texture->texture)
+        return;
+
+    // 남길 레벨만 GPU에서 복사 (파일을 다시 읽지 않음)
+    const UINT drop = UINT(level - entry.residentLevel);
+    D3D11_TEXTURE2D_DESC desc;
+    texture->texture->GetDesc(&desc);
+    desc.Width = std::max(desc.Width >> drop, 1u);
+    desc.Height = std::max(desc.Height >> drop, 1u);
+    desc.MipLevels -= drop;
+    desc.Usage = D3D11_USAGE_DEFAULT; // 복사 대상
+
+    ComPtr<ID3D11Texture2D> newTexture;
+    ComPtr<ID3D11ShaderResourceView> newView;
+    if (FAILED(device->CreateTexture2D(&desc, nullptr,
+                                       newTexture.GetAddressOf())) ||
+        FAILED(device->CreateShaderResourceView(newTexture.Get(), nullptr,
+                                                newView.GetAddressOf())))
+        return;
+
+    for (UINT mip = 0; mip < desc.MipLevels; mip++)
+    {
+        context->CopySubresourceRegion(newTexture.Get(), mip, 0, 0, 0,
+                                       texture->texture.Get(), mip + drop,
+                                       nullptr);
+    }
+
+    texture->texture = newTexture;
+    texture->resourceView = newView;
+    texture->bytes = GetBytes(entry, level);
+    entry.residentLevel = level;
+    m_stats.numDrops++;
+}
+
+void TextureResidency::EndFrame(ID3D11Device *device,
+                                ID3D11DeviceContext *context,
+                                const CreateTextureFunc &createTexture)
+{
+    // 1. 끝난 읽기 올리기
+    for (Entry &entry : m_entries)
+    {
+        if (entry.load.valid() &&
+            entry.load.wait_for(std::chrono::seconds(0)) ==
+                std::future_status::ready)
+            FinishLoad(entry, createTexture);
+    }
+
+    // 2. 레벨 정하기
+    //    보이는 텍스춰: 원하는 레벨 (이미 더 큰 레벨이 있으면 그대로)
+    //    보이지 않는 텍스춰: 지금 레벨, 우선순위 0
+    std::vector<int> target(m_entries.size(), -1);
+    size_t total = 0;
+    m_stats.requestedBytes = 0;
+    m_stats.numRequested = 0;
+    m_stats.numDroppedLevels = 0;
+
+    // (우선순위, 번호), 우선순위가 낮은 것부터
+    using Item = std::pair<float, size_t>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+
+    for (size_t i = 0; i < m_entries.size(); i++)
+    {
+        Entry &entry = m_entries[i];
+        if (entry.texture.expired())
+            continue;
+        m_stats.numRequested += entry.requested;
+        if (!entry.hasInfo)
+            continue;
+
+        if (entry.requested)
+        {
+            const int desired = GetDesiredLevel(entry);
+            m_stats.requestedBytes += GetBytes(entry, desired);
+            target[i] = entry.residentLevel >= 0
+                            ? std::min(desired, entry.residentLevel)
+                            : desired;
+        }
+        else if (entry.residentLevel >= 0)
+        {
+            target[i] = entry.residentLevel;
+        }
+        else
+        {
+            continue;
+        }
+
+        total += GetBytes(entry, target[i]);
+        queue.push({entry.requested ? entry.priority : 0.0f, i});
+    }
+
+    // 3. 예산을 넘으면 우선순위가 가장 낮은 텍스춰의 위쪽 레벨부터 버림
+    //    한 레벨 버린 텍스춰는 우선순위를 절반으로 보고 다시 비교
+    std::vector<char> evict(m_entries.size(), 0);
+    while (total > m_stats.budget && !queue.empty())
+    {
+        const Item item = queue.top();
+        queue.pop();
+
+        const size_t i = item.second;
+        Entry &entry = m_entries[i];
+        if (target[i] < entry.coarsestTop)
+        {
+            total -= entry.levelSizes[size_t(target[i])];
+            target[i]++;
+            if (entry.requested)
+                m_stats.numDroppedLevels++;
+            queue.push({item.first * 0.5f, i});
+        }
+        else if (!entry.requested)
+        {
+            total -= GetBytes(entry, target[i]);
+            evict[i] = 1;
+        }
+    }
+    if (total > m_stats.budget)
+        m_stats.numOverBudgetFrames++;
+
+    // 4. 적용: 내리기, 버리기는 바로 / 읽기는 작업 스레드에서
+    size_t numPending = 0;
+    for (const Entry &entry : m_entries)
+        numPending += entry.load.valid();
+
+    for (size_t i = 0; i < m_entries.size(); i++)
+    {
+        Entry &entry = m_entries[i];
+        auto texture = entry.texture.lock();
+        if (!texture || entry.failed)
+            continue;
+
+        if (evict[i])
+        {
+            texture->texture.Reset();
+            texture->resourceView.Reset();
+            texture->bytes = 0;
+            entry.residentLevel = -1;
+            m_stats.numEvictions++;
+            continue;
+        }
+
+        if (entry.residentLevel >= 0 && target[i] > entry.residentLevel)
+        {
+            DropLevels(entry, target[i], device, context);
+            continue;
+        }
+
+        // 처음 보였거나 더 큰 레벨이 필요함
+        const bool needLoad =
+            entry.requested &&
+            (entry.residentLevel < 0 || target[i] < entry.residentLevel);
+        if (needLoad && !entry.load.valid() && numPending < m_maxPendingLoads)
+        {
+            entry.loadLevel = entry.hasInfo ? target[i] : -1;
+            entry.image = std::make_unique<ImageData>();
+            ImageData *image = entry.image.get();
+            const std::string filename = entry.filename;
+            const TextureLoadOptions options = m_options;
+            entry.load = std::async(std::launch::async, [=]() {
+                return TextureLoader::Load(filename, options, *image);
+            });
+            numPending++;
+        }
+    }
+
+    m_stats.numPendingLoads = numPending;
+    m_stats.residentBytes = 0;
+    m_stats.numResident = 0;
+    for (const Entry &entry : m_entries)
+    {
+        if (entry.residentLevel < 0 || entry.texture.expired())
+            continue;
+        m_stats.residentBytes += GetBytes(entry, entry.residentLevel);
+        m_stats.numResident++;
+    }
+}
+
+} // namespace FEFE
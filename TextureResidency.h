@@ -0,0 +1,132 @@
+﻿#pragma once
+
+#include <d3d11.h>
+#include <wrl.h> // ComPtr
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "TextureCache.h"
+#include "TextureLoader.h"
+
+namespace FEFE
+{
+
+using Microsoft::WRL::ComPtr;
+
+struct ResidencyStats
+{
+    size_t budget = size_t(256) << 20;
+    size_t requestedBytes = 0; // 보이는 텍스춰를 원하는 mip까지 올렸을 때 크기
+    size_t residentBytes = 0;  // 지금 GPU에 올라가 있는 크기
+    size_t numTextures = 0;    // 등록된 텍스춰
+    size_t numResident = 0;
+    size_t numRequested = 0;     // 이번 프레임에 보인 텍스춰
+    size_t numDroppedLevels = 0; // 예산 때문에 원하는 것보다 낮춘 레벨 수 (이번 프레임)
+    size_t numPendingLoads = 0;
+
+    // 처음부터 누적
+    size_t numLoads = 0;
+    size_t numDrops = 0;     // 올라가 있는 텍스춰의 위쪽 mip을 버린 횟수
+    size_t numEvictions = 0; // 보이지 않는 텍스춰를 내린 횟수
+    size_t numOverBudgetFrames = 0; // 가장 작은 mip으로도 예산을 넘은 프레임
+
+    // 1보다 크면 보이는 텍스춰를 원하는 만큼 올릴 수 없음
+    double GetPressure() const
+    {
+        return budget ? double(requestedBytes) / double(budget) : 0.0;
+    }
+};
+
+// 텍스춰를 GPU 메모리 예산 안에서 관리하는 클래스
+// 1. 처음 보일 때 작업 스레드에서 읽음 (Initialize()에서 모두 읽지 않음)
+// 2. 화면에서 필요한 해상도 (uv 밀도 x 화면 크기)보다 큰 mip은 올리지 않음
+// 3. 예산을 넘으면 우선순위가 낮은 텍스춰부터 위쪽 mip을 버림
+//    우선순위 = uv 1당 화면 픽셀 수, 한 레벨 버릴 때마다 절반으로 보고 다시 비교
+//    보이지 않는 텍스춰는 우선순위 0이라서 먼저 줄이고 그래도 넘으면 내림
+//
+// 원하는 mip이 작아져도 예산이 남으면 그대로 둠 (다시 가까워질 때 다시 읽지 않도록)
+//
+// residency.BeginFrame();
+// for (보이는 메쉬) residency.Request(mesh.texture.get(), pixelsPerUv);
+// residency.EndFrame(device, context, createTexture);
+class TextureResidency
+{
+  public:
+    // GPU 텍스춰 생성 (AppBase::CreateTexture())
+    using CreateTextureFunc = std::function<void(
+        const ImageData &, ComPtr<ID3D11Texture2D> &,
+        ComPtr<ID3D11ShaderResourceView> &)>;
+
+    TextureResidency() = default;
+    ~TextureResidency(); // 읽는 중인 작업을 기다림
+
+    TextureResidency(const TextureResidency &) = delete;
+    TextureResidency &operator=(const TextureResidency &) = delete;
+
+    void SetBudget(size_t bytes) { m_stats.budget = bytes; }
+    void SetLoadOptions(const TextureLoadOptions &options) { m_options = options; }
+    void SetMaxPendingLoads(size_t count) { m_maxPendingLoads = count; }
+
+    // texture를 읽지 않고 등록만 함 (이미 등록했으면 무시)
+    void Register(const std::shared_ptr<CachedTexture> &texture,
+                  const std::string &filename);
+
+    void BeginFrame();
+
+    // 이번 프레임에 texture가 보임
+    // pixelsPerUv: uv 1만큼이 화면에서 몇 픽셀인지 (여러 번 요청하면 가장 큰 값)
+    // nullptr이거나 등록하지 않은 텍스춰는 무시
+    void Request(const CachedTexture *texture, float pixelsPerUv);
+
+    // 끝난 읽기를 올리고, 예산 안에서 텍스춰마다 mip을 정해서 읽기/버리기/내리기
+    void EndFrame(ID3D11Device *device, ID3D11DeviceContext *context,
+                  const CreateTextureFunc &createTexture);
+
+    const ResidencyStats &GetStats() const { return m_stats; }
+
+  private:
+    struct Entry
+    {
+        std::weak_ptr<CachedTexture> texture;
+        std::string filename;
+
+        // 처음 읽은 뒤에 알게 되는 정보
+        bool hasInfo = false;
+        bool failed = false;
+        uint32_t format = 0;
+        int width = 0;
+        int height = 0;
+        std::vector<size_t> levelSizes; // 레벨마다 바이트
+        int coarsestTop = 0; // 가장 위 레벨로 쓸 수 있는 가장 작은 레벨 (BC는 4의 배수)
+
+        int residentLevel = -1; // GPU에 있는 가장 큰 레벨, -1이면 없음
+        float priority = 0.0f;  // 이번 프레임의 pixelsPerUv
+        bool requested = false;
+
+        // 읽는 중
+        std::future<bool> load;
+        std::unique_ptr<ImageData> image;
+        int loadLevel = -1; // -1이면 다 읽은 뒤에 정함
+    };
+
+    int GetDesiredLevel(const Entry &entry) const;
+    size_t GetBytes(const Entry &entry, int level) const;
+    void FinishLoad(Entry &entry, const CreateTextureFunc &createTexture);
+    void DropLevels(Entry &entry, int level, ID3D11Device *device,
+                    ID3D11DeviceContext *context);
+
+    std::vector<Entry> m_entries;
+    std::unordered_map<const CachedTexture *, size_t> m_index;
+
+    TextureLoadOptions m_options;
+    size_t m_maxPendingLoads = 4;
+    ResidencyStats m_stats;
+};
+
+} // namespace FEFE
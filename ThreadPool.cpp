@@ -0,0 +1,139 @@
+﻿#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace FEFE
+{
+
+ThreadPool::ThreadPool(size_t numThreads)
+{
+    if (numThreads == 0)
+    {
+        const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+        numThreads = cores > 1 ? cores - 1 : 1; // 호출한 스레드도 일을 하므로 하나 뺌
+    }
+
+    m_workers.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; i++)
+    {
+        m_workers.emplace_back([this] { WorkerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_jobAvailable.notify_all();
+
+    for (auto &worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+ThreadPool &ThreadPool::Get()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::RunItems(Job &job)
+{
+    size_t i;
+    while ((i = job.next.fetch_add(1)) < job.count)
+    {
+        (*job.func)(i);
+        job.done.fetch_add(1);
+    }
+}
+
+void ThreadPool::WorkerLoop()
+{
+    while (true)
+    {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_jobAvailable.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+
+            if (m_stop && m_jobs.empty())
+                return;
+
+            job = m_jobs.front();
+
+            // 더 나눠줄 일이 없는 작업은 큐에서 빼줌
+            if (job->next.load() >= job->count)
+            {
+                m_jobs.pop_front();
+                continue;
+            }
+        }
+
+        RunItems(*job);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_jobs.empty() && m_jobs.front() == job)
+                m_jobs.pop_front();
+        }
+        m_jobFinished.notify_all();
+    }
+}
+
+void ThreadPool::ParallelFor(size_t count,
+                             const std::function<void(size_t)> &func)
+{
+    if (count == 0)
+        return;
+
+    // 일이 하나뿐이거나 워커가 없으면 그냥 실행
+    if (count == 1 || m_workers.empty())
+    {
+        for (size_t i = 0; i < count; i++)
+            func(i);
+        return;
+    }
+
+    auto job = std::make_shared<Job>();
+    job->func = &func;
+    job->count = count;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(job);
+    }
+    m_jobAvailable.notify_all();
+
+    // 호출한 스레드도 같이 처리
+    RunItems(*job);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobFinished.wait(lock, [&] { return job->done.load() >= job->count; });
+
+    // 다른 워커가 빼기 전에 끝났다면 여기서 정리
+    auto it = std::find(m_jobs.begin(), m_jobs.end(), job);
+    if (it != m_jobs.end())
+        m_jobs.erase(it);
+}
+
+void ThreadPool::ParallelForChunks(
+    size_t count, size_t chunkSize,
+    const std::function<void(size_t, size_t)> &func)
+{
+    if (count == 0)
+        return;
+
+    chunkSize = std::max<size_t>(chunkSize, 1);
+    const size_t numChunks = (count + chunkSize - 1) / chunkSize;
+
+    ParallelFor(numChunks, [&](size_t c) {
+        const size_t begin = c * chunkSize;
+        const size_t end = std::min(begin + chunkSize, count);
+        func(begin, end);
+    });
+}
+
+} // namespace FEFE
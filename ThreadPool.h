@@ -0,0 +1,61 @@
+﻿#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace FEFE
+{
+
+// 로딩/전처리 단계에서 공통으로 사용하는 작업 스레드 풀
+// ParallelFor()를 호출한 스레드도 같이 일을 처리하기 때문에
+// 작업 안에서 다시 ParallelFor()를 호출해도 멈추지 않습니다.
+class ThreadPool
+{
+  public:
+    explicit ThreadPool(size_t numThreads = 0); // 0이면 코어 수 - 1
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // 프로그램 전체에서 공유하는 풀
+    static ThreadPool &Get();
+
+    size_t GetNumThreads() const { return m_workers.size(); }
+
+    // [0, count) 범위를 나눠서 func(i)를 병렬로 실행, 모두 끝날 때까지 대기
+    void ParallelFor(size_t count, const std::function<void(size_t)> &func);
+
+    // chunkSize 단위로 잘라서 func(begin, end) 실행
+    // 큰 버텍스 배열처럼 원소 하나당 일이 작은 경우에 사용
+    void ParallelForChunks(size_t count, size_t chunkSize,
+                           const std::function<void(size_t, size_t)> &func);
+
+  private:
+    struct Job
+    {
+        const std::function<void(size_t)> *func = nullptr;
+        size_t count = 0;
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+    };
+
+    void WorkerLoop();
+    static void RunItems(Job &job);
+
+    std::vector<std::thread> m_workers;
+    std::deque<std::shared_ptr<Job>> m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_jobAvailable;
+    std::condition_variable m_jobFinished;
+    bool m_stop = false;
+};
+
+} // namespace FEFE
@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include <cstdint>
 #include <directxtk/SimpleMath.h>
 #include <vector>
 
@@ -16,4 +17,53 @@ struct Vertex
     Vector2 texcoord;
 };
 
+// 압축 버텍스에서 사용하는 성분 형식 (DXGI 형식과 1:1)
+struct Snorm16x4 // DXGI_FORMAT_R16G16B16A16_SNORM
+{
+    int16_t x, y, z, w;
+};
+
+struct Snorm16x2 // DXGI_FORMAT_R16G16_SNORM
+{
+    int16_t x, y;
+};
+
+struct Unorm16x2 // DXGI_FORMAT_R16G16_UNORM
+{
+    uint16_t x, y;
+};
+
+struct Half2 // DXGI_FORMAT_R16G16_FLOAT
+{
+    uint16_t x, y;
+};
+
+struct Unorm10x3 // DXGI_FORMAT_R10G10B10A2_UNORM
+{
+    uint32_t xyzw;
+};
+
+// 16 bytes
+// position: 메쉬 범위로 양자화한 16비트, normal: 8면체(octahedral) 인코딩
+// texcoord: texcoord 범위로 양자화한 16비트
+struct VertexPacked
+{
+    Snorm16x4 position;
+    Snorm16x2 normal;
+    Unorm16x2 texcoord;
+};
+
+// 12 bytes
+// position: 메쉬 범위로 양자화한 10비트, texcoord: half
+struct VertexCompact
+{
+    Unorm10x3 position;
+    Snorm16x2 normal;
+    Half2 texcoord;
+};
+
+static_assert(sizeof(Vertex) == 32, "Vertex size");
+static_assert(sizeof(VertexPacked) == 16, "VertexPacked size");
+static_assert(sizeof(VertexCompact) == 12, "VertexCompact size");
+
 } // namespace FEFE
\ No newline at end of file
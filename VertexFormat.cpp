@@ -0,0 +1,205 @@
+﻿#include "VertexFormat.h"
+
+#include <DirectXPackedVector.h>
+
+namespace FEFE
+{
+
+using DirectX::PackedVector::XMConvertFloatToHalf;
+using DirectX::PackedVector::XMConvertHalfToFloat;
+
+namespace
+{
+
+float Clamp(float x, float lo, float hi) { return std::min(std::max(x, lo), hi); }
+
+int16_t ToSnorm16(float x)
+{
+    return int16_t(std::lround(Clamp(x, -1.0f, 1.0f) * 32767.0f));
+}
+
+float FromSnorm16(int16_t x) { return std::max(float(x) / 32767.0f, -1.0f); }
+
+uint16_t ToUnorm16(float x)
+{
+    return uint16_t(std::lround(Clamp(x, 0.0f, 1.0f) * 65535.0f));
+}
+
+float FromUnorm16(uint16_t x) { return float(x) / 65535.0f; }
+
+uint32_t ToUnorm10(float x)
+{
+    return uint32_t(std::lround(Clamp(x, 0.0f, 1.0f) * 1023.0f));
+}
+
+float FromUnorm10(uint32_t x) { return float(x & 0x3FF) / 1023.0f; }
+
+// 0으로 나누지 않도록 범위가 없는 축은 1로
+Vector3 SafeExtent(const Vector3 &vmin, const Vector3 &vmax)
+{
+    const Vector3 e = vmax - vmin;
+    return Vector3(e.x > 0.0f ? e.x : 1.0f, e.y > 0.0f ? e.y : 1.0f,
+                   e.z > 0.0f ? e.z : 1.0f);
+}
+
+Vector2 SafeExtent(const Vector2 &vmin, const Vector2 &vmax)
+{
+    const Vector2 e = vmax - vmin;
+    return Vector2(e.x > 0.0f ? e.x : 1.0f, e.y > 0.0f ? e.y : 1.0f);
+}
+
+// 단위 벡터 -> 8면체 [-1, 1]^2 (Cigolle et al. 2014)
+Vector2 OctahedralEncode(const Vector3 &n)
+{
+    const float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    if (l1 == 0.0f)
+        return Vector2(0.0f);
+
+    Vector2 e(n.x / l1, n.y / l1);
+    if (n.z < 0.0f)
+    {
+        e = Vector2((1.0f - std::abs(e.y)) * (e.x >= 0.0f ? 1.0f : -1.0f),
+                    (1.0f - std::abs(e.x)) * (e.y >= 0.0f ? 1.0f : -1.0f));
+    }
+    return e;
+}
+
+// Common.hlsli의 OctahedralDecode()와 같은 계산
+Vector3 OctahedralDecode(const Vector2 &e)
+{
+    Vector3 n(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+    const float t = Clamp(-n.z, 0.0f, 1.0f);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    n.Normalize();
+    return n;
+}
+
+Snorm16x2 PackNormal(const Vector3 &normal)
+{
+    const Vector2 e = OctahedralEncode(normal);
+    return Snorm16x2{ToSnorm16(e.x), ToSnorm16(e.y)};
+}
+
+Vector3 UnpackNormal(const Snorm16x2 &normal)
+{
+    return OctahedralDecode(
+        Vector2(FromSnorm16(normal.x), FromSnorm16(normal.y)));
+}
+
+} // namespace
+
+VertexQuantization
+VertexQuantization::FromMeshes(const std::vector<MeshDataView> &meshes)
+{
+    VertexQuantization q;
+    bool first = true;
+    for (const auto &mesh : meshes)
+    {
+        for (size_t i = 0; i < mesh.numVertices; i++)
+        {
+            const Vertex &v = mesh.vertices[i];
+            if (first)
+            {
+                q.positionMin = q.positionMax = v.position;
+                q.texcoordMin = q.texcoordMax = v.texcoord;
+                first = false;
+                continue;
+            }
+            q.positionMin = Vector3::Min(q.positionMin, v.position);
+            q.positionMax = Vector3::Max(q.positionMax, v.position);
+            q.texcoordMin = Vector2::Min(q.texcoordMin, v.texcoord);
+            q.texcoordMax = Vector2::Max(q.texcoordMax, v.texcoord);
+        }
+    }
+    return q;
+}
+
+// VertexPacked: position은 [min, max] -> [-1, 1], texcoord는 [min, max] -> [0, 1]
+VertexPacked VertexFormat<VertexPacked>::Pack(const Vertex &v,
+                                              const VertexQuantization &q)
+{
+    const Vector3 p = (v.position - q.positionMin) /
+                          SafeExtent(q.positionMin, q.positionMax) * 2.0f -
+                      Vector3(1.0f);
+    const Vector2 t =
+        (v.texcoord - q.texcoordMin) / SafeExtent(q.texcoordMin, q.texcoordMax);
+
+    VertexPacked packed;
+    packed.position = {ToSnorm16(p.x), ToSnorm16(p.y), ToSnorm16(p.z), 0};
+    packed.normal = PackNormal(v.normal);
+    packed.texcoord = {ToUnorm16(t.x), ToUnorm16(t.y)};
+    return packed;
+}
+
+Vertex VertexFormat<VertexPacked>::Unpack(const VertexPacked &v,
+                                          const VertexQuantization &q)
+{
+    const PackedVertexConstantBuffer d = Dequantization(q);
+
+    Vertex u;
+    u.position = Vector3(FromSnorm16(v.position.x), FromSnorm16(v.position.y),
+                         FromSnorm16(v.position.z)) *
+                     d.positionScale +
+                 d.positionOffset;
+    u.normal = UnpackNormal(v.normal);
+    u.texcoord = Vector2(FromUnorm16(v.texcoord.x), FromUnorm16(v.texcoord.y)) *
+                     d.texcoordScale +
+                 d.texcoordOffset;
+    return u;
+}
+
+PackedVertexConstantBuffer
+VertexFormat<VertexPacked>::Dequantization(const VertexQuantization &q)
+{
+    PackedVertexConstantBuffer d;
+    d.positionScale = SafeExtent(q.positionMin, q.positionMax) * 0.5f;
+    d.positionOffset = q.positionMin + d.positionScale; // 범위의 중심
+    d.texcoordScale = SafeExtent(q.texcoordMin, q.texcoordMax);
+    d.texcoordOffset = q.texcoordMin;
+    return d;
+}
+
+// VertexCompact: position은 [min, max] -> [0, 1], texcoord는 half 그대로
+VertexCompact VertexFormat<VertexCompact>::Pack(const Vertex &v,
+                                                const VertexQuantization &q)
+{
+    const Vector3 p =
+        (v.position - q.positionMin) / SafeExtent(q.positionMin, q.positionMax);
+
+    VertexCompact packed;
+    packed.position.xyzw =
+        ToUnorm10(p.x) | (ToUnorm10(p.y) << 10) | (ToUnorm10(p.z) << 20);
+    packed.normal = PackNormal(v.normal);
+    packed.texcoord = {XMConvertFloatToHalf(v.texcoord.x),
+                       XMConvertFloatToHalf(v.texcoord.y)};
+    return packed;
+}
+
+Vertex VertexFormat<VertexCompact>::Unpack(const VertexCompact &v,
+                                           const VertexQuantization &q)
+{
+    const PackedVertexConstantBuffer d = Dequantization(q);
+
+    Vertex u;
+    u.position = Vector3(FromUnorm10(v.position.xyzw),
+                         FromUnorm10(v.position.xyzw >> 10),
+                         FromUnorm10(v.position.xyzw >> 20)) *
+                     d.positionScale +
+                 d.positionOffset;
+    u.normal = UnpackNormal(v.normal);
+    u.texcoord = Vector2(XMConvertHalfToFloat(v.texcoord.x),
+                         XMConvertHalfToFloat(v.texcoord.y));
+    return u;
+}
+
+PackedVertexConstantBuffer
+VertexFormat<VertexCompact>::Dequantization(const VertexQuantization &q)
+{
+    PackedVertexConstantBuffer d;
+    d.positionScale = SafeExtent(q.positionMin, q.positionMax);
+    d.positionOffset = q.positionMin;
+    return d;
+}
+
+} // namespace FEFE
@@ -0,0 +1,195 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <d3d11.h>
+#include <directxtk/SimpleMath.h>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "MeshData.h"
+#include "Vertex.h"
+
+namespace FEFE
+{
+
+using DirectX::SimpleMath::Vector2;
+using DirectX::SimpleMath::Vector3;
+
+// 버텍스 멤버 타입 -> DXGI 형식
+template <typename T_ATTRIBUTE> struct VertexAttribute;
+
+template <> struct VertexAttribute<Vector3>
+{
+    static constexpr DXGI_FORMAT format = DXGI_FORMAT_R32G32B32_FLOAT;
+};
+template <> struct VertexAttribute<Vector2>
+{
+    static constexpr DXGI_FORMAT format = DXGI_FORMAT_R32G32_FLOAT;
+};
+template <> struct VertexAttribute<Snorm16x4>
+{
+    static constexpr DXGI_FORMAT format = DXGI_FORMAT_R16G16B16A16_SNORM;
+};
+template <> struct VertexAttribute<Snorm16x2>
+{
+    static constexpr DXGI_FORMAT format = DXGI_FORMAT_R16G16_SNORM;
+};
+template <> struct VertexAttribute<Unorm16x2>
+{
+    static constexpr DXGI_FORMAT format = DXGI_FORMAT_R16G16_UNORM;
+};
+template <> struct VertexAttribute<Half2>
+{
+    static constexpr DXGI_FORMAT format = DXGI_FORMAT_R16G16_FLOAT;
+};
+template <> struct VertexAttribute<Unorm10x3>
+{
+    static constexpr DXGI_FORMAT format = DXGI_FORMAT_R10G10B10A2_UNORM;
+};
+
+// 멤버의 타입과 오프셋으로 D3D11_INPUT_ELEMENT_DESC를 컴파일 타임에 만듦
+// 예전처럼 4 * 3 + 4 * 3 같은 오프셋을 직접 쓰지 않아도 됨
+#define FEFE_VERTEX_ELEMENT(T_VERTEX, member, semantic)                        \
+    D3D11_INPUT_ELEMENT_DESC                                                   \
+    {                                                                          \
+        semantic, 0, VertexAttribute<decltype(T_VERTEX::member)>::format, 0,   \
+            UINT(offsetof(T_VERTEX, member)), D3D11_INPUT_PER_VERTEX_DATA, 0   \
+    }
+
+// 메쉬 전체의 범위 (양자화 기준)
+struct VertexQuantization
+{
+    Vector3 positionMin = Vector3(0.0f);
+    Vector3 positionMax = Vector3(0.0f);
+    Vector2 texcoordMin = Vector2(0.0f);
+    Vector2 texcoordMax = Vector2(0.0f);
+
+    static VertexQuantization FromMeshes(const std::vector<MeshDataView> &meshes);
+};
+
+// PackedVertexShader.hlsl에서 양자화된 값을 되돌릴 때 사용
+struct PackedVertexConstantBuffer
+{
+    Vector3 positionScale = Vector3(1.0f);
+    float dummy1;
+    Vector3 positionOffset = Vector3(0.0f);
+    float dummy2;
+    Vector2 texcoordScale = Vector2(1.0f);
+    Vector2 texcoordOffset = Vector2(0.0f);
+};
+
+static_assert((sizeof(PackedVertexConstantBuffer) % 16) == 0,
+              "Constant Buffer size must be 16-byte aligned");
+
+// 버텍스 형식마다 입력 레이아웃, 쉐이더, 변환 함수를 모아둔 traits
+template <typename T_VERTEX> struct VertexFormat;
+
+template <> struct VertexFormat<Vertex>
+{
+    static constexpr D3D11_INPUT_ELEMENT_DESC inputElements[] = {
+        FEFE_VERTEX_ELEMENT(Vertex, position, "POSITION"),
+        FEFE_VERTEX_ELEMENT(Vertex, normal, "NORMAL"),
+        FEFE_VERTEX_ELEMENT(Vertex, texcoord, "TEXCOORD"),
+    };
+    static constexpr const wchar_t *vertexShaderFilename =
+        L"BasicVertexShader.hlsl";
+
+    static Vertex Pack(const Vertex &v, const VertexQuantization &) { return v; }
+    static Vertex Unpack(const Vertex &v, const VertexQuantization &) { return v; }
+    static PackedVertexConstantBuffer Dequantization(const VertexQuantization &)
+    {
+        return PackedVertexConstantBuffer();
+    }
+};
+
+template <> struct VertexFormat<VertexPacked>
+{
+    static constexpr D3D11_INPUT_ELEMENT_DESC inputElements[] = {
+        FEFE_VERTEX_ELEMENT(VertexPacked, position, "POSITION"),
+        FEFE_VERTEX_ELEMENT(VertexPacked, normal, "NORMAL"),
+        FEFE_VERTEX_ELEMENT(VertexPacked, texcoord, "TEXCOORD"),
+    };
+    static constexpr const wchar_t *vertexShaderFilename =
+        L"PackedVertexShader.hlsl";
+
+    static VertexPacked Pack(const Vertex &v, const VertexQuantization &q);
+    static Vertex Unpack(const VertexPacked &v, const VertexQuantization &q);
+    static PackedVertexConstantBuffer Dequantization(const VertexQuantization &q);
+};
+
+template <> struct VertexFormat<VertexCompact>
+{
+    static constexpr D3D11_INPUT_ELEMENT_DESC inputElements[] = {
+        FEFE_VERTEX_ELEMENT(VertexCompact, position, "POSITION"),
+        FEFE_VERTEX_ELEMENT(VertexCompact, normal, "NORMAL"),
+        FEFE_VERTEX_ELEMENT(VertexCompact, texcoord, "TEXCOORD"),
+    };
+    static constexpr const wchar_t *vertexShaderFilename =
+        L"PackedVertexShader.hlsl";
+
+    static VertexCompact Pack(const Vertex &v, const VertexQuantization &q);
+    static Vertex Unpack(const VertexCompact &v, const VertexQuantization &q);
+    static PackedVertexConstantBuffer Dequantization(const VertexQuantization &q);
+};
+
+template <typename T_VERTEX>
+std::vector<D3D11_INPUT_ELEMENT_DESC> GetInputElements()
+{
+    return std::vector<D3D11_INPUT_ELEMENT_DESC>(
+        std::begin(VertexFormat<T_VERTEX>::inputElements),
+        std::end(VertexFormat<T_VERTEX>::inputElements));
+}
+
+// 변환 전후 최대 오차 (원래 Vertex 기준)
+struct VertexPackingError
+{
+    float position = 0.0f; // 모델 좌표 거리
+    float normalDegrees = 0.0f;
+    float texcoord = 0.0f;
+};
+
+template <typename T_VERTEX>
+TMeshData<T_VERTEX> PackMeshData(const MeshDataView &meshData,
+                                 const VertexQuantization &quantization,
+                                 VertexPackingError &error)
+{
+    TMeshData<T_VERTEX> packed;
+    packed.vertices.resize(meshData.numVertices);
+    packed.indices.assign(meshData.indices,
+                          meshData.indices + meshData.numIndices);
+    packed.textureFilename = meshData.textureFilename;
+    packed.packedTextureFilename = meshData.packedTextureFilename;
+    packed.packedChannels = meshData.packedChannels;
+    packed.uvDensity = meshData.uvDensity;
+    packed.lods.assign(meshData.lods, meshData.lods + meshData.numLods);
+    packed.meshlets.assign(meshData.meshlets,
+                           meshData.meshlets + meshData.numMeshlets);
+
+    for (size_t i = 0; i < meshData.numVertices; i++)
+    {
+        const Vertex &v = meshData.vertices[i];
+        packed.vertices[i] = VertexFormat<T_VERTEX>::Pack(v, quantization);
+
+        const Vertex u =
+            VertexFormat<T_VERTEX>::Unpack(packed.vertices[i], quantization);
+        error.position =
+            std::max(error.position, (u.position - v.position).Length());
+        error.texcoord =
+            std::max(error.texcoord, (u.texcoord - v.texcoord).Length());
+
+        const float cosAngle = std::min(
+            std::max(u.normal.Dot(v.normal) /
+                         std::max(v.normal.Length() * u.normal.Length(), 1e-12f),
+                     -1.0f),
+            1.0f);
+        error.normalDegrees = std::max(
+            error.normalDegrees, DirectX::XMConvertToDegrees(std::acos(cosAngle)));
+    }
+
+    return packed;
+}
+
+} // namespace FEFE
@@ -0,0 +1,519 @@
+﻿#include "VertexKernels.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "ThreadPool.h"
+#include "VertexKernelsAvx.h"
+
+// x64는 항상 SSE2가 있음
+// AVX는 VertexKernelsAvx.cpp에만 켜고 CPU가 지원할 때만 호출 (실행 중에 확인)
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FEFE_KERNELS_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h> // _xgetbv
+#include <intrin.h>    // __cpuid
+#endif
+
+namespace FEFE
+{
+
+using namespace DirectX::SimpleMath;
+
+static_assert(sizeof(Vertex) == 8 * sizeof(float),
+              "VertexKernels assume Vertex = 8 floats");
+
+namespace
+{
+
+// chunk 하나 = 64K 버텍스 (2 MB)
+// 이보다 작은 배열은 호출한 스레드에서 바로 처리
+const size_t chunkSize = 64 * 1024;
+
+// position은 float 0 ~ 2, normal은 float 3 ~ 5
+const size_t positionOffset = 0;
+const size_t normalOffset = 3;
+
+// 행 벡터 규약: p' = p.x * row[0] + p.y * row[1] + p.z * row[2] + row[3]
+struct Rows
+{
+    float row[4][3];
+};
+
+Rows ToRows(const Matrix &m)
+{
+    return {{{m._11, m._12, m._13},
+             {m._21, m._22, m._23},
+             {m._31, m._32, m._33},
+             {m._41, m._42, m._43}}};
+}
+
+Matrix NormalMatrix(const Matrix &m)
+{
+    Matrix normalMatrix = m;
+    normalMatrix.Translation(Vector3(0.0f));
+    return normalMatrix.Invert().Transpose();
+}
+
+float *Floats(Vertex *v) { return &v->position.x; }
+const float *Floats(const Vertex *v) { return &v->position.x; }
+
+void ForEachChunk(size_t count, const std::function<void(size_t, size_t)> &func)
+{
+    if (count <= chunkSize)
+        func(0, count);
+    else
+        ThreadPool::Get().ParallelForChunks(count, chunkSize, func);
+}
+
+// 스칼라 (SIMD 구현의 나머지 처리 겸용)
+Vector3 TransformScalar(const Vector3 &p, const Rows &r, float w)
+{
+    return Vector3(
+        p.x * r.row[0][0] + p.y * r.row[1][0] + p.z * r.row[2][0] + w * r.row[3][0],
+        p.x * r.row[0][1] + p.y * r.row[1][1] + p.z * r.row[2][1] + w * r.row[3][1],
+        p.x * r.row[0][2] + p.y * r.row[1][2] + p.z * r.row[2][2] + w * r.row[3][2]);
+}
+
+void TransformPositionsScalar(Vertex *v, size_t count, const Rows &r)
+{
+    for (size_t i = 0; i < count; i++)
+        v[i].position = TransformScalar(v[i].position, r, 1.0f);
+}
+
+void TransformNormalsScalar(Vertex *v, size_t count, const Rows &r)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        v[i].normal = TransformScalar(v[i].normal, r, 0.0f);
+        v[i].normal.Normalize();
+    }
+}
+
+void BoundsScalar(const Vertex *v, size_t count, Vector3 &vmin, Vector3 &vmax)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        vmin = Vector3::Min(vmin, v[i].position);
+        vmax = Vector3::Max(vmax, v[i].position);
+    }
+}
+
+void RecenterAndScaleScalar(Vertex *v, size_t count, const Vector3 &scale,
+                            const Vector3 &bias)
+{
+    for (size_t i = 0; i < count; i++)
+        v[i].position = v[i].position * scale + bias;
+}
+
+#ifdef FEFE_KERNELS_SSE2
+
+// 버텍스 4개의 float[offset, offset + 4)를 읽어서 SoA로 전치
+inline void Load4(const float *f, size_t offset, __m128 &x, __m128 &y,
+                  __m128 &z, __m128 &w)
+{
+    x = _mm_loadu_ps(f + offset);
+    y = _mm_loadu_ps(f + 8 + offset);
+    z = _mm_loadu_ps(f + 16 + offset);
+    w = _mm_loadu_ps(f + 24 + offset);
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+}
+
+inline void Store4(float *f, size_t offset, __m128 x, __m128 y, __m128 z,
+                   __m128 w)
+{
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    _mm_storeu_ps(f + offset, x);
+    _mm_storeu_ps(f + 8 + offset, y);
+    _mm_storeu_ps(f + 16 + offset, z);
+    _mm_storeu_ps(f + 24 + offset, w);
+}
+
+struct Rows4
+{
+    __m128 row[4][3];
+
+    explicit Rows4(const Rows &r)
+    {
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 3; j++)
+                row[i][j] = _mm_set1_ps(r.row[i][j]);
+    }
+
+    __m128 Dot(__m128 x, __m128 y, __m128 z, int j) const
+    {
+        return _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(x, row[0][j]), _mm_mul_ps(y, row[1][j])),
+            _mm_mul_ps(z, row[2][j]));
+    }
+};
+
+inline void Normalize4(__m128 &x, __m128 &y, __m128 &z)
+{
+    const __m128 lengthSquared = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+    // 길이가 0이면 그대로 0 (Vector3::Normalize()와 같음)
+    const __m128 inverse = _mm_and_ps(
+        _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(lengthSquared)),
+        _mm_cmpgt_ps(lengthSquared, _mm_setzero_ps()));
+    x = _mm_mul_ps(x, inverse);
+    y = _mm_mul_ps(y, inverse);
+    z = _mm_mul_ps(z, inverse);
+}
+
+#endif // FEFE_KERNELS_SSE2
+
+// CPU와 OS (YMM 레지스터 저장)가 AVX를 지원하고 AVX 경로가 빌드됐는지
+bool CanUseAvx()
+{
+    if (!VertexKernelsAvx::IsCompiled())
+        return false;
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    return osxsave && avx && (_xgetbv(0) & 6) == 6;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    return __builtin_cpu_supports("avx");
+#else
+    return false;
+#endif
+}
+
+bool UseAvx()
+{
+    static const bool useAvx = CanUseAvx();
+    return useAvx;
+}
+
+// 한 chunk 안에서의 처리: AVX 8개 -> SSE 4개 -> 스칼라 순서로 나머지 처리
+// positions/normals 중 하나만 켜면 다른 쪽은 읽은 값을 그대로 다시 씀
+void TransformRange(Vertex *v, size_t count, const Rows *positionRows,
+                    const Rows *normalRows)
+{
+    size_t i = 0;
+
+    if (UseAvx())
+    {
+        i = VertexKernelsAvx::TransformRange(
+            Floats(v), count, positionRows ? &positionRows->row[0][0] : nullptr,
+            normalRows ? &normalRows->row[0][0] : nullptr);
+    }
+
+#ifdef FEFE_KERNELS_SSE2
+    {
+        const Rows4 p4(positionRows ? *positionRows : Rows());
+        const Rows4 n4(normalRows ? *normalRows : Rows());
+        for (; i + 4 <= count; i += 4)
+        {
+            float *f = Floats(v + i);
+
+            __m128 px, py, pz, pw, nx, ny, nz, nw;
+            Load4(f, positionOffset, px, py, pz, pw);
+            Load4(f, normalOffset, nx, ny, nz, nw);
+
+            if (positionRows)
+            {
+                const __m128 x = _mm_add_ps(p4.Dot(px, py, pz, 0), p4.row[3][0]);
+                const __m128 y = _mm_add_ps(p4.Dot(px, py, pz, 1), p4.row[3][1]);
+                const __m128 z = _mm_add_ps(p4.Dot(px, py, pz, 2), p4.row[3][2]);
+                Store4(f, positionOffset, x, y, z, pw);
+            }
+            if (normalRows)
+            {
+                __m128 x = n4.Dot(nx, ny, nz, 0);
+                __m128 y = n4.Dot(nx, ny, nz, 1);
+                __m128 z = n4.Dot(nx, ny, nz, 2);
+                Normalize4(x, y, z);
+                Store4(f, normalOffset, x, y, z, nw);
+            }
+        }
+    }
+#endif
+
+    if (positionRows)
+        TransformPositionsScalar(v + i, count - i, *positionRows);
+    if (normalRows)
+        TransformNormalsScalar(v + i, count - i, *normalRows);
+}
+
+// 메모리 대역폭이 한계라서 SoA 전치 없이 버텍스마다 float4로 min/max
+// (4번째 성분은 normal.x라서 버림)
+void BoundsRange(const Vertex *v, size_t count, Vector3 &vmin, Vector3 &vmax)
+{
+    size_t i = 0;
+
+#ifdef FEFE_KERNELS_SSE2
+    if (count >= 2)
+    {
+        const float *f = Floats(v);
+        __m128 min0 = _mm_loadu_ps(f), max0 = min0;
+        __m128 min1 = min0, max1 = min0;
+        for (; i + 2 <= count; i += 2)
+        {
+            const __m128 a = _mm_loadu_ps(f + i * 8);
+            const __m128 b = _mm_loadu_ps(f + i * 8 + 8);
+            min0 = _mm_min_ps(min0, a);
+            max0 = _mm_max_ps(max0, a);
+            min1 = _mm_min_ps(min1, b);
+            max1 = _mm_max_ps(max1, b);
+        }
+        float lo[4], hi[4];
+        _mm_storeu_ps(lo, _mm_min_ps(min0, min1));
+        _mm_storeu_ps(hi, _mm_max_ps(max0, max1));
+        vmin = Vector3::Min(vmin, Vector3(lo[0], lo[1], lo[2]));
+        vmax = Vector3::Max(vmax, Vector3(hi[0], hi[1], hi[2]));
+    }
+#endif
+
+    BoundsScalar(v + i, count - i, vmin, vmax);
+}
+
+// position * scale + bias를 버텍스 전체(float 8개)에 대해 계산
+// normal/texcoord 자리는 * 1 + 0이라서 값이 바뀌지 않음
+void RecenterAndScaleRange(Vertex *v, size_t count, const Vector3 &scale,
+                           const Vector3 &bias)
+{
+    size_t i = 0;
+
+    if (UseAvx())
+    {
+        const float s[3] = {scale.x, scale.y, scale.z};
+        const float b[3] = {bias.x, bias.y, bias.z};
+        i = VertexKernelsAvx::RecenterAndScaleRange(Floats(v), count, s, b);
+    }
+
+#ifdef FEFE_KERNELS_SSE2
+    {
+        float *f = Floats(v);
+        const __m128 s = _mm_setr_ps(scale.x, scale.y, scale.z, 1.0f);
+        const __m128 b = _mm_setr_ps(bias.x, bias.y, bias.z, 0.0f);
+        for (; i < count; i++)
+        {
+            _mm_storeu_ps(f + i * 8,
+                          _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(f + i * 8), s), b));
+        }
+    }
+#endif
+
+    RecenterAndScaleScalar(v + i, count - i, scale, bias);
+}
+
+} // namespace
+
+const char *VertexKernels::GetInstructionSet()
+{
+    if (UseAvx())
+        return "AVX";
+#if defined(FEFE_KERNELS_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+void VertexKernels::TransformPositions(Vertex *vertices, size_t count,
+                                       const Matrix &m)
+{
+    const Rows rows = ToRows(m);
+    ForEachChunk(count, [&](size_t begin, size_t end) {
+        TransformRange(vertices + begin, end - begin, &rows, nullptr);
+    });
+}
+
+void VertexKernels::TransformNormals(Vertex *vertices, size_t count,
+                                     const Matrix &normalMatrix)
+{
+    const Rows rows = ToRows(normalMatrix);
+    ForEachChunk(count, [&](size_t begin, size_t end) {
+        TransformRange(vertices + begin, end - begin, nullptr, &rows);
+    });
+}
+
+void VertexKernels::TransformVertices(Vertex *vertices, size_t count,
+                                      const Matrix &m)
+{
+    const Rows positionRows = ToRows(m);
+    const Rows normalRows = ToRows(NormalMatrix(m));
+    ForEachChunk(count, [&](size_t begin, size_t end) {
+        TransformRange(vertices + begin, end - begin, &positionRows,
+                       &normalRows);
+    });
+}
+
+void VertexKernels::ComputeBounds(const Vertex *vertices, size_t count,
+                                  Vector3 &vmin, Vector3 &vmax)
+{
+    // chunk마다 따로 구해서 마지막에 합침
+    const size_t numChunks = (count + chunkSize - 1) / chunkSize;
+    std::vector<Vector3> chunkMin(numChunks, Vector3(FLT_MAX));
+    std::vector<Vector3> chunkMax(numChunks, Vector3(-FLT_MAX));
+    ForEachChunk(count, [&](size_t begin, size_t end) {
+        BoundsRange(vertices + begin, end - begin, chunkMin[begin / chunkSize],
+                    chunkMax[begin / chunkSize]);
+    });
+
+    vmin = Vector3(FLT_MAX);
+    vmax = Vector3(-FLT_MAX);
+    for (size_t c = 0; c < numChunks; c++)
+    {
+        vmin = Vector3::Min(vmin, chunkMin[c]);
+        vmax = Vector3::Max(vmax, chunkMax[c]);
+    }
+}
+
+void VertexKernels::RecenterAndScale(Vertex *vertices, size_t count,
+                                     const Vector3 &center, float scale)
+{
+    // (p - center) * scale = p * scale - center * scale
+    const Vector3 scale3(scale);
+    const Vector3 bias = -center * scale;
+    ForEachChunk(count, [&](size_t begin, size_t end) {
+        RecenterAndScaleRange(vertices + begin, end - begin, scale3, bias);
+    });
+}
+
+void VertexKernels::Benchmark(size_t numVertices)
+{
+    using namespace DirectX;
+
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+
+    std::vector<Vertex> source(numVertices);
+    for (auto &v : source)
+    {
+        v.position = Vector3(distribution(random), distribution(random),
+                             distribution(random));
+        v.normal = Vector3(distribution(random), distribution(random),
+                           distribution(random));
+        v.normal.Normalize();
+        v.texcoord = Vector2(distribution(random), distribution(random));
+    }
+
+    auto Measure = [](const std::function<void()> &func) {
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        return std::chrono::duration<double, std::milli>(
+                   std::chrono::steady_clock::now() - start)
+            .count();
+    };
+
+    auto MaxError = [](const std::vector<Vertex> &a,
+                       const std::vector<Vertex> &b) {
+        float error = 0.0f;
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            const float *fa = Floats(&a[i]);
+            const float *fb = Floats(&b[i]);
+            for (int k = 0; k < 8; k++)
+                error = std::max(error, std::fabs(fa[k] - fb[k]));
+        }
+        return error;
+    };
+
+    const size_t numThreads = ThreadPool::Get().GetNumThreads() + 1;
+    auto Print = [&](const char *name, double loop, double single,
+                     double parallel, float error) {
+        std::cout << "VertexKernels " << name << " " << numVertices
+                  << " vertices: loop " << loop << " ms, "
+                  << GetInstructionSet() << " " << single << " ms, "
+                  << GetInstructionSet() << " x" << numThreads << " "
+                  << parallel << " ms (max error " << error << ")"
+                  << std::endl;
+    };
+
+    const Matrix m = Matrix::CreateScale(Vector3(0.5f, 2.0f, 1.5f)) *
+                     Matrix::CreateRotationY(0.3f) *
+                     Matrix::CreateRotationX(0.7f) *
+                     Matrix::CreateTranslation(Vector3(1.0f, 2.0f, 3.0f));
+    const Matrix normalMatrix = NormalMatrix(m);
+
+    // 1. position + normal 변환
+    {
+        std::vector<Vertex> loop = source, single = source, parallel = source;
+        const double tLoop = Measure([&] {
+            for (auto &v : loop)
+            {
+                v.position = Vector3::Transform(v.position, m);
+                v.normal = Vector3::TransformNormal(v.normal, normalMatrix);
+                v.normal.Normalize();
+            }
+        });
+        const Rows positionRows = ToRows(m);
+        const Rows normalRows = ToRows(normalMatrix);
+        const double tSingle = Measure([&] {
+            TransformRange(single.data(), single.size(), &positionRows,
+                           &normalRows);
+        });
+        const double tParallel = Measure(
+            [&] { TransformVertices(parallel.data(), parallel.size(), m); });
+        Print("transform", tLoop, tSingle, tParallel,
+              std::max(MaxError(loop, single), MaxError(loop, parallel)));
+    }
+
+    // 2. AABB
+    {
+        Vector3 loopMin(FLT_MAX), loopMax(-FLT_MAX);
+        const double tLoop = Measure([&] {
+            for (const auto &v : source)
+            {
+                loopMin.x = XMMin(loopMin.x, v.position.x);
+                loopMin.y = XMMin(loopMin.y, v.position.y);
+                loopMin.z = XMMin(loopMin.z, v.position.z);
+                loopMax.x = XMMax(loopMax.x, v.position.x);
+                loopMax.y = XMMax(loopMax.y, v.position.y);
+                loopMax.z = XMMax(loopMax.z, v.position.z);
+            }
+        });
+        Vector3 singleMin(FLT_MAX), singleMax(-FLT_MAX);
+        const double tSingle = Measure([&] {
+            BoundsRange(source.data(), source.size(), singleMin, singleMax);
+        });
+        Vector3 parallelMin, parallelMax;
+        const double tParallel = Measure([&] {
+            ComputeBounds(source.data(), source.size(), parallelMin,
+                          parallelMax);
+        });
+        const bool same = loopMin == singleMin && loopMax == singleMax &&
+                          loopMin == parallelMin && loopMax == parallelMax;
+        Print("bounds", tLoop, tSingle, tParallel, same ? 0.0f : FLT_MAX);
+    }
+
+    // 3. 중심 이동 + 크기 조절
+    {
+        const Vector3 center(1.0f, -2.0f, 3.0f);
+        const float scale = 1.0f / 200.0f;
+        std::vector<Vertex> loop = source, single = source, parallel = source;
+        const double tLoop = Measure([&] {
+            for (auto &v : loop)
+            {
+                v.position.x = (v.position.x - center.x) * scale;
+                v.position.y = (v.position.y - center.y) * scale;
+                v.position.z = (v.position.z - center.z) * scale;
+            }
+        });
+        const double tSingle = Measure([&] {
+            RecenterAndScaleRange(single.data(), single.size(), Vector3(scale),
+                                  -center * scale);
+        });
+        const double tParallel = Measure([&] {
+            RecenterAndScale(parallel.data(), parallel.size(), center, scale);
+        });
+        Print("recenter", tLoop, tSingle, tParallel,
+              std::max(MaxError(loop, single), MaxError(loop, parallel)));
+    }
+}
+
+} // namespace FEFE
@@ -0,0 +1,46 @@
+﻿#pragma once
+
+#include <cstddef>
+
+#include "Vertex.h"
+
+namespace FEFE
+{
+
+using DirectX::SimpleMath::Matrix;
+
+// Vertex 배열 전체를 한 번에 처리하는 변환/범위 계산 커널
+// SSE는 4개, AVX는 8개의 버텍스를 SoA로 바꿔서 계산 (나머지는 스칼라)
+// 큰 배열은 ThreadPool에서 chunk 단위로 나눠서 병렬 처리
+class VertexKernels
+{
+  public:
+    // 컴파일된 구현 ("AVX", "SSE2", "scalar")
+    static const char *GetInstructionSet();
+
+    // position = position * m
+    static void TransformPositions(Vertex *vertices, size_t count,
+                                   const Matrix &m);
+
+    // normal = normalize(normal * normalMatrix)
+    // normalMatrix는 보통 모델 행렬의 역행렬의 전치 (이동은 무시)
+    static void TransformNormals(Vertex *vertices, size_t count,
+                                 const Matrix &normalMatrix);
+
+    // position과 normal을 한 번에 변환 (normal은 m의 역행렬의 전치 사용)
+    static void TransformVertices(Vertex *vertices, size_t count,
+                                  const Matrix &m);
+
+    // position의 AABB, count가 0이면 vmin > vmax (FLT_MAX, -FLT_MAX)
+    static void ComputeBounds(const Vertex *vertices, size_t count,
+                              Vector3 &vmin, Vector3 &vmax);
+
+    // position = (position - center) * scale
+    static void RecenterAndScale(Vertex *vertices, size_t count,
+                                 const Vector3 &center, float scale);
+
+    // 버텍스마다 SimpleMath를 호출하는 루프와 속도/오차 비교 (콘솔 출력)
+    static void Benchmark(size_t numVertices);
+};
+
+} // namespace FEFE
@@ -0,0 +1,180 @@
+﻿#include "VertexKernelsAvx.h"
+
+// 프로젝트에서 이 파일만 /arch:AVX (gcc, clang은 -mavx)
+#if defined(__AVX__)
+#define FEFE_KERNELS_AVX
+#include <immintrin.h>
+#endif
+
+namespace FEFE
+{
+
+#ifdef FEFE_KERNELS_AVX
+
+namespace
+{
+
+// position은 float 0 ~ 2, normal은 float 3 ~ 5
+const size_t positionOffset = 0;
+const size_t normalOffset = 3;
+
+// 버텍스 i와 i + 4를 한 레지스터의 아래/위 128비트에 넣고
+// 128비트 단위로 전치 (_MM_TRANSPOSE4_PS와 같은 순서)
+inline void Transpose8(__m256 &x, __m256 &y, __m256 &z, __m256 &w)
+{
+    const __m256 t0 = _mm256_unpacklo_ps(x, y);
+    const __m256 t1 = _mm256_unpacklo_ps(z, w);
+    const __m256 t2 = _mm256_unpackhi_ps(x, y);
+    const __m256 t3 = _mm256_unpackhi_ps(z, w);
+    x = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+    y = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+    z = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    w = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+inline __m256 LoadPair(const float *f, size_t i, size_t offset)
+{
+    return _mm256_insertf128_ps(
+        _mm256_castps128_ps256(_mm_loadu_ps(f + i * 8 + offset)),
+        _mm_loadu_ps(f + (i + 4) * 8 + offset), 1);
+}
+
+inline void StorePair(float *f, size_t i, size_t offset, __m256 v)
+{
+    _mm_storeu_ps(f + i * 8 + offset, _mm256_castps256_ps128(v));
+    _mm_storeu_ps(f + (i + 4) * 8 + offset, _mm256_extractf128_ps(v, 1));
+}
+
+inline void Load8(const float *f, size_t offset, __m256 &x, __m256 &y,
+                  __m256 &z, __m256 &w)
+{
+    x = LoadPair(f, 0, offset);
+    y = LoadPair(f, 1, offset);
+    z = LoadPair(f, 2, offset);
+    w = LoadPair(f, 3, offset);
+    Transpose8(x, y, z, w);
+}
+
+inline void Store8(float *f, size_t offset, __m256 x, __m256 y, __m256 z,
+                   __m256 w)
+{
+    Transpose8(x, y, z, w);
+    StorePair(f, 0, offset, x);
+    StorePair(f, 1, offset, y);
+    StorePair(f, 2, offset, z);
+    StorePair(f, 3, offset, w);
+}
+
+struct Rows8
+{
+    __m256 row[4][3];
+
+    explicit Rows8(const float *r)
+    {
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 3; j++)
+                row[i][j] = _mm256_set1_ps(r ? r[i * 3 + j] : 0.0f);
+    }
+
+    __m256 Dot(__m256 x, __m256 y, __m256 z, int j) const
+    {
+        return _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, row[0][j]),
+                                           _mm256_mul_ps(y, row[1][j])),
+                             _mm256_mul_ps(z, row[2][j]));
+    }
+};
+
+inline void Normalize8(__m256 &x, __m256 &y, __m256 &z)
+{
+    const __m256 lengthSquared =
+        _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)),
+                      _mm256_mul_ps(z, z));
+    // 길이가 0이면 그대로 0 (Vector3::Normalize()와 같음)
+    const __m256 inverse = _mm256_and_ps(
+        _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(lengthSquared)),
+        _mm256_cmp_ps(lengthSquared, _mm256_setzero_ps(), _CMP_GT_OQ));
+    x = _mm256_mul_ps(x, inverse);
+    y = _mm256_mul_ps(y, inverse);
+    z = _mm256_mul_ps(z, inverse);
+}
+
+} // namespace
+
+bool VertexKernelsAvx::IsCompiled()
+{
+    return true;
+}
+
+size_t VertexKernelsAvx::TransformRange(float *f, size_t count,
+                                        const float *positionRows,
+                                        const float *normalRows)
+{
+    const Rows8 p8(positionRows);
+    const Rows8 n8(normalRows);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8, f += 64)
+    {
+        // 두 번 읽은 다음 저장 (position 쪽 w = normal.x 원래 값)
+        __m256 px, py, pz, pw, nx, ny, nz, nw;
+        Load8(f, positionOffset, px, py, pz, pw);
+        Load8(f, normalOffset, nx, ny, nz, nw);
+
+        if (positionRows)
+        {
+            const __m256 x = _mm256_add_ps(p8.Dot(px, py, pz, 0), p8.row[3][0]);
+            const __m256 y = _mm256_add_ps(p8.Dot(px, py, pz, 1), p8.row[3][1]);
+            const __m256 z = _mm256_add_ps(p8.Dot(px, py, pz, 2), p8.row[3][2]);
+            Store8(f, positionOffset, x, y, z, pw);
+        }
+        if (normalRows)
+        {
+            __m256 x = n8.Dot(nx, ny, nz, 0);
+            __m256 y = n8.Dot(nx, ny, nz, 1);
+            __m256 z = n8.Dot(nx, ny, nz, 2);
+            Normalize8(x, y, z);
+            Store8(f, normalOffset, x, y, z, nw);
+        }
+    }
+    return i;
+}
+
+size_t VertexKernelsAvx::RecenterAndScaleRange(float *f, size_t count,
+                                               const float scale[3],
+                                               const float bias[3])
+{
+    // normal/texcoord 자리는 * 1 + 0이라서 값이 바뀌지 않음
+    const __m256 s = _mm256_setr_ps(scale[0], scale[1], scale[2], 1.0f, 1.0f,
+                                    1.0f, 1.0f, 1.0f);
+    const __m256 b = _mm256_setr_ps(bias[0], bias[1], bias[2], 0.0f, 0.0f,
+                                    0.0f, 0.0f, 0.0f);
+    for (size_t i = 0; i < count; i++)
+    {
+        _mm256_storeu_ps(f + i * 8,
+                         _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(f + i * 8), s), b));
+    }
+    return count;
+}
+
+#else
+
+bool VertexKernelsAvx::IsCompiled()
+{
+    return false;
+}
+
+size_t VertexKernelsAvx::TransformRange(float *, size_t, const float *,
+                                        const float *)
+{
+    return 0;
+}
+
+size_t VertexKernelsAvx::RecenterAndScaleRange(float *, size_t, const float[3],
+                                               const float[3])
+{
+    return 0;
+}
+
+#endif // FEFE_KERNELS_AVX
+
+} // namespace FEFE
@@ -0,0 +1,30 @@
+﻿#pragma once
+
+#include <cstddef>
+
+namespace FEFE
+{
+
+// VertexKernels의 AVX 경로 (이 파일만 /arch:AVX로 빌드)
+// AVX로 컴파일된 inline 함수가 다른 파일로 섞이지 않도록 SimpleMath 없이 float 배열만 받음
+// CPU가 AVX를 지원하는지는 VertexKernels가 확인하고 호출
+class VertexKernelsAvx
+{
+  public:
+    // 이 파일이 AVX로 빌드됐는지 (아니면 아래 함수는 아무것도 하지 않고 0)
+    static bool IsCompiled();
+
+    // f: Vertex 배열 (버텍스마다 float 8개)
+    // rows: 행 벡터 규약의 float[4][3], nullptr이면 그 성분은 건너뜀
+    // 8개 단위로 처리한 버텍스 수를 돌려줌 (나머지는 호출한 쪽에서)
+    static size_t TransformRange(float *f, size_t count,
+                                 const float *positionRows,
+                                 const float *normalRows);
+
+    // position = position * scale + bias (버텍스 전체를 float 8개로 처리)
+    static size_t RecenterAndScaleRange(float *f, size_t count,
+                                        const float scale[3],
+                                        const float bias[3]);
+};
+
+} // namespace FEFE